@@ -0,0 +1,11 @@
+#ifndef ALIMER_GLSL
+#define ALIMER_GLSL
+
+// Per view data shared by every engine shader, set 0 is left to the material.
+layout (set = 1, binding = 0) uniform Camera
+{
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+} camera;
+
+#endif
@@ -2,23 +2,30 @@
 
 #include "alimer.glsl"
 
-layout (location = 0) in highp vec3 inPosition;
-
-layout (location = 2) in highp vec2 inTexCoord;
+// Per instance data written by SpriteBatch, quads are drawn as 4 vertex triangle strips.
+layout (location = 0) in highp vec4 inPositionSize;
+layout (location = 1) in highp vec3 inRotationDepth;
+layout (location = 2) in highp vec4 inTexRect;
 layout (location = 1) out highp vec2 vTexCoord;
 
 #if HAVE_VERTEX_COLOR
-layout (location = 1) in mediump vec4 inColor;
+layout (location = 3) in mediump vec4 inColor;
 layout (location = 0) out mediump vec4 vColor;
 #endif
 
 void main()
 {
-	gl_Position = camera.projectionMatrix * camera.viewMatrix * vec4(inPosition.xyz, 1.0);
+	highp vec2 corner = vec2(float(gl_VertexIndex & 1), float(gl_VertexIndex >> 1));
+	highp vec2 offset = (corner * 2.0 - 1.0) * inPositionSize.zw;
+	highp vec2 position = inPositionSize.xy + vec2(
+		offset.x * inRotationDepth.x - offset.y * inRotationDepth.y,
+		offset.x * inRotationDepth.y + offset.y * inRotationDepth.x);
+
+	gl_Position = camera.projectionMatrix * camera.viewMatrix * vec4(position, inRotationDepth.z, 1.0);
 
 #if HAVE_VERTEX_COLOR
     vColor = inColor;
 #endif
 
-    vTexCoord = inTexCoord;
+    vTexCoord = mix(inTexRect.xy, inTexRect.zw, corner);
 }
@@ -20,16 +20,733 @@
 // THE SOFTWARE.
 //
 
+
 #include "audio/audio.h"
+#include "foundation/allocator.h"
+#include "foundation/job_system.h"
+#include "foundation/log.h"
+#include "foundation/profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
 
 namespace alimer
 {
+    namespace
+    {
+        /// Highest source frames per output frame, bounds the stream frames read per block.
+        static constexpr uint32_t MaxStepFrames = 8;
+        static constexpr float MinPitch = 1.0f / 64.0f;
+        static constexpr float MaxPitch = 4.0f;
+
+        /// Blocks Update mixes at most to catch up after a stall, older audio is skipped.
+        static constexpr uint32_t MaxCatchUpBlocks = 8;
+
+        /// Mixer containers accounted to MemoryTag::Audio.
+        template <typename T>
+        using AudioVector = std::vector<T, MemoryTagAllocator<T, MemoryTag::Audio>>;
+
+        enum class AudioCommandType : uint32_t
+        {
+            Play,
+            Stop,
+            SetGain,
+            SetPan,
+            SetPitch,
+            SetPaused,
+            SetMasterGain
+        };
+
+        struct AudioCommand
+        {
+            AudioCommandType type;
+            uint32_t index;
+            uint32_t generation;
+            float value;
+            const AudioClip* clip;
+            AudioStream* stream;
+            AudioVoiceParams params;
+        };
+
+        /// Queue slot, the sequence number tells producers and the mixer who owns it (bounded MPMC queue by D. Vyukov).
+        struct alignas(64) CommandRecord : AlignedAllocation<CommandRecord, MemoryTag::Audio>
+        {
+            std::atomic<uint64_t> sequence;
+            AudioCommand command;
+        };
+
+        /// Voice slot state shared with game threads, claimed by Play and released by the mixer.
+        struct VoiceSlot : AlignedAllocation<VoiceSlot, MemoryTag::Audio>
+        {
+            std::atomic<bool> busy{ false };
+            std::atomic<uint32_t> generation{ 0 };
+        };
+
+        /// Voice state owned by the mixer.
+        struct Voice
+        {
+            bool active = false;
+            bool stopping = false;
+            bool paused = false;
+            bool loop = false;
+            bool streamStarted = false;
+            uint32_t generation = 0;
+            const AudioClip* clip = nullptr;
+            AudioStream* stream = nullptr;
+            uint32_t channels = 0;
+            uint32_t sampleRate = 0;
+            uint64_t position = 0;
+            uint64_t step = 0;
+            float gain = 1.0f;
+            float pan = 0.0f;
+            /// Gains reached at the end of the previous block, the next block ramps from them.
+            float appliedLeft = 0.0f;
+            float appliedRight = 0.0f;
+        };
+
+        uint64_t ComputeStep(uint32_t sourceRate, uint32_t outputRate, float pitch)
+        {
+            pitch = std::min(std::max(pitch, MinPitch), MaxPitch);
+            const double step = static_cast<double>(sourceRate) / static_cast<double>(outputRate) * pitch * static_cast<double>(AudioFractionOne);
+            return std::min(std::max(static_cast<uint64_t>(step), uint64_t(1)), MaxStepFrames * AudioFractionOne);
+        }
+    }
+
+    struct Audio::Impl : AlignedAllocation<Audio::Impl, MemoryTag::Audio>
+    {
+        AudioSettings settings;
+        AudioDevice* device = nullptr;
+        JobSystem* jobs = nullptr;
+
+        // Voice pool, clips and streams hold the sources of each slot until it is claimed again.
+        std::unique_ptr<VoiceSlot[]> slots;
+        std::atomic<uint32_t> nextSlot{ 0 };
+        AudioVector<std::shared_ptr<AudioClip>> clips;
+        AudioVector<std::shared_ptr<AudioStream>> streams;
+        AudioVector<Voice> voices;
+        uint32_t activeVoices = 0;
+
+        // Commands from game threads, only the mixer dequeues.
+        std::unique_ptr<CommandRecord[]> commands;
+        uint32_t commandCapacity = 0;
+        alignas(64) std::atomic<uint64_t> enqueuePosition{ 0 };
+        alignas(64) uint64_t dequeuePosition = 0;
+
+        // Planar mix buffers, one block each.
+        AudioSampleVector mixLeft;
+        AudioSampleVector mixRight;
+        AudioSampleVector voiceBuffer;
+        AudioSampleVector streamBuffer;
+        AudioSampleVector output;
+        uint32_t streamBufferFrames = 0;
+        float masterGain = 1.0f;
+
+        // Statistics, written by the mixer.
+        std::atomic<uint64_t> blocksMixed{ 0 };
+        std::atomic<uint64_t> voicesMixed{ 0 };
+        std::atomic<uint64_t> mixTime{ 0 };
+        std::atomic<uint32_t> activeVoiceCount{ 0 };
+        std::atomic<uint64_t> commandsProcessed{ 0 };
+        std::atomic<uint64_t> commandsDropped{ 0 };
+        std::atomic<uint64_t> streamUnderruns{ 0 };
+
+        // Streams still decoding.
+        std::mutex streamMutex;
+        AudioVector<std::shared_ptr<AudioStream>> decodeStreams;
+        AudioVector<std::shared_ptr<AudioStream>> refillStreams;
+
+        std::chrono::steady_clock::time_point startTime;
+        uint64_t framesDue = 0;
+
+        /// The update job in flight, at most one runs so the mixer keeps a single consumer.
+        JobCounter updateCounter;
+
+        uint32_t ClaimVoice()
+        {
+            for (uint32_t attempt = 0; attempt < settings.maxVoices; attempt++)
+            {
+                const uint32_t index = nextSlot.fetch_add(1, std::memory_order_relaxed) % settings.maxVoices;
+                bool expected = false;
+                if (slots[index].busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return index;
+                }
+            }
+
+            return ~0u;
+        }
+
+        bool Enqueue(const AudioCommand& command)
+        {
+            uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                CommandRecord& record = commands[position & (commandCapacity - 1)];
+                const uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+                const int64_t difference = static_cast<int64_t>(sequence - position);
+                if (difference == 0)
+                {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        record.command = command;
+                        record.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // Full, game threads never wait for the mixer.
+                    commandsDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void Send(AudioCommandType type, AudioVoice voice, float value)
+        {
+            if (voice.index >= settings.maxVoices) {
+                return;
+            }
+
+            AudioCommand command = {};
+            command.type = type;
+            command.index = voice.index;
+            command.generation = voice.generation;
+            command.value = value;
+            Enqueue(command);
+        }
+
+        AudioVoice StartVoice(uint32_t index, const AudioClip* clip, AudioStream* stream, const AudioVoiceParams& params)
+        {
+            AudioCommand command = {};
+            command.type = AudioCommandType::Play;
+            command.index = index;
+            command.generation = slots[index].generation.load(std::memory_order_relaxed);
+            command.clip = clip;
+            command.stream = stream;
+            command.params = params;
+            if (!Enqueue(command))
+            {
+                slots[index].busy.store(false, std::memory_order_release);
+                return AudioVoice();
+            }
+
+            AudioVoice voice;
+            voice.index = index;
+            voice.generation = command.generation;
+            return voice;
+        }
+
+        void FreeVoice(uint32_t index)
+        {
+            voices[index] = Voice();
+            activeVoices--;
+
+            // The new generation must be visible before the slot can be claimed again.
+            VoiceSlot& slot = slots[index];
+            slot.generation.store(slot.generation.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            slot.busy.store(false, std::memory_order_release);
+        }
+
+        void Apply(const AudioCommand& command)
+        {
+            if (command.type == AudioCommandType::SetMasterGain)
+            {
+                masterGain = command.value;
+                return;
+            }
+
+            Voice& voice = voices[command.index];
+            if (command.type == AudioCommandType::Play)
+            {
+                voice = Voice();
+                voice.active = true;
+                voice.generation = command.generation;
+                voice.clip = command.clip;
+                voice.stream = command.stream;
+                voice.channels = command.clip ? command.clip->GetChannels() : command.stream->GetChannels();
+                voice.sampleRate = command.clip ? command.clip->GetSampleRate() : command.stream->GetSampleRate();
+                voice.loop = command.params.loop;
+                voice.gain = command.params.gain;
+                voice.pan = command.params.pan;
+                voice.step = ComputeStep(voice.sampleRate, settings.sampleRate, command.params.pitch);
+                activeVoices++;
+                return;
+            }
+
+            if (!voice.active || voice.generation != command.generation) {
+                return;
+            }
+
+            switch (command.type)
+            {
+            case AudioCommandType::Stop:
+                voice.stopping = true;
+                break;
+            case AudioCommandType::SetGain:
+                voice.gain = command.value;
+                break;
+            case AudioCommandType::SetPan:
+                voice.pan = command.value;
+                break;
+            case AudioCommandType::SetPitch:
+                voice.step = ComputeStep(voice.sampleRate, settings.sampleRate, command.value);
+                break;
+            case AudioCommandType::SetPaused:
+                voice.paused = command.value != 0.0f;
+                break;
+            default:
+                break;
+            }
+        }
+
+        void ApplyCommands()
+        {
+            uint64_t processed = 0;
+            for (;;)
+            {
+                CommandRecord& record = commands[dequeuePosition & (commandCapacity - 1)];
+                if (record.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+                    break;
+                }
+
+                Apply(record.command);
+                record.sequence.store(dequeuePosition + commandCapacity, std::memory_order_release);
+                dequeuePosition++;
+                processed++;
+            }
+
+            if (processed > 0) {
+                commandsProcessed.fetch_add(processed, std::memory_order_relaxed);
+            }
+        }
+
+        /// Resample the next frames of a clip voice, returns true when it ended.
+        bool ReadClip(Voice& voice, float* const* channels, uint32_t frames)
+        {
+            const AudioClip* clip = voice.clip;
+            for (uint32_t channel = 0; channel < voice.channels; channel++) {
+                ResampleLinear(clip->GetChannelData(channel), clip->GetFrameCount(), voice.loop, voice.position, voice.step, channels[channel], frames);
+            }
+
+            voice.position += voice.step * frames;
+            const uint64_t end = static_cast<uint64_t>(clip->GetFrameCount()) << AudioFractionBits;
+            if (voice.position >= end)
+            {
+                if (!voice.loop || end == 0) {
+                    return true;
+                }
+                voice.position %= end;
+            }
+            return false;
+        }
+
+        /// Resample the next frames of a stream voice, positions are relative to the ring read position. Returns true when it ended.
+        bool ReadStream(Voice& voice, float* const* channels, uint32_t frames)
+        {
+            AudioStream* stream = voice.stream;
+
+            // Read the end flag first, once it is set the available count is final.
+            const bool ended = stream->IsEndOfStream();
+            const uint32_t available = stream->GetAvailableFrames();
+            const uint64_t last = voice.position + voice.step * (frames - 1);
+            const uint32_t count = static_cast<uint32_t>(std::min<uint64_t>((last >> AudioFractionBits) + 2, available));
+            float* source[2] = { streamBuffer.data(), streamBuffer.data() + streamBufferFrames };
+            stream->Peek(source, count);
+
+            // Until the stream ends its last frame is only an interpolation partner.
+            const uint64_t limit = static_cast<uint64_t>(ended ? count : (count > 0 ? count - 1 : 0)) << AudioFractionBits;
+            uint32_t produced = 0;
+            if (voice.position < limit) {
+                produced = static_cast<uint32_t>(std::min<uint64_t>(frames, (limit - voice.position + voice.step - 1) / voice.step));
+            }
+
+            for (uint32_t channel = 0; channel < voice.channels; channel++)
+            {
+                ResampleLinear(source[channel], count, false, voice.position, voice.step, channels[channel], produced);
+                memset(channels[channel] + produced, 0, sizeof(float) * (frames - produced));
+            }
+
+            voice.position += voice.step * produced;
+            const uint32_t consumed = static_cast<uint32_t>(std::min<uint64_t>(voice.position >> AudioFractionBits, count));
+            stream->Consume(consumed);
+            voice.position -= static_cast<uint64_t>(consumed) << AudioFractionBits;
+
+            if (produced < frames)
+            {
+                if (ended && consumed == available) {
+                    return true;
+                }
+
+                // Silence before the first decoded frames is startup latency, not an underrun.
+                if (voice.streamStarted) {
+                    streamUnderruns.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            voice.streamStarted |= count > 0;
+            return false;
+        }
+
+        /// Mix a voice into the block, returns false once it is done.
+        bool MixVoice(Voice& voice, uint32_t frames)
+        {
+            // Paused voices hold their position once faded out.
+            if (voice.paused && voice.appliedLeft == 0.0f && voice.appliedRight == 0.0f) {
+                return !voice.stopping;
+            }
+
+            float targetLeft = 0.0f;
+            float targetRight = 0.0f;
+            if (!voice.stopping && !voice.paused)
+            {
+                ComputePanGains(voice.pan, voice.channels, targetLeft, targetRight);
+                targetLeft *= voice.gain;
+                targetRight *= voice.gain;
+            }
+
+            float* channels[2] = { voiceBuffer.data(), voiceBuffer.data() + settings.blockFrames };
+            const bool ended = voice.stream ? ReadStream(voice, channels, frames) : ReadClip(voice, channels, frames);
+
+            // Gains ramp over the block so changes, starts and stops do not click.
+            const float inverseFrames = 1.0f / static_cast<float>(frames);
+            MixWithGainRamp(channels[0], mixLeft.data(), frames, voice.appliedLeft, (targetLeft - voice.appliedLeft) * inverseFrames);
+            MixWithGainRamp(channels[voice.channels - 1], mixRight.data(), frames, voice.appliedRight, (targetRight - voice.appliedRight) * inverseFrames);
+            voice.appliedLeft = targetLeft;
+            voice.appliedRight = targetRight;
+            return !ended && !voice.stopping;
+        }
+
+        void MixBlock(float* destination)
+        {
+            ALIMER_PROFILE_SCOPE("Audio Mix");
+            const auto start = std::chrono::steady_clock::now();
+            ApplyCommands();
+
+            const uint32_t frames = settings.blockFrames;
+            std::fill(mixLeft.begin(), mixLeft.end(), 0.0f);
+            std::fill(mixRight.begin(), mixRight.end(), 0.0f);
+
+            uint32_t mixed = 0;
+            for (uint32_t i = 0; i < settings.maxVoices && mixed < activeVoices; i++)
+            {
+                Voice& voice = voices[i];
+                if (!voice.active) {
+                    continue;
+                }
+
+                mixed++;
+                if (!MixVoice(voice, frames)) {
+                    FreeVoice(i);
+                }
+            }
+
+            InterleaveStereo(mixLeft.data(), mixRight.data(), masterGain, destination, frames);
+
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            blocksMixed.fetch_add(1, std::memory_order_relaxed);
+            voicesMixed.fetch_add(mixed, std::memory_order_relaxed);
+            mixTime.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+            activeVoiceCount.store(activeVoices, std::memory_order_relaxed);
+        }
+
+        /// Decode every playing stream, each one is decoded by a single thread at a time.
+        void RefillStreams()
+        {
+            {
+                std::lock_guard<std::mutex> lock(streamMutex);
+                decodeStreams.erase(std::remove_if(decodeStreams.begin(), decodeStreams.end(),
+                    [](const std::shared_ptr<AudioStream>& stream) { return stream->IsEndOfStream() || stream.use_count() == 1; }),
+                    decodeStreams.end());
+                refillStreams.assign(decodeStreams.begin(), decodeStreams.end());
+            }
+
+            for (const std::shared_ptr<AudioStream>& stream : refillStreams) {
+                stream->Refill();
+            }
+            refillStreams.clear();
+        }
+
+        /// Mix what playback consumed since the last call into a realtime device.
+        void MixDue()
+        {
+            const uint32_t blockFrames = settings.blockFrames;
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            const uint64_t due = static_cast<uint64_t>(elapsed * settings.sampleRate);
+            if (due > framesDue + MaxCatchUpBlocks * blockFrames) {
+                framesDue = due - MaxCatchUpBlocks * blockFrames;
+            }
+
+            while (framesDue + blockFrames <= due)
+            {
+                MixBlock(output.data());
+                device->Write(output.data(), blockFrames);
+                framesDue += blockFrames;
+            }
+        }
+
+        /// Decode streams, then mix for realtime devices.
+        void Run()
+        {
+            RefillStreams();
+            if (device->IsRealtime()) {
+                MixDue();
+            }
+        }
+    };
+
     Audio::Audio()
-        : _audioDevice(nullptr)
     {
     }
 
     Audio::~Audio()
     {
+        Shutdown();
+    }
+
+    bool Audio::Initialize(std::unique_ptr<AudioDevice> device, const AudioSettings& settings, JobSystem* jobs)
+    {
+        if (_impl)
+        {
+            ALIMER_LOGERROR("Audio: already initialized");
+            return false;
+        }
+
+        if (!device) {
+            return false;
+        }
+
+        std::unique_ptr<Impl> impl(new Impl());
+        impl->settings = settings;
+        impl->settings.blockFrames = std::max(settings.blockFrames, 1u);
+        impl->settings.maxVoices = std::max(settings.maxVoices, 1u);
+        impl->commandCapacity = 2;
+        while (impl->commandCapacity < settings.commandQueueCapacity) {
+            impl->commandCapacity <<= 1;
+        }
+
+        AudioFormat format;
+        format.sampleRate = impl->settings.sampleRate;
+        format.channels = 2;
+        format.blockFrames = impl->settings.blockFrames;
+        if (!device->Open(format))
+        {
+            ALIMER_LOGERROR("Audio: failed to open the output device");
+            return false;
+        }
+
+        const uint32_t maxVoices = impl->settings.maxVoices;
+        const uint32_t blockFrames = impl->settings.blockFrames;
+        impl->slots.reset(new VoiceSlot[maxVoices]);
+        impl->clips.resize(maxVoices);
+        impl->streams.resize(maxVoices);
+        impl->voices.resize(maxVoices);
+        impl->commands.reset(new CommandRecord[impl->commandCapacity]);
+        for (uint32_t i = 0; i < impl->commandCapacity; i++) {
+            impl->commands[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        impl->mixLeft.resize(blockFrames);
+        impl->mixRight.resize(blockFrames);
+        impl->voiceBuffer.resize(blockFrames * 2);
+        impl->streamBufferFrames = blockFrames * MaxStepFrames + 2;
+        impl->streamBuffer.resize(impl->streamBufferFrames * 2);
+        impl->output.resize(blockFrames * 2);
+        impl->device = device.get();
+        impl->jobs = jobs && jobs->GetWorkerCount() > 0 ? jobs : nullptr;
+        impl->startTime = std::chrono::steady_clock::now();
+
+        _audioDevice = std::move(device);
+        _impl = std::move(impl);
+        return true;
+    }
+
+    void Audio::Shutdown()
+    {
+        if (!_impl) {
+            return;
+        }
+
+        if (_impl->jobs) {
+            _impl->jobs->Wait(_impl->updateCounter);
+        }
+
+        _audioDevice->Close();
+        _impl.reset();
+        _audioDevice.reset();
+    }
+
+    void Audio::Update()
+    {
+        if (!_impl) {
+            return;
+        }
+
+        if (!_impl->jobs)
+        {
+            _impl->Run();
+            return;
+        }
+
+        // Skip while the previous job still runs, the next update mixes everything that came due meanwhile.
+        if (_impl->updateCounter.IsDone())
+        {
+            Impl* impl = _impl.get();
+            _impl->jobs->Schedule(&_impl->updateCounter, [impl]() {
+                ALIMER_PROFILE_SCOPE("Audio Update");
+                impl->Run();
+            });
+        }
+    }
+
+    void Audio::Render(uint32_t frameCount)
+    {
+        if (!_impl) {
+            return;
+        }
+
+        if (_audioDevice->IsRealtime())
+        {
+            ALIMER_LOGERROR("Audio: Render called for a realtime device, Update drives it");
+            return;
+        }
+
+        // The mixer has a single consumer, finish the update job first.
+        if (_impl->jobs) {
+            _impl->jobs->Wait(_impl->updateCounter);
+        }
+
+        const uint32_t blockFrames = _impl->settings.blockFrames;
+        for (uint32_t frames = 0; frames < frameCount; frames += blockFrames)
+        {
+            // Decode inline so offline renders never underrun.
+            _impl->RefillStreams();
+            _impl->MixBlock(_impl->output.data());
+            _audioDevice->Write(_impl->output.data(), blockFrames);
+        }
+    }
+
+    AudioVoice Audio::Play(const std::shared_ptr<AudioClip>& clip, const AudioVoiceParams& params)
+    {
+        if (!_impl || !clip) {
+            return AudioVoice();
+        }
+
+        const uint32_t index = _impl->ClaimVoice();
+        if (index == ~0u) {
+            return AudioVoice();
+        }
+
+        // The mixer only sees raw pointers, the slot keeps the source alive.
+        _impl->clips[index] = clip;
+        _impl->streams[index].reset();
+        return _impl->StartVoice(index, clip.get(), nullptr, params);
+    }
+
+    AudioVoice Audio::Play(const std::shared_ptr<AudioStream>& stream, const AudioVoiceParams& params)
+    {
+        if (!_impl || !stream) {
+            return AudioVoice();
+        }
+
+        const uint32_t index = _impl->ClaimVoice();
+        if (index == ~0u) {
+            return AudioVoice();
+        }
+
+        if (!stream->Bind())
+        {
+            _impl->slots[index].busy.store(false, std::memory_order_release);
+            ALIMER_LOGERROR("Audio: stream already played, open a new one to play it again");
+            return AudioVoice();
+        }
+
+        _impl->clips[index].reset();
+        _impl->streams[index] = stream;
+        stream->SetLooping(params.loop);
+        {
+            std::lock_guard<std::mutex> lock(_impl->streamMutex);
+            _impl->decodeStreams.push_back(stream);
+        }
+        return _impl->StartVoice(index, nullptr, stream.get(), params);
+    }
+
+    void Audio::Stop(AudioVoice voice)
+    {
+        if (_impl) {
+            _impl->Send(AudioCommandType::Stop, voice, 0.0f);
+        }
+    }
+
+    void Audio::SetGain(AudioVoice voice, float gain)
+    {
+        if (_impl) {
+            _impl->Send(AudioCommandType::SetGain, voice, gain);
+        }
+    }
+
+    void Audio::SetPan(AudioVoice voice, float pan)
+    {
+        if (_impl) {
+            _impl->Send(AudioCommandType::SetPan, voice, pan);
+        }
+    }
+
+    void Audio::SetPitch(AudioVoice voice, float pitch)
+    {
+        if (_impl) {
+            _impl->Send(AudioCommandType::SetPitch, voice, pitch);
+        }
+    }
+
+    void Audio::SetPaused(AudioVoice voice, bool paused)
+    {
+        if (_impl) {
+            _impl->Send(AudioCommandType::SetPaused, voice, paused ? 1.0f : 0.0f);
+        }
+    }
+
+    void Audio::SetMasterGain(float gain)
+    {
+        if (!_impl) {
+            return;
+        }
+
+        AudioCommand command = {};
+        command.type = AudioCommandType::SetMasterGain;
+        command.value = gain;
+        _impl->Enqueue(command);
+    }
+
+    bool Audio::IsPlaying(AudioVoice voice) const
+    {
+        if (!_impl || voice.index >= _impl->settings.maxVoices) {
+            return false;
+        }
+
+        const VoiceSlot& slot = _impl->slots[voice.index];
+        return slot.busy.load(std::memory_order_acquire) && slot.generation.load(std::memory_order_relaxed) == voice.generation;
+    }
+
+    AudioStats Audio::GetStats() const
+    {
+        AudioStats stats;
+        if (!_impl) {
+            return stats;
+        }
+
+        stats.blocksMixed = _impl->blocksMixed.load(std::memory_order_relaxed);
+        stats.framesMixed = stats.blocksMixed * _impl->settings.blockFrames;
+        stats.voicesMixed = _impl->voicesMixed.load(std::memory_order_relaxed);
+        stats.mixTime = _impl->mixTime.load(std::memory_order_relaxed);
+        stats.activeVoices = _impl->activeVoiceCount.load(std::memory_order_relaxed);
+        stats.commandsProcessed = _impl->commandsProcessed.load(std::memory_order_relaxed);
+        stats.commandsDropped = _impl->commandsDropped.load(std::memory_order_relaxed);
+        stats.streamUnderruns = _impl->streamUnderruns.load(std::memory_order_relaxed);
+        return stats;
     }
 }
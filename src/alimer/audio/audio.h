@@ -20,17 +20,77 @@
 // THE SOFTWARE.
 //
 
+
 #pragma once
 
-#include "foundation/platform.h"
-#include <string>
-#include <vector>
+#include "audio/audio_clip.h"
+#include "audio/audio_device.h"
+#include "audio/audio_stream.h"
+#include <memory>
 
 namespace alimer
 {
-    class AudioDevice;
+    class JobSystem;
+
+    /// Voice handle, the generation detects handles to voices that stopped and whose slot was reused.
+    struct AudioVoice
+    {
+        uint32_t index = ~0u;
+        uint32_t generation = 0;
+
+        /// Check if the handle refers to a voice at all, use Audio::IsPlaying to check if it still plays.
+        bool IsValid() const { return index != ~0u; }
+
+        bool operator==(const AudioVoice& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const AudioVoice& other) const { return !(*this == other); }
+    };
+
+    /// Initial parameters of a voice.
+    struct AudioVoiceParams
+    {
+        float gain = 1.0f;
+        /// Pan from -1 (left) to 1 (right).
+        float pan = 0.0f;
+        /// Playback rate multiplier, clamped to [1/64, 4].
+        float pitch = 1.0f;
+        bool loop = false;
+    };
 
-    /// Class for playing audio
+    /// Audio settings.
+    struct AudioSettings
+    {
+        uint32_t sampleRate = 48000;
+        /// Frames mixed per block, also the device write size.
+        uint32_t blockFrames = 512;
+        /// Size of the voice pool.
+        uint32_t maxVoices = 64;
+        /// Capacity of the command queue from game threads to the mixer, rounded up to a power of two.
+        uint32_t commandQueueCapacity = 1024;
+    };
+
+    /// Mixer statistics, accumulated since Initialize.
+    struct AudioStats
+    {
+        uint64_t blocksMixed = 0;
+        uint64_t framesMixed = 0;
+        /// Sum over blocks of the voices mixed in the block.
+        uint64_t voicesMixed = 0;
+        /// Time spent mixing in nanoseconds.
+        uint64_t mixTime = 0;
+        /// Voices playing at the end of the last block.
+        uint32_t activeVoices = 0;
+        uint64_t commandsProcessed = 0;
+        /// Commands lost because the queue was full.
+        uint64_t commandsDropped = 0;
+        /// Blocks where a stream voice had not enough decoded frames.
+        uint64_t streamUnderruns = 0;
+
+        /// Get the mixing throughput, comparable across block sizes and voice counts.
+        double GetVoicesPerMillisecond() const { return mixTime ? static_cast<double>(voicesMixed) * 1e6 / static_cast<double>(mixTime) : 0.0; }
+    };
+
+    /// Software mixer playing a fixed pool of voices into an AudioDevice.
+    /// Voice functions can be called from any thread, they queue commands the mixer applies before its next block.
     class ALIMER_API Audio final
     {
     public:
@@ -40,7 +100,61 @@ namespace alimer
         /// Destructor.
         virtual ~Audio();
 
+        Audio(const Audio&) = delete;
+        Audio& operator=(const Audio&) = delete;
+
+        /// Open device and start mixing. With a job system that has workers, Update decodes streams and mixes realtime devices in a job.
+        bool Initialize(std::unique_ptr<AudioDevice> device, const AudioSettings& settings = AudioSettings(), JobSystem* jobs = nullptr);
+
+        /// Stop mixing and close the device.
+        void Shutdown();
+
+        /// Check if the mixer is initialized.
+        bool IsInitialized() const { return _impl != nullptr; }
+
+        /// Per frame update, decodes streams and mixes what a realtime device played since the last update.
+        void Update();
+
+        /// Mix frameCount frames, rounded up to whole blocks, into the device on the calling thread. For devices that are not realtime.
+        void Render(uint32_t frameCount);
+
+        /// Start playing a clip, returns an invalid handle when every voice is busy.
+        AudioVoice Play(const std::shared_ptr<AudioClip>& clip, const AudioVoiceParams& params = AudioVoiceParams());
+
+        /// Start playing a stream that has not played yet.
+        AudioVoice Play(const std::shared_ptr<AudioStream>& stream, const AudioVoiceParams& params = AudioVoiceParams());
+
+        /// Fade out and stop a voice.
+        void Stop(AudioVoice voice);
+
+        /// Set the gain of a voice.
+        void SetGain(AudioVoice voice, float gain);
+
+        /// Set the pan of a voice.
+        void SetPan(AudioVoice voice, float pan);
+
+        /// Set the playback rate multiplier of a voice.
+        void SetPitch(AudioVoice voice, float pitch);
+
+        /// Pause or resume a voice.
+        void SetPaused(AudioVoice voice, bool paused);
+
+        /// Set the gain applied to the final mix.
+        void SetMasterGain(float gain);
+
+        /// Check if a voice still plays, commands in flight are not taken into account.
+        bool IsPlaying(AudioVoice voice) const;
+
+        /// Get mixer statistics.
+        AudioStats GetStats() const;
+
+        /// Get the output device.
+        AudioDevice* GetDevice() const { return _audioDevice.get(); }
+
     private:
-        AudioDevice* _audioDevice;
+        struct Impl;
+
+        std::unique_ptr<Impl> _impl;
+        std::unique_ptr<AudioDevice> _audioDevice;
     };
-} 
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "audio/audio_clip.h"
+#include "foundation/log.h"
+#include <cassert>
+#define STB_VORBIS_HEADER_ONLY
+#define STB_VORBIS_NO_STDIO
+#include <stb_vorbis.h>
+
+namespace alimer
+{
+    AudioClip::AudioClip(const float* samples, uint32_t frameCount, uint32_t channels, uint32_t sampleRate)
+        : _frameCount(frameCount)
+        , _channels(channels)
+        , _sampleRate(sampleRate)
+    {
+        assert(channels == 1 || channels == 2);
+        _samples.resize(static_cast<size_t>(frameCount) * channels);
+        for (uint32_t channel = 0; channel < channels; channel++)
+        {
+            float* destination = _samples.data() + static_cast<size_t>(channel) * frameCount;
+            for (uint32_t i = 0; i < frameCount; i++) {
+                destination[i] = samples[static_cast<size_t>(i) * channels + channel];
+            }
+        }
+    }
+
+    std::shared_ptr<AudioClip> AudioClip::LoadOgg(const void* data, size_t size)
+    {
+        int error = 0;
+        stb_vorbis* decoder = stb_vorbis_open_memory(static_cast<const unsigned char*>(data), static_cast<int>(size), &error, nullptr);
+        if (!decoder)
+        {
+            ALIMER_LOGERROR("AudioClip: failed to open Ogg Vorbis data (error {})", error);
+            return nullptr;
+        }
+
+        const stb_vorbis_info info = stb_vorbis_get_info(decoder);
+        std::shared_ptr<AudioClip> clip(new AudioClip());
+        clip->_channels = info.channels > 1 ? 2 : 1;
+        clip->_sampleRate = info.sample_rate;
+        clip->_frameCount = stb_vorbis_stream_length_in_samples(decoder);
+        clip->_samples.resize(static_cast<size_t>(clip->_frameCount) * clip->_channels);
+
+        // stb_vorbis writes planar output, straight into the clip layout.
+        uint32_t decoded = 0;
+        while (decoded < clip->_frameCount)
+        {
+            float* channels[2] = { clip->_samples.data() + decoded, clip->_channels > 1 ? clip->_samples.data() + clip->_frameCount + decoded : nullptr };
+            const int count = stb_vorbis_get_samples_float(decoder, clip->_channels, channels, static_cast<int>(clip->_frameCount - decoded));
+            if (count <= 0) {
+                break;
+            }
+            decoded += static_cast<uint32_t>(count);
+        }
+        stb_vorbis_close(decoder);
+
+        if (decoded != clip->_frameCount)
+        {
+            ALIMER_LOGERROR("AudioClip: Ogg Vorbis data ended after {} of {} frames", decoded, clip->_frameCount);
+            return nullptr;
+        }
+
+        return clip;
+    }
+}
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "audio/audio_kernels.h"
+#include <memory>
+
+namespace alimer
+{
+    /// Sound decoded into memory, mono or stereo. Samples are stored planar, one array per channel.
+    class ALIMER_API AudioClip final
+    {
+    public:
+        /// Constructor, copies frameCount interleaved frames of 1 or 2 channels.
+        AudioClip(const float* samples, uint32_t frameCount, uint32_t channels, uint32_t sampleRate);
+
+        AudioClip(const AudioClip&) = delete;
+        AudioClip& operator=(const AudioClip&) = delete;
+
+        /// Decode a whole Ogg Vorbis file, channels past the second are dropped. Returns nullptr on error.
+        static std::shared_ptr<AudioClip> LoadOgg(const void* data, size_t size);
+
+        /// Get the number of frames.
+        uint32_t GetFrameCount() const { return _frameCount; }
+
+        /// Get the number of channels.
+        uint32_t GetChannels() const { return _channels; }
+
+        /// Get the sample rate in Hz.
+        uint32_t GetSampleRate() const { return _sampleRate; }
+
+        /// Get the samples of a channel.
+        const float* GetChannelData(uint32_t channel) const { return _samples.data() + static_cast<size_t>(channel) * _frameCount; }
+
+    private:
+        AudioClip() = default;
+
+        AudioSampleVector _samples;
+        uint32_t _frameCount = 0;
+        uint32_t _channels = 0;
+        uint32_t _sampleRate = 0;
+    };
+}
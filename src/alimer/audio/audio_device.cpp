@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "audio/audio_device.h"
+#include "foundation/log.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace alimer
+{
+    bool NullAudioDevice::Open(const AudioFormat& format)
+    {
+        _sampleRate = format.sampleRate;
+        _framesWritten = 0;
+        _startTime = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void NullAudioDevice::Close()
+    {
+    }
+
+    void NullAudioDevice::Write(const float* samples, uint32_t frameCount)
+    {
+        (void)samples;
+        _framesWritten += frameCount;
+        if (_realtime && _sampleRate > 0)
+        {
+            // Block like a hardware queue one write deep.
+            const auto played = std::chrono::microseconds((_framesWritten - frameCount) * 1000000ull / _sampleRate);
+            std::this_thread::sleep_until(_startTime + played);
+        }
+    }
+
+    WavAudioDevice::~WavAudioDevice()
+    {
+        Close();
+    }
+
+    bool WavAudioDevice::Open(const AudioFormat& format)
+    {
+        Close();
+        _file = fopen(_path.c_str(), "wb");
+        if (!_file)
+        {
+            ALIMER_LOGERROR("Failed to open WAV file: {}", _path);
+            return false;
+        }
+
+        _format = format;
+        _framesWritten = 0;
+        _pcm.resize(static_cast<size_t>(format.blockFrames) * format.channels);
+        WriteHeader();
+        return true;
+    }
+
+    void WavAudioDevice::Close()
+    {
+        if (!_file) {
+            return;
+        }
+
+        // Patch the sizes now that they are known.
+        fseek(_file, 0, SEEK_SET);
+        WriteHeader();
+        fclose(_file);
+        _file = nullptr;
+    }
+
+    void WavAudioDevice::Write(const float* samples, uint32_t frameCount)
+    {
+        if (!_file) {
+            return;
+        }
+
+        const size_t sampleCount = static_cast<size_t>(frameCount) * _format.channels;
+        if (_pcm.size() < sampleCount) {
+            _pcm.resize(sampleCount);
+        }
+
+        for (size_t i = 0; i < sampleCount; i++)
+        {
+            const float sample = std::min(std::max(samples[i], -1.0f), 1.0f);
+            _pcm[i] = static_cast<int16_t>(lrintf(sample * 32767.0f));
+        }
+
+        // WAV is little endian, like every platform the engine runs on.
+        fwrite(_pcm.data(), sizeof(int16_t), sampleCount, _file);
+        _framesWritten += frameCount;
+    }
+
+    void WavAudioDevice::WriteHeader()
+    {
+        const uint32_t blockAlign = _format.channels * sizeof(int16_t);
+        const uint32_t dataSize = static_cast<uint32_t>(std::min<uint64_t>(_framesWritten * blockAlign, 0xFFFFFFFFull - 36));
+        const uint32_t riffSize = 36 + dataSize;
+        const uint32_t formatSize = 16;
+        const uint16_t formatTag = 1;
+        const uint16_t channels = static_cast<uint16_t>(_format.channels);
+        const uint32_t byteRate = _format.sampleRate * blockAlign;
+        const uint16_t align = static_cast<uint16_t>(blockAlign);
+        const uint16_t bitsPerSample = 16;
+
+        fwrite("RIFF", 1, 4, _file);
+        fwrite(&riffSize, 4, 1, _file);
+        fwrite("WAVEfmt ", 1, 8, _file);
+        fwrite(&formatSize, 4, 1, _file);
+        fwrite(&formatTag, 2, 1, _file);
+        fwrite(&channels, 2, 1, _file);
+        fwrite(&_format.sampleRate, 4, 1, _file);
+        fwrite(&byteRate, 4, 1, _file);
+        fwrite(&align, 2, 1, _file);
+        fwrite(&bitsPerSample, 2, 1, _file);
+        fwrite("data", 1, 4, _file);
+        fwrite(&dataSize, 4, 1, _file);
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace alimer
+{
+    /// Output format, samples are interleaved floats.
+    struct AudioFormat
+    {
+        uint32_t sampleRate = 48000;
+        uint32_t channels = 2;
+        /// Frames passed to every Write call.
+        uint32_t blockFrames = 512;
+    };
+
+    /// Output the mixer writes to, platform outputs and the headless devices below implement it.
+    class ALIMER_API AudioDevice
+    {
+    public:
+        /// Destructor.
+        virtual ~AudioDevice() = default;
+
+        /// Open the device with given format.
+        virtual bool Open(const AudioFormat& format) = 0;
+
+        /// Close the device.
+        virtual void Close() = 0;
+
+        /// Consume format.blockFrames frames, realtime devices block until they have room.
+        virtual void Write(const float* samples, uint32_t frameCount) = 0;
+
+        /// Realtime devices pace the mixer thread through Write, the others are driven by Audio::Render.
+        virtual bool IsRealtime() const = 0;
+    };
+
+    /// Device discarding its output, optionally at playback speed.
+    class ALIMER_API NullAudioDevice final : public AudioDevice
+    {
+    public:
+        /// Constructor.
+        explicit NullAudioDevice(bool realtime = false) : _realtime(realtime) {}
+
+        bool Open(const AudioFormat& format) override;
+        void Close() override;
+        void Write(const float* samples, uint32_t frameCount) override;
+        bool IsRealtime() const override { return _realtime; }
+
+        /// Get the number of frames written since Open.
+        uint64_t GetFramesWritten() const { return _framesWritten; }
+
+    private:
+        bool _realtime;
+        uint32_t _sampleRate = 0;
+        uint64_t _framesWritten = 0;
+        std::chrono::steady_clock::time_point _startTime;
+    };
+
+    /// Device writing 16 bit PCM WAV files, for headless captures.
+    class ALIMER_API WavAudioDevice final : public AudioDevice
+    {
+    public:
+        /// Constructor.
+        explicit WavAudioDevice(const std::string& path) : _path(path) {}
+
+        /// Destructor.
+        ~WavAudioDevice() override;
+
+        bool Open(const AudioFormat& format) override;
+        void Close() override;
+        void Write(const float* samples, uint32_t frameCount) override;
+        bool IsRealtime() const override { return false; }
+
+        /// Get the number of frames written since Open.
+        uint64_t GetFramesWritten() const { return _framesWritten; }
+
+    private:
+        void WriteHeader();
+
+        std::string _path;
+        FILE* _file = nullptr;
+        AudioFormat _format;
+        uint64_t _framesWritten = 0;
+        std::vector<int16_t> _pcm;
+    };
+}
@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "audio/audio_kernels.h"
+#include "foundation/math/simd_lane.h"
+#include <algorithm>
+#include <cstring>
+
+namespace alimer
+{
+    namespace
+    {
+        using namespace simd;
+
+        static constexpr float FractionScale = 1.0f / static_cast<float>(AudioFractionOne);
+
+        /// Fetch the two frames around position, position is wrapped in place when looping.
+        inline void FetchFrames(const float* source, uint32_t frameCount, bool loop, uint64_t& position, float& a, float& b, float& t)
+        {
+            uint64_t index = position >> AudioFractionBits;
+            if (index >= frameCount)
+            {
+                if (!loop)
+                {
+                    a = b = t = 0.0f;
+                    return;
+                }
+
+                position %= static_cast<uint64_t>(frameCount) << AudioFractionBits;
+                index = position >> AudioFractionBits;
+            }
+
+            const uint64_t next = index + 1;
+            a = source[index];
+            b = next < frameCount ? source[next] : (loop ? source[0] : 0.0f);
+            t = static_cast<float>(position & (AudioFractionOne - 1)) * FractionScale;
+        }
+    }
+
+    void ResampleLinear(const float* source, uint32_t frameCount, bool loop, uint64_t position, uint64_t step, float* output, uint32_t count)
+    {
+        if (frameCount == 0)
+        {
+            memset(output, 0, sizeof(float) * count);
+            return;
+        }
+
+        // Unity rate on a whole frame is a copy, the common case for sounds authored at the output rate.
+        if (step == AudioFractionOne && (position & (AudioFractionOne - 1)) == 0)
+        {
+            uint64_t index = position >> AudioFractionBits;
+            if (loop) {
+                index %= frameCount;
+            }
+
+            uint32_t done = 0;
+            while (done < count)
+            {
+                if (index >= frameCount)
+                {
+                    if (!loop)
+                    {
+                        memset(output + done, 0, sizeof(float) * (count - done));
+                        return;
+                    }
+                    index = 0;
+                }
+
+                const uint32_t run = static_cast<uint32_t>(std::min<uint64_t>(count - done, frameCount - index));
+                memcpy(output + done, source + index, sizeof(float) * run);
+                done += run;
+                index += run;
+            }
+            return;
+        }
+
+        uint32_t i = 0;
+#if ALIMER_SIMD_SSE2 || ALIMER_SIMD_NEON
+        // Positions are irregular so frames are fetched per lane, the interpolation itself runs a lane at a time.
+        alignas(32) float a[LaneWidth];
+        alignas(32) float b[LaneWidth];
+        alignas(32) float t[LaneWidth];
+        for (; i + LaneWidth <= count; i += LaneWidth)
+        {
+            for (uint32_t lane = 0; lane < LaneWidth; lane++)
+            {
+                FetchFrames(source, frameCount, loop, position, a[lane], b[lane], t[lane]);
+                position += step;
+            }
+
+            const Lane va = Load(a);
+            Store(output + i, MulAdd(Sub(Load(b), va), Load(t), va));
+        }
+#endif
+        for (; i < count; i++)
+        {
+            float a0, b0, t0;
+            FetchFrames(source, frameCount, loop, position, a0, b0, t0);
+            output[i] = a0 + (b0 - a0) * t0;
+            position += step;
+        }
+    }
+
+    void MixWithGainRamp(const float* input, float* output, uint32_t count, float gain, float gainStep)
+    {
+        uint32_t i = 0;
+#if ALIMER_SIMD_SSE2 || ALIMER_SIMD_NEON
+        alignas(32) float ramp[LaneWidth];
+        for (uint32_t lane = 0; lane < LaneWidth; lane++) {
+            ramp[lane] = gain + static_cast<float>(lane) * gainStep;
+        }
+
+        Lane gains = Load(ramp);
+        const Lane gainAdvance = Splat(gainStep * static_cast<float>(LaneWidth));
+        for (; i + LaneWidth <= count; i += LaneWidth)
+        {
+            Store(output + i, MulAdd(Load(input + i), gains, Load(output + i)));
+            gains = Add(gains, gainAdvance);
+        }
+#endif
+        for (; i < count; i++) {
+            output[i] += input[i] * (gain + static_cast<float>(i) * gainStep);
+        }
+    }
+
+    void InterleaveStereo(const float* left, const float* right, float gain, float* output, uint32_t count)
+    {
+        uint32_t i = 0;
+#if ALIMER_SIMD_SSE2 || ALIMER_SIMD_NEON
+        alignas(32) float l[LaneWidth];
+        alignas(32) float r[LaneWidth];
+        const Lane scale = Splat(gain);
+        const Lane lower = Splat(-1.0f);
+        const Lane upper = Splat(1.0f);
+        for (; i + LaneWidth <= count; i += LaneWidth)
+        {
+            Store(l, Min(Max(Mul(Load(left + i), scale), lower), upper));
+            Store(r, Min(Max(Mul(Load(right + i), scale), lower), upper));
+            for (uint32_t lane = 0; lane < LaneWidth; lane++)
+            {
+                output[(i + lane) * 2 + 0] = l[lane];
+                output[(i + lane) * 2 + 1] = r[lane];
+            }
+        }
+#endif
+        for (; i < count; i++)
+        {
+            output[i * 2 + 0] = std::min(std::max(left[i] * gain, -1.0f), 1.0f);
+            output[i * 2 + 1] = std::min(std::max(right[i] * gain, -1.0f), 1.0f);
+        }
+    }
+
+    void ComputePanGains(float pan, uint32_t channels, float& left, float& right)
+    {
+        pan = std::min(std::max(pan, -1.0f), 1.0f);
+        if (channels == 1)
+        {
+            const float angle = (pan + 1.0f) * 0.5f * HalfPi;
+            left = cosf(angle);
+            right = sinf(angle);
+        }
+        else
+        {
+            left = pan > 0.0f ? 1.0f - pan : 1.0f;
+            right = pan < 0.0f ? 1.0f + pan : 1.0f;
+        }
+    }
+}
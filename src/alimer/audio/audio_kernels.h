@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/memory_tracker.h"
+#include <vector>
+
+namespace alimer
+{
+    /// Source positions and rates are 32.32 fixed point frames.
+    static constexpr uint32_t AudioFractionBits = 32;
+    static constexpr uint64_t AudioFractionOne = 1ull << AudioFractionBits;
+
+    /// Float samples accounted to MemoryTag::Audio.
+    using AudioSampleVector = std::vector<float, MemoryTagAllocator<float, MemoryTag::Audio>>;
+
+    /// Resample count frames of one planar channel with linear interpolation, starting at position and advancing by step.
+    /// Reads past frameCount wrap to the start when loop is set and are silent otherwise.
+    ALIMER_API void ResampleLinear(const float* source, uint32_t frameCount, bool loop, uint64_t position, uint64_t step, float* output, uint32_t count);
+
+    /// Compute output[i] += input[i] * (gain + i * gainStep), the ramp removes zipper noise on gain changes.
+    ALIMER_API void MixWithGainRamp(const float* input, float* output, uint32_t count, float gain, float gainStep);
+
+    /// Scale the planar left and right mix by gain, clamp to [-1, 1] and write it interleaved to output.
+    ALIMER_API void InterleaveStereo(const float* left, const float* right, float gain, float* output, uint32_t count);
+
+    /// Compute the output gains of a source with pan in [-1, 1], constant power for mono and balance for stereo sources.
+    ALIMER_API void ComputePanGains(float pan, uint32_t channels, float& left, float& right);
+}
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "audio/audio_stream.h"
+#include "foundation/log.h"
+#include <algorithm>
+#include <cstring>
+#define STB_VORBIS_HEADER_ONLY
+#define STB_VORBIS_NO_STDIO
+#include <stb_vorbis.h>
+
+namespace alimer
+{
+    constexpr uint32_t AudioStream::DecodeFrames;
+
+    AudioStream::~AudioStream()
+    {
+        if (_decoder) {
+            stb_vorbis_close(_decoder);
+        }
+    }
+
+    std::shared_ptr<AudioStream> AudioStream::OpenOgg(std::vector<uint8_t> data, uint32_t bufferFrames)
+    {
+        std::shared_ptr<AudioStream> stream(new AudioStream());
+        stream->_data = std::move(data);
+
+        int error = 0;
+        stream->_decoder = stb_vorbis_open_memory(stream->_data.data(), static_cast<int>(stream->_data.size()), &error, nullptr);
+        if (!stream->_decoder)
+        {
+            ALIMER_LOGERROR("AudioStream: failed to open Ogg Vorbis data (error {})", error);
+            return nullptr;
+        }
+
+        const stb_vorbis_info info = stb_vorbis_get_info(stream->_decoder);
+        stream->_channels = info.channels > 1 ? 2 : 1;
+        stream->_sampleRate = info.sample_rate;
+
+        // Power of two capacity so positions wrap with a mask.
+        if (bufferFrames == 0) {
+            bufferFrames = stream->_sampleRate / 2;
+        }
+        uint32_t capacity = DecodeFrames * 2;
+        while (capacity < bufferFrames) {
+            capacity <<= 1;
+        }
+        stream->_capacity = capacity;
+        stream->_ring.resize(static_cast<size_t>(capacity) * stream->_channels);
+        return stream;
+    }
+
+    bool AudioStream::Refill()
+    {
+        if (_decoding.test_and_set(std::memory_order_acquire)) {
+            return false;
+        }
+
+        bool rewound = false;
+        while (!_endOfStream.load(std::memory_order_relaxed))
+        {
+            const uint64_t writePosition = _writePosition.load(std::memory_order_relaxed);
+            const uint32_t space = _capacity - static_cast<uint32_t>(writePosition - _readPosition.load(std::memory_order_acquire));
+            if (space < DecodeFrames) {
+                break;
+            }
+
+            const uint32_t offset = static_cast<uint32_t>(writePosition & (_capacity - 1));
+            const uint32_t count = std::min(space, _capacity - offset);
+            float* channels[2] = { _ring.data() + offset, _channels > 1 ? _ring.data() + _capacity + offset : nullptr };
+            const int decoded = stb_vorbis_get_samples_float(_decoder, static_cast<int>(_channels), channels, static_cast<int>(count));
+            if (decoded <= 0)
+            {
+                // A second empty read right after rewinding means there is nothing to loop.
+                if (_loop.load(std::memory_order_relaxed) && !rewound && stb_vorbis_seek_start(_decoder))
+                {
+                    rewound = true;
+                    continue;
+                }
+
+                _endOfStream.store(true, std::memory_order_release);
+                break;
+            }
+
+            rewound = false;
+            _writePosition.store(writePosition + static_cast<uint32_t>(decoded), std::memory_order_release);
+        }
+
+        _decoding.clear(std::memory_order_release);
+        return true;
+    }
+
+    void AudioStream::Peek(float* const* channels, uint32_t count) const
+    {
+        const uint32_t offset = static_cast<uint32_t>(_readPosition.load(std::memory_order_relaxed) & (_capacity - 1));
+        const uint32_t first = std::min(count, _capacity - offset);
+        for (uint32_t channel = 0; channel < _channels; channel++)
+        {
+            const float* ring = _ring.data() + static_cast<size_t>(channel) * _capacity;
+            memcpy(channels[channel], ring + offset, sizeof(float) * first);
+            memcpy(channels[channel] + first, ring, sizeof(float) * (count - first));
+        }
+    }
+}
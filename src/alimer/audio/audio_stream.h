@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "audio/audio_kernels.h"
+#include "foundation/allocator.h"
+#include <atomic>
+#include <memory>
+
+struct stb_vorbis;
+
+namespace alimer
+{
+    /// Ogg Vorbis file decoded while it plays. A job decodes into a ring buffer the mixer reads from,
+    /// the decoder is the only producer and the mixer the only consumer. A stream plays once on a single voice.
+    class ALIMER_API AudioStream final : public AlignedAllocation<AudioStream, MemoryTag::Audio>
+    {
+    public:
+        /// Frames decoded per step, decoding stops until the ring has this much room.
+        static constexpr uint32_t DecodeFrames = 1024;
+
+        /// Destructor.
+        ~AudioStream();
+
+        AudioStream(const AudioStream&) = delete;
+        AudioStream& operator=(const AudioStream&) = delete;
+
+        /// Open an Ogg Vorbis file kept in memory by the stream, bufferFrames of 0 selects half a second. Returns nullptr on error.
+        static std::shared_ptr<AudioStream> OpenOgg(std::vector<uint8_t> data, uint32_t bufferFrames = 0);
+
+        /// Get the number of channels, 1 or 2.
+        uint32_t GetChannels() const { return _channels; }
+
+        /// Get the sample rate in Hz.
+        uint32_t GetSampleRate() const { return _sampleRate; }
+
+        /// Restart from the beginning when the end is reached instead of finishing.
+        void SetLooping(bool loop) { _loop.store(loop, std::memory_order_relaxed); }
+
+        /// Decode until the ring is full, returns false if another thread is decoding it.
+        bool Refill();
+
+        /// Check if the decoder reached the end, frames still in the ring remain readable.
+        bool IsEndOfStream() const { return _endOfStream.load(std::memory_order_acquire); }
+
+        /// Get the number of decoded frames ready to be read.
+        uint32_t GetAvailableFrames() const
+        {
+            return static_cast<uint32_t>(_writePosition.load(std::memory_order_acquire) - _readPosition.load(std::memory_order_relaxed));
+        }
+
+        /// Copy the next count frames to one array per channel without consuming them, mixer side.
+        void Peek(float* const* channels, uint32_t count) const;
+
+        /// Release count frames to the decoder, mixer side.
+        void Consume(uint32_t count) { _readPosition.store(_readPosition.load(std::memory_order_relaxed) + count, std::memory_order_release); }
+
+        /// Bind the stream to a voice, fails if it already played.
+        bool Bind() { return !_bound.exchange(true, std::memory_order_acq_rel); }
+
+    private:
+        AudioStream() = default;
+
+        std::vector<uint8_t> _data;
+        stb_vorbis* _decoder = nullptr;
+        AudioSampleVector _ring;
+        uint32_t _capacity = 0;
+        uint32_t _channels = 0;
+        uint32_t _sampleRate = 0;
+        std::atomic<bool> _loop{ false };
+        std::atomic<bool> _bound{ false };
+        std::atomic<bool> _endOfStream{ false };
+        std::atomic_flag _decoding = ATOMIC_FLAG_INIT;
+        alignas(64) std::atomic<uint64_t> _writePosition{ 0 };
+        alignas(64) std::atomic<uint64_t> _readPosition{ 0 };
+    };
+}
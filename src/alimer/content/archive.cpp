@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "content/archive.h"
+#include "foundation/log.h"
+#include <stb_image.h>
+#include <string.h>
+
+namespace alimer
+{
+    namespace
+    {
+        bool InRange(uint64_t offset, uint64_t size, uint64_t limit)
+        {
+            return offset <= limit && size <= limit - offset;
+        }
+    }
+
+    bool Archive::Open(const std::string& path)
+    {
+        Close();
+
+        if (!_file.Open(path))
+        {
+            ALIMER_LOGERROR("Failed to open archive: {}", path);
+            return false;
+        }
+
+        _header = reinterpret_cast<const ArchiveHeader*>(_file.GetData());
+        if (!Validate())
+        {
+            ALIMER_LOGERROR("Invalid archive: {}", path);
+            Close();
+            return false;
+        }
+
+        _entries = reinterpret_cast<const ArchiveEntry*>(_file.GetData() + _header->entriesOffset);
+        _chunks = reinterpret_cast<const ArchiveChunk*>(_file.GetData() + _header->chunksOffset);
+        return true;
+    }
+
+    void Archive::Close()
+    {
+        _header = nullptr;
+        _entries = nullptr;
+        _chunks = nullptr;
+        _file.Close();
+    }
+
+    bool Archive::Validate() const
+    {
+        const uint64_t size = _file.GetSize();
+        if (size < sizeof(ArchiveHeader)
+            || _header->magic != ArchiveMagic
+            || _header->version != ArchiveVersion
+            || _header->fileSize != size
+            || _header->chunkSize == 0)
+        {
+            return false;
+        }
+
+        // Every range is checked once here so lookups can index the tables directly.
+        const uint8_t* data = _file.GetData();
+        if (!InRange(_header->stringsOffset, _header->stringsSize, size)
+            || (_header->stringsSize > 0 && data[_header->stringsOffset + _header->stringsSize - 1] != '\0')
+            || !InRange(_header->entriesOffset, uint64_t(_header->entryCount) * sizeof(ArchiveEntry), size)
+            || !InRange(_header->chunksOffset, uint64_t(_header->chunkCount) * sizeof(ArchiveChunk), size))
+        {
+            return false;
+        }
+
+        const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(data + _header->entriesOffset);
+        const ArchiveChunk* chunks = reinterpret_cast<const ArchiveChunk*>(data + _header->chunksOffset);
+        for (uint32_t i = 0; i < _header->entryCount; ++i)
+        {
+            const ArchiveEntry& entry = entries[i];
+            if (entry.nameOffset >= _header->stringsSize
+                || !InRange(entry.offset, entry.storedSize, size)
+                || (i > 0 && entry.pathHash < entries[i - 1].pathHash))
+            {
+                return false;
+            }
+
+            if (entry.compression == ArchiveCompression::None)
+            {
+                if (entry.storedSize != entry.size) {
+                    return false;
+                }
+                continue;
+            }
+
+            const uint64_t chunkCount = (entry.size + _header->chunkSize - 1) / _header->chunkSize;
+            if (entry.compression != ArchiveCompression::Deflate
+                || entry.chunkCount != chunkCount
+                || !InRange(entry.firstChunk, entry.chunkCount, _header->chunkCount))
+            {
+                return false;
+            }
+
+            for (uint32_t chunkIndex = 0; chunkIndex < entry.chunkCount; ++chunkIndex)
+            {
+                const ArchiveChunk& chunk = chunks[entry.firstChunk + chunkIndex];
+                if (!InRange(chunk.offset, chunk.storedSize, size)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    const ArchiveEntry* Archive::GetEntry(uint32_t index) const
+    {
+        if (!_header || index >= _header->entryCount) {
+            return nullptr;
+        }
+
+        return &_entries[index];
+    }
+
+    const ArchiveEntry* Archive::Find(const char* path) const
+    {
+        if (!_header) {
+            return nullptr;
+        }
+
+        const uint64_t hash = ArchivePathHash(path);
+        uint32_t first = 0;
+        uint32_t count = _header->entryCount;
+        while (count > 0)
+        {
+            const uint32_t step = count / 2;
+            if (_entries[first + step].pathHash < hash)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        for (; first < _header->entryCount && _entries[first].pathHash == hash; ++first)
+        {
+            if (strcmp(GetName(&_entries[first]), path) == 0) {
+                return &_entries[first];
+            }
+        }
+
+        return nullptr;
+    }
+
+    const char* Archive::GetName(const ArchiveEntry* entry) const
+    {
+        return reinterpret_cast<const char*>(_file.GetData() + _header->stringsOffset + entry->nameOffset);
+    }
+
+    const uint8_t* Archive::GetData(const ArchiveEntry* entry) const
+    {
+        if (entry->compression != ArchiveCompression::None) {
+            return nullptr;
+        }
+
+        return _file.GetData() + entry->offset;
+    }
+
+    bool Archive::Read(const ArchiveEntry* entry, std::vector<uint8_t>& data) const
+    {
+        data.resize(static_cast<size_t>(entry->size));
+        if (entry->compression == ArchiveCompression::None)
+        {
+            if (entry->size) {
+                memcpy(data.data(), _file.GetData() + entry->offset, static_cast<size_t>(entry->size));
+            }
+            return true;
+        }
+
+        for (uint32_t i = 0; i < entry->chunkCount; ++i)
+        {
+            const ArchiveChunk& chunk = _chunks[entry->firstChunk + i];
+            const uint64_t offset = uint64_t(i) * _header->chunkSize;
+            const uint32_t size = static_cast<uint32_t>(entry->size - offset < _header->chunkSize ? entry->size - offset : _header->chunkSize);
+            const uint8_t* source = _file.GetData() + chunk.offset;
+            if (chunk.storedSize == size)
+            {
+                memcpy(data.data() + offset, source, size);
+                continue;
+            }
+
+            const int decoded = stbi_zlib_decode_buffer(reinterpret_cast<char*>(data.data() + offset), static_cast<int>(size),
+                reinterpret_cast<const char*>(source), static_cast<int>(chunk.storedSize));
+            if (decoded != static_cast<int>(size)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "content/archive_format.h"
+#include "foundation/mapped_file.h"
+#include <vector>
+
+namespace alimer
+{
+    /// Packed asset archive produced by alimer-pack, mapped and used in place.
+    class ALIMER_API Archive final
+    {
+    public:
+        /// Constructor.
+        Archive() = default;
+
+        /// Destructor.
+        ~Archive() = default;
+
+        Archive(const Archive&) = delete;
+        Archive& operator=(const Archive&) = delete;
+
+        /// Map and validate the archive at path.
+        bool Open(const std::string& path);
+
+        /// Unmap the archive, pointers returned earlier become invalid.
+        void Close();
+
+        /// Check if an archive is open.
+        bool IsOpen() const { return _header != nullptr; }
+
+        /// Get the number of entries.
+        uint32_t GetEntryCount() const { return _header ? _header->entryCount : 0; }
+
+        /// Get entry by index, sorted by path hash.
+        const ArchiveEntry* GetEntry(uint32_t index) const;
+
+        /// Find entry by path relative to the packed directory, for example "shaders/sprite.vert".
+        const ArchiveEntry* Find(const char* path) const;
+
+        /// Get the path of an entry.
+        const char* GetName(const ArchiveEntry* entry) const;
+
+        /// Get the data of an uncompressed entry in place, nullptr for compressed entries.
+        const uint8_t* GetData(const ArchiveEntry* entry) const;
+
+        /// Copy or decompress the entry data into data.
+        bool Read(const ArchiveEntry* entry, std::vector<uint8_t>& data) const;
+
+    private:
+        bool Validate() const;
+
+        MappedFile _file;
+        const ArchiveHeader* _header = nullptr;
+        const ArchiveEntry* _entries = nullptr;
+        const ArchiveChunk* _chunks = nullptr;
+    };
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Binary layout shared by alimer-pack and the runtime Archive reader.
+ * Every offset is relative to the start of the file. Entry data is aligned to ArchiveAlignment so
+ * uncompressed entries can be used straight from a mapping of the file. */
+namespace alimer
+{
+    static constexpr uint32_t ArchiveMagic = 0x4B504C41u; // 'ALPK'
+    static constexpr uint32_t ArchiveVersion = 1;
+    static constexpr uint32_t ArchiveAlignment = 4096;
+
+    enum class ArchiveCompression : uint32_t
+    {
+        /// Stored as is, usable in place.
+        None = 0,
+        /// Split in chunks of ArchiveHeader::chunkSize, each a zlib stream or stored when it did not shrink.
+        Deflate = 1
+    };
+
+    struct ArchiveHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t chunkCount;
+        /// Uncompressed size of a chunk, the last chunk of an entry may be shorter.
+        uint32_t chunkSize;
+        uint32_t stringsSize;
+        /// ArchiveEntry[entryCount] sorted by pathHash, then name.
+        uint64_t entriesOffset;
+        /// ArchiveChunk[chunkCount].
+        uint64_t chunksOffset;
+        /// Null terminated entry paths.
+        uint64_t stringsOffset;
+        uint64_t fileSize;
+    };
+
+    struct ArchiveEntry
+    {
+        uint64_t pathHash;
+        /// Path relative to the packed directory with '/' separators.
+        uint32_t nameOffset;
+        ArchiveCompression compression;
+        uint64_t offset;
+        /// Uncompressed size.
+        uint64_t size;
+        /// Size in the archive.
+        uint64_t storedSize;
+        uint32_t firstChunk;
+        uint32_t chunkCount;
+    };
+
+    struct ArchiveChunk
+    {
+        uint64_t offset;
+        /// Equal to the chunk size when stored uncompressed.
+        uint32_t storedSize;
+        uint32_t reserved;
+    };
+
+    /// FNV-1a hash of an entry path.
+    inline uint64_t ArchivePathHash(const char* path)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        while (*path)
+        {
+            hash ^= static_cast<uint8_t>(*path++);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
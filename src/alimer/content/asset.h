@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+#include <atomic>
+#include <string>
+#include <utility>
+
+namespace alimer
+{
+    class ContentManager;
+    class AssetLoader;
+
+    /// Loading state of an asset.
+    enum class AssetState : uint32_t
+    {
+        /// Not requested.
+        Unloaded = 0,
+        /// Waiting in the I/O queue.
+        Queued,
+        /// Reading from storage.
+        Loading,
+        /// Decoding on a worker thread.
+        Decoding,
+        /// Waiting for the render thread upload.
+        Uploading,
+        /// Loaded and usable.
+        Ready,
+        /// Read, decode or upload failed.
+        Failed,
+        /// Cancelled before it finished loading.
+        Cancelled
+    };
+
+    /// Priority of a load request, higher priorities are read and uploaded first.
+    enum class LoadPriority : uint32_t
+    {
+        Background = 0,
+        Low,
+        Normal,
+        High,
+        Immediate
+    };
+
+    /// Identifier of an asset type, unique per C++ type.
+    using AssetTypeId = const void*;
+
+    template <typename T>
+    AssetTypeId GetAssetTypeId()
+    {
+        static const char id = 0;
+        return &id;
+    }
+
+    /// Base class for reference counted assets owned by the ContentManager.
+    class ALIMER_API Asset
+    {
+    public:
+        /// Destructor.
+        virtual ~Asset() = default;
+
+        Asset(const Asset&) = delete;
+        Asset& operator=(const Asset&) = delete;
+
+        /// Add a reference.
+        void AddRef() { _refCount.fetch_add(1, std::memory_order_relaxed); }
+
+        /// Release a reference, the asset is destroyed when the last one goes away.
+        void Release();
+
+        /// Get the reference count.
+        uint32_t GetRefCount() const { return _refCount.load(std::memory_order_acquire); }
+
+        /// Get the name the asset was loaded with.
+        const std::string& GetName() const { return _name; }
+
+        /// Get the loading state.
+        AssetState GetState() const { return _state.load(std::memory_order_acquire); }
+
+        /// Check if the asset finished loading with success.
+        bool IsReady() const { return GetState() == AssetState::Ready; }
+
+        /// Check if the asset is still moving through the loading pipeline.
+        bool IsLoading() const
+        {
+            const AssetState state = GetState();
+            return state >= AssetState::Queued && state <= AssetState::Uploading;
+        }
+
+    protected:
+        /// Constructor.
+        Asset() = default;
+
+    private:
+        friend class ContentManager;
+
+        std::atomic<uint32_t> _refCount{ 0 };
+        std::atomic<AssetState> _state{ AssetState::Unloaded };
+        std::atomic<bool> _cancelled{ false };
+        std::atomic<ContentManager*> _manager{ nullptr };
+        AssetLoader* _loader = nullptr;
+        std::string _name;
+        /// Request data owned by the ContentManager.
+        LoadPriority _priority = LoadPriority::Normal;
+        uint32_t _requestVersion = 0;
+        uint64_t _uploadSize = 0;
+    };
+
+    /// Typed reference counting handle to an asset.
+    template <typename T>
+    class AssetHandle final
+    {
+    public:
+        AssetHandle() = default;
+
+        explicit AssetHandle(T* asset, bool addRef = true)
+            : _asset(asset)
+        {
+            if (_asset && addRef) {
+                _asset->AddRef();
+            }
+        }
+
+        AssetHandle(const AssetHandle& other)
+            : AssetHandle(other._asset)
+        {
+        }
+
+        AssetHandle(AssetHandle&& other)
+            : _asset(other._asset)
+        {
+            other._asset = nullptr;
+        }
+
+        ~AssetHandle()
+        {
+            Reset();
+        }
+
+        AssetHandle& operator=(const AssetHandle& other)
+        {
+            AssetHandle(other).Swap(*this);
+            return *this;
+        }
+
+        AssetHandle& operator=(AssetHandle&& other)
+        {
+            AssetHandle(std::move(other)).Swap(*this);
+            return *this;
+        }
+
+        /// Drop the reference.
+        void Reset()
+        {
+            if (_asset)
+            {
+                _asset->Release();
+                _asset = nullptr;
+            }
+        }
+
+        void Swap(AssetHandle& other) { std::swap(_asset, other._asset); }
+
+        /// Get the asset, it may still be loading.
+        T* Get() const { return _asset; }
+        T* operator->() const { return _asset; }
+        T& operator*() const { return *_asset; }
+        explicit operator bool() const { return _asset != nullptr; }
+
+        /// Check if the asset finished loading with success.
+        bool IsReady() const { return _asset && _asset->IsReady(); }
+
+        bool operator==(const AssetHandle& other) const { return _asset == other._asset; }
+        bool operator!=(const AssetHandle& other) const { return _asset != other._asset; }
+
+    private:
+        T* _asset = nullptr;
+    };
+
+    /// Loader for one asset type, reads are done by the ContentManager.
+    class ALIMER_API AssetLoader
+    {
+    public:
+        /// Destructor.
+        virtual ~AssetLoader() = default;
+
+        /// Create an empty asset.
+        virtual Asset* Create() = 0;
+
+        /// Decode file data into the asset, called on a worker thread.
+        virtual bool Decode(Asset* asset, const uint8_t* data, size_t size) = 0;
+
+        /// Get the bytes the upload of a decoded asset sends to the GPU, charged against the frame budget.
+        virtual uint64_t GetUploadSize(const Asset* /*asset*/) const { return 0; }
+
+        /// Create GPU resources of a decoded asset, called on the render thread.
+        virtual bool Upload(Asset* /*asset*/) { return true; }
+    };
+}
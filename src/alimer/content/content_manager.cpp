@@ -20,15 +20,744 @@
 // THE SOFTWARE.
 //
 
+
 #include "content/content_manager.h"
+#include "content/archive.h"
+#include "foundation/job_system.h"
+#include "foundation/log.h"
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#if defined(_WIN32)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
 
 namespace alimer
 {
+    struct ContentManager::Request
+    {
+        Asset* asset;
+        LoadPriority priority;
+        uint32_t version;
+        uint64_t sequence;
+    };
+
+    namespace
+    {
+        /// Requests an I/O thread reads together, hinting all of them first lets the OS overlap their reads.
+        constexpr uint32_t IoBatchSize = 4;
+
+#if defined(_WIN32)
+        using FileHandle = HANDLE;
+        const FileHandle InvalidFileHandle = INVALID_HANDLE_VALUE;
+
+        FileHandle OpenFile(const std::string& path, uint64_t& size)
+        {
+            FileHandle file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            LARGE_INTEGER fileSize;
+            if (file != INVALID_HANDLE_VALUE && !GetFileSizeEx(file, &fileSize))
+            {
+                CloseHandle(file);
+                return INVALID_HANDLE_VALUE;
+            }
+
+            size = file != INVALID_HANDLE_VALUE ? static_cast<uint64_t>(fileSize.QuadPart) : 0;
+            return file;
+        }
+
+        bool ReadFileAt(FileHandle file, uint8_t* data, uint64_t size)
+        {
+            uint64_t offset = 0;
+            while (offset < size)
+            {
+                const DWORD chunk = static_cast<DWORD>(std::min<uint64_t>(size - offset, 1u << 30));
+                OVERLAPPED overlapped = {};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD bytesRead = 0;
+                if (!ReadFile(file, data + offset, chunk, &bytesRead, &overlapped) || bytesRead == 0) {
+                    return false;
+                }
+                offset += bytesRead;
+            }
+            return true;
+        }
+
+        void CloseFile(FileHandle file)
+        {
+            CloseHandle(file);
+        }
+#else
+        using FileHandle = int;
+        const FileHandle InvalidFileHandle = -1;
+
+        FileHandle OpenFile(const std::string& path, uint64_t& size)
+        {
+            const int fd = open(path.c_str(), O_RDONLY);
+            struct stat info;
+            if (fd >= 0 && fstat(fd, &info) != 0)
+            {
+                close(fd);
+                return -1;
+            }
+
+            size = fd >= 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#if defined(POSIX_FADV_WILLNEED)
+            // Start readahead now, the read happens after the rest of the batch is opened.
+            if (fd >= 0) {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+            }
+#endif
+            return fd;
+        }
+
+        bool ReadFileAt(FileHandle file, uint8_t* data, uint64_t size)
+        {
+            uint64_t offset = 0;
+            while (offset < size)
+            {
+                const ssize_t bytesRead = pread(file, data + offset, static_cast<size_t>(size - offset), static_cast<off_t>(offset));
+                if (bytesRead <= 0) {
+                    return false;
+                }
+                offset += static_cast<uint64_t>(bytesRead);
+            }
+            return true;
+        }
+
+        void CloseFile(FileHandle file)
+        {
+            close(file);
+        }
+#endif
+
+        /// Only the pipeline reference is left, or the request was cancelled.
+        bool IsAbandoned(const Asset* asset, bool cancelled)
+        {
+            return cancelled || asset->GetRefCount() <= 1;
+        }
+
+        void LogError(const std::string& message)
+        {
+            Logger::GetDefault().Log(LogLevel::Error, ALIMER_TAG, message);
+        }
+    }
+
+    struct ContentManager::Impl
+    {
+        JobSystem* jobs = nullptr;
+        std::string rootDirectory;
+        std::unordered_map<AssetTypeId, std::unique_ptr<AssetLoader>> loaders;
+        std::unordered_map<std::string, Asset*> assets;
+        std::vector<std::unique_ptr<Archive>> archives;
+
+        /// Read requests, a max heap with stale entries skipped by version.
+        std::mutex queueMutex;
+        std::condition_variable queueCondition;
+        std::vector<Request> queue;
+        uint64_t sequence = 0;
+        bool running = false;
+        std::vector<std::thread> ioThreads;
+
+        /// Decode jobs in flight.
+        JobCounter decodeCounter;
+
+        /// Decoded assets waiting for the render thread, a max heap.
+        std::mutex uploadMutex;
+        std::vector<Request> uploads;
+
+        std::atomic<uint64_t> requested{ 0 };
+        std::atomic<uint64_t> loaded{ 0 };
+        std::atomic<uint64_t> failed{ 0 };
+        std::atomic<uint64_t> cancelled{ 0 };
+        std::atomic<uint64_t> bytesRead{ 0 };
+        std::atomic<uint64_t> bytesUploaded{ 0 };
+        std::atomic<uint32_t> pending{ 0 };
+
+        /// Heap order: higher priority first, then first requested.
+        static bool Less(const Request& a, const Request& b)
+        {
+            if (a.priority != b.priority) {
+                return a.priority < b.priority;
+            }
+            return a.sequence > b.sequence;
+        }
+
+        void Push(std::vector<Request>& heap, const Request& request)
+        {
+            heap.push_back(request);
+            std::push_heap(heap.begin(), heap.end(), &Less);
+        }
+
+        Request Pop(std::vector<Request>& heap)
+        {
+            std::pop_heap(heap.begin(), heap.end(), &Less);
+            const Request request = heap.back();
+            heap.pop_back();
+            return request;
+        }
+    };
+
     ContentManager::ContentManager()
     {
     }
 
     ContentManager::~ContentManager()
     {
+        Shutdown();
+    }
+
+    void ContentManager::Initialize(JobSystem* jobs, uint32_t ioThreadCount)
+    {
+        if (_impl) {
+            return;
+        }
+
+        _impl.reset(new Impl());
+        _impl->jobs = jobs;
+        _impl->running = true;
+
+#if defined(ALIMER_THREADING)
+        _impl->ioThreads.reserve(ioThreadCount);
+        for (uint32_t i = 0; i < ioThreadCount; ++i)
+        {
+            _impl->ioThreads.emplace_back(&ContentManager::IoMain, this);
+        }
+#endif
+    }
+
+    void ContentManager::Shutdown()
+    {
+        if (!_impl) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_impl->queueMutex);
+            _impl->running = false;
+            _impl->queueCondition.notify_all();
+        }
+
+        for (std::thread& thread : _impl->ioThreads)
+        {
+            thread.join();
+        }
+        _impl->ioThreads.clear();
+
+        if (_impl->jobs) {
+            _impl->jobs->Wait(_impl->decodeCounter);
+        }
+
+        // Threads are gone, drop everything still in the pipeline.
+        while (!_impl->queue.empty())
+        {
+            const Request request = _impl->Pop(_impl->queue);
+            if (request.version == request.asset->_requestVersion) {
+                Finish(request.asset, AssetState::Cancelled);
+            }
+        }
+
+        while (!_impl->uploads.empty())
+        {
+            Finish(_impl->Pop(_impl->uploads).asset, AssetState::Cancelled);
+        }
+
+        // Assets still referenced outlive the manager and delete themselves.
+        std::lock_guard<std::mutex> lock(_assetMutex);
+        for (auto& it : _impl->assets)
+        {
+            it.second->_manager.store(nullptr, std::memory_order_release);
+        }
+        _impl.reset();
+    }
+
+    void ContentManager::SetRootDirectory(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(_assetMutex);
+        if (!_impl) {
+            return;
+        }
+
+        _impl->rootDirectory = path;
+        if (!path.empty() && path.back() != '/' && path.back() != '\\') {
+            _impl->rootDirectory += '/';
+        }
+    }
+
+    bool ContentManager::MountArchive(const std::string& path)
+    {
+        std::unique_ptr<Archive> archive(new Archive());
+        if (!archive->Open(path)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_assetMutex);
+        if (!_impl) {
+            return false;
+        }
+
+        _impl->archives.push_back(std::move(archive));
+        return true;
+    }
+
+    void ContentManager::RegisterLoader(AssetTypeId type, std::unique_ptr<AssetLoader> loader)
+    {
+        std::lock_guard<std::mutex> lock(_assetMutex);
+        if (_impl) {
+            _impl->loaders[type] = std::move(loader);
+        }
+    }
+
+    Asset* ContentManager::LoadAsset(AssetTypeId type, const std::string& name, LoadPriority priority)
+    {
+        std::lock_guard<std::mutex> lock(_assetMutex);
+        if (!_impl) {
+            LogError("ContentManager is not initialized");
+            return nullptr;
+        }
+
+        auto loader = _impl->loaders.find(type);
+        if (loader == _impl->loaders.end()) {
+            LogError("No asset loader registered for '" + name + "'");
+            return nullptr;
+        }
+
+        Asset* asset = nullptr;
+        auto it = _impl->assets.find(name);
+        if (it != _impl->assets.end())
+        {
+            asset = it->second;
+            if (asset->_loader != loader->second.get()) {
+                LogError("Asset '" + name + "' is already loaded with a different type");
+                return nullptr;
+            }
+
+            // Handle reference, added under the lock so the asset cannot go away before the caller gets it.
+            asset->AddRef();
+
+            // Checked under the queue lock, the load stages decide abandonment under the same lock.
+            bool requeue = false;
+            {
+                std::lock_guard<std::mutex> queueLock(_impl->queueMutex);
+                const AssetState state = asset->GetState();
+                if (state == AssetState::Cancelled)
+                {
+                    requeue = true;
+                }
+                else if (state == AssetState::Queued)
+                {
+                    if (priority > asset->_priority)
+                    {
+                        asset->_priority = priority;
+                        _impl->Push(_impl->queue, { asset, priority, ++asset->_requestVersion, _impl->sequence++ });
+                    }
+                }
+                else if (asset->IsLoading())
+                {
+                    // A cancelled in flight load is revived instead of finishing as cancelled.
+                    if (asset->_cancelled.exchange(false, std::memory_order_relaxed)) {
+                        ++asset->_requestVersion;
+                    }
+                    if (priority > asset->_priority) {
+                        asset->_priority = priority;
+                    }
+                }
+            }
+
+            if (requeue)
+            {
+                asset->AddRef();
+                Enqueue(asset, priority);
+            }
+        }
+        else
+        {
+            asset = loader->second->Create();
+            if (!asset) {
+                return nullptr;
+            }
+
+            asset->_manager.store(this, std::memory_order_relaxed);
+            asset->_loader = loader->second.get();
+            asset->_name = name;
+            _impl->assets[name] = asset;
+
+            // Handle reference first, readers treat an asset holding only the pipeline reference as abandoned.
+            asset->AddRef();
+            asset->AddRef();
+            Enqueue(asset, priority);
+        }
+
+        return asset;
+    }
+
+    void ContentManager::ReleaseAsset(Asset* asset)
+    {
+        std::unique_lock<std::mutex> lock(_assetMutex);
+        if (asset->_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        if (_impl && asset->_manager.load(std::memory_order_relaxed) == this) {
+            _impl->assets.erase(asset->_name);
+        }
+        lock.unlock();
+        delete asset;
+    }
+
+    void ContentManager::Enqueue(Asset* asset, LoadPriority priority)
+    {
+        _impl->requested.fetch_add(1, std::memory_order_relaxed);
+        _impl->pending.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(_impl->queueMutex);
+        asset->_priority = priority;
+        asset->_state.store(AssetState::Queued, std::memory_order_release);
+        _impl->Push(_impl->queue, { asset, priority, ++asset->_requestVersion, _impl->sequence++ });
+        _impl->queueCondition.notify_one();
+    }
+
+    void ContentManager::SetPriority(Asset* asset, LoadPriority priority)
+    {
+        if (!_impl || !asset) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_impl->queueMutex);
+        if (asset->GetState() != AssetState::Queued || asset->_priority == priority) {
+            return;
+        }
+
+        // The old heap entry goes stale and is skipped when popped.
+        asset->_priority = priority;
+        _impl->Push(_impl->queue, { asset, priority, ++asset->_requestVersion, _impl->sequence++ });
+    }
+
+    void ContentManager::Cancel(Asset* asset)
+    {
+        if (!_impl || !asset) {
+            return;
+        }
+
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(_impl->queueMutex);
+            if (asset->GetState() == AssetState::Queued)
+            {
+                ++asset->_requestVersion;
+                asset->_state.store(AssetState::Cancelled, std::memory_order_release);
+                queued = true;
+            }
+            else if (asset->IsLoading())
+            {
+                asset->_cancelled.store(true, std::memory_order_release);
+            }
+        }
+
+        if (queued) {
+            Retire(asset, AssetState::Cancelled);
+        }
+    }
+
+    uint32_t ContentManager::PopRequests(Request* requests, uint32_t maxCount)
+    {
+        uint32_t count = 0;
+        while (count < maxCount && !_impl->queue.empty())
+        {
+            const Request request = _impl->Pop(_impl->queue);
+            if (request.version != request.asset->_requestVersion) {
+                continue;
+            }
+
+            request.asset->_state.store(AssetState::Loading, std::memory_order_release);
+            requests[count++] = request;
+        }
+        return count;
+    }
+
+    void ContentManager::IoMain()
+    {
+        Request requests[IoBatchSize];
+        for (;;)
+        {
+            uint32_t count = 0;
+            {
+                std::unique_lock<std::mutex> lock(_impl->queueMutex);
+                _impl->queueCondition.wait(lock, [this]() { return !_impl->running || !_impl->queue.empty(); });
+                if (!_impl->running) {
+                    return;
+                }
+
+                count = PopRequests(requests, IoBatchSize);
+            }
+
+            ReadRequests(requests, count);
+        }
+    }
+
+    void ContentManager::ReadRequests(Request* requests, uint32_t count)
+    {
+        // Mounts and the root directory can change while I/O threads run, archives stay alive until shutdown.
+        std::string rootDirectory;
+        std::vector<const Archive*> archives;
+        {
+            std::lock_guard<std::mutex> lock(_assetMutex);
+            rootDirectory = _impl->rootDirectory;
+            archives.reserve(_impl->archives.size());
+            for (const std::unique_ptr<Archive>& archive : _impl->archives)
+            {
+                archives.push_back(archive.get());
+            }
+        }
+
+        FileHandle files[IoBatchSize];
+        uint64_t sizes[IoBatchSize];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            files[i] = InvalidFileHandle;
+            sizes[i] = 0;
+
+            // Archive entries skip the file system entirely.
+            const std::string& name = requests[i].asset->GetName();
+            for (auto it = archives.rbegin(); it != archives.rend(); ++it)
+            {
+                const ArchiveEntry* entry = (*it)->Find(name.c_str());
+                if (entry)
+                {
+                    _impl->bytesRead.fetch_add(entry->storedSize, std::memory_order_relaxed);
+                    ScheduleDecode(requests[i].asset, std::vector<uint8_t>(), *it, entry);
+                    requests[i].asset = nullptr;
+                    break;
+                }
+            }
+
+            if (requests[i].asset) {
+                files[i] = OpenFile(rootDirectory + name, sizes[i]);
+            }
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Asset* asset = requests[i].asset;
+            if (!asset) {
+                continue;
+            }
+
+            if (files[i] == InvalidFileHandle)
+            {
+                LogError("Failed to open asset '" + asset->GetName() + "'");
+                Finish(asset, AssetState::Failed);
+                continue;
+            }
+
+            if (FinishIfAbandoned(asset))
+            {
+                CloseFile(files[i]);
+                continue;
+            }
+
+            std::vector<uint8_t> data(static_cast<size_t>(sizes[i]));
+            const bool success = ReadFileAt(files[i], data.data(), sizes[i]);
+            CloseFile(files[i]);
+            if (!success)
+            {
+                LogError("Failed to read asset '" + asset->GetName() + "'");
+                Finish(asset, AssetState::Failed);
+                continue;
+            }
+
+            _impl->bytesRead.fetch_add(sizes[i], std::memory_order_relaxed);
+            ScheduleDecode(asset, std::move(data), nullptr, nullptr);
+        }
+    }
+
+    void ContentManager::ScheduleDecode(Asset* asset, std::vector<uint8_t>&& data, const Archive* archive, const ArchiveEntry* entry)
+    {
+        asset->_state.store(AssetState::Decoding, std::memory_order_release);
+        if (_impl->jobs && _impl->jobs->GetWorkerCount() > 0)
+        {
+            _impl->jobs->Schedule(&_impl->decodeCounter, [this, asset, data = std::move(data), archive, entry]() mutable {
+                Decode(asset, data, archive, entry);
+            });
+        }
+        else
+        {
+            Decode(asset, data, archive, entry);
+        }
+    }
+
+    void ContentManager::Decode(Asset* asset, std::vector<uint8_t>& data, const Archive* archive, const ArchiveEntry* entry)
+    {
+        if (FinishIfAbandoned(asset)) {
+            return;
+        }
+
+        // Uncompressed archive entries are decoded straight from the mapping, compressed ones inflate here.
+        const uint8_t* source = data.data();
+        size_t size = data.size();
+        if (archive)
+        {
+            source = archive->GetData(entry);
+            size = static_cast<size_t>(entry->size);
+            if (!source)
+            {
+                if (!archive->Read(entry, data))
+                {
+                    LogError("Failed to decompress asset '" + asset->GetName() + "'");
+                    Finish(asset, AssetState::Failed);
+                    return;
+                }
+                source = data.data();
+            }
+        }
+
+        if (!asset->_loader->Decode(asset, source, size))
+        {
+            LogError("Failed to decode asset '" + asset->GetName() + "'");
+            Finish(asset, AssetState::Failed);
+            return;
+        }
+
+        asset->_uploadSize = asset->_loader->GetUploadSize(asset);
+        asset->_state.store(AssetState::Uploading, std::memory_order_release);
+
+        Request request = { asset, LoadPriority::Normal, 0, 0 };
+        {
+            std::lock_guard<std::mutex> lock(_impl->queueMutex);
+            request.priority = asset->_priority;
+            request.version = asset->_requestVersion;
+            request.sequence = _impl->sequence++;
+        }
+
+        std::lock_guard<std::mutex> lock(_impl->uploadMutex);
+        _impl->Push(_impl->uploads, request);
+    }
+
+    void ContentManager::Update(uint64_t uploadBudget)
+    {
+        if (!_impl) {
+            return;
+        }
+
+        // Without I/O threads reads happen here, one batch per frame.
+        if (_impl->ioThreads.empty())
+        {
+            Request requests[IoBatchSize];
+            uint32_t count = 0;
+            {
+                std::lock_guard<std::mutex> lock(_impl->queueMutex);
+                count = PopRequests(requests, IoBatchSize);
+            }
+            ReadRequests(requests, count);
+        }
+
+        uint64_t spent = 0;
+        for (;;)
+        {
+            Request request;
+            {
+                std::lock_guard<std::mutex> lock(_impl->uploadMutex);
+                if (_impl->uploads.empty()) {
+                    break;
+                }
+
+                const uint64_t size = _impl->uploads.front().asset->_uploadSize;
+                if (spent > 0 && spent + size > uploadBudget) {
+                    break;
+                }
+
+                request = _impl->Pop(_impl->uploads);
+            }
+
+            Asset* asset = request.asset;
+            if (FinishIfAbandoned(asset)) {
+                continue;
+            }
+
+            spent += asset->_uploadSize;
+            _impl->bytesUploaded.fetch_add(asset->_uploadSize, std::memory_order_relaxed);
+            if (asset->_loader->Upload(asset))
+            {
+                Finish(asset, AssetState::Ready);
+            }
+            else
+            {
+                LogError("Failed to upload asset '" + asset->GetName() + "'");
+                Finish(asset, AssetState::Failed);
+            }
+        }
+    }
+
+    bool ContentManager::FinishIfAbandoned(Asset* asset)
+    {
+        // Decided under the queue lock, a concurrent LoadAsset either revives the load first or sees Cancelled and requeues.
+        {
+            std::lock_guard<std::mutex> lock(_impl->queueMutex);
+            if (!IsAbandoned(asset, asset->_cancelled.load(std::memory_order_relaxed))) {
+                return false;
+            }
+
+            asset->_cancelled.store(false, std::memory_order_relaxed);
+            asset->_state.store(AssetState::Cancelled, std::memory_order_release);
+        }
+
+        Retire(asset, AssetState::Cancelled);
+        return true;
+    }
+
+    void ContentManager::Finish(Asset* asset, AssetState state)
+    {
+        asset->_cancelled.store(false, std::memory_order_relaxed);
+        asset->_state.store(state, std::memory_order_release);
+        Retire(asset, state);
+    }
+
+    void ContentManager::Retire(Asset* asset, AssetState state)
+    {
+        switch (state)
+        {
+        case AssetState::Ready:
+            _impl->loaded.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case AssetState::Failed:
+            _impl->failed.fetch_add(1, std::memory_order_relaxed);
+            break;
+        default:
+            _impl->cancelled.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+
+        _impl->pending.fetch_sub(1, std::memory_order_relaxed);
+
+        // Drop the pipeline reference.
+        asset->Release();
+    }
+
+    ContentStats ContentManager::GetStats() const
+    {
+        ContentStats stats;
+        if (!_impl) {
+            return stats;
+        }
+
+        stats.requested = _impl->requested.load(std::memory_order_relaxed);
+        stats.loaded = _impl->loaded.load(std::memory_order_relaxed);
+        stats.failed = _impl->failed.load(std::memory_order_relaxed);
+        stats.cancelled = _impl->cancelled.load(std::memory_order_relaxed);
+        stats.bytesRead = _impl->bytesRead.load(std::memory_order_relaxed);
+        stats.bytesUploaded = _impl->bytesUploaded.load(std::memory_order_relaxed);
+        stats.pending = _impl->pending.load(std::memory_order_relaxed);
+        return stats;
     }
 }
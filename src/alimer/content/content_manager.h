@@ -20,17 +20,50 @@
 // THE SOFTWARE.
 //
 
+
 #pragma once
 
-#include "foundation/platform.h"
+#include "content/asset.h"
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace alimer
 {
+    class JobSystem;
+    class Archive;
+    struct ArchiveEntry;
+
+    /// Content loading statistics.
+    struct ContentStats
+    {
+        /// Requests queued since initialization.
+        uint64_t requested = 0;
+        /// Assets that finished loading.
+        uint64_t loaded = 0;
+        /// Assets that failed to load.
+        uint64_t failed = 0;
+        /// Requests cancelled before they finished.
+        uint64_t cancelled = 0;
+        /// Bytes read from storage.
+        uint64_t bytesRead = 0;
+        /// Bytes charged against upload budgets.
+        uint64_t bytesUploaded = 0;
+        /// Requests still moving through the pipeline.
+        uint32_t pending = 0;
+    };
+
+    /// Asynchronous asset loader: prioritised reads on I/O threads, decoding on the job system and
+    /// GPU uploads on the render thread under a per frame byte budget.
     class ALIMER_API ContentManager
     {
     public:
+        /// Bytes uploaded per Update call by default.
+        static constexpr uint64_t DefaultUploadBudget = 8 * 1024 * 1024;
+        /// Number of I/O threads by default.
+        static constexpr uint32_t DefaultIoThreadCount = 2;
+
         ContentManager();
 
         /// Destructor.
@@ -42,6 +75,70 @@ namespace alimer
         ContentManager(ContentManager&&) = delete;
         ContentManager& operator=(ContentManager&&) = delete;
 
-    protected:
+        /// Start I/O threads, decoding runs on jobs or inline when null.
+        void Initialize(JobSystem* jobs, uint32_t ioThreadCount = DefaultIoThreadCount);
+
+        /// Cancel pending requests, wait for in flight work and stop I/O threads.
+        void Shutdown();
+
+        /// Set the directory asset names are relative to, call before loading.
+        void SetRootDirectory(const std::string& path);
+
+        /// Mount a packed archive, assets found in it are used before loose files. Archives mounted later take
+        /// precedence, call before loading.
+        bool MountArchive(const std::string& path);
+
+        /// Register the loader used for assets of type T.
+        template <typename T>
+        void RegisterLoader(std::unique_ptr<AssetLoader> loader)
+        {
+            RegisterLoader(GetAssetTypeId<T>(), std::move(loader));
+        }
+
+        /// Register the loader used for assets of the given type.
+        void RegisterLoader(AssetTypeId type, std::unique_ptr<AssetLoader> loader);
+
+        /// Request an asset, returns the cached one when already loaded or loading. The handle is empty
+        /// when no loader is registered for T.
+        template <typename T>
+        AssetHandle<T> Load(const std::string& name, LoadPriority priority = LoadPriority::Normal)
+        {
+            // LoadAsset returns the asset with a reference already added for the handle.
+            return AssetHandle<T>(static_cast<T*>(LoadAsset(GetAssetTypeId<T>(), name, priority)), false);
+        }
+
+        /// Change the priority of a pending request.
+        void SetPriority(Asset* asset, LoadPriority priority);
+
+        /// Cancel a pending request, work already in flight is dropped at the next stage.
+        void Cancel(Asset* asset);
+
+        /// Upload decoded assets in priority order until uploadBudget bytes are spent, call once per frame
+        /// from the render thread. At least one asset is uploaded per call so large ones make progress.
+        void Update(uint64_t uploadBudget = DefaultUploadBudget);
+
+        /// Get accumulated statistics.
+        ContentStats GetStats() const;
+
+    private:
+        friend class Asset;
+        struct Impl;
+        struct Request;
+
+        Asset* LoadAsset(AssetTypeId type, const std::string& name, LoadPriority priority);
+        void ReleaseAsset(Asset* asset);
+        void Enqueue(Asset* asset, LoadPriority priority);
+        void IoMain();
+        uint32_t PopRequests(Request* requests, uint32_t maxCount);
+        void ReadRequests(Request* requests, uint32_t count);
+        void ScheduleDecode(Asset* asset, std::vector<uint8_t>&& data, const Archive* archive, const ArchiveEntry* entry);
+        void Decode(Asset* asset, std::vector<uint8_t>& data, const Archive* archive, const ArchiveEntry* entry);
+        bool FinishIfAbandoned(Asset* asset);
+        void Finish(Asset* asset, AssetState state);
+        void Retire(Asset* asset, AssetState state);
+
+        std::unique_ptr<Impl> _impl;
+        /// Guards the asset cache and reference drops of cached assets.
+        std::mutex _assetMutex;
     };
-} 
+}
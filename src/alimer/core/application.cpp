@@ -22,28 +22,105 @@
 
 //#include "core/log.h"
 #include "core/application.h"
+#include "foundation/memory_tracker.h"
+#include "foundation/profiler.h"
 #include "graphics/graphics.h"
+#include "graphics/texture.h"
 #include <vgpu.h>
+#include <cstring>
 
 namespace alimer
 {
-    Application::Application()
+    static constexpr size_t FrameAllocatorCapacity = 4 * 1024 * 1024;
+
+    /* vgpu host memory is accounted to MemoryTag::Graphics */
+    static void* VGpuAllocate(void* userData, size_t size)
     {
+        return static_cast<Allocator*>(userData)->Allocate(size);
     }
 
-    Application::~Application()
+    static void* VGpuReallocate(void* userData, void* ptr, size_t oldSize, size_t newSize)
+    {
+        Allocator* allocator = static_cast<Allocator*>(userData);
+        void* newPtr = allocator->Allocate(newSize);
+        if (newPtr && ptr)
+        {
+            memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+            allocator->Free(ptr);
+        }
+        return newPtr;
+    }
+
+    static void VGpuFree(void* userData, void* ptr)
     {
-        // Shutdown vgpu
-        vgpuShutdown();
+        static_cast<Allocator*>(userData)->Free(ptr);
+    }
+
+    Application::Application()
+        : _frameAllocator(FrameAllocatorCapacity)
+        , _systems(_world, &_jobs)
+    {
+        // Installed before the platform initializes vgpu.
+        VGpuAllocationCallbacks allocationCallbacks = {};
+        allocationCallbacks.userData = &GetTaggedAllocator(MemoryTag::Graphics);
+        allocationCallbacks.allocate = VGpuAllocate;
+        allocationCallbacks.reallocate = VGpuReallocate;
+        allocationCallbacks.free = VGpuFree;
+        vgpuSetAllocationCallbacks(&allocationCallbacks);
     }
 
     static VGpuBuffer vertex_buffer;
+    static VGpuShader shader;
     static VGpuPipeline renderPipeline;
+    static VGpuCommandBuffer commandBuffer;
+
+    Application::~Application()
+    {
+        // Platforms call shutdown() before destroying vgpu, this only covers early exits.
+        shutdown();
+        vgpuSetAllocationCallbacks(nullptr);
+    }
+
+    void Application::shutdown()
+    {
+        if (!_initialized) {
+            return;
+        }
+        _initialized = false;
+
+        vgpuDestroyCommandBuffer(commandBuffer);
+        vgpuDestroyPipeline(renderPipeline);
+        vgpuDestroyShader(shader);
+        vgpuDestroyBuffer(vertex_buffer);
+        commandBuffer = {};
+        renderPipeline = {};
+        shader = {};
+        vertex_buffer = {};
+
+        _audio.Shutdown();
+
+        // Content drops assets still in flight and waits for decode jobs, stop it before the job system.
+        _content.Shutdown();
+        _graphics.reset();
+
+        _jobs.Shutdown();
+    }
 
     void Application::initialize()
     {
+        _jobs.Initialize();
+        _content.Initialize(&_jobs);
+#if defined(ALIMER_TOOLS)
+        // Tool builds pack the assets next to the binaries and install only the archive.
+        _content.MountArchive("assets.alpk");
+#endif
+        _content.SetRootDirectory("assets");
+        _content.RegisterLoader<Texture>(std::unique_ptr<AssetLoader>(new TextureLoader(&_jobs, true, TextureCompression::Auto)));
         _graphics.reset(new Graphics());
 
+        // No platform output backend yet, the null device keeps the mixer running at playback rate.
+        _audio.Initialize(std::unique_ptr<AudioDevice>(new NullAudioDevice(true)), AudioSettings(), &_jobs);
+
         const float vertices[] = {
             // positions            colors 
              0.0f, 0.5f, 0.5f,      1.0f, 0.0f, 0.0f, 1.0f,
@@ -74,7 +151,8 @@ namespace alimer
         })";
 
         VGpuRenderPipelineDescriptor pipelineDesc = {};
-        pipelineDesc.shader = vgpuCreateShader(vertexShaderSource, fragmentShaderSource);
+        shader = vgpuCreateShader(vertexShaderSource, fragmentShaderSource);
+        pipelineDesc.shader = shader;
         pipelineDesc.primitiveTopology = VGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         pipelineDesc.depthStencil.depthCompareFunction = VGPU_COMPARE_FUNCTION_LESS_EQUAL;
         pipelineDesc.depthStencil.depthWriteEnabled = true;
@@ -83,26 +161,60 @@ namespace alimer
         pipelineDesc.vertexDescriptor.attributes[1].offset = 12;
         pipelineDesc.vertexDescriptor.attributes[1].format = VGPU_VERTEX_FORMAT_FLOAT4;
         renderPipeline = vgpuCreateRenderPipeline(&pipelineDesc);
+
+        // Command buffer memory is retained between frames.
+        commandBuffer = vgpuCreateCommandBuffer(4096);
+
+        _initialized = true;
+        _lastFrameTime = std::chrono::steady_clock::now();
     }
 
     void Application::frame()
     {
-        vgpuBeginDefaultRenderPass({ 0.2f, 0.3f, 0.3f, 1.0f }, 1.0f, 0);
+        _frameAllocator.BeginFrame();
+
+        // Upload streamed assets within the frame budget, reads and decoding happen off this thread.
+        {
+            ALIMER_PROFILE_SCOPE("Content");
+            _content.Update();
+        }
 
-        // Get frame command buffer for recording.
-        vgpuBindPipeline(renderPipeline);
-        vgpuDraw(3, 1, 0);
+        {
+            ALIMER_PROFILE_SCOPE("Audio");
+            _audio.Update();
+        }
 
-        vgpuEndRenderPass();
+        const auto now = std::chrono::steady_clock::now();
+        const float deltaTime = std::chrono::duration<float>(now - _lastFrameTime).count();
+        _lastFrameTime = now;
 
-        /*VGpuCommandBuffer commandBuffer = vgpuGetCommandBuffer();
-        vgpuBeginCommandBuffer(commandBuffer);
-        vgpuCmdBeginDefaultRenderPass(commandBuffer, { 0.5f, 0.5f, 0.5f, 1.0f}, 1.0f, 0);
-        vgpuCmdEndRenderPass(commandBuffer);
-        vgpuEndCommandBuffer(commandBuffer);
-        vgpuSubmitCommandBuffer(commandBuffer);*/
+        // Update game logic, systems that do not conflict run in parallel.
+        {
+            ALIMER_PROFILE_SCOPE("Systems");
+            _systems.Update(deltaTime);
+        }
+
+        // Record frame commands, recording does not touch the device and can happen on any thread.
+        {
+            ALIMER_PROFILE_SCOPE("Render");
+            vgpuBeginCommandBuffer(commandBuffer);
+            vgpuCmdBeginDefaultRenderPass(commandBuffer, { 0.2f, 0.3f, 0.3f, 1.0f }, 1.0f, 0);
+            vgpuCmdBindPipeline(commandBuffer, renderPipeline);
+            vgpuCmdSetVertexBuffers(commandBuffer, 0, 1, &vertex_buffer, nullptr);
+            vgpuCmdDraw(commandBuffer, 3, 1, 0);
+            vgpuCmdEndRenderPass(commandBuffer);
+            vgpuEndCommandBuffer(commandBuffer);
+
+            // Replay on the device thread.
+            vgpuSubmitCommandBuffer(commandBuffer);
+        }
 
         // Submit GPU frame.
-        vgpuFrame();
+        {
+            ALIMER_PROFILE_SCOPE("Present");
+            vgpuFrame();
+        }
+
+        MemoryTracker::EndFrame();
     }
 }
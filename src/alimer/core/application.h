@@ -22,9 +22,14 @@
 
 #pragma once
 
+#include "foundation/allocator.h"
+#include "foundation/job_system.h"
 #include "core/window.h"
 //#include "input.hpp"
 #include "content/content_manager.h"
+#include "audio/audio.h"
+#include "scene/system.h"
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
@@ -56,14 +61,31 @@ namespace alimer
         /// Get the input system.
         //inline Input& get_input() { return _input; }
 
+        /// Get the job system.
+        inline JobSystem& get_jobs() { return _jobs; }
+
+        /// Get the per frame transient allocator.
+        inline FrameAllocator& get_frame_allocator() { return _frameAllocator; }
+
         /// Get the content manager.
         inline ContentManager& get_content() { return _content; }
 
+        /// Get the audio mixer.
+        inline Audio& get_audio() { return _audio; }
+
+        /// Get the entity world.
+        inline World& get_world() { return _world; }
+
+        /// Get the system scheduler updating the world.
+        inline SystemScheduler& get_systems() { return _systems; }
+
     protected:
         // Initialize after all system setup
         void initialize();
         /// Run one frame.
         void frame();
+        /// Release everything that uses vgpu, called by the platform before it shuts down vgpu and the context.
+        void shutdown();
 
     protected:
         std::vector<std::string> _args;
@@ -74,13 +96,34 @@ namespace alimer
         uint32_t _width = 0;
         uint32_t _height = 0;
 
+        /// Job system.
+        JobSystem _jobs;
+
+        /// Transient memory released in bulk, one region per frame in flight.
+        FrameAllocator _frameAllocator;
+
         /// Input system.
         //Input _input;
 
         /// Content manager
         ContentManager _content;
 
+        /// Audio mixer.
+        Audio _audio;
+
+        /// Entity world.
+        World _world;
+
+        /// Systems updated every frame.
+        SystemScheduler _systems;
+
+        /// Start of the previous frame.
+        std::chrono::steady_clock::time_point _lastFrameTime;
+
         /// Graphics system.
         std::unique_ptr<Graphics> _graphics;
+
+        /// Whether initialize() ran and shutdown() has not yet.
+        bool _initialized = false;
     };
 } 
@@ -22,6 +22,8 @@
 
 //#include "core/log.h"
 #include "application_glfw.h"
+#include "foundation/profiler.h"
+#include <cstdlib>
 
 #if defined(__linux__)
 #   define GLFW_EXPOSE_NATIVE_X11
@@ -51,6 +53,8 @@ namespace alimer
 
     ApplicationGlfw::~ApplicationGlfw()
     {
+        // Everything holding vgpu objects goes first, then vgpu, then the context it renders with.
+        shutdown();
         vgpuShutdown();
         glfwTerminate();
     }
@@ -125,7 +129,7 @@ namespace alimer
 #if defined(_DEBUG)
         gpuDescriptor.validation = false;
 #endif
-#if defined(__linux__)
+#if defined(__linux__) && !defined(VGPU_NULL)
         gpuDescriptor.handle.connection = XGetXCBConnection(glfwGetX11Display());
         gpuDescriptor.handle.window = glfwGetX11Window(_window);
 #elif defined(_WIN32)
@@ -139,6 +143,9 @@ namespace alimer
         gpuDescriptor.swapchain.colorClearValue = { 0.0f, 0.0f, 0.2f, 1.0f };
         gpuDescriptor.swapchain.depthStencilFormat = VGPU_PIXEL_FORMAT_D32_FLOAT;
         gpuDescriptor.swapchain.sampleCount = VGPU_SAMPLE_COUNT1;
+#if defined(ALIMER_PROFILING)
+        gpuDescriptor.gpuTiming = true;
+#endif
         vgpuInitialize("vortice", &gpuDescriptor);
 
         // Initialize app now
@@ -159,16 +166,28 @@ namespace alimer
             return 1;
         }
 
+        ALIMER_PROFILE_THREAD("Main");
         while (!glfwWindowShouldClose(_window))
         {
             frame();
 
 #if defined(VGPU_GL) || defined(VGPU_GLES)
-            glfwSwapBuffers(_window);
+            {
+                ALIMER_PROFILE_SCOPE("Present");
+                glfwSwapBuffers(_window);
+            }
 #endif
             glfwPollEvents();
+            ALIMER_PROFILE_FRAME();
         }
 
+#if defined(ALIMER_PROFILING)
+        // Set ALIMER_PROFILE_OUTPUT to a file path to save the last frames as a Chrome trace.
+        if (const char* profilePath = getenv("ALIMER_PROFILE_OUTPUT")) {
+            Profiler::WriteChromeTrace(profilePath);
+        }
+#endif
+
         return exit_code;
     }
 }
@@ -0,0 +1,352 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "foundation/allocator.h"
+#include <algorithm>
+#include <assert.h>
+#include <stdlib.h>
+
+namespace alimer
+{
+    namespace
+    {
+        /// Stored right before every heap allocation.
+        struct HeapHeader
+        {
+            void* base;
+            size_t size;
+        };
+
+        void UpdatePeak(std::atomic<size_t>& peak, size_t value)
+        {
+            size_t current = peak.load(std::memory_order_relaxed);
+            while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+
+    /* HeapAllocator */
+    void* HeapAllocator::Allocate(size_t size, size_t alignment)
+    {
+        if (alignment < alignof(HeapHeader)) {
+            alignment = alignof(HeapHeader);
+        }
+
+        uint8_t* base = static_cast<uint8_t*>(malloc(size + alignment + sizeof(HeapHeader)));
+        if (!base) {
+            return nullptr;
+        }
+
+        uint8_t* ptr = reinterpret_cast<uint8_t*>(AlignTo(reinterpret_cast<uintptr_t>(base) + sizeof(HeapHeader), alignment));
+        HeapHeader* header = reinterpret_cast<HeapHeader*>(ptr) - 1;
+        header->base = base;
+        header->size = size;
+
+        UpdatePeak(_peak, _used.fetch_add(size, std::memory_order_relaxed) + size);
+        _allocations.fetch_add(1, std::memory_order_relaxed);
+        MemoryTracker::OnAllocate(_tag, size);
+        return ptr;
+    }
+
+    void HeapAllocator::Free(void* ptr)
+    {
+        if (!ptr) {
+            return;
+        }
+
+        HeapHeader* header = static_cast<HeapHeader*>(ptr) - 1;
+        _used.fetch_sub(header->size, std::memory_order_relaxed);
+        MemoryTracker::OnFree(_tag, header->size);
+        free(header->base);
+    }
+
+    AllocatorStats HeapAllocator::GetStats() const
+    {
+        AllocatorStats stats;
+        stats.used = _used.load(std::memory_order_relaxed);
+        stats.peak = _peak.load(std::memory_order_relaxed);
+        stats.allocations = _allocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    Allocator& GetDefaultAllocator()
+    {
+        return GetTaggedAllocator(MemoryTag::General);
+    }
+
+    Allocator& GetTaggedAllocator(MemoryTag tag)
+    {
+        static HeapAllocator general(MemoryTag::General);
+        static HeapAllocator graphics(MemoryTag::Graphics);
+        static HeapAllocator content(MemoryTag::Content);
+        static HeapAllocator audio(MemoryTag::Audio);
+        static HeapAllocator script(MemoryTag::Script);
+        static HeapAllocator scene(MemoryTag::Scene);
+        static Allocator* const allocators[] = { &general, &graphics, &content, &audio, &script, &scene };
+        static_assert(sizeof(allocators) / sizeof(allocators[0]) == static_cast<size_t>(MemoryTag::Count), "Missing tagged allocator");
+
+        assert(tag < MemoryTag::Count);
+        return *allocators[static_cast<uint32_t>(tag)];
+    }
+
+    /* LinearAllocator */
+    LinearAllocator::LinearAllocator(size_t capacity, Allocator& parent)
+        : _parent(parent)
+        , _data(static_cast<uint8_t*>(parent.Allocate(capacity, 64)))
+        , _capacity(_data ? capacity : 0)
+    {
+    }
+
+    LinearAllocator::~LinearAllocator()
+    {
+        _parent.Free(_data);
+    }
+
+    void* LinearAllocator::Allocate(size_t size, size_t alignment)
+    {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(_data);
+        size_t offset = _offset.load(std::memory_order_relaxed);
+        size_t alignedOffset;
+        do
+        {
+            alignedOffset = AlignTo(base + offset, alignment) - base;
+            if (alignedOffset + size > _capacity) {
+                return nullptr;
+            }
+        } while (!_offset.compare_exchange_weak(offset, alignedOffset + size, std::memory_order_relaxed));
+
+        _allocations.fetch_add(1, std::memory_order_relaxed);
+        return _data + alignedOffset;
+    }
+
+    AllocatorStats LinearAllocator::GetStats() const
+    {
+        AllocatorStats stats;
+        stats.capacity = _capacity;
+        stats.used = _offset.load(std::memory_order_relaxed);
+        stats.peak = std::max(_peak, stats.used);
+        stats.allocations = _allocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void LinearAllocator::Reset()
+    {
+        _peak = std::max(_peak, _offset.load(std::memory_order_relaxed));
+        _offset.store(0, std::memory_order_relaxed);
+    }
+
+    /* FrameAllocator */
+    struct FrameAllocator::Frame
+    {
+        std::unique_ptr<LinearAllocator> memory;
+        std::mutex overflowMutex;
+        std::vector<void*> overflow;
+    };
+
+    FrameAllocator::FrameAllocator(size_t capacityPerFrame, uint32_t frameCount, Allocator& parent)
+        : _parent(parent)
+        , _frames(new Frame[frameCount])
+        , _frameCount(frameCount)
+    {
+        assert(frameCount > 0);
+        for (uint32_t i = 0; i < frameCount; ++i)
+        {
+            _frames[i].memory.reset(new LinearAllocator(capacityPerFrame, parent));
+        }
+    }
+
+    FrameAllocator::~FrameAllocator()
+    {
+        for (uint32_t i = 0; i < _frameCount; ++i)
+        {
+            for (void* ptr : _frames[i].overflow)
+            {
+                _parent.Free(ptr);
+            }
+        }
+    }
+
+    void* FrameAllocator::Allocate(size_t size, size_t alignment)
+    {
+        Frame& frame = _frames[_frameIndex];
+        if (void* ptr = frame.memory->Allocate(size, alignment)) {
+            return ptr;
+        }
+
+        // Region exhausted, keep going from the parent and report it so the budget can be raised.
+        void* ptr = _parent.Allocate(size, alignment);
+        if (ptr)
+        {
+            std::lock_guard<std::mutex> lock(frame.overflowMutex);
+            frame.overflow.push_back(ptr);
+        }
+
+        _overflows.fetch_add(1, std::memory_order_relaxed);
+        return ptr;
+    }
+
+    AllocatorStats FrameAllocator::GetStats() const
+    {
+        AllocatorStats stats = _frames[_frameIndex].memory->GetStats();
+        stats.peak = std::max(_peak, stats.used);
+        stats.overflows = _overflows.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void FrameAllocator::BeginFrame()
+    {
+        _peak = std::max(_peak, _frames[_frameIndex].memory->GetStats().used);
+        _frameIndex = (_frameIndex + 1) % _frameCount;
+
+        Frame& frame = _frames[_frameIndex];
+        frame.memory->Reset();
+        for (void* ptr : frame.overflow)
+        {
+            _parent.Free(ptr);
+        }
+        frame.overflow.clear();
+    }
+
+    /* StackAllocator */
+    StackAllocator::StackAllocator(size_t capacity, Allocator& parent)
+        : _parent(parent)
+        , _data(static_cast<uint8_t*>(parent.Allocate(capacity, 64)))
+        , _capacity(_data ? capacity : 0)
+    {
+    }
+
+    StackAllocator::~StackAllocator()
+    {
+        _parent.Free(_data);
+    }
+
+    void* StackAllocator::Allocate(size_t size, size_t alignment)
+    {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(_data);
+        const size_t alignedOffset = AlignTo(base + _offset, alignment) - base;
+        if (alignedOffset + size > _capacity)
+        {
+            _overflows++;
+            return nullptr;
+        }
+
+        _offset = alignedOffset + size;
+        _peak = std::max(_peak, _offset);
+        _allocations++;
+        return _data + alignedOffset;
+    }
+
+    AllocatorStats StackAllocator::GetStats() const
+    {
+        AllocatorStats stats;
+        stats.capacity = _capacity;
+        stats.used = _offset;
+        stats.peak = _peak;
+        stats.allocations = _allocations;
+        stats.overflows = _overflows;
+        return stats;
+    }
+
+    void StackAllocator::FreeToMarker(Marker marker)
+    {
+        assert(marker <= _offset);
+        _offset = marker;
+    }
+
+    StackAllocator& GetThreadScratch()
+    {
+        static constexpr size_t ScratchCapacity = 256 * 1024;
+        static thread_local StackAllocator scratch(ScratchCapacity);
+        return scratch;
+    }
+
+    /* PoolAllocator */
+    PoolAllocator::PoolAllocator(size_t blockSize, uint32_t blockCount, size_t alignment, Allocator& parent)
+        : _parent(parent)
+        , _blockSize(AlignTo(std::max(blockSize, sizeof(void*)), alignment))
+        , _alignment(alignment)
+        , _blockCount(blockCount)
+    {
+        _data = static_cast<uint8_t*>(parent.Allocate(_blockSize * blockCount, alignment));
+        if (!_data) {
+            _blockCount = 0;
+        }
+
+        // Thread the free list through the blocks, lowest address first.
+        for (uint32_t i = _blockCount; i > 0; --i)
+        {
+            void* block = _data + (i - 1) * _blockSize;
+            *static_cast<void**>(block) = _freeList;
+            _freeList = block;
+        }
+    }
+
+    PoolAllocator::~PoolAllocator()
+    {
+        _parent.Free(_data);
+    }
+
+    void* PoolAllocator::Allocate(size_t size, size_t alignment)
+    {
+        assert(size <= _blockSize && alignment <= _alignment);
+        ALIMER_UNUSED(size);
+        ALIMER_UNUSED(alignment);
+
+        if (!_freeList)
+        {
+            _overflows++;
+            return nullptr;
+        }
+
+        void* block = _freeList;
+        _freeList = *static_cast<void**>(block);
+        _usedBlocks++;
+        _peakBlocks = std::max(_peakBlocks, _usedBlocks);
+        _allocations++;
+        return block;
+    }
+
+    void PoolAllocator::Free(void* ptr)
+    {
+        if (!ptr) {
+            return;
+        }
+
+        assert(Owns(ptr));
+        *static_cast<void**>(ptr) = _freeList;
+        _freeList = ptr;
+        _usedBlocks--;
+    }
+
+    AllocatorStats PoolAllocator::GetStats() const
+    {
+        AllocatorStats stats;
+        stats.capacity = _blockSize * _blockCount;
+        stats.used = _blockSize * _usedBlocks;
+        stats.peak = _blockSize * _peakBlocks;
+        stats.allocations = _allocations;
+        stats.overflows = _overflows;
+        return stats;
+    }
+}
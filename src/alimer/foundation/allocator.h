@@ -0,0 +1,358 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/memory_tracker.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace alimer
+{
+    /// Default alignment of allocations, large enough for SIMD types.
+    static constexpr size_t DefaultAlignment = 16;
+
+    /// Round value up to the next multiple of alignment, alignment must be a power of two.
+    inline size_t AlignTo(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    /// Allocator statistics.
+    struct AllocatorStats
+    {
+        /// Bytes reserved by the allocator, 0 if unbounded.
+        size_t capacity = 0;
+        /// Bytes currently in use.
+        size_t used = 0;
+        /// Highest used value since creation.
+        size_t peak = 0;
+        /// Total number of allocations.
+        uint64_t allocations = 0;
+        /// Allocations that could not be served from the allocator memory.
+        uint64_t overflows = 0;
+    };
+
+    /// Base allocator interface.
+    class ALIMER_API Allocator
+    {
+    public:
+        /// Destructor.
+        virtual ~Allocator() = default;
+
+        /// Allocate memory, returns nullptr on failure.
+        virtual void* Allocate(size_t size, size_t alignment = DefaultAlignment) = 0;
+
+        /// Free memory, allocators that release in bulk ignore this.
+        virtual void Free(void* ptr) = 0;
+
+        /// Get allocator statistics.
+        virtual AllocatorStats GetStats() const = 0;
+
+        /// Allocate and construct an object.
+        template <typename T, typename... Args>
+        T* New(Args&&... args)
+        {
+            void* memory = Allocate(sizeof(T), alignof(T) > DefaultAlignment ? alignof(T) : DefaultAlignment);
+            return memory ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+        }
+
+        /// Destroy and free an object created with New.
+        template <typename T>
+        void Delete(T* object)
+        {
+            if (object)
+            {
+                object->~T();
+                Free(object);
+            }
+        }
+
+        /// Allocate uninitialized storage for count elements.
+        template <typename T>
+        T* AllocateArray(size_t count)
+        {
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T) > DefaultAlignment ? alignof(T) : DefaultAlignment));
+        }
+    };
+
+    /// General purpose allocator on top of the system heap, thread safe. Allocations are also reported to the MemoryTracker under its tag.
+    class ALIMER_API HeapAllocator final : public Allocator
+    {
+    public:
+        /// Constructor.
+        explicit HeapAllocator(MemoryTag tag = MemoryTag::General) : _tag(tag) {}
+
+        void* Allocate(size_t size, size_t alignment = DefaultAlignment) override;
+        void Free(void* ptr) override;
+        AllocatorStats GetStats() const override;
+
+        /// Get the tag allocations are accounted to.
+        MemoryTag GetTag() const { return _tag; }
+
+    private:
+        MemoryTag _tag;
+        std::atomic<size_t> _used{ 0 };
+        std::atomic<size_t> _peak{ 0 };
+        std::atomic<uint64_t> _allocations{ 0 };
+    };
+
+    /// Get the default heap allocator, accounted to MemoryTag::General.
+    ALIMER_API Allocator& GetDefaultAllocator();
+
+    /// Get the heap allocator accounting its allocations to tag.
+    ALIMER_API Allocator& GetTaggedAllocator(MemoryTag tag);
+
+    /// Base for types with extended alignment, gives them class operator new and delete honoring alignof(T) without C++17 aligned new.
+    /// Memory comes from the heap allocator of Tag.
+    template <typename T, MemoryTag Tag = MemoryTag::General>
+    class AlignedAllocation
+    {
+    public:
+        static void* operator new(size_t size) { return Allocate(size); }
+        static void* operator new[](size_t size) { return Allocate(size); }
+        static void operator delete(void* ptr) { GetTaggedAllocator(Tag).Free(ptr); }
+        static void operator delete[](void* ptr) { GetTaggedAllocator(Tag).Free(ptr); }
+
+    private:
+        static void* Allocate(size_t size)
+        {
+            void* ptr = GetTaggedAllocator(Tag).Allocate(size, alignof(T) > DefaultAlignment ? alignof(T) : DefaultAlignment);
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            return ptr;
+        }
+    };
+
+    /// Bump pointer allocator over a fixed block, Free is a no-op and memory is released with Reset, thread safe.
+    class ALIMER_API LinearAllocator final : public Allocator
+    {
+    public:
+        /// Constructor.
+        explicit LinearAllocator(size_t capacity, Allocator& parent = GetDefaultAllocator());
+
+        /// Destructor.
+        ~LinearAllocator() override;
+
+        LinearAllocator(const LinearAllocator&) = delete;
+        LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = DefaultAlignment) override;
+        void Free(void* ptr) override { ALIMER_UNUSED(ptr); }
+        AllocatorStats GetStats() const override;
+
+        /// Release every allocation at once.
+        void Reset();
+
+        /// Check if ptr lives inside this allocator block.
+        bool Owns(const void* ptr) const { return ptr >= _data && ptr < _data + _capacity; }
+
+    private:
+        Allocator& _parent;
+        uint8_t* _data;
+        size_t _capacity;
+        std::atomic<size_t> _offset{ 0 };
+        size_t _peak = 0;
+        std::atomic<uint64_t> _allocations{ 0 };
+    };
+
+    /// Per frame transient allocator, one linear region per frame in flight so memory the GPU may still read is not reused.
+    /// Allocations that do not fit fall back to the parent allocator and are freed when their frame comes around again.
+    class ALIMER_API FrameAllocator final : public Allocator
+    {
+    public:
+        /// Matches the swapchain image count.
+        static constexpr uint32_t DefaultFrameCount = 3;
+
+        /// Constructor.
+        FrameAllocator(size_t capacityPerFrame, uint32_t frameCount = DefaultFrameCount, Allocator& parent = GetDefaultAllocator());
+
+        /// Destructor.
+        ~FrameAllocator() override;
+
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = DefaultAlignment) override;
+        void Free(void* ptr) override { ALIMER_UNUSED(ptr); }
+
+        /// Get statistics of the current frame, peak and overflows accumulate over all frames.
+        AllocatorStats GetStats() const override;
+
+        /// Advance to the next frame region and release its previous allocations.
+        void BeginFrame();
+
+        /// Get the number of frame regions.
+        uint32_t GetFrameCount() const { return _frameCount; }
+
+        /// Get the current frame region index.
+        uint32_t GetFrameIndex() const { return _frameIndex; }
+
+    private:
+        struct Frame;
+
+        Allocator& _parent;
+        std::unique_ptr<Frame[]> _frames;
+        uint32_t _frameCount;
+        uint32_t _frameIndex = 0;
+        size_t _peak = 0;
+        std::atomic<uint64_t> _overflows{ 0 };
+    };
+
+    /// Single threaded stack allocator, allocations are released in LIFO order by rewinding to a marker.
+    class ALIMER_API StackAllocator final : public Allocator
+    {
+    public:
+        using Marker = size_t;
+
+        /// Constructor.
+        explicit StackAllocator(size_t capacity, Allocator& parent = GetDefaultAllocator());
+
+        /// Destructor.
+        ~StackAllocator() override;
+
+        StackAllocator(const StackAllocator&) = delete;
+        StackAllocator& operator=(const StackAllocator&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = DefaultAlignment) override;
+        void Free(void* ptr) override { ALIMER_UNUSED(ptr); }
+        AllocatorStats GetStats() const override;
+
+        /// Get the current top of the stack.
+        Marker GetMarker() const { return _offset; }
+
+        /// Release every allocation made after marker.
+        void FreeToMarker(Marker marker);
+
+    private:
+        Allocator& _parent;
+        uint8_t* _data;
+        size_t _capacity;
+        size_t _offset = 0;
+        size_t _peak = 0;
+        uint64_t _allocations = 0;
+        uint64_t _overflows = 0;
+    };
+
+    /// Get the scratch stack of the calling thread.
+    ALIMER_API StackAllocator& GetThreadScratch();
+
+    /// Scoped scratch memory, everything allocated through it is released when it goes out of scope.
+    class ScratchScope final
+    {
+    public:
+        ScratchScope()
+            : _allocator(GetThreadScratch())
+            , _marker(_allocator.GetMarker())
+        {
+        }
+
+        ~ScratchScope()
+        {
+            _allocator.FreeToMarker(_marker);
+        }
+
+        ScratchScope(const ScratchScope&) = delete;
+        ScratchScope& operator=(const ScratchScope&) = delete;
+
+        /// Allocate scratch memory.
+        void* Allocate(size_t size, size_t alignment = DefaultAlignment) { return _allocator.Allocate(size, alignment); }
+
+        /// Allocate uninitialized scratch storage for count elements.
+        template <typename T>
+        T* AllocateArray(size_t count) { return _allocator.AllocateArray<T>(count); }
+
+        /// Get the underlying allocator.
+        StackAllocator& GetAllocator() { return _allocator; }
+
+    private:
+        StackAllocator& _allocator;
+        StackAllocator::Marker _marker;
+    };
+
+    /// Fixed size block allocator with an intrusive free list, not thread safe.
+    class ALIMER_API PoolAllocator final : public Allocator
+    {
+    public:
+        /// Constructor.
+        PoolAllocator(size_t blockSize, uint32_t blockCount, size_t alignment = DefaultAlignment, Allocator& parent = GetDefaultAllocator());
+
+        /// Destructor.
+        ~PoolAllocator() override;
+
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        /// Allocate one block, size must not exceed the block size.
+        void* Allocate(size_t size, size_t alignment = DefaultAlignment) override;
+        void Free(void* ptr) override;
+        AllocatorStats GetStats() const override;
+
+        /// Get the block size.
+        size_t GetBlockSize() const { return _blockSize; }
+
+        /// Check if ptr lives inside this pool.
+        bool Owns(const void* ptr) const { return ptr >= _data && ptr < _data + _blockSize * _blockCount; }
+
+    private:
+        Allocator& _parent;
+        uint8_t* _data;
+        void* _freeList = nullptr;
+        size_t _blockSize;
+        size_t _alignment;
+        uint32_t _blockCount;
+        uint32_t _usedBlocks = 0;
+        uint32_t _peakBlocks = 0;
+        uint64_t _allocations = 0;
+        uint64_t _overflows = 0;
+    };
+
+    /// Typed pool of objects, not thread safe.
+    template <typename T>
+    class ObjectPool final
+    {
+    public:
+        explicit ObjectPool(uint32_t capacity, Allocator& parent = GetDefaultAllocator())
+            : _pool(sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T), capacity, alignof(T) > DefaultAlignment ? alignof(T) : DefaultAlignment, parent)
+        {
+        }
+
+        /// Create a new object, returns nullptr if the pool is exhausted.
+        template <typename... Args>
+        T* Create(Args&&... args) { return _pool.New<T>(std::forward<Args>(args)...); }
+
+        /// Destroy an object created by this pool.
+        void Destroy(T* object) { _pool.Delete(object); }
+
+        /// Get pool statistics.
+        AllocatorStats GetStats() const { return _pool.GetStats(); }
+
+    private:
+        PoolAllocator _pool;
+    };
+}
@@ -0,0 +1,587 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "foundation/job_system.h"
+#include "foundation/profiler.h"
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+#if defined(ALIMER_THREADING)
+#   include <condition_variable>
+#endif
+
+namespace alimer
+{
+    using detail::Job;
+
+    static constexpr uint32_t InvalidThreadIndex = ~0u;
+
+    /// Power of two, jobs in flight per thread and queue capacity.
+    static constexpr uint32_t MaxJobsPerThread = 4096;
+    static constexpr uint32_t JobMask = MaxJobsPerThread - 1;
+
+    static thread_local uint32_t t_threadIndex = InvalidThreadIndex;
+    static thread_local JobSystem* t_jobSystem = nullptr;
+
+    namespace
+    {
+        /// Chase-Lev work-stealing deque, the owner pushes and pops at the bottom, thieves steal from the top.
+        class WorkStealingQueue final
+        {
+        public:
+            WorkStealingQueue()
+            {
+                for (uint32_t i = 0; i < MaxJobsPerThread; ++i)
+                {
+                    _jobs[i].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            bool Push(Job* job)
+            {
+                const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+                const int64_t top = _top.load(std::memory_order_acquire);
+                if (bottom - top >= static_cast<int64_t>(MaxJobsPerThread)) {
+                    return false;
+                }
+
+                _jobs[bottom & JobMask].store(job, std::memory_order_relaxed);
+                _bottom.store(bottom + 1, std::memory_order_release);
+                return true;
+            }
+
+            Job* Pop()
+            {
+                const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+                _bottom.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t top = _top.load(std::memory_order_relaxed);
+
+                Job* job = nullptr;
+                if (top <= bottom)
+                {
+                    job = _jobs[bottom & JobMask].load(std::memory_order_relaxed);
+                    if (top == bottom)
+                    {
+                        // Last job, race against thieves.
+                        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                            job = nullptr;
+                        }
+
+                        _bottom.store(bottom + 1, std::memory_order_relaxed);
+                    }
+                }
+                else
+                {
+                    _bottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+
+                return job;
+            }
+
+            Job* Steal()
+            {
+                int64_t top = _top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const int64_t bottom = _bottom.load(std::memory_order_acquire);
+                if (top >= bottom) {
+                    return nullptr;
+                }
+
+                Job* job = _jobs[top & JobMask].load(std::memory_order_relaxed);
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    return nullptr;
+                }
+
+                return job;
+            }
+
+        private:
+            alignas(64) std::atomic<int64_t> _top{ 0 };
+            alignas(64) std::atomic<int64_t> _bottom{ 0 };
+            alignas(64) std::atomic<Job*> _jobs[MaxJobsPerThread];
+        };
+
+        struct alignas(64) ThreadContext : AlignedAllocation<ThreadContext>
+        {
+            ThreadContext()
+            {
+                for (uint32_t i = 0; i < MaxJobsPerThread; ++i)
+                {
+                    jobs[i].finished.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            WorkStealingQueue queue;
+            /// Ring of job storage, only the owner thread allocates from it.
+            Job jobs[MaxJobsPerThread];
+            uint32_t nextJob = 0;
+            uint32_t nextVictim = 0;
+
+            std::atomic<uint64_t> executed{ 0 };
+            std::atomic<uint64_t> stolen{ 0 };
+            std::atomic<uint64_t> inlined{ 0 };
+        };
+    }
+
+    struct JobSystem::Impl
+    {
+        std::unique_ptr<ThreadContext[]> contexts;
+        uint32_t threadCount = 0;
+
+        /// Jobs scheduled from threads unknown to the job system.
+        std::mutex globalMutex;
+        std::deque<Job*> globalQueue;
+        std::atomic<uint32_t> globalCount{ 0 };
+
+        /// Jobs sitting in any queue, used to put idle workers to sleep.
+        std::atomic<int32_t> pendingJobs{ 0 };
+
+        /// Jobs taken from a queue and still executing.
+        std::atomic<int32_t> activeJobs{ 0 };
+
+        /// Jobs waiting for their dependency, they stay out of the queues until it is done.
+        std::mutex parkMutex;
+        std::vector<Job*> parked;
+        std::atomic<int32_t> parkedJobs{ 0 };
+
+        /// Stats of jobs executed by threads unknown to the job system.
+        std::atomic<uint64_t> externalExecuted{ 0 };
+
+#if defined(ALIMER_THREADING)
+        std::vector<std::thread> workers;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic<uint32_t> sleepingWorkers{ 0 };
+        std::atomic<bool> running{ false };
+#endif
+
+        void PushGlobal(Job* job)
+        {
+            std::lock_guard<std::mutex> lock(globalMutex);
+            globalQueue.push_back(job);
+            globalCount.fetch_add(1, std::memory_order_release);
+        }
+
+        Job* PopGlobal()
+        {
+            if (globalCount.load(std::memory_order_acquire) == 0) {
+                return nullptr;
+            }
+
+            std::lock_guard<std::mutex> lock(globalMutex);
+            if (globalQueue.empty()) {
+                return nullptr;
+            }
+
+            Job* job = globalQueue.front();
+            globalQueue.pop_front();
+            globalCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+
+        ThreadContext* GetContext(JobSystem* system)
+        {
+            if (t_jobSystem != system || t_threadIndex == InvalidThreadIndex) {
+                return nullptr;
+            }
+
+            return &contexts[t_threadIndex];
+        }
+
+        void Wake()
+        {
+#if defined(ALIMER_THREADING)
+            if (sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                sleepCondition.notify_one();
+            }
+#endif
+        }
+
+        /// Park a job until its dependency is done, returns false if it already is.
+        bool Park(Job* job)
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+
+            // Pairs with the counter decrement in Execute: either it sees the parked job or we see the counter done.
+            parkedJobs.fetch_add(1, std::memory_order_seq_cst);
+            if (job->dependency->_value.load(std::memory_order_seq_cst) == 0)
+            {
+                parkedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            parked.push_back(job);
+            return true;
+        }
+
+        /// Take the parked jobs whose dependency is done.
+        void TakeReady(std::vector<Job*>& ready)
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            for (size_t i = 0; i < parked.size();)
+            {
+                if (parked[i]->dependency->IsDone())
+                {
+                    ready.push_back(parked[i]);
+                    parked[i] = parked.back();
+                    parked.pop_back();
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+    };
+
+    JobSystem::JobSystem()
+    {
+    }
+
+    JobSystem::~JobSystem()
+    {
+        Shutdown();
+    }
+
+    void JobSystem::Initialize(uint32_t workerCount)
+    {
+        if (_impl) {
+            return;
+        }
+
+#if defined(ALIMER_THREADING)
+        if (workerCount == AutoWorkerCount)
+        {
+            const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+#else
+        // Without threading support jobs run on the main thread while it waits.
+        workerCount = 0;
+#endif
+
+        _impl.reset(new Impl());
+        _workerCount = workerCount;
+        _impl->threadCount = workerCount + 1;
+        _impl->contexts.reset(new ThreadContext[_impl->threadCount]);
+        for (uint32_t i = 0; i < _impl->threadCount; ++i)
+        {
+            _impl->contexts[i].nextVictim = (i + 1) % _impl->threadCount;
+        }
+
+        t_threadIndex = 0;
+        t_jobSystem = this;
+
+#if defined(ALIMER_THREADING)
+        _impl->running.store(true);
+        _impl->workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            _impl->workers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+        }
+#endif
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (!_impl) {
+            return;
+        }
+
+        // Help until nothing is queued, executing or parked, running jobs may still schedule more.
+        while (_impl->pendingJobs.load(std::memory_order_acquire) > 0
+            || _impl->activeJobs.load(std::memory_order_acquire) > 0
+            || _impl->parkedJobs.load(std::memory_order_acquire) > 0)
+        {
+            if (!TryExecuteOne()) {
+                std::this_thread::yield();
+            }
+        }
+
+#if defined(ALIMER_THREADING)
+        {
+            std::lock_guard<std::mutex> lock(_impl->sleepMutex);
+            _impl->running.store(false);
+            _impl->sleepCondition.notify_all();
+        }
+
+        for (std::thread& worker : _impl->workers)
+        {
+            worker.join();
+        }
+#endif
+
+        if (t_jobSystem == this)
+        {
+            t_threadIndex = InvalidThreadIndex;
+            t_jobSystem = nullptr;
+        }
+
+        _impl.reset();
+        _workerCount = 0;
+    }
+
+    uint32_t JobSystem::GetCurrentThreadIndex()
+    {
+        return t_threadIndex;
+    }
+
+    JobSystemStats JobSystem::GetStats() const
+    {
+        JobSystemStats stats;
+        if (!_impl) {
+            return stats;
+        }
+
+        for (uint32_t i = 0; i < _impl->threadCount; ++i)
+        {
+            const ThreadContext& context = _impl->contexts[i];
+            stats.executed += context.executed.load(std::memory_order_relaxed);
+            stats.stolen += context.stolen.load(std::memory_order_relaxed);
+            stats.inlined += context.inlined.load(std::memory_order_relaxed);
+        }
+
+        stats.executed += _impl->externalExecuted.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    Job* JobSystem::AllocateJob()
+    {
+        ThreadContext* context = _impl ? _impl->GetContext(this) : nullptr;
+        if (context == nullptr)
+        {
+            Job* job = new Job();
+            job->finished.store(false, std::memory_order_relaxed);
+            job->heapAllocated = true;
+            return job;
+        }
+
+        Job* job = &context->jobs[context->nextJob & JobMask];
+        context->nextJob++;
+
+        // Every slot of the ring is in flight, help out until the oldest one finishes.
+        while (!job->finished.load(std::memory_order_acquire))
+        {
+            if (!TryExecuteOne()) {
+                std::this_thread::yield();
+            }
+        }
+
+        job->finished.store(false, std::memory_order_relaxed);
+        job->heapAllocated = false;
+        return job;
+    }
+
+    void JobSystem::Submit(Job* job)
+    {
+        if (job->counter) {
+            job->counter->_value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (!_impl)
+        {
+            Execute(job);
+            return;
+        }
+
+        if (job->dependency != nullptr && _impl->Park(job)) {
+            return;
+        }
+
+        Enqueue(job);
+    }
+
+    void JobSystem::Enqueue(Job* job)
+    {
+        ThreadContext* context = _impl->GetContext(this);
+        if (context == nullptr)
+        {
+            _impl->PushGlobal(job);
+        }
+        else if (!context->queue.Push(job))
+        {
+            context->inlined.fetch_add(1, std::memory_order_relaxed);
+            Execute(job);
+            return;
+        }
+
+        _impl->pendingJobs.fetch_add(1, std::memory_order_seq_cst);
+        _impl->Wake();
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            if (!TryExecuteOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool JobSystem::TryExecuteOne()
+    {
+        if (!_impl) {
+            return false;
+        }
+
+        ThreadContext* context = _impl->GetContext(this);
+        Job* job = nullptr;
+        bool stolen = false;
+
+        if (context != nullptr) {
+            job = context->queue.Pop();
+        }
+
+        if (job == nullptr) {
+            job = _impl->PopGlobal();
+        }
+
+        if (job == nullptr)
+        {
+            const uint32_t threadCount = _impl->threadCount;
+            uint32_t victim = context ? context->nextVictim : 0;
+            for (uint32_t i = 0; i < threadCount && job == nullptr; ++i)
+            {
+                if (context != &_impl->contexts[victim]) {
+                    job = _impl->contexts[victim].queue.Steal();
+                }
+
+                if (job == nullptr) {
+                    victim = (victim + 1) % threadCount;
+                }
+            }
+
+            if (context != nullptr) {
+                context->nextVictim = victim;
+            }
+
+            stolen = job != nullptr;
+        }
+
+        if (job == nullptr) {
+            return false;
+        }
+
+        // Counted as active before it stops being pending so Shutdown never sees both at zero while it runs.
+        _impl->activeJobs.fetch_add(1, std::memory_order_relaxed);
+        _impl->pendingJobs.fetch_sub(1, std::memory_order_release);
+
+        if (stolen && context != nullptr) {
+            context->stolen.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Execute(job);
+        _impl->activeJobs.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        {
+            ALIMER_PROFILE_SCOPE("Job");
+            job->function(job);
+        }
+
+        JobCounter* counter = job->counter;
+        if (job->heapAllocated) {
+            delete job;
+        }
+        else {
+            job->finished.store(true, std::memory_order_release);
+        }
+
+        if (counter && counter->_value.fetch_sub(1, std::memory_order_seq_cst) == 1
+            && _impl && _impl->parkedJobs.load(std::memory_order_seq_cst) > 0)
+        {
+            ReleaseParked();
+        }
+
+        ThreadContext* context = _impl ? _impl->GetContext(this) : nullptr;
+        if (context != nullptr) {
+            context->executed.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (_impl) {
+            _impl->externalExecuted.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void JobSystem::ReleaseParked()
+    {
+        std::vector<Job*> ready;
+        _impl->TakeReady(ready);
+        for (Job* job : ready)
+        {
+            // Queued before it stops counting as parked so Shutdown keeps draining.
+            Enqueue(job);
+            _impl->parkedJobs.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void JobSystem::WorkerMain(uint32_t threadIndex)
+    {
+#if defined(ALIMER_THREADING)
+        t_threadIndex = threadIndex;
+        t_jobSystem = this;
+
+#if defined(ALIMER_PROFILING)
+        const std::string threadName = "Worker " + std::to_string(threadIndex);
+        ALIMER_PROFILE_THREAD(threadName.c_str());
+#endif
+
+        static constexpr uint32_t SpinCount = 64;
+        uint32_t idleCount = 0;
+        while (_impl->running.load(std::memory_order_relaxed))
+        {
+            if (TryExecuteOne())
+            {
+                idleCount = 0;
+                continue;
+            }
+
+            if (++idleCount < SpinCount)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_impl->sleepMutex);
+            _impl->sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            _impl->sleepCondition.wait(lock, [this]() {
+                return _impl->pendingJobs.load(std::memory_order_seq_cst) > 0 || !_impl->running.load();
+            });
+            _impl->sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+            idleCount = 0;
+        }
+
+        t_threadIndex = InvalidThreadIndex;
+        t_jobSystem = nullptr;
+#else
+        (void)threadIndex;
+#endif
+    }
+}
@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "foundation/allocator.h"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace alimer
+{
+    /// Counter tracking completion of a group of jobs.
+    class ALIMER_API JobCounter final
+    {
+    public:
+        JobCounter() = default;
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        /// Check if every job tracked by this counter has finished.
+        bool IsDone() const { return _value.load(std::memory_order_acquire) == 0; }
+
+        /// Get the number of jobs still pending.
+        uint32_t GetValue() const { return _value.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> _value{ 0 };
+    };
+
+    /// Job system statistics.
+    struct JobSystemStats
+    {
+        /// Total jobs executed.
+        uint64_t executed = 0;
+        /// Jobs taken from another thread queue.
+        uint64_t stolen = 0;
+        /// Jobs executed inline because a queue was full.
+        uint64_t inlined = 0;
+    };
+
+    namespace detail
+    {
+        /// Job storage, the callable lives inline so scheduling does not allocate.
+        struct alignas(64) Job : AlignedAllocation<Job>
+        {
+            static constexpr size_t PayloadSize = 88;
+
+            void (*function)(Job* job);
+            JobCounter* counter;
+            const JobCounter* dependency;
+            std::atomic<bool> finished;
+            bool heapAllocated;
+            alignas(16) uint8_t payload[PayloadSize];
+        };
+
+        template <typename F>
+        void InvokeJob(Job* job)
+        {
+            F* function = reinterpret_cast<F*>(job->payload);
+            (*function)();
+            function->~F();
+        }
+    }
+
+    /// Work-stealing job system, one worker per core plus the thread that initialized it.
+    class ALIMER_API JobSystem final
+    {
+    public:
+        /// Use one worker per hardware thread, minus the main thread.
+        static constexpr uint32_t AutoWorkerCount = ~0u;
+
+        /// Constructor.
+        JobSystem();
+
+        /// Destructor.
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /// Start worker threads, the calling thread becomes the main thread.
+        void Initialize(uint32_t workerCount = AutoWorkerCount);
+
+        /// Stop and join worker threads.
+        void Shutdown();
+
+        /// Schedule a callable, optionally tracked by counter and started only once dependency is done.
+        template <typename F>
+        void Schedule(JobCounter* counter, F&& function, const JobCounter* dependency = nullptr)
+        {
+            using Function = typename std::decay<F>::type;
+            static_assert(sizeof(Function) <= detail::Job::PayloadSize, "Job callable is too large, capture by reference");
+            static_assert(alignof(Function) <= 16, "Job callable alignment is too large");
+
+            detail::Job* job = AllocateJob();
+            job->function = &detail::InvokeJob<Function>;
+            job->counter = counter;
+            job->dependency = dependency;
+            new (job->payload) Function(std::forward<F>(function));
+            Submit(job);
+        }
+
+        /// Wait for counter to reach zero, the calling thread executes jobs while waiting.
+        void Wait(const JobCounter& counter);
+
+        /// Split [0, count) in batches of batchSize and call function(begin, end) for each one in parallel.
+        template <typename F>
+        void ParallelFor(uint32_t count, uint32_t batchSize, const F& function)
+        {
+            if (count == 0) {
+                return;
+            }
+
+            if (batchSize == 0) {
+                batchSize = 1;
+            }
+
+            JobCounter counter;
+            for (uint32_t begin = 0; begin < count; begin += batchSize)
+            {
+                const uint32_t end = (count - begin) > batchSize ? begin + batchSize : count;
+                Schedule(&counter, [&function, begin, end]() { function(begin, end); });
+            }
+
+            Wait(counter);
+        }
+
+        /// Get the number of worker threads.
+        uint32_t GetWorkerCount() const { return _workerCount; }
+
+        /// Get the number of threads executing jobs, workers plus the main thread.
+        uint32_t GetThreadCount() const { return _workerCount + 1; }
+
+        /// Get the index of the calling thread, 0 is the main thread, ~0u for threads unknown to the job system.
+        static uint32_t GetCurrentThreadIndex();
+
+        /// Get accumulated statistics.
+        JobSystemStats GetStats() const;
+
+    private:
+        struct Impl;
+
+        detail::Job* AllocateJob();
+        void Submit(detail::Job* job);
+        void Enqueue(detail::Job* job);
+        void ReleaseParked();
+        bool TryExecuteOne();
+        void Execute(detail::Job* job);
+        void WorkerMain(uint32_t threadIndex);
+
+        std::unique_ptr<Impl> _impl;
+        uint32_t _workerCount = 0;
+    };
+}
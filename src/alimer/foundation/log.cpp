@@ -21,17 +21,203 @@
 //
 
 #include "foundation/log.h"
-#include "graphics/graphics.h"
-#include <vgpu.h>
+#include "foundation/allocator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#if defined(ALIMER_THREADING)
+#   include <chrono>
+#   include <condition_variable>
+#   include <mutex>
+#endif
+#if defined(__ANDROID__)
+#   include <android/log.h>
+#elif defined(_WIN32) || defined(_WIN64)
+#   include <windows.h>
+#endif
 
 namespace alimer
 {
+    constexpr uint32_t Logger::MaxMessageLength;
+    constexpr uint32_t Logger::MaxTagLength;
+    constexpr uint32_t Logger::QueueCapacity;
+
+    static_assert((Logger::QueueCapacity & (Logger::QueueCapacity - 1)) == 0, "Logger queue capacity must be a power of two");
+
+    namespace
+    {
+        /// Queue slot, the sequence number tells producers and the sink who owns it (bounded MPMC queue by D. Vyukov).
+        struct alignas(64) LogRecord : AlignedAllocation<LogRecord>
+        {
+            std::atomic<uint64_t> sequence;
+            LogLevel level;
+            char tag[Logger::MaxTagLength];
+            char message[Logger::MaxMessageLength];
+        };
+
+        void WriteRecord(LogLevel level, const char* tag, const char* message)
+        {
+#if defined(__ANDROID__)
+            android_LogPriority priority = ANDROID_LOG_DEFAULT;
+            switch (level)
+            {
+            case LogLevel::Trace:
+                priority = ANDROID_LOG_VERBOSE;
+                break;
+            case LogLevel::Debug:
+                priority = ANDROID_LOG_DEBUG;
+                break;
+            case LogLevel::Info:
+                priority = ANDROID_LOG_INFO;
+                break;
+            case LogLevel::Warn:
+                priority = ANDROID_LOG_WARN;
+                break;
+            case LogLevel::Error:
+                priority = ANDROID_LOG_ERROR;
+                break;
+            case LogLevel::Critical:
+                priority = ANDROID_LOG_FATAL;
+                break;
+            default:
+                priority = ANDROID_LOG_DEFAULT;
+                break;
+            }
+
+            __android_log_write(priority, tag[0] ? tag : "alimer", message);
+#else
+            const char* priority = "INFO";
+            switch (level)
+            {
+            case LogLevel::Trace:
+                priority = "TRACE";
+                break;
+            case LogLevel::Debug:
+                priority = "DEBUG";
+                break;
+            case LogLevel::Info:
+                priority = "INFO";
+                break;
+            case LogLevel::Warn:
+                priority = "WARNING";
+                break;
+            case LogLevel::Error:
+                priority = "ERROR";
+                break;
+            case LogLevel::Critical:
+                priority = "CRITICAL";
+                break;
+            default:
+                priority = "INFO";
+                break;
+            }
+
+            fprintf(stdout, "%s [%s] : %s\n", tag, priority, message);
+
+#if defined(_DEBUG) && (defined(_WIN32) || defined(_WIN64))
+            OutputDebugStringA(message);
+            OutputDebugStringA("\n");
+#endif
+#endif
+        }
+    }
+
+    struct Logger::Impl : AlignedAllocation<Logger::Impl>
+    {
+        std::unique_ptr<LogRecord[]> records;
+        alignas(64) std::atomic<uint64_t> enqueuePosition{ 0 };
+        alignas(64) std::atomic<uint64_t> dequeuePosition{ 0 };
+        std::atomic<uint64_t> written{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<uint64_t> stalled{ 0 };
+        std::atomic<uint64_t> truncated{ 0 };
+
+#if defined(ALIMER_THREADING)
+        std::thread sink;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic<bool> sinkSleeping{ false };
+        std::atomic<bool> stopping{ false };
+
+        /// Write one record if available, only called by the sink thread.
+        bool WriteOne()
+        {
+            const uint64_t position = dequeuePosition.load(std::memory_order_relaxed);
+            LogRecord& record = records[position & (QueueCapacity - 1)];
+            if (record.sequence.load(std::memory_order_acquire) != position + 1) {
+                return false;
+            }
+
+            WriteRecord(record.level, record.tag, record.message);
+            record.sequence.store(position + QueueCapacity, std::memory_order_release);
+            written.fetch_add(1, std::memory_order_relaxed);
+            dequeuePosition.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        void SinkMain()
+        {
+            for (;;)
+            {
+                while (WriteOne()) {
+                }
+
+                fflush(stdout);
+                if (stopping.load(std::memory_order_acquire))
+                {
+                    // Producers are gone, drain what is left.
+                    while (WriteOne()) {
+                    }
+                    fflush(stdout);
+                    return;
+                }
+
+                // Producers only touch the mutex when they see the sink asleep, the timeout covers a missed wake up.
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sinkSleeping.store(true, std::memory_order_seq_cst);
+                const uint64_t position = dequeuePosition.load(std::memory_order_relaxed);
+                if (records[position & (QueueCapacity - 1)].sequence.load(std::memory_order_acquire) != position + 1
+                    && !stopping.load(std::memory_order_acquire))
+                {
+                    sleepCondition.wait_for(lock, std::chrono::milliseconds(10));
+                }
+                sinkSleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        void WakeSink()
+        {
+            if (sinkSleeping.load(std::memory_order_seq_cst)) {
+                sleepCondition.notify_one();
+            }
+        }
+#endif
+    };
+
     Logger::Logger()
+        : _impl(new Impl())
     {
+        _impl->records.reset(new LogRecord[QueueCapacity]);
+        for (uint32_t i = 0; i < QueueCapacity; i++) {
+            _impl->records[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+#if defined(ALIMER_THREADING)
+        _impl->sink = std::thread(&Impl::SinkMain, _impl.get());
+#endif
     }
 
     Logger::~Logger()
     {
+#if defined(ALIMER_THREADING)
+        {
+            std::lock_guard<std::mutex> lock(_impl->sleepMutex);
+            _impl->stopping.store(true, std::memory_order_release);
+        }
+        _impl->sleepCondition.notify_one();
+        _impl->sink.join();
+#endif
     }
 
     Logger &Logger::GetDefault()
@@ -40,6 +226,12 @@ namespace alimer
         return defaultLogger;
     }
 
+    fmt::memory_buffer& Logger::GetThreadBuffer()
+    {
+        static thread_local fmt::memory_buffer buffer;
+        return buffer;
+    }
+
     void Logger::Log(LogLevel level, const std::string& message)
     {
         Log(level, "", message);
@@ -47,83 +239,102 @@ namespace alimer
 
     void Logger::Log(LogLevel level, const std::string& tag, const std::string& message)
     {
-        if (!_isEnabled || static_cast<uint8_t>(level) < static_cast<uint8_t>(_level))
-        {
+        if (!IsLevelEnabled(level)) {
             return;
         }
 
-#if defined(__ANDROID__)
-        android_LogPriority priority = ANDROID_LOG_DEFAULT;
-        switch (level)
+        Enqueue(level, tag.c_str(), message.data(), message.size());
+    }
+
+    void Logger::Enqueue(LogLevel level, const char* tag, const char* message, size_t length)
+    {
+        if (length >= MaxMessageLength)
         {
-        case LogLevel::Trace:
-            priority = ANDROID_LOG_VERBOSE;
-            break;
-        case LogLevel::Debug:
-            priority = ANDROID_LOG_DEBUG;
-            break;
-        case LogLevel::Info:
-            priority = ANDROID_LOG_INFO;
-            break;
-        case LogLevel::Warn:
-            priority = ANDROID_LOG_WARN;
-            break;
-        case LogLevel::Error:
-            priority = ANDROID_LOG_ERROR;
-            break;
-        case LogLevel::Critical:
-            priority = ANDROID_LOG_FATAL;
-            break;
-        default:
-            priority = ANDROID_LOG_DEFAULT;
-            break;
+            length = MaxMessageLength - 1;
+            _impl->truncated.fetch_add(1, std::memory_order_relaxed);
         }
 
-        const char *tag_output = tag.empty() ? "alimer" : tag.c_str();
-        const char *msg_output = message.c_str();
-        // See system/core/liblog/logger_write.c for explanation of return value
-        int ret = __android_log_write(priority, tag_output, msg_output);
-        if (ret < 0)
+#if defined(ALIMER_THREADING)
+        bool stalled = false;
+        uint64_t position = _impl->enqueuePosition.load(std::memory_order_relaxed);
+        LogRecord* record;
+        for (;;)
         {
-            ALIMER_ASSERT_FAIL("__android_log_write() failed, error: %s", ret);
+            record = &_impl->records[position & (QueueCapacity - 1)];
+            const uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+            const int64_t difference = static_cast<int64_t>(sequence - position);
+            if (difference == 0)
+            {
+                if (_impl->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Full, never block hot paths for low priority messages.
+                if (level < LogLevel::Error)
+                {
+                    _impl->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                if (!stalled)
+                {
+                    stalled = true;
+                    _impl->stalled.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                _impl->WakeSink();
+                std::this_thread::yield();
+                position = _impl->enqueuePosition.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                position = _impl->enqueuePosition.load(std::memory_order_relaxed);
+            }
         }
 
-        __android_log_write(priority, tag_.c_str(),
+        record->level = level;
+        const size_t tagLength = std::min(strlen(tag), static_cast<size_t>(MaxTagLength - 1));
+        memcpy(record->tag, tag, tagLength);
+        record->tag[tagLength] = '\0';
+        memcpy(record->message, message, length);
+        record->message[length] = '\0';
+        record->sequence.store(position + 1, std::memory_order_release);
+        _impl->WakeSink();
 #else
-        const char* priority = "INFO";
-        switch (level)
+        char buffer[MaxMessageLength];
+        memcpy(buffer, message, length);
+        buffer[length] = '\0';
+        WriteRecord(level, tag, buffer);
+        _impl->written.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    void Logger::Flush()
+    {
+#if defined(ALIMER_THREADING)
+        // Messages are claimed in order, waiting for the sink to pass the current claim position covers every earlier one.
+        const uint64_t target = _impl->enqueuePosition.load(std::memory_order_acquire);
+        while (_impl->dequeuePosition.load(std::memory_order_acquire) < target)
         {
-        case LogLevel::Trace:
-            priority = "TRACE";
-            break;
-        case LogLevel::Debug:
-            priority = "DEBUG";
-            break;
-        case LogLevel::Info:
-            priority = "INFO";
-            break;
-        case LogLevel::Warn:
-            priority = "WARNING";
-            break;
-        case LogLevel::Error:
-            priority = "ERROR";
-            break;
-        case LogLevel::Critical:
-            priority = "CRITICAL";
-            break;
-        default:
-            priority = "INFO";
-            break;
+            {
+                std::lock_guard<std::mutex> lock(_impl->sleepMutex);
+            }
+            _impl->sleepCondition.notify_one();
+            std::this_thread::yield();
         }
-        fprintf(stdout, "%s [%s] : ", tag.c_str(), priority);
-        fprintf(stdout, message.c_str());
-        fprintf(stdout, "\n");
-
-#if defined(_DEBUG) && (defined(_WIN32) || defined(_WIN64))
-        OutputDebugStringA(message.c_str());
-        OutputDebugStringA("\n");
 #endif
+        fflush(stdout);
+    }
 
-#endif
+    LoggerStats Logger::GetStats() const
+    {
+        LoggerStats stats;
+        stats.written = _impl->written.load(std::memory_order_relaxed);
+        stats.dropped = _impl->dropped.load(std::memory_order_relaxed);
+        stats.stalled = _impl->stalled.load(std::memory_order_relaxed);
+        stats.truncated = _impl->truncated.load(std::memory_order_relaxed);
+        return stats;
     }
 }
@@ -23,8 +23,10 @@
 #pragma once
 
 #include "foundation/platform.h"
+#include <fmt/format.h>
+#include <atomic>
+#include <memory>
 #include <string>
-#include <vector>
 
 namespace alimer
 {
@@ -45,49 +47,155 @@ namespace alimer
         Critical
     };
 
+    /// Logger statistics.
+    struct LoggerStats
+    {
+        /// Messages written by the sink.
+        uint64_t written = 0;
+        /// Messages discarded because the queue was full.
+        uint64_t dropped = 0;
+        /// Error and critical messages that had to wait for queue space.
+        uint64_t stalled = 0;
+        /// Messages cut to Logger::MaxMessageLength.
+        uint64_t truncated = 0;
+    };
 
-    /// Defines class for loging capabilities
+    /// Defines class for loging capabilities.
+    /// Messages are formatted on the calling thread into a thread local buffer and pushed on a lock-free queue,
+    /// a background thread writes them out. When the queue is full messages below Error are dropped and counted,
+    /// Error and Critical messages wait for space.
     class ALIMER_API Logger final
     {
     public:
+        /// Longest message kept, including the terminator, longer messages are truncated.
+        static constexpr uint32_t MaxMessageLength = 448;
+        /// Longest tag kept, including the terminator.
+        static constexpr uint32_t MaxTagLength = 32;
+        /// Number of messages the queue can hold, power of two.
+        static constexpr uint32_t QueueCapacity = 1024;
+
         /// Constructor.
         Logger();
 
-        /// Destructor.
+        /// Destructor, writes every queued message.
         virtual ~Logger();
 
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
 
         static Logger &GetDefault();
 
         void Log(LogLevel level, const std::string& message);
         void Log(LogLevel level, const std::string& tag, const std::string& message);
 
+        /// Format message with fmt and queue it, nothing is formatted when level is filtered out.
+        template <typename... Args>
+        void Write(LogLevel level, const char* tag, const char* format, const Args&... args)
+        {
+            if (!IsLevelEnabled(level)) {
+                return;
+            }
+
+            fmt::memory_buffer& buffer = GetThreadBuffer();
+            buffer.clear();
+            fmt::format_to(buffer, format, args...);
+            Enqueue(level, tag, buffer.data(), buffer.size());
+        }
+
+        /// Block until every message queued so far has been written.
+        void Flush();
+
+        /// Check if a message with given level would be logged.
+        bool IsLevelEnabled(LogLevel level) const
+        {
+            return _isEnabled.load(std::memory_order_relaxed) && level >= _level.load(std::memory_order_relaxed);
+        }
+
         /// Get if logger is enabled.
-        bool IsEnabled() const { return _isEnabled; }
+        bool IsEnabled() const { return _isEnabled.load(std::memory_order_relaxed); }
 
         /// Set logger enabled state.
-        void SetEnabled(bool value) { _isEnabled = value; }
+        void SetEnabled(bool value) { _isEnabled.store(value, std::memory_order_relaxed); }
 
         /// Get the log level.
-        LogLevel GetLevel() const { return _level; }
+        LogLevel GetLevel() const { return _level.load(std::memory_order_relaxed); }
 
         /// Set the log level.
-        void SetLevel(LogLevel value) { _level = value; }
+        void SetLevel(LogLevel value) { _level.store(value, std::memory_order_relaxed); }
+
+        /// Get accumulated statistics.
+        LoggerStats GetStats() const;
 
     private:
-        bool _isEnabled = true;
+        struct Impl;
+
+        static fmt::memory_buffer& GetThreadBuffer();
+        void Enqueue(LogLevel level, const char* tag, const char* message, size_t length);
+
+        std::unique_ptr<Impl> _impl;
+        std::atomic<bool> _isEnabled{ true };
 #ifdef _DEBUG
-        LogLevel _level = LogLevel::Debug;
+        std::atomic<LogLevel> _level{ LogLevel::Debug };
 #else
-        LogLevel _level = LogLevel::Info;
+        std::atomic<LogLevel> _level{ LogLevel::Info };
 #endif
     };
 } 
 
+// Compile time threshold, log macros below ALIMER_LOG_LEVEL compile to nothing.
+#define ALIMER_LOG_LEVEL_TRACE 0
+#define ALIMER_LOG_LEVEL_DEBUG 1
+#define ALIMER_LOG_LEVEL_INFO 2
+#define ALIMER_LOG_LEVEL_WARN 3
+#define ALIMER_LOG_LEVEL_ERROR 4
+#define ALIMER_LOG_LEVEL_CRITICAL 5
+#define ALIMER_LOG_LEVEL_OFF 6
+
+#ifndef ALIMER_LOG_LEVEL
+#   if !defined(ALIMER_LOGGING)
+#       define ALIMER_LOG_LEVEL ALIMER_LOG_LEVEL_OFF
+#   elif defined(_DEBUG)
+#       define ALIMER_LOG_LEVEL ALIMER_LOG_LEVEL_DEBUG
+#   else
+#       define ALIMER_LOG_LEVEL ALIMER_LOG_LEVEL_INFO
+#   endif
+#endif
+
 #define ALIMER_TAG "alimer"
-#define ALIMER_LOGTRACE(...) alimer::Logger::GetDefault().Log(alimer::LogLevel::Trace, ALIMER_TAG, alimer::str::Format(__VA_ARGS__))
-#define ALIMER_LOGDEBUG(...) alimer::Logger::GetDefault().Log(alimer::LogLevel::Debug, ALIMER_TAG, alimer::str::Format(__VA_ARGS__))
-#define ALIMER_LOGINFO(...) alimer::Logger::GetDefault().Log(alimer::LogLevel::Info, ALIMER_TAG, alimer::str::Format(__VA_ARGS__))
-#define ALIMER_LOGWARN(...) alimer::Logger::GetDefault().Log(alimer::LogLevel::Warn, ALIMER_TAG, alimer::str::Format(__VA_ARGS__))
-#define ALIMER_LOGERROR(...) alimer::Logger::GetDefault().Log(alimer::LogLevel::Error, ALIMER_TAG, alimer::str::Format(__VA_ARGS__))
-#define ALIMER_LOGCRITICAL(...) alimer::Logger::GetDefault().Log(alimer::LogLevel::Critical, ALIMER_TAG, alimer::str::Format(__VA_ARGS__))
+#define ALIMER_LOG(level, ...) alimer::Logger::GetDefault().Write(level, ALIMER_TAG, __VA_ARGS__)
+
+#if ALIMER_LOG_LEVEL <= ALIMER_LOG_LEVEL_TRACE
+#   define ALIMER_LOGTRACE(...) ALIMER_LOG(alimer::LogLevel::Trace, __VA_ARGS__)
+#else
+#   define ALIMER_LOGTRACE(...) ((void)0)
+#endif
+
+#if ALIMER_LOG_LEVEL <= ALIMER_LOG_LEVEL_DEBUG
+#   define ALIMER_LOGDEBUG(...) ALIMER_LOG(alimer::LogLevel::Debug, __VA_ARGS__)
+#else
+#   define ALIMER_LOGDEBUG(...) ((void)0)
+#endif
+
+#if ALIMER_LOG_LEVEL <= ALIMER_LOG_LEVEL_INFO
+#   define ALIMER_LOGINFO(...) ALIMER_LOG(alimer::LogLevel::Info, __VA_ARGS__)
+#else
+#   define ALIMER_LOGINFO(...) ((void)0)
+#endif
+
+#if ALIMER_LOG_LEVEL <= ALIMER_LOG_LEVEL_WARN
+#   define ALIMER_LOGWARN(...) ALIMER_LOG(alimer::LogLevel::Warn, __VA_ARGS__)
+#else
+#   define ALIMER_LOGWARN(...) ((void)0)
+#endif
+
+#if ALIMER_LOG_LEVEL <= ALIMER_LOG_LEVEL_ERROR
+#   define ALIMER_LOGERROR(...) ALIMER_LOG(alimer::LogLevel::Error, __VA_ARGS__)
+#else
+#   define ALIMER_LOGERROR(...) ((void)0)
+#endif
+
+#if ALIMER_LOG_LEVEL <= ALIMER_LOG_LEVEL_CRITICAL
+#   define ALIMER_LOGCRITICAL(...) ALIMER_LOG(alimer::LogLevel::Critical, __VA_ARGS__)
+#else
+#   define ALIMER_LOGCRITICAL(...) ((void)0)
+#endif
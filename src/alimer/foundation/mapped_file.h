@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+#include <string>
+
+namespace alimer
+{
+    /// Read-only memory mapping of a whole file.
+    class ALIMER_API MappedFile final
+    {
+    public:
+        /// Constructor.
+        MappedFile() = default;
+
+        /// Destructor.
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// Map the file at path, closes any previous mapping.
+        bool Open(const std::string& path);
+
+        /// Unmap the file.
+        void Close();
+
+        /// Check if a file is mapped.
+        bool IsOpen() const { return _data != nullptr; }
+
+        /// Get the mapped data.
+        const uint8_t* GetData() const { return _data; }
+
+        /// Get the mapped size in bytes.
+        size_t GetSize() const { return _size; }
+
+    private:
+        const uint8_t* _data = nullptr;
+        size_t _size = 0;
+#if defined(_WIN32)
+        void* _file = nullptr;
+        void* _mapping = nullptr;
+#endif
+    };
+}
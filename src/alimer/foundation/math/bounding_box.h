@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/matrix4.h"
+#include <float.h>
+
+namespace alimer
+{
+    /// Axis aligned bounding box.
+    struct BoundingBox
+    {
+        Vector3 min;
+        Vector3 max;
+
+        /// Construct an empty box, merging anything into it yields that thing.
+        constexpr BoundingBox() : min(FLT_MAX), max(-FLT_MAX) {}
+        constexpr BoundingBox(const Vector3& min_, const Vector3& max_) : min(min_), max(max_) {}
+
+        /// Check if the box contains anything.
+        constexpr bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+        constexpr Vector3 GetCenter() const { return (min + max) * 0.5f; }
+        constexpr Vector3 GetExtents() const { return (max - min) * 0.5f; }
+        constexpr Vector3 GetSize() const { return max - min; }
+
+        /// Get the surface area, used as cost by bounding volume hierarchies.
+        constexpr float GetSurfaceArea() const
+        {
+            return 2.0f * ((max.x - min.x) * (max.y - min.y) + (max.y - min.y) * (max.z - min.z) + (max.z - min.z) * (max.x - min.x));
+        }
+
+        void Merge(const Vector3& point)
+        {
+            min = alimer::Min(min, point);
+            max = alimer::Max(max, point);
+        }
+
+        void Merge(const BoundingBox& box)
+        {
+            min = alimer::Min(min, box.min);
+            max = alimer::Max(max, box.max);
+        }
+
+        constexpr bool Contains(const Vector3& point) const
+        {
+            return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y && point.z >= min.z && point.z <= max.z;
+        }
+
+        constexpr bool Contains(const BoundingBox& box) const
+        {
+            return box.min.x >= min.x && box.max.x <= max.x && box.min.y >= min.y && box.max.y <= max.y && box.min.z >= min.z && box.max.z <= max.z;
+        }
+
+        constexpr bool Intersects(const BoundingBox& box) const
+        {
+            return min.x <= box.max.x && max.x >= box.min.x && min.y <= box.max.y && max.y >= box.min.y && min.z <= box.max.z && max.z >= box.min.z;
+        }
+    };
+
+    /// Get the union of a and b.
+    inline BoundingBox Merge(const BoundingBox& a, const BoundingBox& b)
+    {
+        return BoundingBox(Min(a.min, b.min), Max(a.max, b.max));
+    }
+
+    /// Get the box enclosing box transformed by matrix, an empty box stays empty.
+    inline BoundingBox Transform(const BoundingBox& box, const Matrix4& matrix)
+    {
+        if (!box.IsValid()) {
+            return box;
+        }
+
+        // Transform the center, the new extents are the extents projected on the absolute matrix axes.
+        const Vector3 center = TransformPoint(matrix, box.GetCenter());
+        const Vector3 extents = box.GetExtents();
+        const float* m = matrix.m;
+        const Vector3 newExtents(
+            fabsf(m[0]) * extents.x + fabsf(m[4]) * extents.y + fabsf(m[8]) * extents.z,
+            fabsf(m[1]) * extents.x + fabsf(m[5]) * extents.y + fabsf(m[9]) * extents.z,
+            fabsf(m[2]) * extents.x + fabsf(m[6]) * extents.y + fabsf(m[10]) * extents.z);
+        return BoundingBox(center - newExtents, center + newExtents);
+    }
+}
@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/plane.h"
+
+namespace alimer
+{
+    /// View volume bounded by six inward facing planes.
+    struct Frustum
+    {
+        enum PlaneIndex
+        {
+            Left = 0,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            PlaneCount
+        };
+
+        Plane planes[PlaneCount];
+
+        /// Extract the planes of a view projection matrix, OpenGL clip space with depth in [-1, 1].
+        static Frustum FromMatrix(const Matrix4& viewProjection)
+        {
+            const float* m = viewProjection.m;
+            const Vector4 row0(m[0], m[4], m[8], m[12]);
+            const Vector4 row1(m[1], m[5], m[9], m[13]);
+            const Vector4 row2(m[2], m[6], m[10], m[14]);
+            const Vector4 row3(m[3], m[7], m[11], m[15]);
+
+            Frustum frustum;
+            const Vector4 planes[PlaneCount] = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2 };
+            for (uint32_t i = 0; i < PlaneCount; i++) {
+                frustum.planes[i] = Normalize(Plane(planes[i].x, planes[i].y, planes[i].z, planes[i].w));
+            }
+            return frustum;
+        }
+
+        /// Check if any part of box may be inside.
+        bool Intersects(const BoundingBox& box) const
+        {
+            for (const Plane& plane : planes)
+            {
+                if (plane.GetMaxDistance(box) < 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "foundation/math/math_batch.h"
+#include "foundation/math/simd_lane.h"
+
+namespace alimer
+{
+    namespace
+    {
+        using namespace simd;
+
+        /// Load element of LaneWidth consecutive matrices.
+#if ALIMER_SIMD_AVX2
+        inline Lane GatherMatrixElement(const Matrix4* matrices, uint32_t element)
+        {
+            const __m256i offsets = _mm256_setr_epi32(0, 16, 32, 48, 64, 80, 96, 112);
+            return _mm256_i32gather_ps(matrices->m + element, offsets, 4);
+        }
+#elif ALIMER_SIMD_SSE2
+        inline Lane GatherMatrixElement(const Matrix4* matrices, uint32_t element)
+        {
+            return _mm_setr_ps(matrices[0].m[element], matrices[1].m[element], matrices[2].m[element], matrices[3].m[element]);
+        }
+#elif ALIMER_SIMD_NEON
+        inline Lane GatherMatrixElement(const Matrix4* matrices, uint32_t element)
+        {
+            const float values[4] = { matrices[0].m[element], matrices[1].m[element], matrices[2].m[element], matrices[3].m[element] };
+            return vld1q_f32(values);
+        }
+#endif
+
+        inline void TransformPoint(const float* m, float x, float y, float z, float& outX, float& outY, float& outZ)
+        {
+            outX = m[0] * x + m[4] * y + m[8] * z + m[12];
+            outY = m[1] * x + m[5] * y + m[9] * z + m[13];
+            outZ = m[2] * x + m[6] * y + m[10] * z + m[14];
+        }
+
+        inline void TransformBoundingBox(const float* m, const BoundingBoxArrays& local, const BoundingBoxArrays& world, uint32_t i)
+        {
+            const float cx = (local.minX[i] + local.maxX[i]) * 0.5f;
+            const float cy = (local.minY[i] + local.maxY[i]) * 0.5f;
+            const float cz = (local.minZ[i] + local.maxZ[i]) * 0.5f;
+            const float ex = (local.maxX[i] - local.minX[i]) * 0.5f;
+            const float ey = (local.maxY[i] - local.minY[i]) * 0.5f;
+            const float ez = (local.maxZ[i] - local.minZ[i]) * 0.5f;
+
+            float wx, wy, wz;
+            TransformPoint(m, cx, cy, cz, wx, wy, wz);
+            const float nx = fabsf(m[0]) * ex + fabsf(m[4]) * ey + fabsf(m[8]) * ez;
+            const float ny = fabsf(m[1]) * ex + fabsf(m[5]) * ey + fabsf(m[9]) * ez;
+            const float nz = fabsf(m[2]) * ex + fabsf(m[6]) * ey + fabsf(m[10]) * ez;
+            world.minX[i] = wx - nx;
+            world.minY[i] = wy - ny;
+            world.minZ[i] = wz - nz;
+            world.maxX[i] = wx + nx;
+            world.maxY[i] = wy + ny;
+            world.maxZ[i] = wz + nz;
+        }
+    }
+
+    void TransformPoints(const Matrix4& matrix, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ, uint32_t count)
+    {
+        const float* m = matrix.m;
+        uint32_t i = 0;
+#if ALIMER_SIMD_SSE2 || ALIMER_SIMD_NEON
+        const Lane m0 = Splat(m[0]), m1 = Splat(m[1]), m2 = Splat(m[2]);
+        const Lane m4 = Splat(m[4]), m5 = Splat(m[5]), m6 = Splat(m[6]);
+        const Lane m8 = Splat(m[8]), m9 = Splat(m[9]), m10 = Splat(m[10]);
+        const Lane m12 = Splat(m[12]), m13 = Splat(m[13]), m14 = Splat(m[14]);
+        for (; i + LaneWidth <= count; i += LaneWidth)
+        {
+            const Lane px = Load(x + i);
+            const Lane py = Load(y + i);
+            const Lane pz = Load(z + i);
+            Store(outX + i, MulAdd(m0, px, MulAdd(m4, py, MulAdd(m8, pz, m12))));
+            Store(outY + i, MulAdd(m1, px, MulAdd(m5, py, MulAdd(m9, pz, m13))));
+            Store(outZ + i, MulAdd(m2, px, MulAdd(m6, py, MulAdd(m10, pz, m14))));
+        }
+#endif
+        for (; i < count; i++) {
+            TransformPoint(m, x[i], y[i], z[i], outX[i], outY[i], outZ[i]);
+        }
+    }
+
+    void MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* result, uint32_t count)
+    {
+#if ALIMER_SIMD_AVX2
+        // Matrices are only 16 byte aligned. Two result columns per 256 bit register, element k of each b column is broadcast within its half.
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a[i].m));
+            const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a[i].m + 4));
+            const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a[i].m + 8));
+            const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a[i].m + 12));
+            const __m256 b01 = _mm256_loadu_ps(b[i].m);
+            const __m256 b23 = _mm256_loadu_ps(b[i].m + 8);
+
+            __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)));
+            r01 = MulAdd(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)), r01);
+            r01 = MulAdd(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2)), r01);
+            r01 = MulAdd(a3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3)), r01);
+            __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0)));
+            r23 = MulAdd(a1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1)), r23);
+            r23 = MulAdd(a2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2)), r23);
+            r23 = MulAdd(a3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3)), r23);
+
+            _mm256_storeu_ps(result[i].m, r01);
+            _mm256_storeu_ps(result[i].m + 8, r23);
+        }
+#else
+        for (uint32_t i = 0; i < count; i++) {
+            result[i] = Multiply(a[i], b[i]);
+        }
+#endif
+    }
+
+    void TransformBoundingBoxes(const Matrix4* matrices, const BoundingBoxArrays& local, const BoundingBoxArrays& world, uint32_t count)
+    {
+        uint32_t i = 0;
+#if ALIMER_SIMD_SSE2 || ALIMER_SIMD_NEON
+        const Lane half = Splat(0.5f);
+        for (; i + LaneWidth <= count; i += LaneWidth)
+        {
+            const Lane minX = Load(local.minX + i), maxX = Load(local.maxX + i);
+            const Lane minY = Load(local.minY + i), maxY = Load(local.maxY + i);
+            const Lane minZ = Load(local.minZ + i), maxZ = Load(local.maxZ + i);
+            const Lane cx = Mul(Add(minX, maxX), half);
+            const Lane cy = Mul(Add(minY, maxY), half);
+            const Lane cz = Mul(Add(minZ, maxZ), half);
+            const Lane ex = Mul(Sub(maxX, minX), half);
+            const Lane ey = Mul(Sub(maxY, minY), half);
+            const Lane ez = Mul(Sub(maxZ, minZ), half);
+
+            // Matrices are transposed into lanes, one register per element of the upper 3x4 part.
+            const Matrix4* m = matrices + i;
+            const Lane m0 = GatherMatrixElement(m, 0), m1 = GatherMatrixElement(m, 1), m2 = GatherMatrixElement(m, 2);
+            const Lane m4 = GatherMatrixElement(m, 4), m5 = GatherMatrixElement(m, 5), m6 = GatherMatrixElement(m, 6);
+            const Lane m8 = GatherMatrixElement(m, 8), m9 = GatherMatrixElement(m, 9), m10 = GatherMatrixElement(m, 10);
+            const Lane m12 = GatherMatrixElement(m, 12), m13 = GatherMatrixElement(m, 13), m14 = GatherMatrixElement(m, 14);
+
+            const Lane wx = MulAdd(m0, cx, MulAdd(m4, cy, MulAdd(m8, cz, m12)));
+            const Lane wy = MulAdd(m1, cx, MulAdd(m5, cy, MulAdd(m9, cz, m13)));
+            const Lane wz = MulAdd(m2, cx, MulAdd(m6, cy, MulAdd(m10, cz, m14)));
+            const Lane nx = MulAdd(Abs(m0), ex, MulAdd(Abs(m4), ey, Mul(Abs(m8), ez)));
+            const Lane ny = MulAdd(Abs(m1), ex, MulAdd(Abs(m5), ey, Mul(Abs(m9), ez)));
+            const Lane nz = MulAdd(Abs(m2), ex, MulAdd(Abs(m6), ey, Mul(Abs(m10), ez)));
+
+            Store(world.minX + i, Sub(wx, nx));
+            Store(world.minY + i, Sub(wy, ny));
+            Store(world.minZ + i, Sub(wz, nz));
+            Store(world.maxX + i, Add(wx, nx));
+            Store(world.maxY + i, Add(wy, ny));
+            Store(world.maxZ + i, Add(wz, nz));
+        }
+#endif
+        for (; i < count; i++) {
+            TransformBoundingBox(matrices[i].m, local, world, i);
+        }
+    }
+
+    BoundingBox ComputeBoundingBox(const float* x, const float* y, const float* z, uint32_t count)
+    {
+        BoundingBox result;
+        uint32_t i = 0;
+#if ALIMER_SIMD_SSE2 || ALIMER_SIMD_NEON
+        if (count >= LaneWidth)
+        {
+            Lane minX = Load(x), minY = Load(y), minZ = Load(z);
+            Lane maxX = minX, maxY = minY, maxZ = minZ;
+            for (i = LaneWidth; i + LaneWidth <= count; i += LaneWidth)
+            {
+                const Lane px = Load(x + i);
+                const Lane py = Load(y + i);
+                const Lane pz = Load(z + i);
+                minX = Min(minX, px);
+                minY = Min(minY, py);
+                minZ = Min(minZ, pz);
+                maxX = Max(maxX, px);
+                maxY = Max(maxY, py);
+                maxZ = Max(maxZ, pz);
+            }
+
+            float lanes[6][LaneWidth];
+            Store(lanes[0], minX);
+            Store(lanes[1], minY);
+            Store(lanes[2], minZ);
+            Store(lanes[3], maxX);
+            Store(lanes[4], maxY);
+            Store(lanes[5], maxZ);
+            for (uint32_t lane = 0; lane < LaneWidth; lane++)
+            {
+                result.min = alimer::Min(result.min, Vector3(lanes[0][lane], lanes[1][lane], lanes[2][lane]));
+                result.max = alimer::Max(result.max, Vector3(lanes[3][lane], lanes[4][lane], lanes[5][lane]));
+            }
+        }
+#endif
+        for (; i < count; i++) {
+            result.Merge(Vector3(x[i], y[i], z[i]));
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/bounding_box.h"
+
+namespace alimer
+{
+    /// Bounding boxes stored as structure of arrays, one array per bound component.
+    struct BoundingBoxArrays
+    {
+        float* minX;
+        float* minY;
+        float* minZ;
+        float* maxX;
+        float* maxY;
+        float* maxZ;
+    };
+
+    /// Transform count points stored as x, y and z arrays by matrix, the output may alias the input.
+    ALIMER_API void TransformPoints(const Matrix4& matrix, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ, uint32_t count);
+
+    /// Compute result[i] = a[i] * b[i], result may alias a or b.
+    ALIMER_API void MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* result, uint32_t count);
+
+    /// Compute the world bounds of count local boxes, box i transformed by matrices[i]. Input boxes must be valid, world may alias local.
+    ALIMER_API void TransformBoundingBoxes(const Matrix4* matrices, const BoundingBoxArrays& local, const BoundingBoxArrays& world, uint32_t count);
+
+    /// Compute the bounds of count points stored as x, y and z arrays.
+    ALIMER_API BoundingBox ComputeBoundingBox(const float* x, const float* y, const float* z, uint32_t count);
+}
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+#include <math.h>
+
+namespace alimer
+{
+    static constexpr float Pi = 3.14159265358979323846f;
+    static constexpr float HalfPi = Pi * 0.5f;
+    static constexpr float TwoPi = Pi * 2.0f;
+    static constexpr float Epsilon = 1e-6f;
+
+    /// Convert degrees to radians.
+    inline constexpr float ToRadians(float degrees) { return degrees * (Pi / 180.0f); }
+
+    /// Convert radians to degrees.
+    inline constexpr float ToDegrees(float radians) { return radians * (180.0f / Pi); }
+
+    template <typename T>
+    inline constexpr T Min(T a, T b) { return a < b ? a : b; }
+
+    template <typename T>
+    inline constexpr T Max(T a, T b) { return a > b ? a : b; }
+
+    template <typename T>
+    inline constexpr T Clamp(T value, T low, T high) { return value < low ? low : (value > high ? high : value); }
+
+    /// Linear interpolation between a and b.
+    inline constexpr float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+    /// Check if a and b are equal within epsilon.
+    inline bool Equals(float a, float b, float epsilon = Epsilon) { return fabsf(a - b) <= epsilon; }
+}
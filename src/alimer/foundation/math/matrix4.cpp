@@ -0,0 +1,268 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "foundation/math/matrix4.h"
+
+#if ALIMER_SIMD_SSE2
+#   include <emmintrin.h>
+#elif ALIMER_SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace alimer
+{
+    Matrix4 Matrix4::Translation(const Vector3& translation)
+    {
+        Matrix4 result;
+        result.m[12] = translation.x;
+        result.m[13] = translation.y;
+        result.m[14] = translation.z;
+        return result;
+    }
+
+    Matrix4 Matrix4::Scale(const Vector3& scale)
+    {
+        Matrix4 result;
+        result.m[0] = scale.x;
+        result.m[5] = scale.y;
+        result.m[10] = scale.z;
+        return result;
+    }
+
+    Matrix4 Matrix4::Rotation(const Quaternion& rotation)
+    {
+        return Compose(Vector3(0.0f), rotation, Vector3(1.0f));
+    }
+
+    Matrix4 Matrix4::Compose(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+    {
+        const float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+        const float xx = x * x, yy = y * y, zz = z * z;
+        const float xy = x * y, xz = x * z, yz = y * z;
+        const float wx = w * x, wy = w * y, wz = w * z;
+
+        Matrix4 result;
+        result.m[0] = (1.0f - 2.0f * (yy + zz)) * scale.x;
+        result.m[1] = 2.0f * (xy + wz) * scale.x;
+        result.m[2] = 2.0f * (xz - wy) * scale.x;
+        result.m[3] = 0.0f;
+        result.m[4] = 2.0f * (xy - wz) * scale.y;
+        result.m[5] = (1.0f - 2.0f * (xx + zz)) * scale.y;
+        result.m[6] = 2.0f * (yz + wx) * scale.y;
+        result.m[7] = 0.0f;
+        result.m[8] = 2.0f * (xz + wy) * scale.z;
+        result.m[9] = 2.0f * (yz - wx) * scale.z;
+        result.m[10] = (1.0f - 2.0f * (xx + yy)) * scale.z;
+        result.m[11] = 0.0f;
+        result.m[12] = translation.x;
+        result.m[13] = translation.y;
+        result.m[14] = translation.z;
+        result.m[15] = 1.0f;
+        return result;
+    }
+
+    Matrix4 Matrix4::LookAt(const Vector3& eye, const Vector3& target, const Vector3& up)
+    {
+        const Vector3 forward = Normalize(target - eye);
+        const Vector3 right = Normalize(Cross(forward, up));
+        const Vector3 cameraUp = Cross(right, forward);
+        return Matrix4(
+            Vector4(right.x, cameraUp.x, -forward.x, 0.0f),
+            Vector4(right.y, cameraUp.y, -forward.y, 0.0f),
+            Vector4(right.z, cameraUp.z, -forward.z, 0.0f),
+            Vector4(-Dot(right, eye), -Dot(cameraUp, eye), Dot(forward, eye), 1.0f));
+    }
+
+    Matrix4 Matrix4::Perspective(float fovY, float aspect, float zNear, float zFar)
+    {
+        const float f = 1.0f / tanf(fovY * 0.5f);
+        const float range = zNear - zFar;
+        return Matrix4(
+            Vector4(f / aspect, 0.0f, 0.0f, 0.0f),
+            Vector4(0.0f, f, 0.0f, 0.0f),
+            Vector4(0.0f, 0.0f, (zFar + zNear) / range, -1.0f),
+            Vector4(0.0f, 0.0f, 2.0f * zFar * zNear / range, 0.0f));
+    }
+
+    Matrix4 Matrix4::Orthographic(float left, float right, float bottom, float top, float zNear, float zFar)
+    {
+        return Matrix4(
+            Vector4(2.0f / (right - left), 0.0f, 0.0f, 0.0f),
+            Vector4(0.0f, 2.0f / (top - bottom), 0.0f, 0.0f),
+            Vector4(0.0f, 0.0f, -2.0f / (zFar - zNear), 0.0f),
+            Vector4(-(right + left) / (right - left), -(top + bottom) / (top - bottom), -(zFar + zNear) / (zFar - zNear), 1.0f));
+    }
+
+    Matrix4 Multiply(const Matrix4& a, const Matrix4& b)
+    {
+        Matrix4 result;
+#if ALIMER_SIMD_SSE2
+        const __m128 a0 = _mm_load_ps(a.m);
+        const __m128 a1 = _mm_load_ps(a.m + 4);
+        const __m128 a2 = _mm_load_ps(a.m + 8);
+        const __m128 a3 = _mm_load_ps(a.m + 12);
+        for (uint32_t column = 0; column < 4; column++)
+        {
+            const float* bc = b.m + column * 4;
+            __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+            r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+            r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+            _mm_store_ps(result.m + column * 4, r);
+        }
+#elif ALIMER_SIMD_NEON
+        const float32x4_t a0 = vld1q_f32(a.m);
+        const float32x4_t a1 = vld1q_f32(a.m + 4);
+        const float32x4_t a2 = vld1q_f32(a.m + 8);
+        const float32x4_t a3 = vld1q_f32(a.m + 12);
+        for (uint32_t column = 0; column < 4; column++)
+        {
+            const float32x4_t bc = vld1q_f32(b.m + column * 4);
+            float32x4_t r = vmulq_lane_f32(a0, vget_low_f32(bc), 0);
+            r = vmlaq_lane_f32(r, a1, vget_low_f32(bc), 1);
+            r = vmlaq_lane_f32(r, a2, vget_high_f32(bc), 0);
+            r = vmlaq_lane_f32(r, a3, vget_high_f32(bc), 1);
+            vst1q_f32(result.m + column * 4, r);
+        }
+#else
+        for (uint32_t column = 0; column < 4; column++)
+        {
+            for (uint32_t row = 0; row < 4; row++)
+            {
+                result.m[column * 4 + row] =
+                    a.m[row] * b.m[column * 4] +
+                    a.m[4 + row] * b.m[column * 4 + 1] +
+                    a.m[8 + row] * b.m[column * 4 + 2] +
+                    a.m[12 + row] * b.m[column * 4 + 3];
+            }
+        }
+#endif
+        return result;
+    }
+
+    Vector4 Transform(const Matrix4& matrix, const Vector4& v)
+    {
+#if ALIMER_SIMD_SSE2
+        __m128 r = _mm_mul_ps(_mm_load_ps(matrix.m), _mm_set1_ps(v.x));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(matrix.m + 4), _mm_set1_ps(v.y)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(matrix.m + 8), _mm_set1_ps(v.z)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(matrix.m + 12), _mm_set1_ps(v.w)));
+        Vector4 result;
+        _mm_storeu_ps(&result.x, r);
+        return result;
+#elif ALIMER_SIMD_NEON
+        float32x4_t r = vmulq_n_f32(vld1q_f32(matrix.m), v.x);
+        r = vmlaq_n_f32(r, vld1q_f32(matrix.m + 4), v.y);
+        r = vmlaq_n_f32(r, vld1q_f32(matrix.m + 8), v.z);
+        r = vmlaq_n_f32(r, vld1q_f32(matrix.m + 12), v.w);
+        Vector4 result;
+        vst1q_f32(&result.x, r);
+        return result;
+#else
+        const float* m = matrix.m;
+        return Vector4(
+            m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+            m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+            m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+            m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w);
+#endif
+    }
+
+    Matrix4 Transpose(const Matrix4& matrix)
+    {
+        Matrix4 result;
+        for (uint32_t row = 0; row < 4; row++)
+        {
+            for (uint32_t column = 0; column < 4; column++) {
+                result.m[row * 4 + column] = matrix.m[column * 4 + row];
+            }
+        }
+        return result;
+    }
+
+    Matrix4 Inverse(const Matrix4& matrix)
+    {
+        // Cofactor expansion using 2x2 sub determinants of the lower and upper halves.
+        const float* m = matrix.m;
+        const float s0 = m[0] * m[5] - m[4] * m[1];
+        const float s1 = m[0] * m[9] - m[8] * m[1];
+        const float s2 = m[0] * m[13] - m[12] * m[1];
+        const float s3 = m[4] * m[9] - m[8] * m[5];
+        const float s4 = m[4] * m[13] - m[12] * m[5];
+        const float s5 = m[8] * m[13] - m[12] * m[9];
+        const float c5 = m[10] * m[15] - m[14] * m[11];
+        const float c4 = m[6] * m[15] - m[14] * m[7];
+        const float c3 = m[6] * m[11] - m[10] * m[7];
+        const float c2 = m[2] * m[15] - m[14] * m[3];
+        const float c1 = m[2] * m[11] - m[10] * m[3];
+        const float c0 = m[2] * m[7] - m[6] * m[3];
+
+        const float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (fabsf(determinant) < 1e-12f) {
+            return Matrix4();
+        }
+
+        const float invDet = 1.0f / determinant;
+        Matrix4 result;
+        float* r = result.m;
+        r[0] = (m[5] * c5 - m[9] * c4 + m[13] * c3) * invDet;
+        r[4] = (-m[4] * c5 + m[8] * c4 - m[12] * c3) * invDet;
+        r[8] = (m[7] * s5 - m[11] * s4 + m[15] * s3) * invDet;
+        r[12] = (-m[6] * s5 + m[10] * s4 - m[14] * s3) * invDet;
+        r[1] = (-m[1] * c5 + m[9] * c2 - m[13] * c1) * invDet;
+        r[5] = (m[0] * c5 - m[8] * c2 + m[12] * c1) * invDet;
+        r[9] = (-m[3] * s5 + m[11] * s2 - m[15] * s1) * invDet;
+        r[13] = (m[2] * s5 - m[10] * s2 + m[14] * s1) * invDet;
+        r[2] = (m[1] * c4 - m[5] * c2 + m[13] * c0) * invDet;
+        r[6] = (-m[0] * c4 + m[4] * c2 - m[12] * c0) * invDet;
+        r[10] = (m[3] * s4 - m[7] * s2 + m[15] * s0) * invDet;
+        r[14] = (-m[2] * s4 + m[6] * s2 - m[14] * s0) * invDet;
+        r[3] = (-m[1] * c3 + m[5] * c1 - m[9] * c0) * invDet;
+        r[7] = (m[0] * c3 - m[4] * c1 + m[8] * c0) * invDet;
+        r[11] = (-m[3] * s3 + m[7] * s1 - m[11] * s0) * invDet;
+        r[15] = (m[2] * s3 - m[6] * s1 + m[10] * s0) * invDet;
+        return result;
+    }
+
+    Matrix4 InverseAffine(const Matrix4& matrix)
+    {
+        // Inverse of the 3x3 part is its transpose divided by the squared column scales.
+        const float* m = matrix.m;
+        Matrix4 result;
+        for (uint32_t column = 0; column < 3; column++)
+        {
+            const Vector3 axis(m[column * 4], m[column * 4 + 1], m[column * 4 + 2]);
+            const float lengthSquared = LengthSquared(axis);
+            const float invScale = lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f;
+            result.m[column] = axis.x * invScale;
+            result.m[4 + column] = axis.y * invScale;
+            result.m[8 + column] = axis.z * invScale;
+        }
+
+        const Vector3 translation = TransformVector(result, matrix.GetTranslation());
+        result.m[12] = -translation.x;
+        result.m[13] = -translation.y;
+        result.m[14] = -translation.z;
+        return result;
+    }
+}
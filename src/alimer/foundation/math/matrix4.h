@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/quaternion.h"
+
+namespace alimer
+{
+    /// 4x4 matrix stored column major to match GLSL, vectors are column vectors transformed as M * v.
+    struct alignas(16) Matrix4
+    {
+        /// Element at row r and column c is m[c * 4 + r].
+        float m[16];
+
+        /// Construct identity.
+        Matrix4()
+            : m{ 1.0f, 0.0f, 0.0f, 0.0f,
+                 0.0f, 1.0f, 0.0f, 0.0f,
+                 0.0f, 0.0f, 1.0f, 0.0f,
+                 0.0f, 0.0f, 0.0f, 1.0f }
+        {
+        }
+
+        /// Construct from columns.
+        Matrix4(const Vector4& c0, const Vector4& c1, const Vector4& c2, const Vector4& c3)
+            : m{ c0.x, c0.y, c0.z, c0.w,
+                 c1.x, c1.y, c1.z, c1.w,
+                 c2.x, c2.y, c2.z, c2.w,
+                 c3.x, c3.y, c3.z, c3.w }
+        {
+        }
+
+        float& operator()(uint32_t row, uint32_t column) { return m[column * 4 + row]; }
+        float operator()(uint32_t row, uint32_t column) const { return m[column * 4 + row]; }
+
+        Vector4 GetColumn(uint32_t index) const { return Vector4(m[index * 4], m[index * 4 + 1], m[index * 4 + 2], m[index * 4 + 3]); }
+        Vector3 GetTranslation() const { return Vector3(m[12], m[13], m[14]); }
+        const float* Data() const { return m; }
+
+        static Matrix4 Identity() { return Matrix4(); }
+        static Matrix4 Translation(const Vector3& translation);
+        static Matrix4 Scale(const Vector3& scale);
+        static Matrix4 Rotation(const Quaternion& rotation);
+
+        /// Create translation * rotation * scale.
+        static Matrix4 Compose(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+
+        /// Create a right handed view matrix looking from eye at target.
+        static Matrix4 LookAt(const Vector3& eye, const Vector3& target, const Vector3& up);
+
+        /// Create a right handed perspective projection, OpenGL clip space with depth in [-1, 1].
+        static Matrix4 Perspective(float fovY, float aspect, float zNear, float zFar);
+
+        /// Create a right handed orthographic projection, OpenGL clip space with depth in [-1, 1].
+        static Matrix4 Orthographic(float left, float right, float bottom, float top, float zNear, float zFar);
+    };
+
+    /// Multiply matrices, the result applies b first.
+    ALIMER_API Matrix4 Multiply(const Matrix4& a, const Matrix4& b);
+
+    /// Get the inverse, the identity when the matrix is singular.
+    ALIMER_API Matrix4 Inverse(const Matrix4& matrix);
+
+    /// Get the inverse of a matrix made of rotation, translation and positive scale.
+    ALIMER_API Matrix4 InverseAffine(const Matrix4& matrix);
+
+    ALIMER_API Matrix4 Transpose(const Matrix4& matrix);
+
+    /// Transform a four component vector.
+    ALIMER_API Vector4 Transform(const Matrix4& matrix, const Vector4& v);
+
+    inline Matrix4 operator*(const Matrix4& a, const Matrix4& b) { return Multiply(a, b); }
+    inline Vector4 operator*(const Matrix4& a, const Vector4& v) { return Transform(a, v); }
+
+    /// Transform a point, w is assumed to be 1 and the projective divide is skipped.
+    inline Vector3 TransformPoint(const Matrix4& matrix, const Vector3& p)
+    {
+        const float* m = matrix.m;
+        return Vector3(
+            m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+            m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+            m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+    }
+
+    /// Transform a direction, translation is ignored.
+    inline Vector3 TransformVector(const Matrix4& matrix, const Vector3& v)
+    {
+        const float* m = matrix.m;
+        return Vector3(
+            m[0] * v.x + m[4] * v.y + m[8] * v.z,
+            m[1] * v.x + m[5] * v.y + m[9] * v.z,
+            m[2] * v.x + m[6] * v.y + m[10] * v.z);
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/bounding_box.h"
+
+namespace alimer
+{
+    /// Plane of points p where Dot(normal, p) + distance == 0, the normal side is positive.
+    struct Plane
+    {
+        Vector3 normal;
+        float distance;
+
+        constexpr Plane() : normal(0.0f, 1.0f, 0.0f), distance(0.0f) {}
+        constexpr Plane(const Vector3& normal_, float distance_) : normal(normal_), distance(distance_) {}
+        constexpr Plane(float a, float b, float c, float d) : normal(a, b, c), distance(d) {}
+
+        /// Create from a normalized normal and a point on the plane.
+        static constexpr Plane FromPointNormal(const Vector3& point, const Vector3& normal)
+        {
+            return Plane(normal, -Dot(normal, point));
+        }
+
+        /// Create from three points in counter clockwise order.
+        static Plane FromPoints(const Vector3& a, const Vector3& b, const Vector3& c)
+        {
+            return FromPointNormal(a, alimer::Normalize(Cross(b - a, c - a)));
+        }
+
+        /// Get the signed distance to point, only a true distance when the plane is normalized.
+        constexpr float GetDistance(const Vector3& point) const { return Dot(normal, point) + distance; }
+
+        /// Get the signed distance of the box corner furthest along the normal, negative when the whole box is behind.
+        float GetMaxDistance(const BoundingBox& box) const
+        {
+            const Vector3 center = box.GetCenter();
+            const Vector3 extents = box.GetExtents();
+            return GetDistance(center) + fabsf(normal.x) * extents.x + fabsf(normal.y) * extents.y + fabsf(normal.z) * extents.z;
+        }
+    };
+
+    /// Scale the plane so its normal has unit length.
+    inline Plane Normalize(const Plane& plane)
+    {
+        const float length = Length(plane.normal);
+        return length > 0.0f ? Plane(plane.normal * (1.0f / length), plane.distance / length) : plane;
+    }
+}
@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/vector.h"
+
+namespace alimer
+{
+    /// Rotation quaternion, w is the scalar part.
+    struct Quaternion
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+
+        constexpr Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+        constexpr Quaternion(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+        /// Get the identity rotation.
+        static constexpr Quaternion Identity() { return Quaternion(); }
+
+        /// Create a rotation of angle radians around a normalized axis.
+        static Quaternion FromAxisAngle(const Vector3& axis, float angle)
+        {
+            const float s = sinf(angle * 0.5f);
+            return Quaternion(axis.x * s, axis.y * s, axis.z * s, cosf(angle * 0.5f));
+        }
+
+        /// Create a rotation from euler angles in radians, applied in Z, X then Y order.
+        static Quaternion FromEuler(float pitch, float yaw, float roll)
+        {
+            return FromAxisAngle(Vector3(0.0f, 1.0f, 0.0f), yaw) * FromAxisAngle(Vector3(1.0f, 0.0f, 0.0f), pitch) * FromAxisAngle(Vector3(0.0f, 0.0f, 1.0f), roll);
+        }
+
+        /// Combine rotations, the result applies rhs first.
+        constexpr Quaternion operator*(const Quaternion& rhs) const
+        {
+            return Quaternion(
+                w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+                w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+                w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w,
+                w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z);
+        }
+
+        constexpr Quaternion operator*(float rhs) const { return Quaternion(x * rhs, y * rhs, z * rhs, w * rhs); }
+        constexpr Quaternion operator+(const Quaternion& rhs) const { return Quaternion(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w); }
+        constexpr Quaternion operator-() const { return Quaternion(-x, -y, -z, -w); }
+        constexpr bool operator==(const Quaternion& rhs) const { return x == rhs.x && y == rhs.y && z == rhs.z && w == rhs.w; }
+        constexpr bool operator!=(const Quaternion& rhs) const { return !(*this == rhs); }
+
+        /// Rotate v.
+        constexpr Vector3 operator*(const Vector3& v) const
+        {
+            // v + 2w(q x v) + 2q x (q x v)
+            return v + Cross(Vector3(x, y, z), v) * (2.0f * w) + Cross(Vector3(x, y, z), Cross(Vector3(x, y, z), v)) * 2.0f;
+        }
+    };
+
+    inline constexpr float Dot(const Quaternion& a, const Quaternion& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    /// Get the inverse of a unit quaternion.
+    inline constexpr Quaternion Conjugate(const Quaternion& q) { return Quaternion(-q.x, -q.y, -q.z, q.w); }
+
+    inline Quaternion Normalize(const Quaternion& q)
+    {
+        const float length = sqrtf(Dot(q, q));
+        return length > 0.0f ? q * (1.0f / length) : Quaternion();
+    }
+
+    /// Interpolate along the shortest arc, falls back to normalized lerp for nearly equal rotations.
+    inline Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t)
+    {
+        float cosTheta = Dot(a, b);
+        Quaternion end = b;
+        if (cosTheta < 0.0f)
+        {
+            cosTheta = -cosTheta;
+            end = -b;
+        }
+
+        if (cosTheta > 0.9995f) {
+            return Normalize(a * (1.0f - t) + end * t);
+        }
+
+        const float theta = acosf(cosTheta);
+        const float sinTheta = sinf(theta);
+        return a * (sinf((1.0f - t) * theta) / sinTheta) + end * (sinf(t * theta) / sinTheta);
+    }
+}
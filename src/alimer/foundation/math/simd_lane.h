@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/math_helpers.h"
+
+#if ALIMER_SIMD_AVX2
+#   include <immintrin.h>
+#elif ALIMER_SIMD_SSE2
+#   include <emmintrin.h>
+#elif ALIMER_SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace alimer
+{
+    /// Widest float vector available, kernels process LaneWidth elements per step and finish with a scalar tail.
+    /// Without SIMD a lane is a single float so kernels written against it still compile.
+    namespace simd
+    {
+#if ALIMER_SIMD_AVX2
+        using Lane = __m256;
+        static constexpr uint32_t LaneWidth = 8;
+
+        inline Lane Load(const float* p) { return _mm256_loadu_ps(p); }
+        inline void Store(float* p, Lane v) { _mm256_storeu_ps(p, v); }
+        inline Lane Splat(float value) { return _mm256_set1_ps(value); }
+        inline Lane Add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+        inline Lane Sub(Lane a, Lane b) { return _mm256_sub_ps(a, b); }
+        inline Lane Mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+#   if defined(__FMA__)
+        inline Lane MulAdd(Lane a, Lane b, Lane c) { return _mm256_fmadd_ps(a, b, c); }
+#   else
+        inline Lane MulAdd(Lane a, Lane b, Lane c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#   endif
+        inline Lane Min(Lane a, Lane b) { return _mm256_min_ps(a, b); }
+        inline Lane Max(Lane a, Lane b) { return _mm256_max_ps(a, b); }
+        inline Lane Abs(Lane a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+
+        /// Bit i is set when lane i of a is less than lane i of b.
+        inline uint32_t LessMask(Lane a, Lane b) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ))); }
+#elif ALIMER_SIMD_SSE2
+        using Lane = __m128;
+        static constexpr uint32_t LaneWidth = 4;
+
+        inline Lane Load(const float* p) { return _mm_loadu_ps(p); }
+        inline void Store(float* p, Lane v) { _mm_storeu_ps(p, v); }
+        inline Lane Splat(float value) { return _mm_set1_ps(value); }
+        inline Lane Add(Lane a, Lane b) { return _mm_add_ps(a, b); }
+        inline Lane Sub(Lane a, Lane b) { return _mm_sub_ps(a, b); }
+        inline Lane Mul(Lane a, Lane b) { return _mm_mul_ps(a, b); }
+        inline Lane MulAdd(Lane a, Lane b, Lane c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        inline Lane Min(Lane a, Lane b) { return _mm_min_ps(a, b); }
+        inline Lane Max(Lane a, Lane b) { return _mm_max_ps(a, b); }
+        inline Lane Abs(Lane a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        inline uint32_t LessMask(Lane a, Lane b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a, b))); }
+#elif ALIMER_SIMD_NEON
+        using Lane = float32x4_t;
+        static constexpr uint32_t LaneWidth = 4;
+
+        inline Lane Load(const float* p) { return vld1q_f32(p); }
+        inline void Store(float* p, Lane v) { vst1q_f32(p, v); }
+        inline Lane Splat(float value) { return vdupq_n_f32(value); }
+        inline Lane Add(Lane a, Lane b) { return vaddq_f32(a, b); }
+        inline Lane Sub(Lane a, Lane b) { return vsubq_f32(a, b); }
+        inline Lane Mul(Lane a, Lane b) { return vmulq_f32(a, b); }
+        inline Lane MulAdd(Lane a, Lane b, Lane c) { return vmlaq_f32(c, a, b); }
+        inline Lane Min(Lane a, Lane b) { return vminq_f32(a, b); }
+        inline Lane Max(Lane a, Lane b) { return vmaxq_f32(a, b); }
+        inline Lane Abs(Lane a) { return vabsq_f32(a); }
+
+        inline uint32_t LessMask(Lane a, Lane b)
+        {
+            static const uint32_t bits[4] = { 1, 2, 4, 8 };
+            const uint32x4_t masked = vandq_u32(vcltq_f32(a, b), vld1q_u32(bits));
+            const uint32x2_t sum = vpadd_u32(vget_low_u32(masked), vget_high_u32(masked));
+            return vget_lane_u32(vpadd_u32(sum, sum), 0);
+        }
+#else
+        using Lane = float;
+        static constexpr uint32_t LaneWidth = 1;
+
+        inline Lane Load(const float* p) { return *p; }
+        inline void Store(float* p, Lane v) { *p = v; }
+        inline Lane Splat(float value) { return value; }
+        inline Lane Add(Lane a, Lane b) { return a + b; }
+        inline Lane Sub(Lane a, Lane b) { return a - b; }
+        inline Lane Mul(Lane a, Lane b) { return a * b; }
+        inline Lane MulAdd(Lane a, Lane b, Lane c) { return a * b + c; }
+        inline Lane Min(Lane a, Lane b) { return a < b ? a : b; }
+        inline Lane Max(Lane a, Lane b) { return a > b ? a : b; }
+        inline Lane Abs(Lane a) { return fabsf(a); }
+        inline uint32_t LessMask(Lane a, Lane b) { return a < b ? 1u : 0u; }
+#endif
+    }
+}
@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/math_helpers.h"
+
+namespace alimer
+{
+    /// Two component vector.
+    struct Vector2
+    {
+        float x;
+        float y;
+
+        constexpr Vector2() : x(0.0f), y(0.0f) {}
+        constexpr Vector2(float x_, float y_) : x(x_), y(y_) {}
+        explicit constexpr Vector2(float value) : x(value), y(value) {}
+
+        constexpr Vector2 operator-() const { return Vector2(-x, -y); }
+        constexpr Vector2 operator+(const Vector2& rhs) const { return Vector2(x + rhs.x, y + rhs.y); }
+        constexpr Vector2 operator-(const Vector2& rhs) const { return Vector2(x - rhs.x, y - rhs.y); }
+        constexpr Vector2 operator*(const Vector2& rhs) const { return Vector2(x * rhs.x, y * rhs.y); }
+        constexpr Vector2 operator*(float rhs) const { return Vector2(x * rhs, y * rhs); }
+        constexpr Vector2 operator/(float rhs) const { return Vector2(x / rhs, y / rhs); }
+        Vector2& operator+=(const Vector2& rhs) { x += rhs.x; y += rhs.y; return *this; }
+        Vector2& operator-=(const Vector2& rhs) { x -= rhs.x; y -= rhs.y; return *this; }
+        Vector2& operator*=(float rhs) { x *= rhs; y *= rhs; return *this; }
+        constexpr bool operator==(const Vector2& rhs) const { return x == rhs.x && y == rhs.y; }
+        constexpr bool operator!=(const Vector2& rhs) const { return !(*this == rhs); }
+
+        const float* Data() const { return &x; }
+    };
+
+    /// Three component vector.
+    struct Vector3
+    {
+        float x;
+        float y;
+        float z;
+
+        constexpr Vector3() : x(0.0f), y(0.0f), z(0.0f) {}
+        constexpr Vector3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+        explicit constexpr Vector3(float value) : x(value), y(value), z(value) {}
+
+        constexpr Vector3 operator-() const { return Vector3(-x, -y, -z); }
+        constexpr Vector3 operator+(const Vector3& rhs) const { return Vector3(x + rhs.x, y + rhs.y, z + rhs.z); }
+        constexpr Vector3 operator-(const Vector3& rhs) const { return Vector3(x - rhs.x, y - rhs.y, z - rhs.z); }
+        constexpr Vector3 operator*(const Vector3& rhs) const { return Vector3(x * rhs.x, y * rhs.y, z * rhs.z); }
+        constexpr Vector3 operator*(float rhs) const { return Vector3(x * rhs, y * rhs, z * rhs); }
+        constexpr Vector3 operator/(float rhs) const { return Vector3(x / rhs, y / rhs, z / rhs); }
+        Vector3& operator+=(const Vector3& rhs) { x += rhs.x; y += rhs.y; z += rhs.z; return *this; }
+        Vector3& operator-=(const Vector3& rhs) { x -= rhs.x; y -= rhs.y; z -= rhs.z; return *this; }
+        Vector3& operator*=(float rhs) { x *= rhs; y *= rhs; z *= rhs; return *this; }
+        constexpr bool operator==(const Vector3& rhs) const { return x == rhs.x && y == rhs.y && z == rhs.z; }
+        constexpr bool operator!=(const Vector3& rhs) const { return !(*this == rhs); }
+
+        const float* Data() const { return &x; }
+    };
+
+    /// Four component vector.
+    struct Vector4
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+
+        constexpr Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+        constexpr Vector4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+        constexpr Vector4(const Vector3& xyz, float w_) : x(xyz.x), y(xyz.y), z(xyz.z), w(w_) {}
+        explicit constexpr Vector4(float value) : x(value), y(value), z(value), w(value) {}
+
+        constexpr Vector3 Xyz() const { return Vector3(x, y, z); }
+
+        constexpr Vector4 operator-() const { return Vector4(-x, -y, -z, -w); }
+        constexpr Vector4 operator+(const Vector4& rhs) const { return Vector4(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w); }
+        constexpr Vector4 operator-(const Vector4& rhs) const { return Vector4(x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w); }
+        constexpr Vector4 operator*(const Vector4& rhs) const { return Vector4(x * rhs.x, y * rhs.y, z * rhs.z, w * rhs.w); }
+        constexpr Vector4 operator*(float rhs) const { return Vector4(x * rhs, y * rhs, z * rhs, w * rhs); }
+        constexpr Vector4 operator/(float rhs) const { return Vector4(x / rhs, y / rhs, z / rhs, w / rhs); }
+        Vector4& operator+=(const Vector4& rhs) { x += rhs.x; y += rhs.y; z += rhs.z; w += rhs.w; return *this; }
+        Vector4& operator-=(const Vector4& rhs) { x -= rhs.x; y -= rhs.y; z -= rhs.z; w -= rhs.w; return *this; }
+        Vector4& operator*=(float rhs) { x *= rhs; y *= rhs; z *= rhs; w *= rhs; return *this; }
+        constexpr bool operator==(const Vector4& rhs) const { return x == rhs.x && y == rhs.y && z == rhs.z && w == rhs.w; }
+        constexpr bool operator!=(const Vector4& rhs) const { return !(*this == rhs); }
+
+        const float* Data() const { return &x; }
+    };
+
+    inline constexpr float Dot(const Vector2& a, const Vector2& b) { return a.x * b.x + a.y * b.y; }
+    inline constexpr float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline constexpr float Dot(const Vector4& a, const Vector4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    inline constexpr Vector3 Cross(const Vector3& a, const Vector3& b)
+    {
+        return Vector3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+
+    template <typename T>
+    inline float LengthSquared(const T& v) { return Dot(v, v); }
+
+    template <typename T>
+    inline float Length(const T& v) { return sqrtf(Dot(v, v)); }
+
+    /// Normalize v, zero length vectors are returned unchanged.
+    template <typename T>
+    inline T Normalize(const T& v)
+    {
+        const float length = Length(v);
+        return length > 0.0f ? v * (1.0f / length) : v;
+    }
+
+    inline constexpr Vector2 Min(const Vector2& a, const Vector2& b) { return Vector2(Min(a.x, b.x), Min(a.y, b.y)); }
+    inline constexpr Vector3 Min(const Vector3& a, const Vector3& b) { return Vector3(Min(a.x, b.x), Min(a.y, b.y), Min(a.z, b.z)); }
+    inline constexpr Vector4 Min(const Vector4& a, const Vector4& b) { return Vector4(Min(a.x, b.x), Min(a.y, b.y), Min(a.z, b.z), Min(a.w, b.w)); }
+    inline constexpr Vector2 Max(const Vector2& a, const Vector2& b) { return Vector2(Max(a.x, b.x), Max(a.y, b.y)); }
+    inline constexpr Vector3 Max(const Vector3& a, const Vector3& b) { return Vector3(Max(a.x, b.x), Max(a.y, b.y), Max(a.z, b.z)); }
+    inline constexpr Vector4 Max(const Vector4& a, const Vector4& b) { return Vector4(Max(a.x, b.x), Max(a.y, b.y), Max(a.z, b.z), Max(a.w, b.w)); }
+
+    template <typename T>
+    inline constexpr T Lerp(const T& a, const T& b, float t) { return a + (b - a) * t; }
+
+    inline Vector3 Abs(const Vector3& v) { return Vector3(fabsf(v.x), fabsf(v.y), fabsf(v.z)); }
+}
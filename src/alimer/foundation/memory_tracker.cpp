@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "foundation/memory_tracker.h"
+#include <atomic>
+#include <assert.h>
+
+namespace alimer
+{
+    namespace
+    {
+        static constexpr uint32_t TagCount = static_cast<uint32_t>(MemoryTag::Count);
+
+        /// One cache line per tag so subsystems allocating on different threads do not contend.
+        struct alignas(64) TagCounters
+        {
+            std::atomic<size_t> liveBytes{ 0 };
+            std::atomic<size_t> peakBytes{ 0 };
+            std::atomic<uint64_t> allocations{ 0 };
+            std::atomic<uint64_t> frees{ 0 };
+            std::atomic<uint64_t> allocatedBytes{ 0 };
+
+            /// Main thread only.
+            uint64_t frameStartAllocations = 0;
+            uint64_t frameStartBytes = 0;
+            uint64_t frameAllocations = 0;
+            uint64_t frameBytes = 0;
+        };
+
+        TagCounters s_counters[TagCount];
+
+        const char* s_tagNames[TagCount] = {
+            "General",
+            "Graphics",
+            "Content",
+            "Audio",
+            "Script",
+            "Scene"
+        };
+
+        TagCounters& GetCounters(MemoryTag tag)
+        {
+            assert(tag < MemoryTag::Count);
+            return s_counters[static_cast<uint32_t>(tag)];
+        }
+    }
+
+    void MemoryTracker::OnAllocate(MemoryTag tag, size_t size)
+    {
+        TagCounters& counters = GetCounters(tag);
+        const size_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        // Only a new high water mark pays for the compare exchange.
+        size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void MemoryTracker::OnFree(MemoryTag tag, size_t size)
+    {
+        TagCounters& counters = GetCounters(tag);
+        counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        counters.frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::EndFrame()
+    {
+        for (TagCounters& counters : s_counters)
+        {
+            const uint64_t allocations = counters.allocations.load(std::memory_order_relaxed);
+            const uint64_t bytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+            counters.frameAllocations = allocations - counters.frameStartAllocations;
+            counters.frameBytes = bytes - counters.frameStartBytes;
+            counters.frameStartAllocations = allocations;
+            counters.frameStartBytes = bytes;
+        }
+    }
+
+    MemoryTagStats MemoryTracker::GetStats(MemoryTag tag)
+    {
+        const TagCounters& counters = GetCounters(tag);
+        MemoryTagStats stats;
+        stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+        stats.frees = counters.frees.load(std::memory_order_relaxed);
+        stats.frameAllocations = counters.frameAllocations;
+        stats.frameBytes = counters.frameBytes;
+        return stats;
+    }
+
+    MemoryTagStats MemoryTracker::GetTotalStats()
+    {
+        // Tags peak at different times, the total peak is an upper bound.
+        MemoryTagStats total;
+        for (uint32_t i = 0; i < TagCount; ++i)
+        {
+            const MemoryTagStats stats = GetStats(static_cast<MemoryTag>(i));
+            total.liveBytes += stats.liveBytes;
+            total.peakBytes += stats.peakBytes;
+            total.allocations += stats.allocations;
+            total.frees += stats.frees;
+            total.frameAllocations += stats.frameAllocations;
+            total.frameBytes += stats.frameBytes;
+        }
+        return total;
+    }
+
+    const char* MemoryTracker::GetTagName(MemoryTag tag)
+    {
+        assert(tag < MemoryTag::Count);
+        return s_tagNames[static_cast<uint32_t>(tag)];
+    }
+}
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+#include <cstddef>
+#include <new>
+
+namespace alimer
+{
+    /// Engine subsystem an allocation is accounted to.
+    enum class MemoryTag : uint32_t
+    {
+        General = 0,
+        Graphics,
+        Content,
+        Audio,
+        Script,
+        Scene,
+        Count
+    };
+
+    /// Memory statistics of one tag.
+    struct MemoryTagStats
+    {
+        /// Bytes currently allocated.
+        size_t liveBytes = 0;
+        /// Highest liveBytes value since startup.
+        size_t peakBytes = 0;
+        /// Total allocations and frees since startup.
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        /// Allocations and bytes allocated during the last completed frame.
+        uint64_t frameAllocations = 0;
+        uint64_t frameBytes = 0;
+    };
+
+    /// Tagged allocation tracker, counters are relaxed atomics kept on their own cache line per tag so it can stay enabled in shipping builds.
+    /// OnAllocate and OnFree are thread safe, EndFrame and the per frame values of GetStats belong to the main thread.
+    class ALIMER_API MemoryTracker final
+    {
+    public:
+        MemoryTracker() = delete;
+
+        /// Record an allocation of size bytes.
+        static void OnAllocate(MemoryTag tag, size_t size);
+
+        /// Record the release of size bytes.
+        static void OnFree(MemoryTag tag, size_t size);
+
+        /// Close the current frame and compute per frame allocation rates.
+        static void EndFrame();
+
+        /// Get the statistics of a tag.
+        static MemoryTagStats GetStats(MemoryTag tag);
+
+        /// Get the sum of every tag.
+        static MemoryTagStats GetTotalStats();
+
+        /// Get the display name of a tag.
+        static const char* GetTagName(MemoryTag tag);
+    };
+
+    /// Standard library allocator accounting its memory to Tag.
+    template <typename T, MemoryTag Tag>
+    class MemoryTagAllocator
+    {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = MemoryTagAllocator<U, Tag>;
+        };
+
+        MemoryTagAllocator() noexcept = default;
+
+        template <typename U>
+        MemoryTagAllocator(const MemoryTagAllocator<U, Tag>&) noexcept {}
+
+        T* allocate(size_t count)
+        {
+            T* ptr = static_cast<T*>(::operator new(count * sizeof(T)));
+            MemoryTracker::OnAllocate(Tag, count * sizeof(T));
+            return ptr;
+        }
+
+        void deallocate(T* ptr, size_t count) noexcept
+        {
+            MemoryTracker::OnFree(Tag, count * sizeof(T));
+            ::operator delete(ptr);
+        }
+
+        template <typename U>
+        bool operator==(const MemoryTagAllocator<U, Tag>&) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const MemoryTagAllocator<U, Tag>&) const noexcept { return false; }
+    };
+}
@@ -59,6 +59,25 @@
 #   endif
 #endif
 
+// SIMD, define ALIMER_NO_SIMD to force the scalar paths
+#define ALIMER_SIMD_SSE2 0
+#define ALIMER_SIMD_AVX2 0
+#define ALIMER_SIMD_NEON 0
+
+#if !defined(ALIMER_NO_SIMD)
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       undef ALIMER_SIMD_SSE2
+#       define ALIMER_SIMD_SSE2 1
+#       if defined(__AVX2__)
+#           undef ALIMER_SIMD_AVX2
+#           define ALIMER_SIMD_AVX2 1
+#       endif
+#   elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#       undef ALIMER_SIMD_NEON
+#       define ALIMER_SIMD_NEON 1
+#   endif
+#endif
+
 // Misc
 #define ALIMER_UNUSED(x) (void)(true ? (void)0 : ((void)(x)))
 
@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "foundation/profiler.h"
+
+#if defined(ALIMER_PROFILING)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace alimer
+{
+    constexpr uint32_t Profiler::EventsPerThread;
+
+    namespace
+    {
+        struct ProfileSlot
+        {
+            std::atomic<const char*> name;
+            std::atomic<uint64_t> begin;
+            std::atomic<uint64_t> end;
+        };
+
+        /// Single writer ring, the exporter uses reserved to detect slots overwritten while it was copying them.
+        struct ThreadBuffer
+        {
+            std::unique_ptr<ProfileSlot[]> slots;
+            std::atomic<uint64_t> reserved{ 0 };
+            std::atomic<uint64_t> written{ 0 };
+            uint32_t id = 0;
+            std::string name;
+        };
+
+        struct ProfilerState
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> threads;
+            std::atomic<bool> enabled{ true };
+            std::atomic<uint64_t> lastFrame{ 0 };
+            std::atomic<uint64_t> frameIndex{ 0 };
+            uint64_t calibrationTicks;
+            std::chrono::steady_clock::time_point calibrationTime;
+
+            ProfilerState()
+                : calibrationTicks(Profiler::GetTimestamp())
+                , calibrationTime(std::chrono::steady_clock::now())
+            {
+            }
+        };
+
+        struct ZoneRecord
+        {
+            const char* name;
+            uint64_t begin;
+            uint64_t end;
+            uint32_t thread;
+        };
+
+        thread_local ThreadBuffer* t_buffer = nullptr;
+
+        ProfilerState& GetState()
+        {
+            static ProfilerState state;
+            return state;
+        }
+
+        ThreadBuffer* GetThreadBuffer()
+        {
+            if (t_buffer != nullptr) {
+                return t_buffer;
+            }
+
+            std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+            buffer->slots.reset(new ProfileSlot[Profiler::EventsPerThread]);
+
+            ProfilerState& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            buffer->id = static_cast<uint32_t>(state.threads.size());
+            buffer->name = "Thread " + std::to_string(buffer->id);
+            t_buffer = buffer.get();
+            state.threads.push_back(std::move(buffer));
+            return t_buffer;
+        }
+
+        double GetTicksPerMicrosecond(ProfilerState& state)
+        {
+#if ALIMER_PROFILER_RDTSC
+            // Calibrate the TSC against the steady clock over the whole session.
+            auto now = std::chrono::steady_clock::now();
+            if (now - state.calibrationTime < std::chrono::milliseconds(10))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                now = std::chrono::steady_clock::now();
+            }
+
+            const uint64_t ticks = Profiler::GetTimestamp() - state.calibrationTicks;
+            const double microseconds = std::chrono::duration<double, std::micro>(now - state.calibrationTime).count();
+            return static_cast<double>(ticks) / microseconds;
+#else
+            ALIMER_UNUSED(state);
+            return 1000.0;
+#endif
+        }
+
+        void WriteEscaped(FILE* file, const char* text)
+        {
+            for (; *text; ++text)
+            {
+                const char c = *text;
+                if (c == '"' || c == '\\') {
+                    fputc('\\', file);
+                }
+
+                if (static_cast<unsigned char>(c) >= 0x20) {
+                    fputc(c, file);
+                }
+            }
+        }
+    }
+
+    void Profiler::AddZone(const char* name, uint64_t begin, uint64_t end)
+    {
+        if (!GetState().enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        ThreadBuffer* buffer = GetThreadBuffer();
+        const uint64_t index = buffer->written.load(std::memory_order_relaxed);
+        buffer->reserved.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        ProfileSlot& slot = buffer->slots[index & (EventsPerThread - 1)];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin.store(begin, std::memory_order_relaxed);
+        slot.end.store(end, std::memory_order_relaxed);
+        buffer->written.store(index + 1, std::memory_order_release);
+    }
+
+    void Profiler::MarkFrame()
+    {
+        ProfilerState& state = GetState();
+        const uint64_t now = GetTimestamp();
+        const uint64_t last = state.lastFrame.exchange(now, std::memory_order_relaxed);
+        state.frameIndex.fetch_add(1, std::memory_order_relaxed);
+        if (last != 0) {
+            AddZone("Frame", last, now);
+        }
+    }
+
+    uint64_t Profiler::GetFrameIndex()
+    {
+        return GetState().frameIndex.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::SetThreadName(const char* name)
+    {
+        ThreadBuffer* buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(GetState().mutex);
+        buffer->name = name;
+    }
+
+    bool Profiler::IsEnabled()
+    {
+        return GetState().enabled.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::SetEnabled(bool value)
+    {
+        GetState().enabled.store(value, std::memory_order_relaxed);
+    }
+
+    bool Profiler::WriteChromeTrace(const std::string& path)
+    {
+        ProfilerState& state = GetState();
+        std::vector<ZoneRecord> zones;
+        std::vector<std::pair<uint32_t, std::string>> threadNames;
+        {
+            // Threads keep recording while we copy, zones overwritten during the copy are discarded.
+            std::lock_guard<std::mutex> lock(state.mutex);
+            for (const std::unique_ptr<ThreadBuffer>& buffer : state.threads)
+            {
+                threadNames.emplace_back(buffer->id, buffer->name);
+
+                const uint64_t written = buffer->written.load(std::memory_order_acquire);
+                const uint64_t first = written > EventsPerThread ? written - EventsPerThread : 0;
+                const size_t start = zones.size();
+                for (uint64_t index = first; index < written; index++)
+                {
+                    const ProfileSlot& slot = buffer->slots[index & (EventsPerThread - 1)];
+                    zones.push_back({ slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed), buffer->id });
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64_t reserved = buffer->reserved.load(std::memory_order_relaxed);
+                const uint64_t valid = reserved > EventsPerThread ? reserved - EventsPerThread : 0;
+                if (valid > first) {
+                    zones.erase(zones.begin() + start, zones.begin() + start + static_cast<size_t>(std::min(valid, written) - first));
+                }
+            }
+        }
+
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+
+        uint64_t baseTicks = ~0ull;
+        for (const ZoneRecord& zone : zones) {
+            baseTicks = std::min(baseTicks, zone.begin);
+        }
+
+        const double ticksPerMicrosecond = GetTicksPerMicrosecond(state);
+        fputs("{\"traceEvents\":[\n", file);
+        bool first = true;
+        for (const auto& thread : threadNames)
+        {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"", first ? "" : ",\n", thread.first);
+            WriteEscaped(file, thread.second.c_str());
+            fputs("\"}}", file);
+            first = false;
+        }
+
+        for (const ZoneRecord& zone : zones)
+        {
+            const double timestamp = static_cast<double>(zone.begin - baseTicks) / ticksPerMicrosecond;
+            const double duration = static_cast<double>(zone.end - zone.begin) / ticksPerMicrosecond;
+            fputs(first ? "{\"name\":\"" : ",\n{\"name\":\"", file);
+            WriteEscaped(file, zone.name);
+            fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", zone.thread, timestamp, duration);
+            first = false;
+        }
+
+        fputs("\n]}\n", file);
+        return fclose(file) == 0;
+    }
+}
+#endif
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+
+#if defined(ALIMER_PROFILING)
+#include <string>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <intrin.h>
+#   define ALIMER_PROFILER_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#   define ALIMER_PROFILER_RDTSC 1
+#else
+#   include <chrono>
+#   define ALIMER_PROFILER_RDTSC 0
+#endif
+
+namespace alimer
+{
+    /// Zone based CPU profiler.
+    /// Zones are written to a lock-free ring buffer owned by the calling thread, each thread keeps its
+    /// last EventsPerThread zones. Zone names are stored by pointer and must outlive the profiler, use literals.
+    class ALIMER_API Profiler final
+    {
+    public:
+        /// Zones kept per thread, older ones are overwritten.
+        static constexpr uint32_t EventsPerThread = 1u << 16;
+
+        Profiler() = delete;
+
+        /// Get a timestamp in ticks, TSC on x86 and nanoseconds elsewhere.
+        static uint64_t GetTimestamp()
+        {
+#if ALIMER_PROFILER_RDTSC
+            return __rdtsc();
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        /// Record a completed zone on the calling thread.
+        static void AddZone(const char* name, uint64_t begin, uint64_t end);
+
+        /// Mark the end of a frame, recorded as a "Frame" zone spanning the previous mark.
+        static void MarkFrame();
+
+        /// Get the number of MarkFrame calls.
+        static uint64_t GetFrameIndex();
+
+        /// Name the calling thread in exported traces.
+        static void SetThreadName(const char* name);
+
+        /// Get if zones are recorded.
+        static bool IsEnabled();
+
+        /// Set if zones are recorded.
+        static void SetEnabled(bool value);
+
+        /// Write the zones currently held by every thread as Chrome trace JSON, viewable in chrome://tracing or Perfetto.
+        static bool WriteChromeTrace(const std::string& path);
+    };
+
+    /// Records a zone from construction to destruction.
+    class ProfileScope final
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : _name(name)
+            , _begin(Profiler::GetTimestamp())
+        {
+        }
+
+        ~ProfileScope()
+        {
+            Profiler::AddZone(_name, _begin, Profiler::GetTimestamp());
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* _name;
+        uint64_t _begin;
+    };
+}
+
+#define ALIMER_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ALIMER_PROFILE_CONCAT(a, b) ALIMER_PROFILE_CONCAT_IMPL(a, b)
+#define ALIMER_PROFILE_SCOPE(name) alimer::ProfileScope ALIMER_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define ALIMER_PROFILE_FUNCTION() ALIMER_PROFILE_SCOPE(__FUNCTION__)
+#define ALIMER_PROFILE_FRAME() alimer::Profiler::MarkFrame()
+#define ALIMER_PROFILE_THREAD(name) alimer::Profiler::SetThreadName(name)
+#else
+#define ALIMER_PROFILE_SCOPE(name) ((void)0)
+#define ALIMER_PROFILE_FUNCTION() ((void)0)
+#define ALIMER_PROFILE_FRAME() ((void)0)
+#define ALIMER_PROFILE_THREAD(name) ((void)0)
+#endif
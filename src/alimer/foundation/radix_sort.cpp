@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "foundation/radix_sort.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace alimer
+{
+    namespace
+    {
+        static constexpr uint32_t RadixPasses = 8;
+        static constexpr uint32_t ParallelBlockSize = 16 * 1024;
+        static constexpr uint32_t MaxBlocks = 64;
+
+        void Scatter(const uint64_t* sourceKeys, const uint32_t* sourceValues, uint64_t* keys, uint32_t* values,
+            uint32_t begin, uint32_t end, uint32_t shift, uint32_t* offsets)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const uint64_t key = sourceKeys[i];
+                const uint32_t destination = offsets[(key >> shift) & 0xff]++;
+                keys[destination] = key;
+                values[destination] = sourceValues[i];
+            }
+        }
+    }
+
+    void RadixSort(uint64_t* keys, uint32_t* values, uint64_t* keyScratch, uint32_t* valueScratch, uint32_t count, JobSystem* jobs)
+    {
+        if (count < 2) {
+            return;
+        }
+
+        // Global digit counts decide which passes can be skipped, they do not depend on the key order.
+        uint32_t histograms[RadixPasses][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const uint64_t key = keys[i];
+            for (uint32_t pass = 0; pass < RadixPasses; pass++) {
+                histograms[pass][(key >> (pass * 8)) & 0xff]++;
+            }
+        }
+
+        uint32_t blockCount = 1;
+        if (jobs && jobs->GetThreadCount() > 1) {
+            blockCount = std::min(std::min((count + ParallelBlockSize - 1) / ParallelBlockSize, jobs->GetThreadCount() * 2), MaxBlocks);
+        }
+        const uint32_t blockSize = (count + blockCount - 1) / blockCount;
+
+        std::vector<uint32_t> blockOffsets;
+        if (blockCount > 1) {
+            blockOffsets.resize(blockCount * 256);
+        }
+
+        uint64_t* sourceKeys = keys;
+        uint32_t* sourceValues = values;
+        uint64_t* destinationKeys = keyScratch;
+        uint32_t* destinationValues = valueScratch;
+        for (uint32_t pass = 0; pass < RadixPasses; pass++)
+        {
+            const uint32_t shift = pass * 8;
+            uint32_t* histogram = histograms[pass];
+            if (histogram[(sourceKeys[0] >> shift) & 0xff] == count) {
+                continue;
+            }
+
+            if (blockCount == 1)
+            {
+                uint32_t offset = 0;
+                for (uint32_t digit = 0; digit < 256; digit++)
+                {
+                    const uint32_t digitCount = histogram[digit];
+                    histogram[digit] = offset;
+                    offset += digitCount;
+                }
+
+                Scatter(sourceKeys, sourceValues, destinationKeys, destinationValues, 0, count, shift, histogram);
+            }
+            else
+            {
+                // Count the digits of every block in parallel, then every block scatters to its own slice of each digit range.
+                uint32_t* offsets = blockOffsets.data();
+                jobs->ParallelFor(blockCount, 1, [=](uint32_t begin, uint32_t end) {
+                    for (uint32_t block = begin; block < end; block++)
+                    {
+                        uint32_t* blockHistogram = offsets + block * 256;
+                        memset(blockHistogram, 0, sizeof(uint32_t) * 256);
+                        const uint32_t last = std::min(count, (block + 1) * blockSize);
+                        for (uint32_t i = block * blockSize; i < last; i++) {
+                            blockHistogram[(sourceKeys[i] >> shift) & 0xff]++;
+                        }
+                    }
+                });
+
+                uint32_t offset = 0;
+                for (uint32_t digit = 0; digit < 256; digit++)
+                {
+                    for (uint32_t block = 0; block < blockCount; block++)
+                    {
+                        const uint32_t digitCount = offsets[block * 256 + digit];
+                        offsets[block * 256 + digit] = offset;
+                        offset += digitCount;
+                    }
+                }
+
+                jobs->ParallelFor(blockCount, 1, [=](uint32_t begin, uint32_t end) {
+                    for (uint32_t block = begin; block < end; block++) {
+                        Scatter(sourceKeys, sourceValues, destinationKeys, destinationValues, block * blockSize, std::min(count, (block + 1) * blockSize), shift, offsets + block * 256);
+                    }
+                });
+            }
+
+            std::swap(sourceKeys, destinationKeys);
+            std::swap(sourceValues, destinationValues);
+        }
+
+        if (sourceKeys != keys)
+        {
+            memcpy(keys, sourceKeys, sizeof(uint64_t) * count);
+            memcpy(values, sourceValues, sizeof(uint32_t) * count);
+        }
+    }
+}
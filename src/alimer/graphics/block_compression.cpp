@@ -0,0 +1,775 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "graphics/block_compression.h"
+#include "foundation/job_system.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#if ALIMER_SIMD_SSE2
+#   include <emmintrin.h>
+#elif ALIMER_SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace alimer
+{
+    namespace
+    {
+        /// Blocks per compression job.
+        constexpr uint32_t BlocksPerJob = 256;
+
+        /// Block pixels stored one array per channel so four pixels fill a SIMD register.
+        struct BlockPixels
+        {
+            alignas(16) float channels[4][16];
+        };
+
+        struct Palette
+        {
+            float colors[16][4];
+            uint32_t count;
+        };
+
+        struct Endpoints
+        {
+            float e0[4];
+            float e1[4];
+        };
+
+        struct QualitySettings
+        {
+            /// Power iterations used to find the principal axis, 0 keeps the bounding box diagonal.
+            uint32_t powerIterations;
+            /// Least squares endpoint refinements.
+            uint32_t refinements;
+            /// Try extra endpoint modes where the format has them.
+            bool exhaustive;
+        };
+
+        const QualitySettings QualityTiers[] = {
+            { 1, 0, false },
+            { 4, 1, false },
+            { 8, 4, true },
+        };
+
+        const float BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        const float BC4Weights8[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+        /// Entries 6 and 7 are the constants 0 and 255 and do not depend on the endpoints.
+        const float BC4Weights6[8] = { 0.0f, 1.0f, 1.0f / 5.0f, 2.0f / 5.0f, 3.0f / 5.0f, 4.0f / 5.0f, -1.0f, -1.0f };
+        const uint32_t BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        inline float Saturate255(float value)
+        {
+            return value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+        }
+
+        void LoadBlock(const uint8_t* pixels, uint32_t channelMask, BlockPixels& block)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                const bool enabled = (channelMask & (1u << c)) != 0;
+                for (uint32_t i = 0; i < 16; i++) {
+                    block.channels[c][i] = enabled ? static_cast<float>(pixels[i * 4 + c]) : 0.0f;
+                }
+            }
+        }
+
+        /// Pick the closest palette entry of every pixel, returns the summed squared error.
+        float FindIndices(const BlockPixels& block, const Palette& palette, uint8_t* indices)
+        {
+            float error = 0.0f;
+#if ALIMER_SIMD_SSE2
+            for (uint32_t group = 0; group < 16; group += 4)
+            {
+                const __m128 r = _mm_load_ps(&block.channels[0][group]);
+                const __m128 g = _mm_load_ps(&block.channels[1][group]);
+                const __m128 b = _mm_load_ps(&block.channels[2][group]);
+                const __m128 a = _mm_load_ps(&block.channels[3][group]);
+                __m128 best = _mm_set1_ps(FLT_MAX);
+                __m128i bestIndex = _mm_setzero_si128();
+
+                for (uint32_t i = 0; i < palette.count; i++)
+                {
+                    const __m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette.colors[i][0]));
+                    const __m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette.colors[i][1]));
+                    const __m128 db = _mm_sub_ps(b, _mm_set1_ps(palette.colors[i][2]));
+                    const __m128 da = _mm_sub_ps(a, _mm_set1_ps(palette.colors[i][3]));
+                    const __m128 distance = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)),
+                        _mm_add_ps(_mm_mul_ps(db, db), _mm_mul_ps(da, da)));
+
+                    const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+                    best = _mm_min_ps(distance, best);
+                    bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(i))), _mm_andnot_si128(closer, bestIndex));
+                }
+
+                alignas(16) int32_t lanes[4];
+                alignas(16) float distances[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), bestIndex);
+                _mm_store_ps(distances, best);
+                for (uint32_t k = 0; k < 4; k++)
+                {
+                    indices[group + k] = static_cast<uint8_t>(lanes[k]);
+                    error += distances[k];
+                }
+            }
+#elif ALIMER_SIMD_NEON
+            for (uint32_t group = 0; group < 16; group += 4)
+            {
+                const float32x4_t r = vld1q_f32(&block.channels[0][group]);
+                const float32x4_t g = vld1q_f32(&block.channels[1][group]);
+                const float32x4_t b = vld1q_f32(&block.channels[2][group]);
+                const float32x4_t a = vld1q_f32(&block.channels[3][group]);
+                float32x4_t best = vdupq_n_f32(FLT_MAX);
+                uint32x4_t bestIndex = vdupq_n_u32(0);
+
+                for (uint32_t i = 0; i < palette.count; i++)
+                {
+                    const float32x4_t dr = vsubq_f32(r, vdupq_n_f32(palette.colors[i][0]));
+                    const float32x4_t dg = vsubq_f32(g, vdupq_n_f32(palette.colors[i][1]));
+                    const float32x4_t db = vsubq_f32(b, vdupq_n_f32(palette.colors[i][2]));
+                    const float32x4_t da = vsubq_f32(a, vdupq_n_f32(palette.colors[i][3]));
+                    float32x4_t distance = vmulq_f32(dr, dr);
+                    distance = vmlaq_f32(distance, dg, dg);
+                    distance = vmlaq_f32(distance, db, db);
+                    distance = vmlaq_f32(distance, da, da);
+
+                    const uint32x4_t closer = vcltq_f32(distance, best);
+                    best = vminq_f32(distance, best);
+                    bestIndex = vbslq_u32(closer, vdupq_n_u32(i), bestIndex);
+                }
+
+                uint32_t lanes[4];
+                float distances[4];
+                vst1q_u32(lanes, bestIndex);
+                vst1q_f32(distances, best);
+                for (uint32_t k = 0; k < 4; k++)
+                {
+                    indices[group + k] = static_cast<uint8_t>(lanes[k]);
+                    error += distances[k];
+                }
+            }
+#else
+            for (uint32_t p = 0; p < 16; p++)
+            {
+                float best = FLT_MAX;
+                uint32_t bestIndex = 0;
+                for (uint32_t i = 0; i < palette.count; i++)
+                {
+                    float distance = 0.0f;
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        const float delta = block.channels[c][p] - palette.colors[i][c];
+                        distance += delta * delta;
+                    }
+
+                    if (distance < best)
+                    {
+                        best = distance;
+                        bestIndex = i;
+                    }
+                }
+
+                indices[p] = static_cast<uint8_t>(bestIndex);
+                error += best;
+            }
+#endif
+            return error;
+        }
+
+        /// Endpoints on the principal axis of the block colors, spanning the projected extent of the pixels.
+        void FitEndpoints(const BlockPixels& block, uint32_t powerIterations, Endpoints& endpoints)
+        {
+            float mean[4] = {};
+            float minimum[4];
+            float maximum[4];
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                minimum[c] = maximum[c] = block.channels[c][0];
+                for (uint32_t i = 0; i < 16; i++)
+                {
+                    const float value = block.channels[c][i];
+                    mean[c] += value;
+                    minimum[c] = std::min(minimum[c], value);
+                    maximum[c] = std::max(maximum[c], value);
+                }
+                mean[c] *= 1.0f / 16.0f;
+            }
+
+            float covariance[4][4] = {};
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                float delta[4];
+                for (uint32_t c = 0; c < 4; c++) {
+                    delta[c] = block.channels[c][i] - mean[c];
+                }
+
+                for (uint32_t row = 0; row < 4; row++)
+                {
+                    for (uint32_t column = row; column < 4; column++) {
+                        covariance[row][column] += delta[row] * delta[column];
+                    }
+                }
+            }
+
+            for (uint32_t row = 1; row < 4; row++)
+            {
+                for (uint32_t column = 0; column < row; column++) {
+                    covariance[row][column] = covariance[column][row];
+                }
+            }
+
+            // Start from the bounding box diagonal, channels anti-correlated with the widest one run backwards.
+            float axis[4];
+            uint32_t widest = 0;
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                axis[c] = maximum[c] - minimum[c];
+                if (axis[c] > axis[widest]) {
+                    widest = c;
+                }
+            }
+
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                if (covariance[widest][c] < 0.0f) {
+                    axis[c] = -axis[c];
+                }
+            }
+
+            for (uint32_t iteration = 0; iteration < powerIterations; iteration++)
+            {
+                float next[4];
+                float largest = 0.0f;
+                for (uint32_t row = 0; row < 4; row++)
+                {
+                    next[row] = covariance[row][0] * axis[0] + covariance[row][1] * axis[1] + covariance[row][2] * axis[2] + covariance[row][3] * axis[3];
+                    largest = std::max(largest, fabsf(next[row]));
+                }
+
+                if (largest < 1e-6f) {
+                    break;
+                }
+
+                for (uint32_t c = 0; c < 4; c++) {
+                    axis[c] = next[c] / largest;
+                }
+            }
+
+            const float length = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3]);
+            if (length < 1e-6f)
+            {
+                // Solid block.
+                memcpy(endpoints.e0, mean, sizeof(mean));
+                memcpy(endpoints.e1, mean, sizeof(mean));
+                return;
+            }
+
+            float minT = FLT_MAX;
+            float maxT = -FLT_MAX;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                float t = 0.0f;
+                for (uint32_t c = 0; c < 4; c++) {
+                    t += (block.channels[c][i] - mean[c]) * axis[c];
+                }
+                t /= length;
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                endpoints.e0[c] = Saturate255(mean[c] + minT * axis[c] / length);
+                endpoints.e1[c] = Saturate255(mean[c] + maxT * axis[c] / length);
+            }
+        }
+
+        /// Least squares endpoints for fixed indices, weights[k] places palette entry k between e0 and e1, negative weights are ignored.
+        bool RefineEndpoints(const BlockPixels& block, const uint8_t* indices, const float* weights, Endpoints& endpoints)
+        {
+            float aa = 0.0f;
+            float ab = 0.0f;
+            float bb = 0.0f;
+            float ax[4] = {};
+            float bx[4] = {};
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                const float b = weights[indices[i]];
+                if (b < 0.0f) {
+                    continue;
+                }
+
+                const float a = 1.0f - b;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    ax[c] += a * block.channels[c][i];
+                    bx[c] += b * block.channels[c][i];
+                }
+            }
+
+            const float determinant = aa * bb - ab * ab;
+            if (fabsf(determinant) < 1e-6f) {
+                return false;
+            }
+
+            const float scale = 1.0f / determinant;
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                endpoints.e0[c] = Saturate255((bb * ax[c] - ab * bx[c]) * scale);
+                endpoints.e1[c] = Saturate255((aa * bx[c] - ab * ax[c]) * scale);
+            }
+
+            return true;
+        }
+
+        /// Little endian bit stream of up to 128 bits.
+        struct BitWriter
+        {
+            uint8_t* output;
+            uint32_t position;
+
+            void Write(uint32_t value, uint32_t count)
+            {
+                for (uint32_t bit = 0; bit < count; bit++, position++)
+                {
+                    if ((value >> bit) & 1u) {
+                        output[position >> 3] |= static_cast<uint8_t>(1u << (position & 7u));
+                    }
+                }
+            }
+        };
+
+        // BC1
+
+        uint16_t PackRGB565(const float* color)
+        {
+            const uint32_t r = static_cast<uint32_t>(Saturate255(color[0]) * (31.0f / 255.0f) + 0.5f);
+            const uint32_t g = static_cast<uint32_t>(Saturate255(color[1]) * (63.0f / 255.0f) + 0.5f);
+            const uint32_t b = static_cast<uint32_t>(Saturate255(color[2]) * (31.0f / 255.0f) + 0.5f);
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        void UnpackRGB565(uint16_t packed, float* color)
+        {
+            const uint32_t r = (packed >> 11) & 31u;
+            const uint32_t g = (packed >> 5) & 63u;
+            const uint32_t b = packed & 31u;
+            color[0] = static_cast<float>((r << 3) | (r >> 2));
+            color[1] = static_cast<float>((g << 2) | (g >> 4));
+            color[2] = static_cast<float>((b << 3) | (b >> 2));
+            color[3] = 0.0f;
+        }
+
+        struct BC1Block
+        {
+            uint16_t color0;
+            uint16_t color1;
+            uint8_t indices[16];
+            float error;
+        };
+
+        /// Quantize endpoints in four color mode, color0 > color1, and pick indices.
+        void EncodeBC1Candidate(const BlockPixels& block, const Endpoints& endpoints, BC1Block& result)
+        {
+            result.color0 = PackRGB565(endpoints.e0);
+            result.color1 = PackRGB565(endpoints.e1);
+            if (result.color0 < result.color1) {
+                std::swap(result.color0, result.color1);
+            }
+
+            Palette palette;
+            UnpackRGB565(result.color0, palette.colors[0]);
+            UnpackRGB565(result.color1, palette.colors[1]);
+            palette.count = 4;
+            if (result.color0 == result.color1)
+            {
+                // Equal endpoints decode in three color mode, index 0 is the only safe entry.
+                palette.count = 1;
+            }
+
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                palette.colors[2][c] = (2.0f * palette.colors[0][c] + palette.colors[1][c]) * (1.0f / 3.0f);
+                palette.colors[3][c] = (palette.colors[0][c] + 2.0f * palette.colors[1][c]) * (1.0f / 3.0f);
+            }
+
+            result.error = FindIndices(block, palette, result.indices);
+        }
+
+        void EncodeBC1(const uint8_t* pixels, uint8_t* output, CompressionQuality quality)
+        {
+            const QualitySettings& settings = QualityTiers[static_cast<uint32_t>(quality)];
+
+            BlockPixels block;
+            LoadBlock(pixels, 0x7u, block);
+
+            Endpoints endpoints;
+            FitEndpoints(block, settings.powerIterations, endpoints);
+
+            BC1Block best;
+            EncodeBC1Candidate(block, endpoints, best);
+            for (uint32_t i = 0; i < settings.refinements && best.error > 0.0f; i++)
+            {
+                if (!RefineEndpoints(block, best.indices, BC1Weights, endpoints)) {
+                    break;
+                }
+
+                BC1Block candidate;
+                EncodeBC1Candidate(block, endpoints, candidate);
+                if (candidate.error >= best.error) {
+                    break;
+                }
+                best = candidate;
+            }
+
+            uint32_t indices = 0;
+            for (uint32_t i = 0; i < 16; i++) {
+                indices |= static_cast<uint32_t>(best.indices[i]) << (i * 2);
+            }
+
+            output[0] = static_cast<uint8_t>(best.color0);
+            output[1] = static_cast<uint8_t>(best.color0 >> 8);
+            output[2] = static_cast<uint8_t>(best.color1);
+            output[3] = static_cast<uint8_t>(best.color1 >> 8);
+            for (uint32_t i = 0; i < 4; i++) {
+                output[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+            }
+        }
+
+        // BC4
+
+        struct BC4Block
+        {
+            uint8_t value0;
+            uint8_t value1;
+            uint8_t indices[16];
+            float error;
+        };
+
+        uint8_t QuantizeUnorm8(float value)
+        {
+            return static_cast<uint8_t>(Saturate255(value) + 0.5f);
+        }
+
+        /// Quantize endpoints in eight value mode (value0 > value1) or six value mode and pick indices.
+        void EncodeBC4Candidate(const BlockPixels& block, uint32_t channel, float e0, float e1, bool sixValues, BC4Block& result)
+        {
+            result.value0 = QuantizeUnorm8(e0);
+            result.value1 = QuantizeUnorm8(e1);
+            if (sixValues ? result.value0 > result.value1 : result.value0 < result.value1) {
+                std::swap(result.value0, result.value1);
+            }
+
+            const float v0 = result.value0;
+            const float v1 = result.value1;
+            float values[8] = { v0, v1 };
+            if (result.value0 > result.value1)
+            {
+                for (uint32_t k = 2; k < 8; k++) {
+                    values[k] = ((8 - k) * v0 + (k - 1) * v1) * (1.0f / 7.0f);
+                }
+            }
+            else
+            {
+                for (uint32_t k = 2; k < 6; k++) {
+                    values[k] = ((6 - k) * v0 + (k - 1) * v1) * (1.0f / 5.0f);
+                }
+                values[6] = 0.0f;
+                values[7] = 255.0f;
+            }
+
+            Palette palette;
+            palette.count = 8;
+            memset(palette.colors, 0, sizeof(palette.colors));
+            for (uint32_t k = 0; k < 8; k++) {
+                palette.colors[k][channel] = values[k];
+            }
+
+            result.error = FindIndices(block, palette, result.indices);
+        }
+
+        void RefineBC4(const BlockPixels& block, uint32_t channel, uint32_t refinements, BC4Block& best)
+        {
+            for (uint32_t i = 0; i < refinements && best.error > 0.0f; i++)
+            {
+                const bool sixValues = best.value0 <= best.value1;
+                Endpoints endpoints;
+                if (!RefineEndpoints(block, best.indices, sixValues ? BC4Weights6 : BC4Weights8, endpoints)) {
+                    break;
+                }
+
+                BC4Block candidate;
+                EncodeBC4Candidate(block, channel, endpoints.e0[channel], endpoints.e1[channel], sixValues, candidate);
+                if (candidate.error >= best.error) {
+                    break;
+                }
+                best = candidate;
+            }
+        }
+
+        void EncodeBC4(const uint8_t* pixels, uint32_t channel, uint8_t* output, CompressionQuality quality)
+        {
+            const QualitySettings& settings = QualityTiers[static_cast<uint32_t>(quality)];
+
+            BlockPixels block;
+            LoadBlock(pixels, 1u << channel, block);
+
+            const float* values = block.channels[channel];
+            float minimum = values[0];
+            float maximum = values[0];
+            // Extent without the 0 and 255 extremes that six value mode stores as constants.
+            float innerMinimum = 255.0f;
+            float innerMaximum = 0.0f;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                minimum = std::min(minimum, values[i]);
+                maximum = std::max(maximum, values[i]);
+                if (values[i] > 0.0f && values[i] < 255.0f)
+                {
+                    innerMinimum = std::min(innerMinimum, values[i]);
+                    innerMaximum = std::max(innerMaximum, values[i]);
+                }
+            }
+
+            BC4Block best;
+            EncodeBC4Candidate(block, channel, maximum, minimum, false, best);
+            RefineBC4(block, channel, settings.refinements, best);
+
+            if (settings.exhaustive && best.error > 0.0f && innerMinimum <= innerMaximum)
+            {
+                BC4Block candidate;
+                EncodeBC4Candidate(block, channel, innerMinimum, innerMaximum, true, candidate);
+                RefineBC4(block, channel, settings.refinements, candidate);
+                if (candidate.error < best.error) {
+                    best = candidate;
+                }
+            }
+
+            uint64_t indices = 0;
+            for (uint32_t i = 0; i < 16; i++) {
+                indices |= static_cast<uint64_t>(best.indices[i]) << (i * 3);
+            }
+
+            output[0] = best.value0;
+            output[1] = best.value1;
+            for (uint32_t i = 0; i < 6; i++) {
+                output[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+            }
+        }
+
+        // BC7, mode 6: one subset, RGBA 7.7.7.7 endpoints with a unique p-bit each and 4 bit indices.
+
+        struct BC7Block
+        {
+            uint8_t endpoints[2][4];
+            uint32_t pbits[2];
+            uint8_t indices[16];
+            float error;
+        };
+
+        void QuantizeBC7Endpoint(const float* endpoint, uint8_t* quantized, uint32_t& pbit)
+        {
+            float bestError = FLT_MAX;
+            for (uint32_t p = 0; p < 2; p++)
+            {
+                uint8_t candidate[4];
+                float error = 0.0f;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const int value = static_cast<int>((endpoint[c] - p) * 0.5f + 0.5f);
+                    candidate[c] = static_cast<uint8_t>(std::min(std::max(value, 0), 127));
+                    const float delta = static_cast<float>(candidate[c] * 2 + p) - endpoint[c];
+                    error += delta * delta;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    pbit = p;
+                    memcpy(quantized, candidate, sizeof(candidate));
+                }
+            }
+        }
+
+        void EncodeBC7Candidate(const BlockPixels& block, const Endpoints& endpoints, BC7Block& result)
+        {
+            QuantizeBC7Endpoint(endpoints.e0, result.endpoints[0], result.pbits[0]);
+            QuantizeBC7Endpoint(endpoints.e1, result.endpoints[1], result.pbits[1]);
+
+            Palette palette;
+            palette.count = 16;
+            for (uint32_t k = 0; k < 16; k++)
+            {
+                const uint32_t weight = BC7Weights4[k];
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const uint32_t v0 = result.endpoints[0][c] * 2u + result.pbits[0];
+                    const uint32_t v1 = result.endpoints[1][c] * 2u + result.pbits[1];
+                    palette.colors[k][c] = static_cast<float>(((64u - weight) * v0 + weight * v1 + 32u) >> 6);
+                }
+            }
+
+            result.error = FindIndices(block, palette, result.indices);
+        }
+
+        void EncodeBC7(const uint8_t* pixels, uint8_t* output, CompressionQuality quality)
+        {
+            static const float Weights[16] = {
+                0.0f / 64.0f, 4.0f / 64.0f, 9.0f / 64.0f, 13.0f / 64.0f, 17.0f / 64.0f, 21.0f / 64.0f, 26.0f / 64.0f, 30.0f / 64.0f,
+                34.0f / 64.0f, 38.0f / 64.0f, 43.0f / 64.0f, 47.0f / 64.0f, 51.0f / 64.0f, 55.0f / 64.0f, 60.0f / 64.0f, 64.0f / 64.0f
+            };
+
+            const QualitySettings& settings = QualityTiers[static_cast<uint32_t>(quality)];
+
+            BlockPixels block;
+            LoadBlock(pixels, 0xFu, block);
+
+            Endpoints endpoints;
+            FitEndpoints(block, settings.powerIterations, endpoints);
+
+            BC7Block best;
+            EncodeBC7Candidate(block, endpoints, best);
+            for (uint32_t i = 0; i < settings.refinements && best.error > 0.0f; i++)
+            {
+                if (!RefineEndpoints(block, best.indices, Weights, endpoints)) {
+                    break;
+                }
+
+                BC7Block candidate;
+                EncodeBC7Candidate(block, endpoints, candidate);
+                if (candidate.error >= best.error) {
+                    break;
+                }
+                best = candidate;
+            }
+
+            // The most significant bit of the first index is implicit zero.
+            if (best.indices[0] & 8u)
+            {
+                for (uint32_t c = 0; c < 4; c++) {
+                    std::swap(best.endpoints[0][c], best.endpoints[1][c]);
+                }
+                std::swap(best.pbits[0], best.pbits[1]);
+                for (uint32_t i = 0; i < 16; i++) {
+                    best.indices[i] = static_cast<uint8_t>(15u - best.indices[i]);
+                }
+            }
+
+            memset(output, 0, 16);
+            BitWriter writer = { output, 0 };
+            writer.Write(1u << 6, 7);
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                writer.Write(best.endpoints[0][c], 7);
+                writer.Write(best.endpoints[1][c], 7);
+            }
+            writer.Write(best.pbits[0], 1);
+            writer.Write(best.pbits[1], 1);
+            writer.Write(best.indices[0], 3);
+            for (uint32_t i = 1; i < 16; i++) {
+                writer.Write(best.indices[i], 4);
+            }
+        }
+    }
+
+    uint32_t GetBlockSize(BlockFormat format)
+    {
+        return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8u : 16u;
+    }
+
+    size_t GetCompressedSize(BlockFormat format, uint32_t width, uint32_t height)
+    {
+        const size_t blocksX = (width + 3) / 4;
+        const size_t blocksY = (height + 3) / 4;
+        return blocksX * blocksY * GetBlockSize(format);
+    }
+
+    void CompressBlock(BlockFormat format, const uint8_t* pixels, uint8_t* block, CompressionQuality quality)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            EncodeBC1(pixels, block, quality);
+            break;
+        case BlockFormat::BC3:
+            EncodeBC4(pixels, 3, block, quality);
+            EncodeBC1(pixels, block + 8, quality);
+            break;
+        case BlockFormat::BC4:
+            EncodeBC4(pixels, 0, block, quality);
+            break;
+        case BlockFormat::BC5:
+            EncodeBC4(pixels, 0, block, quality);
+            EncodeBC4(pixels, 1, block + 8, quality);
+            break;
+        case BlockFormat::BC7:
+            EncodeBC7(pixels, block, quality);
+            break;
+        }
+    }
+
+    void CompressSurface(BlockFormat format, const uint8_t* pixels, uint32_t width, uint32_t height,
+        uint8_t* output, CompressionQuality quality, JobSystem* jobs)
+    {
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t blockSize = GetBlockSize(format);
+
+        auto compressRows = [=](uint32_t begin, uint32_t end) {
+            uint8_t block[64];
+            for (uint32_t blockY = begin; blockY < end; blockY++)
+            {
+                for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+                {
+                    for (uint32_t y = 0; y < 4; y++)
+                    {
+                        const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+                        for (uint32_t x = 0; x < 4; x++)
+                        {
+                            const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                            memcpy(block + (y * 4 + x) * 4, pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                        }
+                    }
+
+                    CompressBlock(format, block, output + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize, quality);
+                }
+            }
+        };
+
+        if (jobs && blocksX * blocksY > BlocksPerJob)
+        {
+            jobs->ParallelFor(blocksY, std::max(BlocksPerJob / blocksX, 1u), compressRows);
+        }
+        else
+        {
+            compressRows(0, blocksY);
+        }
+    }
+}
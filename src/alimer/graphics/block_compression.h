@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+
+namespace alimer
+{
+    class JobSystem;
+
+    /// Block compressed formats produced by the encoder.
+    enum class BlockFormat : uint32_t
+    {
+        /// Opaque RGB, 8 bytes per block.
+        BC1 = 0,
+        /// RGB with interpolated alpha, 16 bytes per block.
+        BC3,
+        /// Red channel, 8 bytes per block.
+        BC4,
+        /// Red and green channels, 16 bytes per block.
+        BC5,
+        /// RGBA, 16 bytes per block, encoded with mode 6.
+        BC7
+    };
+
+    /// Encoder effort, higher tiers refine endpoints more and search more candidates.
+    enum class CompressionQuality : uint32_t
+    {
+        Fast = 0,
+        Normal,
+        High
+    };
+
+    /// Get the size in bytes of one 4x4 block.
+    ALIMER_API uint32_t GetBlockSize(BlockFormat format);
+
+    /// Get the size in bytes of a compressed width x height surface.
+    ALIMER_API size_t GetCompressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+    /// Compress one 4x4 block of RGBA8 pixels stored row by row.
+    ALIMER_API void CompressBlock(BlockFormat format, const uint8_t* pixels, uint8_t* block, CompressionQuality quality);
+
+    /// Compress an RGBA8 surface, partial edge blocks repeat the last row and column. Block rows are split across jobs when given.
+    ALIMER_API void CompressSurface(BlockFormat format, const uint8_t* pixels, uint32_t width, uint32_t height,
+        uint8_t* output, CompressionQuality quality, JobSystem* jobs = nullptr);
+}
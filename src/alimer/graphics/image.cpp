@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "graphics/image.h"
+#include "foundation/job_system.h"
+#include <stb_image.h>
+#include <string.h>
+
+#if ALIMER_SIMD_SSE2
+#   include <emmintrin.h>
+#elif ALIMER_SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace alimer
+{
+    /// Destination pixels below this count are not worth splitting across jobs.
+    static constexpr uint32_t ParallelMipPixelThreshold = 256 * 256;
+    static constexpr uint32_t ParallelMipRowBatch = 32;
+
+    bool Image::Decode(const uint8_t* data, size_t size)
+    {
+        Clear();
+
+        int width, height, components;
+        stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &components, 4);
+        if (!pixels) {
+            return false;
+        }
+
+        _width = static_cast<uint32_t>(width);
+        _height = static_cast<uint32_t>(height);
+        _data.assign(pixels, pixels + static_cast<size_t>(_width) * _height * 4);
+        _mipOffsets.push_back(0);
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    void Image::GenerateMipmaps(JobSystem* jobs)
+    {
+        if (_data.empty() || _format != VGPU_PIXEL_FORMAT_RGBA8_UNORM) {
+            return;
+        }
+
+        // Size the whole chain up front so levels never move while they are written.
+        _mipOffsets.resize(1);
+        size_t totalSize = static_cast<size_t>(_width) * _height * 4;
+        for (uint32_t level = 1; GetMipWidth(level - 1) > 1 || GetMipHeight(level - 1) > 1; level++)
+        {
+            _mipOffsets.push_back(totalSize);
+            totalSize += static_cast<size_t>(GetMipWidth(level)) * GetMipHeight(level) * 4;
+        }
+        _data.resize(totalSize);
+
+        for (uint32_t level = 1; level < GetMipLevels(); level++)
+        {
+            const uint8_t* source = _data.data() + _mipOffsets[level - 1];
+            uint8_t* destination = _data.data() + _mipOffsets[level];
+            const uint32_t sourceWidth = GetMipWidth(level - 1);
+            const uint32_t sourceHeight = GetMipHeight(level - 1);
+            const uint32_t height = GetMipHeight(level);
+
+            if (jobs && GetMipWidth(level) * height >= ParallelMipPixelThreshold)
+            {
+                jobs->ParallelFor(height, ParallelMipRowBatch, [=](uint32_t begin, uint32_t end) {
+                    DownsampleRGBA8(source, sourceWidth, sourceHeight, destination, begin, end);
+                });
+            }
+            else
+            {
+                DownsampleRGBA8(source, sourceWidth, sourceHeight, destination, 0, height);
+            }
+        }
+    }
+
+    void Image::Compress(BlockFormat format, CompressionQuality quality, JobSystem* jobs)
+    {
+        if (_data.empty() || _format != VGPU_PIXEL_FORMAT_RGBA8_UNORM) {
+            return;
+        }
+
+        std::vector<size_t> offsets(_mipOffsets.size());
+        size_t totalSize = 0;
+        for (uint32_t level = 0; level < GetMipLevels(); level++)
+        {
+            offsets[level] = totalSize;
+            totalSize += GetCompressedSize(format, GetMipWidth(level), GetMipHeight(level));
+        }
+
+        PixelData data(totalSize);
+        for (uint32_t level = 0; level < GetMipLevels(); level++) {
+            CompressSurface(format, GetMipData(level), GetMipWidth(level), GetMipHeight(level), data.data() + offsets[level], quality, jobs);
+        }
+
+        _data.swap(data);
+        _mipOffsets.swap(offsets);
+        switch (format)
+        {
+        case BlockFormat::BC1: _format = VGPU_PIXEL_FORMAT_BC1_UNORM; break;
+        case BlockFormat::BC3: _format = VGPU_PIXEL_FORMAT_BC3_UNORM; break;
+        case BlockFormat::BC4: _format = VGPU_PIXEL_FORMAT_BC4_UNORM; break;
+        case BlockFormat::BC5: _format = VGPU_PIXEL_FORMAT_BC5_UNORM; break;
+        case BlockFormat::BC7: _format = VGPU_PIXEL_FORMAT_BC7_UNORM; break;
+        }
+    }
+
+    bool Image::HasAlpha() const
+    {
+        if (_format != VGPU_PIXEL_FORMAT_RGBA8_UNORM) {
+            return false;
+        }
+
+        const size_t size = static_cast<size_t>(_width) * _height * 4;
+        for (size_t i = 3; i < size; i += 4)
+        {
+            if (_data[i] != 255) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Image::Clear()
+    {
+        PixelData().swap(_data);
+        _mipOffsets.clear();
+        _format = VGPU_PIXEL_FORMAT_RGBA8_UNORM;
+        _width = 0;
+        _height = 0;
+    }
+
+    void DownsampleRGBA8(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* destination, uint32_t firstRow, uint32_t lastRow)
+    {
+        const uint32_t width = (sourceWidth >> 1) > 0 ? sourceWidth >> 1 : 1;
+        const size_t sourcePitch = static_cast<size_t>(sourceWidth) * 4;
+
+        // Destination pixels whose two source columns both exist, a one pixel wide source goes through the scalar tail.
+        const uint32_t pairedWidth = sourceWidth >> 1;
+
+        for (uint32_t y = firstRow; y < lastRow; y++)
+        {
+            const uint8_t* row0 = source + (static_cast<size_t>(y) * 2) * sourcePitch;
+            const uint8_t* row1 = (y * 2 + 1 < sourceHeight) ? row0 + sourcePitch : row0;
+            uint8_t* output = destination + static_cast<size_t>(y) * width * 4;
+            uint32_t x = 0;
+
+#if ALIMER_SIMD_SSE2
+            // Four destination pixels from two rows of eight source pixels.
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(2);
+            for (; x + 4 <= pairedWidth; x += 4)
+            {
+                const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8 + 16));
+                const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+                const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8 + 16));
+
+                // Vertical sums in 16 bits, two pixels per register.
+                const __m128i p01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(a1, zero));
+                const __m128i p23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(a1, zero));
+                const __m128i p45 = _mm_add_epi16(_mm_unpacklo_epi8(b0, zero), _mm_unpacklo_epi8(b1, zero));
+                const __m128i p67 = _mm_add_epi16(_mm_unpackhi_epi8(b0, zero), _mm_unpackhi_epi8(b1, zero));
+
+                // Horizontal sums of even and odd pixels.
+                __m128i d01 = _mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23));
+                __m128i d23 = _mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67));
+                d01 = _mm_srli_epi16(_mm_add_epi16(d01, round), 2);
+                d23 = _mm_srli_epi16(_mm_add_epi16(d23, round), 2);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(d01, d23));
+            }
+#elif ALIMER_SIMD_NEON
+            for (; x + 4 <= pairedWidth; x += 4)
+            {
+                // De-interleave even and odd pixels of both rows.
+                const uint32x4x2_t e = vuzpq_u32(vreinterpretq_u32_u8(vld1q_u8(row0 + x * 8)), vreinterpretq_u32_u8(vld1q_u8(row0 + x * 8 + 16)));
+                const uint32x4x2_t f = vuzpq_u32(vreinterpretq_u32_u8(vld1q_u8(row1 + x * 8)), vreinterpretq_u32_u8(vld1q_u8(row1 + x * 8 + 16)));
+                const uint8x16_t even0 = vreinterpretq_u8_u32(e.val[0]);
+                const uint8x16_t odd0 = vreinterpretq_u8_u32(e.val[1]);
+                const uint8x16_t even1 = vreinterpretq_u8_u32(f.val[0]);
+                const uint8x16_t odd1 = vreinterpretq_u8_u32(f.val[1]);
+
+                const uint16x8_t low = vaddq_u16(vaddl_u8(vget_low_u8(even0), vget_low_u8(odd0)), vaddl_u8(vget_low_u8(even1), vget_low_u8(odd1)));
+                const uint16x8_t high = vaddq_u16(vaddl_u8(vget_high_u8(even0), vget_high_u8(odd0)), vaddl_u8(vget_high_u8(even1), vget_high_u8(odd1)));
+                vst1q_u8(output + x * 4, vcombine_u8(vrshrn_n_u16(low, 2), vrshrn_n_u16(high, 2)));
+            }
+#endif
+
+            for (; x < width; x++)
+            {
+                const uint32_t x0 = x * 2;
+                const uint32_t x1 = (x0 + 1 < sourceWidth) ? x0 + 1 : x0;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const uint32_t sum = row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c];
+                    output[x * 4 + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+    }
+}
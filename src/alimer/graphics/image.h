@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/memory_tracker.h"
+#include "graphics/block_compression.h"
+#include <vgpu.h>
+#include <vector>
+
+namespace alimer
+{
+    class JobSystem;
+
+    /// Decoded image with its mip chain stored contiguously, largest level first. Levels are RGBA8 until compressed.
+    class ALIMER_API Image final
+    {
+    public:
+        /// Constructor.
+        Image() = default;
+
+        /// Decode PNG, JPEG, TGA, BMP, PSD, GIF, HDR or PIC data, the result is always RGBA8.
+        bool Decode(const uint8_t* data, size_t size);
+
+        /// Build every level down to 1x1 with a 2x2 box filter, large levels are split across jobs when given.
+        void GenerateMipmaps(JobSystem* jobs = nullptr);
+
+        /// Block compress every level in place, block rows are split across jobs when given.
+        void Compress(BlockFormat format, CompressionQuality quality, JobSystem* jobs = nullptr);
+
+        /// Check if any pixel of level 0 is not fully opaque.
+        bool HasAlpha() const;
+
+        /// Release the pixels.
+        void Clear();
+
+        /// Get the format of the stored levels.
+        VGpuPixelFormat GetFormat() const { return _format; }
+
+        /// Get the width of level 0.
+        uint32_t GetWidth() const { return _width; }
+
+        /// Get the height of level 0.
+        uint32_t GetHeight() const { return _height; }
+
+        /// Get the number of levels.
+        uint32_t GetMipLevels() const { return static_cast<uint32_t>(_mipOffsets.size()); }
+
+        /// Get the width of a level.
+        uint32_t GetMipWidth(uint32_t level) const { return (_width >> level) > 0 ? _width >> level : 1; }
+
+        /// Get the height of a level.
+        uint32_t GetMipHeight(uint32_t level) const { return (_height >> level) > 0 ? _height >> level : 1; }
+
+        /// Get the pixels of a level.
+        const uint8_t* GetMipData(uint32_t level) const { return _data.data() + _mipOffsets[level]; }
+
+        /// Get the size in bytes of every level.
+        size_t GetDataSize() const { return _data.size(); }
+
+        /// Check if the image holds pixels.
+        bool IsEmpty() const { return _data.empty(); }
+
+    private:
+        using PixelData = std::vector<uint8_t, MemoryTagAllocator<uint8_t, MemoryTag::Content>>;
+
+        PixelData _data;
+        std::vector<size_t> _mipOffsets;
+        VGpuPixelFormat _format = VGPU_PIXEL_FORMAT_RGBA8_UNORM;
+        uint32_t _width = 0;
+        uint32_t _height = 0;
+    };
+
+    /// Downsample rows [firstRow, lastRow) of an RGBA8 destination level with a 2x2 box filter, the last row or column of odd sizes is dropped.
+    ALIMER_API void DownsampleRGBA8(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* destination, uint32_t firstRow, uint32_t lastRow);
+}
@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "graphics/render_queue.h"
+#include "foundation/radix_sort.h"
+#include <cassert>
+
+namespace alimer
+{
+    static constexpr uint32_t DepthBits = 24;
+    static constexpr uint32_t MaterialBits = 20;
+    static constexpr uint32_t PipelineBits = 12;
+    static constexpr uint64_t DepthMax = (1u << DepthBits) - 1;
+
+    RenderQueue::RenderQueue()
+    {
+        for (RenderSortMode& mode : _passSortModes) {
+            mode = RenderSortMode::FrontToBack;
+        }
+    }
+
+    RenderQueue::~RenderQueue() = default;
+
+    uint32_t RenderQueue::RegisterPipeline(VGpuPipeline pipeline)
+    {
+        assert(_pipelines.size() < MaxPipelines);
+        _pipelines.push_back(pipeline);
+        return static_cast<uint32_t>(_pipelines.size() - 1);
+    }
+
+    uint32_t RenderQueue::RegisterMaterial(const RenderMaterial& material)
+    {
+        assert(_materials.size() < MaxMaterials);
+        assert(material.textureCount <= RenderMaterial::MaxTextures);
+        _materials.push_back(material);
+        return static_cast<uint32_t>(_materials.size() - 1);
+    }
+
+    void RenderQueue::SetPassSortMode(uint32_t pass, RenderSortMode mode)
+    {
+        assert(pass < MaxPasses);
+        _passSortModes[pass] = mode;
+    }
+
+    void RenderQueue::Clear()
+    {
+        _items.clear();
+        _keys.clear();
+    }
+
+    uint64_t RenderQueue::MakeKey(uint32_t layer, uint32_t pass, uint32_t pipeline, uint32_t material, float depth, RenderSortMode mode)
+    {
+        depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+        uint64_t quantizedDepth = static_cast<uint64_t>(depth * static_cast<float>(DepthMax));
+        const uint64_t state = (static_cast<uint64_t>(pipeline) << MaterialBits) | material;
+        const uint64_t prefix = (static_cast<uint64_t>(layer) << 60) | (static_cast<uint64_t>(pass) << 56);
+        if (mode == RenderSortMode::BackToFront)
+        {
+            quantizedDepth = DepthMax - quantizedDepth;
+            return prefix | (quantizedDepth << (PipelineBits + MaterialBits)) | state;
+        }
+
+        return prefix | (state << DepthBits) | quantizedDepth;
+    }
+
+    void RenderQueue::Submit(const RenderItem& item, uint32_t layer, uint32_t pass, float depth)
+    {
+        assert(layer < MaxLayers && pass < MaxPasses);
+        assert(item.pipeline < _pipelines.size() && item.material < _materials.size());
+        _keys.push_back(MakeKey(layer, pass, item.pipeline, item.material, depth, _passSortModes[pass]));
+        _items.push_back(item);
+    }
+
+    template <typename F>
+    RenderStateChanges RenderQueue::CountStateChanges(uint32_t count, F getItem) const
+    {
+        RenderStateChanges changes;
+        const RenderItem* previous = nullptr;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const RenderItem& item = getItem(i);
+            changes.pipelines += !previous || previous->pipeline != item.pipeline;
+            changes.materials += !previous || previous->material != item.material;
+            changes.vertexBuffers += !previous || previous->vertexBuffer != item.vertexBuffer || previous->vertexOffset != item.vertexOffset;
+            previous = &item;
+        }
+        return changes;
+    }
+
+    void RenderQueue::Sort(JobSystem* jobs)
+    {
+        const uint32_t count = static_cast<uint32_t>(_items.size());
+        _stats.items = count;
+        _stats.submitted = CountStateChanges(count, [this](uint32_t i) -> const RenderItem& { return _items[i]; });
+
+        _order.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            _order[i] = i;
+        }
+
+        _keyScratch.resize(count);
+        _orderScratch.resize(count);
+        RadixSort(_keys.data(), _order.data(), _keyScratch.data(), _orderScratch.data(), count, jobs);
+
+        _stats.sorted = CountStateChanges(count, [this](uint32_t i) -> const RenderItem& { return _items[_order[i]]; });
+    }
+
+    void RenderQueue::Execute(VGpuCommandBuffer commandBuffer) const
+    {
+        assert(_order.size() == _items.size() && "Sort must be called before Execute");
+
+        // The device filters redundant state too, skipping here keeps the command stream small.
+        const RenderItem* previous = nullptr;
+        for (uint32_t index : _order)
+        {
+            const RenderItem& item = _items[index];
+            if (!previous || previous->pipeline != item.pipeline) {
+                vgpuCmdBindPipeline(commandBuffer, _pipelines[item.pipeline]);
+            }
+
+            if (!previous || previous->material != item.material)
+            {
+                const RenderMaterial& material = _materials[item.material];
+                for (uint32_t binding = 0; binding < material.textureCount; binding++) {
+                    vgpuCmdSetTexture(commandBuffer, binding, material.textures[binding]);
+                }
+
+                if (material.uniformBuffer) {
+                    vgpuCmdSetUniformBuffer(commandBuffer, MaterialUniformBinding, material.uniformBuffer, material.uniformOffset, material.uniformSize);
+                }
+            }
+
+            if (!previous || previous->vertexBuffer != item.vertexBuffer || previous->vertexOffset != item.vertexOffset) {
+                vgpuCmdSetVertexBuffers(commandBuffer, 0, 1, &item.vertexBuffer, &item.vertexOffset);
+            }
+
+            if (item.objectBuffer) {
+                vgpuCmdSetUniformBuffer(commandBuffer, ObjectUniformBinding, item.objectBuffer, item.objectOffset, item.objectSize);
+            }
+
+            if (item.indexBuffer)
+            {
+                if (!previous || previous->indexBuffer != item.indexBuffer || previous->indexOffset != item.indexOffset || previous->indexType != item.indexType) {
+                    vgpuCmdSetIndexBuffer(commandBuffer, item.indexBuffer, item.indexOffset, item.indexType);
+                }
+
+                vgpuCmdDrawIndexed(commandBuffer, item.count, item.instanceCount, item.first, item.baseVertex);
+            }
+            else
+            {
+                vgpuCmdDraw(commandBuffer, item.count, item.instanceCount, item.first);
+            }
+
+            previous = &item;
+        }
+    }
+}
@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/job_system.h"
+#include <vgpu.h>
+#include <vector>
+
+namespace alimer
+{
+    /// Textures and uniforms shared by many draws, bound together when the material changes.
+    struct RenderMaterial
+    {
+        static constexpr uint32_t MaxTextures = 4;
+
+        /// Bound to texture bindings 0 to textureCount - 1.
+        VGpuTexture textures[MaxTextures] = {};
+        uint32_t textureCount = 0;
+        /// Optional uniform block bound to RenderQueue::MaterialUniformBinding.
+        VGpuBuffer uniformBuffer = nullptr;
+        uint64_t uniformOffset = 0;
+        uint64_t uniformSize = 0;
+    };
+
+    /// One draw submitted to a RenderQueue.
+    struct RenderItem
+    {
+        /// Id returned by RenderQueue::RegisterPipeline.
+        uint32_t pipeline = 0;
+        /// Id returned by RenderQueue::RegisterMaterial.
+        uint32_t material = 0;
+        VGpuBuffer vertexBuffer = nullptr;
+        uint64_t vertexOffset = 0;
+        /// Draws indexed when set.
+        VGpuBuffer indexBuffer = nullptr;
+        uint64_t indexOffset = 0;
+        VGpuIndexType indexType = VGPU_INDEX_TYPE_UINT16;
+        /// Optional per object uniform block bound to RenderQueue::ObjectUniformBinding.
+        VGpuBuffer objectBuffer = nullptr;
+        uint64_t objectOffset = 0;
+        uint64_t objectSize = 0;
+        /// Vertex or index count.
+        uint32_t count = 0;
+        uint32_t instanceCount = 1;
+        /// First vertex or first index.
+        uint32_t first = 0;
+        int32_t baseVertex = 0;
+    };
+
+    /// Order of the items of a pass.
+    enum class RenderSortMode : uint8_t
+    {
+        /// Sort by state then nearest first, for opaque geometry.
+        FrontToBack,
+        /// Sort by depth first then state, farthest first, for blended geometry.
+        BackToFront
+    };
+
+    /// State changes needed to draw the items in a given order.
+    struct RenderStateChanges
+    {
+        uint32_t pipelines = 0;
+        uint32_t materials = 0;
+        uint32_t vertexBuffers = 0;
+    };
+
+    /// Render queue statistics of the last Sort call.
+    struct RenderQueueStats
+    {
+        uint32_t items = 0;
+        /// Changes in submission order.
+        RenderStateChanges submitted;
+        /// Changes in sorted order.
+        RenderStateChanges sorted;
+    };
+
+    /// Collects the draws of one view with 64 bit sort keys, radix sorts them and replays them into a command buffer.
+    /// Keys pack, most significant first, layer (4 bits), pass (4 bits), pipeline (12 bits), material (20 bits) and
+    /// depth (24 bits). Back to front passes move depth in front of pipeline and material.
+    class ALIMER_API RenderQueue final
+    {
+    public:
+        static constexpr uint32_t MaxLayers = 1u << 4;
+        static constexpr uint32_t MaxPasses = 1u << 4;
+        static constexpr uint32_t MaxPipelines = 1u << 12;
+        static constexpr uint32_t MaxMaterials = 1u << 20;
+
+        static constexpr uint32_t MaterialUniformBinding = 1;
+        static constexpr uint32_t ObjectUniformBinding = 2;
+
+        /// Constructor.
+        RenderQueue();
+
+        /// Destructor.
+        ~RenderQueue();
+
+        RenderQueue(const RenderQueue&) = delete;
+        RenderQueue& operator=(const RenderQueue&) = delete;
+
+        /// Register a pipeline, returns the id used by RenderItem::pipeline.
+        uint32_t RegisterPipeline(VGpuPipeline pipeline);
+
+        /// Register a material, returns the id used by RenderItem::material.
+        uint32_t RegisterMaterial(const RenderMaterial& material);
+
+        /// Set how the items of pass are ordered, passes default to front to back.
+        void SetPassSortMode(uint32_t pass, RenderSortMode mode);
+
+        /// Remove every submitted item, registered pipelines and materials are kept.
+        void Clear();
+
+        /// Submit an item, depth is the normalized view depth in [0, 1].
+        void Submit(const RenderItem& item, uint32_t layer, uint32_t pass, float depth);
+
+        /// Sort the submitted items, spread across jobs when given.
+        void Sort(JobSystem* jobs = nullptr);
+
+        /// Record the sorted items, the command buffer must be inside a render pass.
+        void Execute(VGpuCommandBuffer commandBuffer) const;
+
+        /// Get the number of submitted items.
+        uint32_t GetItemCount() const { return static_cast<uint32_t>(_items.size()); }
+
+        /// Get the statistics of the last Sort call.
+        const RenderQueueStats& GetStats() const { return _stats; }
+
+        /// Pack a sort key.
+        static uint64_t MakeKey(uint32_t layer, uint32_t pass, uint32_t pipeline, uint32_t material, float depth, RenderSortMode mode);
+
+    private:
+        template <typename F>
+        RenderStateChanges CountStateChanges(uint32_t count, F getItem) const;
+
+        std::vector<VGpuPipeline> _pipelines;
+        std::vector<RenderMaterial> _materials;
+        RenderSortMode _passSortModes[MaxPasses];
+        std::vector<RenderItem> _items;
+        std::vector<uint64_t> _keys;
+        std::vector<uint32_t> _order;
+        std::vector<uint64_t> _keyScratch;
+        std::vector<uint32_t> _orderScratch;
+        RenderQueueStats _stats;
+    };
+}
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "graphics/shader_library.h"
+#include "foundation/log.h"
+#include <string.h>
+#include <vector>
+
+namespace alimer
+{
+    namespace
+    {
+        template <typename T>
+        const T* GetTable(const uint8_t* data, uint32_t offset)
+        {
+            return reinterpret_cast<const T*>(data + offset);
+        }
+
+        bool InRange(uint64_t offset, uint64_t size, uint64_t limit)
+        {
+            return offset <= limit && size <= limit - offset;
+        }
+    }
+
+    bool ShaderLibrary::Load(const std::string& path)
+    {
+        Unload();
+
+        if (!_file.Open(path))
+        {
+            ALIMER_LOGERROR("Failed to open shader library: {}", path);
+            return false;
+        }
+
+        _header = reinterpret_cast<const ShaderLibraryHeader*>(_file.GetData());
+        if (!Validate())
+        {
+            ALIMER_LOGERROR("Invalid shader library: {}", path);
+            Unload();
+            return false;
+        }
+
+        return true;
+    }
+
+    void ShaderLibrary::Unload()
+    {
+        _header = nullptr;
+        _file.Close();
+    }
+
+    bool ShaderLibrary::Validate() const
+    {
+        const uint64_t size = _file.GetSize();
+        if (size < sizeof(ShaderLibraryHeader)
+            || _header->magic != ShaderLibraryMagic
+            || _header->version != ShaderLibraryVersion
+            || _header->target >= ShaderLibraryTarget::Count
+            || _header->fileSize != size)
+        {
+            return false;
+        }
+
+        // Every range is checked once here so lookups can index the tables directly.
+        if (!InRange(_header->stringsOffset, _header->stringsSize, size)
+            || _header->stringsSize == 0
+            || _file.GetData()[_header->stringsOffset + _header->stringsSize - 1] != '\0'
+            || !InRange(_header->programsOffset, uint64_t(_header->programCount) * sizeof(ShaderLibraryProgram), size))
+        {
+            return false;
+        }
+
+        const uint8_t* data = _file.GetData();
+        for (uint32_t i = 0; i < _header->programCount; ++i)
+        {
+            const ShaderLibraryProgram& program = GetTable<ShaderLibraryProgram>(data, _header->programsOffset)[i];
+            if (program.nameOffset >= _header->stringsSize
+                || !InRange(_header->stagesOffset + uint64_t(program.firstStage) * sizeof(ShaderLibraryStageCode), uint64_t(program.stageCount) * sizeof(ShaderLibraryStageCode), size)
+                || !InRange(_header->vertexInputsOffset + uint64_t(program.firstVertexInput) * sizeof(ShaderLibraryVertexInput), uint64_t(program.vertexInputCount) * sizeof(ShaderLibraryVertexInput), size)
+                || !InRange(_header->resourcesOffset + uint64_t(program.firstResource) * sizeof(ShaderLibraryResource), uint64_t(program.resourceCount) * sizeof(ShaderLibraryResource), size))
+            {
+                return false;
+            }
+
+            const ShaderLibraryStageCode* stages = GetStages(&program);
+            for (uint32_t stageIndex = 0; stageIndex < program.stageCount; ++stageIndex)
+            {
+                const ShaderLibraryStageCode& stage = stages[stageIndex];
+                if (stage.stage >= ShaderLibraryStage::Count
+                    || !InRange(stage.spirvOffset, stage.spirvSize, size)
+                    || (stage.codeOffset != ShaderLibraryInvalidOffset && !InRange(stage.codeOffset, uint64_t(stage.codeSize) + 1, size)))
+                {
+                    return false;
+                }
+            }
+
+            const ShaderLibraryVertexInput* inputs = GetVertexInputs(&program);
+            for (uint32_t inputIndex = 0; inputIndex < program.vertexInputCount; ++inputIndex)
+            {
+                if (inputs[inputIndex].nameOffset >= _header->stringsSize) {
+                    return false;
+                }
+            }
+
+            const ShaderLibraryResource* resources = GetResources(&program);
+            for (uint32_t resourceIndex = 0; resourceIndex < program.resourceCount; ++resourceIndex)
+            {
+                if (resources[resourceIndex].nameOffset >= _header->stringsSize) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    const ShaderLibraryProgram* ShaderLibrary::GetProgram(uint32_t index) const
+    {
+        if (!_header || index >= _header->programCount) {
+            return nullptr;
+        }
+
+        return GetTable<ShaderLibraryProgram>(_file.GetData(), _header->programsOffset) + index;
+    }
+
+    const ShaderLibraryProgram* ShaderLibrary::FindProgram(const char* name) const
+    {
+        if (!_header) {
+            return nullptr;
+        }
+
+        const uint64_t hash = ShaderLibraryHash(name);
+        const ShaderLibraryProgram* programs = GetTable<ShaderLibraryProgram>(_file.GetData(), _header->programsOffset);
+        uint32_t first = 0;
+        uint32_t count = _header->programCount;
+        while (count > 0)
+        {
+            const uint32_t step = count / 2;
+            if (programs[first + step].nameHash < hash)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        for (uint32_t i = first; i < _header->programCount && programs[i].nameHash == hash; ++i)
+        {
+            if (strcmp(GetString(programs[i].nameOffset), name) == 0) {
+                return &programs[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    const ShaderLibraryStageCode* ShaderLibrary::GetStages(const ShaderLibraryProgram* program) const
+    {
+        return GetTable<ShaderLibraryStageCode>(_file.GetData(), _header->stagesOffset) + program->firstStage;
+    }
+
+    const ShaderLibraryVertexInput* ShaderLibrary::GetVertexInputs(const ShaderLibraryProgram* program) const
+    {
+        return GetTable<ShaderLibraryVertexInput>(_file.GetData(), _header->vertexInputsOffset) + program->firstVertexInput;
+    }
+
+    const ShaderLibraryResource* ShaderLibrary::GetResources(const ShaderLibraryProgram* program) const
+    {
+        return GetTable<ShaderLibraryResource>(_file.GetData(), _header->resourcesOffset) + program->firstResource;
+    }
+
+    const char* ShaderLibrary::GetString(uint32_t offset) const
+    {
+        return reinterpret_cast<const char*>(_file.GetData() + _header->stringsOffset + offset);
+    }
+
+    VGpuShader ShaderLibrary::CreateShader(const ShaderLibraryProgram* program) const
+    {
+        if (!_header || !program || _header->target == ShaderLibraryTarget::SPIRV) {
+            return nullptr;
+        }
+
+        VGpuShaderDescriptor descriptor = {};
+        const ShaderLibraryStageCode* stages = GetStages(program);
+        for (uint32_t i = 0; i < program->stageCount; ++i)
+        {
+            VGpuShaderStageDescriptor* stageDescriptor = nullptr;
+            switch (stages[i].stage)
+            {
+            case ShaderLibraryStage::Vertex:
+                stageDescriptor = &descriptor.vertex;
+                break;
+            case ShaderLibraryStage::Fragment:
+                stageDescriptor = &descriptor.fragment;
+                break;
+            case ShaderLibraryStage::Compute:
+                stageDescriptor = &descriptor.compute;
+                break;
+            default:
+                continue;
+            }
+
+            stageDescriptor->code = GetData(stages[i].codeOffset);
+            stageDescriptor->codeSize = stages[i].codeSize;
+        }
+
+        // Names are bound before link so vertex layouts and resources do not depend on GL defaults.
+        const ShaderLibraryVertexInput* inputs = GetVertexInputs(program);
+        std::vector<VGpuShaderVertexInput> vertexInputs(program->vertexInputCount);
+        for (uint32_t i = 0; i < program->vertexInputCount; ++i)
+        {
+            vertexInputs[i].name = GetString(inputs[i].nameOffset);
+            vertexInputs[i].location = inputs[i].location;
+        }
+
+        const ShaderLibraryResource* resources = GetResources(program);
+        std::vector<VGpuShaderResourceBinding> bindings;
+        bindings.reserve(program->resourceCount);
+        for (uint32_t i = 0; i < program->resourceCount; ++i)
+        {
+            VGpuShaderResourceBinding binding = {};
+            switch (resources[i].type)
+            {
+            case ShaderLibraryResourceType::UniformBuffer:
+                binding.type = VGPU_SHADER_RESOURCE_TYPE_UNIFORM_BUFFER;
+                break;
+            case ShaderLibraryResourceType::SampledTexture:
+            case ShaderLibraryResourceType::CombinedTextureSampler:
+                binding.type = VGPU_SHADER_RESOURCE_TYPE_TEXTURE;
+                break;
+            default:
+                continue;
+            }
+
+            binding.name = GetString(resources[i].nameOffset);
+            binding.binding = resources[i].slot;
+            bindings.push_back(binding);
+        }
+
+        descriptor.vertexInputCount = program->vertexInputCount;
+        descriptor.vertexInputs = vertexInputs.data();
+        descriptor.resourceCount = static_cast<uint32_t>(bindings.size());
+        descriptor.resources = bindings.data();
+        return vgpuCreateShaderWithDescriptor(&descriptor);
+    }
+}
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/mapped_file.h"
+#include "graphics/shader_library_format.h"
+#include <vgpu.h>
+
+namespace alimer
+{
+    /// Precompiled shader programs produced by alimer-shaderc, mapped and used in place.
+    class ALIMER_API ShaderLibrary final
+    {
+    public:
+        /// Constructor.
+        ShaderLibrary() = default;
+
+        /// Destructor.
+        ~ShaderLibrary() = default;
+
+        ShaderLibrary(const ShaderLibrary&) = delete;
+        ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+        /// Map and validate the library at path.
+        bool Load(const std::string& path);
+
+        /// Unmap the library, pointers returned earlier become invalid.
+        void Unload();
+
+        /// Check if a library is loaded.
+        bool IsLoaded() const { return _header != nullptr; }
+
+        /// Get the code format of the loaded library.
+        ShaderLibraryTarget GetTarget() const { return _header->target; }
+
+        /// Get the number of programs.
+        uint32_t GetProgramCount() const { return _header ? _header->programCount : 0; }
+
+        /// Get program by index, sorted by name hash.
+        const ShaderLibraryProgram* GetProgram(uint32_t index) const;
+
+        /// Find program by name, for example "sprite" or "sprite+HAVE_VERTEX_COLOR".
+        const ShaderLibraryProgram* FindProgram(const char* name) const;
+
+        /// Get the program stages.
+        const ShaderLibraryStageCode* GetStages(const ShaderLibraryProgram* program) const;
+
+        /// Get the reflected vertex inputs sorted by location.
+        const ShaderLibraryVertexInput* GetVertexInputs(const ShaderLibraryProgram* program) const;
+
+        /// Get the reflected resources sorted by set and binding.
+        const ShaderLibraryResource* GetResources(const ShaderLibraryProgram* program) const;
+
+        /// Get a string from the string table.
+        const char* GetString(uint32_t offset) const;
+
+        /// Get a pointer into the library.
+        const void* GetData(uint32_t offset) const { return _file.GetData() + offset; }
+
+        /// Create a vgpu shader from a GLSL program, returns nullptr for SPIR-V libraries.
+        VGpuShader CreateShader(const ShaderLibraryProgram* program) const;
+
+    private:
+        bool Validate() const;
+
+        MappedFile _file;
+        const ShaderLibraryHeader* _header = nullptr;
+    };
+}
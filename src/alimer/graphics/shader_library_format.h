@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Binary layout shared by alimer-shaderc and the runtime ShaderLibrary loader.
+ * Every offset is relative to the start of the file, blobs are aligned to ShaderLibraryAlignment
+ * so the file can be mapped and used in place. */
+namespace alimer
+{
+    static constexpr uint32_t ShaderLibraryMagic = 0x4C534C41u; // 'ALSL'
+    static constexpr uint32_t ShaderLibraryVersion = 1;
+    static constexpr uint32_t ShaderLibraryAlignment = 16;
+    static constexpr uint32_t ShaderLibraryInvalidOffset = ~0u;
+
+    /// Code format stored in the library.
+    enum class ShaderLibraryTarget : uint32_t
+    {
+        /// Desktop GLSL 3.30 core.
+        GLSL330 = 0,
+        /// Desktop GLSL 4.30 core.
+        GLSL430,
+        /// GLSL ES 3.00.
+        GLSLES300,
+        /// GLSL ES 3.10.
+        GLSLES310,
+        /// SPIR-V words only.
+        SPIRV,
+        Count
+    };
+
+    /// Shader stage, matches VGpuShaderStageFlagBits bit positions.
+    enum class ShaderLibraryStage : uint32_t
+    {
+        Vertex = 0,
+        TessControl = 1,
+        TessEvaluation = 2,
+        Geometry = 3,
+        Fragment = 4,
+        Compute = 5,
+        Count
+    };
+
+    /// Scalar type of reflected vertex inputs.
+    enum class ShaderLibraryBaseType : uint32_t
+    {
+        Float = 0,
+        Int,
+        UInt
+    };
+
+    /// Kind of reflected shader resource.
+    enum class ShaderLibraryResourceType : uint32_t
+    {
+        UniformBuffer = 0,
+        StorageBuffer,
+        SampledTexture,
+        CombinedTextureSampler,
+        Sampler,
+        StorageTexture,
+        PushConstant
+    };
+
+    struct ShaderLibraryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        ShaderLibraryTarget target;
+        uint32_t programCount;
+        /// Sorted by nameHash.
+        uint32_t programsOffset;
+        uint32_t stagesOffset;
+        uint32_t vertexInputsOffset;
+        uint32_t resourcesOffset;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+        uint32_t fileSize;
+        uint32_t reserved;
+    };
+
+    struct ShaderLibraryProgram
+    {
+        uint64_t nameHash;
+        /// Offset of the null terminated name in the string table.
+        uint32_t nameOffset;
+        /// Mask of (1 << ShaderLibraryStage).
+        uint32_t stageMask;
+        uint32_t firstStage;
+        uint32_t stageCount;
+        uint32_t firstVertexInput;
+        uint32_t vertexInputCount;
+        uint32_t firstResource;
+        uint32_t resourceCount;
+        /// Compute local size, zero for graphics programs.
+        uint32_t localSize[3];
+        uint32_t reserved;
+    };
+
+    struct ShaderLibraryStageCode
+    {
+        ShaderLibraryStage stage;
+        /// Null terminated GLSL source, ShaderLibraryInvalidOffset for SPIR-V targets.
+        uint32_t codeOffset;
+        uint32_t codeSize;
+        uint32_t spirvOffset;
+        /// Size in bytes.
+        uint32_t spirvSize;
+        uint32_t reserved;
+    };
+
+    struct ShaderLibraryVertexInput
+    {
+        uint32_t nameOffset;
+        uint32_t location;
+        ShaderLibraryBaseType baseType;
+        uint32_t componentCount;
+    };
+
+    struct ShaderLibraryResource
+    {
+        /// Name visible to the target, block name for uniform and storage buffers.
+        uint32_t nameOffset;
+        ShaderLibraryResourceType type;
+        uint32_t set;
+        uint32_t binding;
+        /// Mask of (1 << ShaderLibraryStage) that access the resource.
+        uint32_t stageMask;
+        /// Declared size in bytes of buffer blocks, zero otherwise.
+        uint32_t size;
+        uint32_t arraySize;
+        /// Flat binding slot for targets without descriptor sets, counted per class
+        /// (uniform buffers, storage buffers, textures, storage textures, samplers) in set and binding order.
+        uint32_t slot;
+    };
+
+    /// FNV-1a hash used for program names.
+    inline uint64_t ShaderLibraryHash(const char* name)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        while (*name)
+        {
+            hash ^= static_cast<uint8_t>(*name++);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,254 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "graphics/sprite_batch.h"
+#include "foundation/log.h"
+#include "foundation/radix_sort.h"
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace alimer
+{
+    static_assert(sizeof(float) * 11 + sizeof(uint32_t) == SpriteBatch::InstanceStride, "Sprite instance layout mismatch");
+
+    void SpriteBatch::GetVertexDescriptor(VGpuVertexDescriptor* descriptor, bool vertexColor)
+    {
+        memset(descriptor, 0, sizeof(VGpuVertexDescriptor));
+        descriptor->layouts[0].stride = InstanceStride;
+        descriptor->layouts[0].inputRate = VGPU_VERTEX_INPUT_RATE_INSTANCE;
+        descriptor->attributes[0].format = VGPU_VERTEX_FORMAT_FLOAT4;
+        descriptor->attributes[0].offset = offsetof(Instance, positionSize);
+        descriptor->attributes[1].format = VGPU_VERTEX_FORMAT_FLOAT3;
+        descriptor->attributes[1].offset = offsetof(Instance, rotationDepth);
+        descriptor->attributes[2].format = VGPU_VERTEX_FORMAT_FLOAT4;
+        descriptor->attributes[2].offset = offsetof(Instance, texRect);
+        if (vertexColor)
+        {
+            descriptor->attributes[3].format = VGPU_VERTEX_FORMAT_UBYTE4N;
+            descriptor->attributes[3].offset = offsetof(Instance, color);
+        }
+    }
+
+    uint32_t SpriteBatch::RegisterPipeline(VGpuPipeline pipeline)
+    {
+        assert(_pipelines.size() < MaxPipelines);
+        _pipelines.push_back(pipeline);
+        return static_cast<uint32_t>(_pipelines.size() - 1);
+    }
+
+    void SpriteBatch::Begin(const float* viewMatrix, const float* projectionMatrix)
+    {
+        assert(!_active);
+        memcpy(_camera, viewMatrix, sizeof(float) * 16);
+        memcpy(_camera + 16, projectionMatrix, sizeof(float) * 16);
+
+        _instances.clear();
+        _keys.clear();
+        _indices.clear();
+        _textures.clear();
+        _textureIds.clear();
+        _lastTexture = nullptr;
+        _lastTextureId = 0;
+        _active = true;
+    }
+
+    uint32_t SpriteBatch::GetTextureId(VGpuTexture texture)
+    {
+        // Consecutive sprites usually share a texture.
+        if (texture == _lastTexture && !_textures.empty()) {
+            return _lastTextureId;
+        }
+
+        auto it = _textureIds.find(texture);
+        uint32_t id;
+        if (it != _textureIds.end())
+        {
+            id = it->second;
+        }
+        else
+        {
+            assert(_textures.size() < MaxTextures);
+            id = static_cast<uint32_t>(_textures.size());
+            _textures.push_back(texture);
+            _textureIds.emplace(texture, id);
+        }
+
+        _lastTexture = texture;
+        _lastTextureId = id;
+        return id;
+    }
+
+    void SpriteBatch::AddSprite(const Sprite& sprite, uint64_t state)
+    {
+        const uint32_t index = static_cast<uint32_t>(_instances.size());
+        _instances.emplace_back();
+
+        Instance& instance = _instances.back();
+        instance.positionSize[0] = sprite.x;
+        instance.positionSize[1] = sprite.y;
+        instance.positionSize[2] = sprite.width * 0.5f;
+        instance.positionSize[3] = sprite.height * 0.5f;
+        if (sprite.rotation != 0.0f)
+        {
+            instance.rotationDepth[0] = std::cos(sprite.rotation);
+            instance.rotationDepth[1] = std::sin(sprite.rotation);
+        }
+        else
+        {
+            instance.rotationDepth[0] = 1.0f;
+            instance.rotationDepth[1] = 0.0f;
+        }
+        instance.rotationDepth[2] = sprite.depth;
+        instance.texRect[0] = sprite.u0;
+        instance.texRect[1] = sprite.v0;
+        instance.texRect[2] = sprite.u1;
+        instance.texRect[3] = sprite.v1;
+        instance.color = sprite.color;
+
+        _keys.push_back((static_cast<uint64_t>(sprite.layer) << 24) | state);
+        _indices.push_back(index);
+    }
+
+    void SpriteBatch::Draw(VGpuTexture texture, const Sprite& sprite, uint32_t pipeline)
+    {
+        assert(_active);
+        assert(pipeline < _pipelines.size());
+        assert(_instances.size() < MaxSprites);
+
+        AddSprite(sprite, (static_cast<uint64_t>(pipeline) << 16) | GetTextureId(texture));
+    }
+
+    void SpriteBatch::Draw(VGpuTexture texture, const Sprite* sprites, uint32_t count, uint32_t pipeline)
+    {
+        assert(_active);
+        assert(pipeline < _pipelines.size());
+        assert(_instances.size() + count <= MaxSprites);
+
+        const uint64_t state = (static_cast<uint64_t>(pipeline) << 16) | GetTextureId(texture);
+        _instances.reserve(_instances.size() + count);
+        _keys.reserve(_keys.size() + count);
+        _indices.reserve(_indices.size() + count);
+        for (uint32_t i = 0; i < count; i++) {
+            AddSprite(sprites[i], state);
+        }
+    }
+
+    void SpriteBatch::Sort()
+    {
+        // Stable, equal keys keep submission order. Passes over the unused upper key bytes are skipped.
+        const uint32_t count = static_cast<uint32_t>(_keys.size());
+        _keyScratch.resize(count);
+        _indexScratch.resize(count);
+        RadixSort(_keys.data(), _indices.data(), _keyScratch.data(), _indexScratch.data(), count);
+    }
+
+    void SpriteBatch::End(VGpuCommandBuffer commandBuffer)
+    {
+        assert(_active);
+        _active = false;
+        _stats = SpriteBatchStats();
+
+        const uint32_t count = static_cast<uint32_t>(_keys.size());
+        if (count == 0) {
+            return;
+        }
+
+        VGpuTransientAllocation camera;
+        if (vgpuAllocateTransient(VGPU_BUFFER_USAGE_UNIFORM, sizeof(_camera), 256, &camera) != VGPU_SUCCESS)
+        {
+            ALIMER_LOGERROR("SpriteBatch: failed to allocate camera uniform data");
+            return;
+        }
+        memcpy(camera.data, _camera, sizeof(_camera));
+        vgpuFlushBuffer(camera.buffer, camera.offset, sizeof(_camera));
+
+        Sort();
+
+        const uint64_t* keys = _keys.data();
+        const uint32_t* indices = _indices.data();
+        const Instance* instances = _instances.data();
+        uint32_t currentPipeline = ~0u;
+        uint32_t currentTexture = ~0u;
+
+        for (uint32_t chunkBegin = 0; chunkBegin < count; chunkBegin += SpritesPerAllocation)
+        {
+            const uint32_t chunkEnd = (count - chunkBegin) > SpritesPerAllocation ? chunkBegin + SpritesPerAllocation : count;
+            const uint64_t chunkSize = static_cast<uint64_t>(chunkEnd - chunkBegin) * InstanceStride;
+
+            VGpuTransientAllocation allocation;
+            if (vgpuAllocateTransient(VGPU_BUFFER_USAGE_VERTEX, chunkSize, 16, &allocation) != VGPU_SUCCESS)
+            {
+                ALIMER_LOGERROR("SpriteBatch: transient vertex memory exhausted, increase VGpuRendererSettings::transientBufferSize");
+                return;
+            }
+
+            // Gather instances in sorted order so each run is contiguous.
+            Instance* output = static_cast<Instance*>(allocation.data);
+            for (uint32_t i = chunkBegin; i < chunkEnd; i++) {
+                output[i - chunkBegin] = instances[indices[i]];
+            }
+            vgpuFlushBuffer(allocation.buffer, allocation.offset, chunkSize);
+
+            uint32_t runBegin = chunkBegin;
+            while (runBegin < chunkEnd)
+            {
+                // Only the pipeline and texture bits split runs, consecutive layers with the same state are already contiguous.
+                const uint64_t runKey = keys[runBegin] & 0xffffff;
+                uint32_t runEnd = runBegin + 1;
+                while (runEnd < chunkEnd && (keys[runEnd] & 0xffffff) == runKey) {
+                    runEnd++;
+                }
+
+                const uint32_t pipeline = static_cast<uint32_t>(runKey >> 16) & 0xff;
+                const uint32_t texture = static_cast<uint32_t>(runKey) & 0xffff;
+                if (pipeline != currentPipeline)
+                {
+                    vgpuCmdBindPipeline(commandBuffer, _pipelines[pipeline]);
+                    if (currentPipeline == ~0u) {
+                        vgpuCmdSetUniformBuffer(commandBuffer, 0, camera.buffer, camera.offset, sizeof(_camera));
+                    }
+                    currentPipeline = pipeline;
+                    _stats.pipelineChanges++;
+                }
+
+                if (texture != currentTexture)
+                {
+                    vgpuCmdSetTexture(commandBuffer, 0, _textures[texture]);
+                    currentTexture = texture;
+                    _stats.textureChanges++;
+                }
+
+                const uint64_t offset = allocation.offset + static_cast<uint64_t>(runBegin - chunkBegin) * InstanceStride;
+                vgpuCmdSetVertexBuffers(commandBuffer, 0, 1, &allocation.buffer, &offset);
+                vgpuCmdDraw(commandBuffer, 4, runEnd - runBegin, 0);
+                _stats.draws++;
+
+                runBegin = runEnd;
+            }
+        }
+
+        _stats.sprites = count;
+    }
+}
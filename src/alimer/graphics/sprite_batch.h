@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/math/matrix4.h"
+#include <vgpu.h>
+#include <unordered_map>
+#include <vector>
+
+namespace alimer
+{
+    /// Textured quad submitted to a SpriteBatch.
+    struct Sprite
+    {
+        /// Center position.
+        float x = 0.0f;
+        float y = 0.0f;
+        /// Size in world units.
+        float width = 1.0f;
+        float height = 1.0f;
+        /// Rotation around the center in radians.
+        float rotation = 0.0f;
+        float depth = 0.0f;
+        /// Texture rectangle in normalized coordinates.
+        float u0 = 0.0f;
+        float v0 = 0.0f;
+        float u1 = 1.0f;
+        float v1 = 1.0f;
+        /// Packed RGBA8 tint, red in the lowest byte.
+        uint32_t color = 0xffffffffu;
+        /// Sprites are drawn in ascending layer order, submission order is kept inside a layer.
+        uint16_t layer = 0;
+    };
+
+    /// Sprite batch statistics of the last End call.
+    struct SpriteBatchStats
+    {
+        uint32_t sprites = 0;
+        uint32_t draws = 0;
+        uint32_t pipelineChanges = 0;
+        uint32_t textureChanges = 0;
+    };
+
+    /// Collects sprites into per instance data, sorts them by layer, pipeline and texture with a radix sort
+    /// and records one instanced draw per run in transient vertex memory.
+    class ALIMER_API SpriteBatch final
+    {
+    public:
+        /// Maximum number of sprites between Begin and End.
+        static constexpr uint32_t MaxSprites = 1u << 24;
+        /// Maximum number of registered pipelines.
+        static constexpr uint32_t MaxPipelines = 256;
+        /// Maximum number of distinct textures between Begin and End.
+        static constexpr uint32_t MaxTextures = 1u << 16;
+        /// Sprites written to a single transient allocation.
+        static constexpr uint32_t SpritesPerAllocation = 16384;
+
+        /// Size of the per instance vertex data.
+        static constexpr uint32_t InstanceStride = 48;
+
+        /// Constructor.
+        SpriteBatch() = default;
+
+        /// Destructor.
+        ~SpriteBatch() = default;
+
+        SpriteBatch(const SpriteBatch&) = delete;
+        SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+        /// Fill the vertex layout expected by sprite.vert, pipelines must draw 4 vertex triangle strips.
+        static void GetVertexDescriptor(VGpuVertexDescriptor* descriptor, bool vertexColor = true);
+
+        /// Register a pipeline created with GetVertexDescriptor, returns the id passed to Draw.
+        uint32_t RegisterPipeline(VGpuPipeline pipeline);
+
+        /// Start a batch, matrices are column major 4x4 and are written to the camera uniform block.
+        void Begin(const float* viewMatrix, const float* projectionMatrix);
+
+        /// Start a batch with view and projection matrices.
+        void Begin(const Matrix4& viewMatrix, const Matrix4& projectionMatrix) { Begin(viewMatrix.m, projectionMatrix.m); }
+
+        /// Add a sprite.
+        void Draw(VGpuTexture texture, const Sprite& sprite, uint32_t pipeline = 0);
+
+        /// Add count sprites sharing texture and pipeline.
+        void Draw(VGpuTexture texture, const Sprite* sprites, uint32_t count, uint32_t pipeline = 0);
+
+        /// Sort and record the draws into commandBuffer, the command buffer must be inside a render pass.
+        void End(VGpuCommandBuffer commandBuffer);
+
+        /// Get the statistics of the last End call.
+        const SpriteBatchStats& GetStats() const { return _stats; }
+
+    private:
+        struct Instance
+        {
+            float positionSize[4];
+            float rotationDepth[3];
+            float texRect[4];
+            uint32_t color;
+        };
+
+        uint32_t GetTextureId(VGpuTexture texture);
+        void AddSprite(const Sprite& sprite, uint64_t state);
+        void Sort();
+
+        std::vector<VGpuPipeline> _pipelines;
+        std::vector<VGpuTexture> _textures;
+        std::unordered_map<VGpuTexture, uint32_t> _textureIds;
+        std::vector<Instance> _instances;
+        /// Sort keys, layer, pipeline and texture packed in the lower 40 bits.
+        std::vector<uint64_t> _keys;
+        /// Instance index of each key, permuted with the keys.
+        std::vector<uint32_t> _indices;
+        std::vector<uint64_t> _keyScratch;
+        std::vector<uint32_t> _indexScratch;
+        float _camera[32] = {};
+        VGpuTexture _lastTexture = nullptr;
+        uint32_t _lastTextureId = 0;
+        bool _active = false;
+        SpriteBatchStats _stats;
+    };
+}
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "graphics/texture.h"
+#include "foundation/log.h"
+#include <vector>
+
+namespace alimer
+{
+    Texture::~Texture()
+    {
+        if (_texture) {
+            vgpuDestroyTexture(_texture);
+        }
+    }
+
+    TextureLoader::TextureLoader(JobSystem* jobs, bool generateMipmaps, TextureCompression compression, CompressionQuality quality)
+        : _jobs(jobs)
+        , _generateMipmaps(generateMipmaps)
+        , _compression(compression)
+        , _quality(quality)
+    {
+    }
+
+    Asset* TextureLoader::Create()
+    {
+        return new Texture();
+    }
+
+    bool TextureLoader::Decode(Asset* asset, const uint8_t* data, size_t size)
+    {
+        Texture* texture = static_cast<Texture*>(asset);
+        if (!texture->_image.Decode(data, size))
+        {
+            ALIMER_LOGERROR("Failed to decode texture '{}'", texture->GetName());
+            return false;
+        }
+
+        if (_generateMipmaps) {
+            texture->_image.GenerateMipmaps(_jobs);
+        }
+
+        if (_compression != TextureCompression::Uncompressed && vgpuQueryFeature(VGPU_FEATURE_TEXTURE_COMPRESSION_BC))
+        {
+            BlockFormat format;
+            switch (_compression)
+            {
+            case TextureCompression::BC1: format = BlockFormat::BC1; break;
+            case TextureCompression::BC3: format = BlockFormat::BC3; break;
+            case TextureCompression::BC4: format = BlockFormat::BC4; break;
+            case TextureCompression::BC5: format = BlockFormat::BC5; break;
+            case TextureCompression::BC7: format = BlockFormat::BC7; break;
+            default:
+                format = texture->_image.HasAlpha() ? BlockFormat::BC3 : BlockFormat::BC1;
+                break;
+            }
+
+            texture->_image.Compress(format, _quality, _jobs);
+        }
+
+        return true;
+    }
+
+    uint64_t TextureLoader::GetUploadSize(const Asset* asset) const
+    {
+        return static_cast<const Texture*>(asset)->_image.GetDataSize();
+    }
+
+    bool TextureLoader::Upload(Asset* asset)
+    {
+        Texture* texture = static_cast<Texture*>(asset);
+        const Image& image = texture->_image;
+
+        VGpuTextureDescriptor descriptor = {};
+        descriptor.textureType = VGPU_TEXTURE_TYPE_2D;
+        descriptor.pixelFormat = image.GetFormat();
+        descriptor.size.width = image.GetWidth();
+        descriptor.size.height = image.GetHeight();
+        descriptor.size.depth = 1;
+        descriptor.mipLevels = image.GetMipLevels();
+        descriptor.arrayLayers = 1;
+        descriptor.samples = VGPU_SAMPLE_COUNT1;
+        descriptor.usage = VGPU_TEXTURE_USAGE_SHADER_READ;
+        descriptor.label = texture->GetName().c_str();
+
+        std::vector<VGpuTextureData> initialData(descriptor.mipLevels);
+        for (uint32_t level = 0; level < descriptor.mipLevels; level++) {
+            initialData[level].data = image.GetMipData(level);
+        }
+
+        texture->_texture = vgpuCreateTexture(&descriptor, initialData.data());
+        texture->_width = image.GetWidth();
+        texture->_height = image.GetHeight();
+        texture->_mipLevels = image.GetMipLevels();
+        texture->_image.Clear();
+        return texture->_texture != nullptr;
+    }
+}
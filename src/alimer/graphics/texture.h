@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "content/asset.h"
+#include "graphics/image.h"
+#include <vgpu.h>
+
+namespace alimer
+{
+    class JobSystem;
+
+    /// Block compression applied to textures when they are imported.
+    enum class TextureCompression : uint32_t
+    {
+        /// Keep the source pixels, not named None to stay clear of the Xlib macro.
+        Uncompressed = 0,
+        /// BC1 for opaque images, BC3 when any pixel has alpha.
+        Auto,
+        BC1,
+        BC3,
+        BC4,
+        BC5,
+        BC7
+    };
+
+    /// Sampled 2D texture asset.
+    class ALIMER_API Texture final : public Asset
+    {
+    public:
+        /// Constructor.
+        Texture() = default;
+
+        /// Destructor.
+        ~Texture() override;
+
+        /// Get the vgpu texture, null until the asset is ready.
+        VGpuTexture GetHandle() const { return _texture; }
+
+        /// Get the width of level 0.
+        uint32_t GetWidth() const { return _width; }
+
+        /// Get the height of level 0.
+        uint32_t GetHeight() const { return _height; }
+
+        /// Get the number of mip levels.
+        uint32_t GetMipLevels() const { return _mipLevels; }
+
+    private:
+        friend class TextureLoader;
+
+        /// Decoded levels waiting for upload.
+        Image _image;
+        VGpuTexture _texture = nullptr;
+        uint32_t _width = 0;
+        uint32_t _height = 0;
+        uint32_t _mipLevels = 0;
+    };
+
+    /// Decodes, builds the mip chain and compresses images on worker threads, then uploads every level in one vgpuCreateTexture call.
+    class ALIMER_API TextureLoader final : public AssetLoader
+    {
+    public:
+        /// Constructor, large levels are processed in parallel on jobs when given. Compression is skipped
+        /// when the device has no BC support.
+        explicit TextureLoader(JobSystem* jobs = nullptr, bool generateMipmaps = true,
+            TextureCompression compression = TextureCompression::Uncompressed, CompressionQuality quality = CompressionQuality::Normal);
+
+        Asset* Create() override;
+        bool Decode(Asset* asset, const uint8_t* data, size_t size) override;
+        uint64_t GetUploadSize(const Asset* asset) const override;
+        bool Upload(Asset* asset) override;
+
+    private:
+        JobSystem* _jobs;
+        bool _generateMipmaps;
+        TextureCompression _compression;
+        CompressionQuality _quality;
+    };
+}
@@ -0,0 +1,466 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "scene/bounding_box_tree.h"
+#include "foundation/math/simd_lane.h"
+#include <cassert>
+#include <mutex>
+
+namespace alimer
+{
+    constexpr uint32_t BoundingBoxTree::NullNode;
+
+    BoundingBoxTree::BoundingBoxTree(float margin)
+        : _margin(margin)
+    {
+    }
+
+    BoundingBoxTree::~BoundingBoxTree() = default;
+
+    uint32_t BoundingBoxTree::AllocateNode()
+    {
+        uint32_t index;
+        if (_freeList != NullNode)
+        {
+            index = _freeList;
+            _freeList = _nodes[index].parent;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(_nodes.size());
+            _nodes.push_back({});
+        }
+
+        Node& node = _nodes[index];
+        node.parent = NullNode;
+        node.child1 = NullNode;
+        node.child2 = NullNode;
+        node.height = 0;
+        node.userData = 0;
+        return index;
+    }
+
+    void BoundingBoxTree::FreeNode(uint32_t index)
+    {
+        // Free nodes are chained through parent.
+        _nodes[index].parent = _freeList;
+        _nodes[index].height = -1;
+        _freeList = index;
+    }
+
+    uint32_t BoundingBoxTree::CreateProxy(const BoundingBox& box, uint32_t userData)
+    {
+        const uint32_t proxy = AllocateNode();
+        Node& node = _nodes[proxy];
+        node.box = BoundingBox(box.min - Vector3(_margin), box.max + Vector3(_margin));
+        node.userData = userData;
+        InsertLeaf(proxy);
+        _proxyCount++;
+        return proxy;
+    }
+
+    void BoundingBoxTree::DestroyProxy(uint32_t proxy)
+    {
+        assert(proxy < _nodes.size() && _nodes[proxy].IsLeaf() && _nodes[proxy].height == 0);
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        _proxyCount--;
+    }
+
+    bool BoundingBoxTree::MoveProxy(uint32_t proxy, const BoundingBox& box)
+    {
+        assert(proxy < _nodes.size() && _nodes[proxy].IsLeaf() && _nodes[proxy].height == 0);
+        if (_nodes[proxy].box.Contains(box)) {
+            return false;
+        }
+
+        RemoveLeaf(proxy);
+        _nodes[proxy].box = BoundingBox(box.min - Vector3(_margin), box.max + Vector3(_margin));
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void BoundingBoxTree::InsertLeaf(uint32_t leaf)
+    {
+        if (_root == NullNode)
+        {
+            _root = leaf;
+            _nodes[leaf].parent = NullNode;
+            return;
+        }
+
+        // Descend towards the sibling with the lowest surface area increase, stop when pairing
+        // with the current node is cheaper than pushing the leaf further down.
+        const BoundingBox leafBox = _nodes[leaf].box;
+        uint32_t index = _root;
+        while (!_nodes[index].IsLeaf())
+        {
+            const Node& node = _nodes[index];
+            const float area = node.box.GetSurfaceArea();
+            const float combinedArea = Merge(node.box, leafBox).GetSurfaceArea();
+            const float cost = 2.0f * combinedArea;
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            float childCosts[2];
+            const uint32_t children[2] = { node.child1, node.child2 };
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                const Node& child = _nodes[children[i]];
+                const float mergedArea = Merge(child.box, leafBox).GetSurfaceArea();
+                childCosts[i] = (child.IsLeaf() ? mergedArea : mergedArea - child.box.GetSurfaceArea()) + inheritanceCost;
+            }
+
+            if (cost < childCosts[0] && cost < childCosts[1]) {
+                break;
+            }
+
+            index = childCosts[0] < childCosts[1] ? node.child1 : node.child2;
+        }
+
+        const uint32_t sibling = index;
+        const uint32_t oldParent = _nodes[sibling].parent;
+        const uint32_t newParent = AllocateNode();
+        _nodes[newParent].parent = oldParent;
+        _nodes[newParent].box = Merge(leafBox, _nodes[sibling].box);
+        _nodes[newParent].height = _nodes[sibling].height + 1;
+        _nodes[newParent].child1 = sibling;
+        _nodes[newParent].child2 = leaf;
+        _nodes[sibling].parent = newParent;
+        _nodes[leaf].parent = newParent;
+
+        if (oldParent != NullNode)
+        {
+            if (_nodes[oldParent].child1 == sibling) {
+                _nodes[oldParent].child1 = newParent;
+            }
+            else {
+                _nodes[oldParent].child2 = newParent;
+            }
+        }
+        else
+        {
+            _root = newParent;
+        }
+
+        RefitAncestors(newParent);
+    }
+
+    void BoundingBoxTree::RemoveLeaf(uint32_t leaf)
+    {
+        if (leaf == _root)
+        {
+            _root = NullNode;
+            return;
+        }
+
+        const uint32_t parent = _nodes[leaf].parent;
+        const uint32_t grandParent = _nodes[parent].parent;
+        const uint32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+        if (grandParent != NullNode)
+        {
+            if (_nodes[grandParent].child1 == parent) {
+                _nodes[grandParent].child1 = sibling;
+            }
+            else {
+                _nodes[grandParent].child2 = sibling;
+            }
+
+            _nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            RefitAncestors(grandParent);
+        }
+        else
+        {
+            _root = sibling;
+            _nodes[sibling].parent = NullNode;
+            FreeNode(parent);
+        }
+
+        _nodes[leaf].parent = NullNode;
+    }
+
+    void BoundingBoxTree::RefitAncestors(uint32_t index)
+    {
+        while (index != NullNode)
+        {
+            index = Balance(index);
+
+            Node& node = _nodes[index];
+            const Node& child1 = _nodes[node.child1];
+            const Node& child2 = _nodes[node.child2];
+            node.height = 1 + Max(child1.height, child2.height);
+            node.box = Merge(child1.box, child2.box);
+            index = node.parent;
+        }
+    }
+
+    uint32_t BoundingBoxTree::Balance(uint32_t indexA)
+    {
+        Node& a = _nodes[indexA];
+        if (a.IsLeaf() || a.height < 2) {
+            return indexA;
+        }
+
+        const uint32_t indexB = a.child1;
+        const uint32_t indexC = a.child2;
+        Node& b = _nodes[indexB];
+        Node& c = _nodes[indexC];
+        const int32_t balance = c.height - b.height;
+
+        // Rotate the taller child up, its taller child stays below it and the other one moves under a.
+        if (balance > 1 || balance < -1)
+        {
+            const uint32_t indexUp = balance > 1 ? indexC : indexB;
+            const uint32_t indexStay = balance > 1 ? indexB : indexC;
+            Node& up = _nodes[indexUp];
+            const Node& stay = _nodes[indexStay];
+            const uint32_t indexF = up.child1;
+            const uint32_t indexG = up.child2;
+            Node& f = _nodes[indexF];
+            Node& g = _nodes[indexG];
+
+            up.child1 = indexA;
+            up.parent = a.parent;
+            a.parent = indexUp;
+            if (up.parent != NullNode)
+            {
+                if (_nodes[up.parent].child1 == indexA) {
+                    _nodes[up.parent].child1 = indexUp;
+                }
+                else {
+                    _nodes[up.parent].child2 = indexUp;
+                }
+            }
+            else
+            {
+                _root = indexUp;
+            }
+
+            const bool keepF = f.height > g.height;
+            const uint32_t indexKeep = keepF ? indexF : indexG;
+            const uint32_t indexMove = keepF ? indexG : indexF;
+            Node& keep = _nodes[indexKeep];
+            Node& move = _nodes[indexMove];
+
+            up.child2 = indexKeep;
+            if (balance > 1) {
+                a.child2 = indexMove;
+            }
+            else {
+                a.child1 = indexMove;
+            }
+            move.parent = indexA;
+
+            a.box = Merge(stay.box, move.box);
+            a.height = 1 + Max(stay.height, move.height);
+            up.box = Merge(a.box, keep.box);
+            up.height = 1 + Max(a.height, keep.height);
+            return indexUp;
+        }
+
+        return indexA;
+    }
+
+    void BoundingBoxTree::AddSubtree(uint32_t root, VisibilityList::ThreadData& thread) const
+    {
+        // Borrow the top of the traversal stack, everything pushed here is popped before returning.
+        std::vector<uint32_t>& stack = thread.stack;
+        const size_t base = stack.size();
+        stack.push_back(root);
+        while (stack.size() > base)
+        {
+            const Node& node = _nodes[stack.back()];
+            stack.pop_back();
+            if (node.IsLeaf()) {
+                thread.visible.push_back(node.userData);
+            }
+            else
+            {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    void BoundingBoxTree::CullSubtree(const Frustum& frustum, uint32_t root, VisibilityList::ThreadData& thread) const
+    {
+        using namespace simd;
+
+        Lane planeX[Frustum::PlaneCount], planeY[Frustum::PlaneCount], planeZ[Frustum::PlaneCount], planeW[Frustum::PlaneCount];
+        Lane absX[Frustum::PlaneCount], absY[Frustum::PlaneCount], absZ[Frustum::PlaneCount];
+        for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+        {
+            const Plane& plane = frustum.planes[i];
+            planeX[i] = Splat(plane.normal.x);
+            planeY[i] = Splat(plane.normal.y);
+            planeZ[i] = Splat(plane.normal.z);
+            planeW[i] = Splat(plane.distance);
+            absX[i] = Splat(fabsf(plane.normal.x));
+            absY[i] = Splat(fabsf(plane.normal.y));
+            absZ[i] = Splat(fabsf(plane.normal.z));
+        }
+
+        const Lane half = Splat(0.5f);
+        const Lane zero = Splat(0.0f);
+        std::vector<uint32_t>& stack = thread.stack;
+        stack.clear();
+        stack.push_back(root);
+
+        uint32_t batch[LaneWidth];
+        float bounds[6][LaneWidth];
+        while (!stack.empty())
+        {
+            // Pop up to LaneWidth nodes and transpose their boxes into lanes, unused lanes repeat the first node.
+            const uint32_t count = stack.size() < LaneWidth ? static_cast<uint32_t>(stack.size()) : LaneWidth;
+            for (uint32_t lane = 0; lane < count; lane++)
+            {
+                batch[lane] = stack.back();
+                stack.pop_back();
+            }
+
+            for (uint32_t lane = 0; lane < LaneWidth; lane++)
+            {
+                const BoundingBox& box = _nodes[batch[lane < count ? lane : 0]].box;
+                bounds[0][lane] = box.min.x;
+                bounds[1][lane] = box.min.y;
+                bounds[2][lane] = box.min.z;
+                bounds[3][lane] = box.max.x;
+                bounds[4][lane] = box.max.y;
+                bounds[5][lane] = box.max.z;
+            }
+
+            const Lane minX = Load(bounds[0]), minY = Load(bounds[1]), minZ = Load(bounds[2]);
+            const Lane maxX = Load(bounds[3]), maxY = Load(bounds[4]), maxZ = Load(bounds[5]);
+            const Lane cx = Mul(Add(minX, maxX), half);
+            const Lane cy = Mul(Add(minY, maxY), half);
+            const Lane cz = Mul(Add(minZ, maxZ), half);
+            const Lane ex = Mul(Sub(maxX, minX), half);
+            const Lane ey = Mul(Sub(maxY, minY), half);
+            const Lane ez = Mul(Sub(maxZ, minZ), half);
+
+            // A box is outside when fully behind one plane and needs no further test when in front of all of them.
+            uint32_t outside = 0;
+            uint32_t straddling = 0;
+            for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+            {
+                const Lane distance = MulAdd(planeX[i], cx, MulAdd(planeY[i], cy, MulAdd(planeZ[i], cz, planeW[i])));
+                const Lane radius = MulAdd(absX[i], ex, MulAdd(absY[i], ey, Mul(absZ[i], ez)));
+                outside |= LessMask(Add(distance, radius), zero);
+                straddling |= LessMask(Sub(distance, radius), zero);
+            }
+
+            for (uint32_t lane = 0; lane < count; lane++)
+            {
+                const uint32_t bit = 1u << lane;
+                if (outside & bit) {
+                    continue;
+                }
+
+                const Node& node = _nodes[batch[lane]];
+                if (node.IsLeaf()) {
+                    thread.visible.push_back(node.userData);
+                }
+                else if ((straddling & bit) == 0) {
+                    AddSubtree(batch[lane], thread);
+                }
+                else
+                {
+                    stack.push_back(node.child1);
+                    stack.push_back(node.child2);
+                }
+            }
+        }
+    }
+
+    void BoundingBoxTree::Cull(const Frustum& frustum, VisibilityList& result, JobSystem* jobs) const
+    {
+        result._visible.clear();
+        if (_root == NullNode) {
+            return;
+        }
+
+        // The extra slot is shared by threads the job system does not own, they can run jobs while waiting.
+        const uint32_t threadCount = jobs ? jobs->GetThreadCount() : 1u;
+        if (result._threads.size() < threadCount + 1) {
+            result._threads.resize(threadCount + 1);
+        }
+
+        // Split the top of the tree into enough subtrees to keep every thread busy, the subtree roots are tested by the jobs.
+        std::vector<uint32_t>& frontier = result._frontier;
+        frontier.clear();
+        frontier.push_back(_root);
+        if (threadCount > 1)
+        {
+            const size_t target = threadCount * 8;
+            bool expanded = true;
+            while (frontier.size() < target && expanded)
+            {
+                expanded = false;
+                const size_t count = frontier.size();
+                for (size_t i = 0; i < count; i++)
+                {
+                    const Node& node = _nodes[frontier[i]];
+                    if (!node.IsLeaf())
+                    {
+                        frontier[i] = node.child1;
+                        frontier.push_back(node.child2);
+                        expanded = true;
+                    }
+                }
+            }
+        }
+
+        if (jobs && frontier.size() > 1)
+        {
+            std::mutex foreignMutex;
+            jobs->ParallelFor(static_cast<uint32_t>(frontier.size()), 1, [this, &frustum, &result, &foreignMutex, threadCount](uint32_t begin, uint32_t end) {
+                const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+                if (threadIndex < threadCount)
+                {
+                    for (uint32_t i = begin; i < end; i++) {
+                        CullSubtree(frustum, result._frontier[i], result._threads[threadIndex]);
+                    }
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(foreignMutex);
+                for (uint32_t i = begin; i < end; i++) {
+                    CullSubtree(frustum, result._frontier[i], result._threads[threadCount]);
+                }
+            });
+        }
+        else
+        {
+            for (uint32_t root : frontier) {
+                CullSubtree(frustum, root, result._threads[0]);
+            }
+        }
+
+        for (VisibilityList::ThreadData& thread : result._threads)
+        {
+            result._visible.insert(result._visible.end(), thread.visible.begin(), thread.visible.end());
+            thread.visible.clear();
+        }
+    }
+}
@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/job_system.h"
+#include "foundation/math/frustum.h"
+#include <vector>
+
+namespace alimer
+{
+    /// Visible proxies of one view, also holds the scratch memory reused between frames. Use one per view.
+    class ALIMER_API VisibilityList final
+    {
+    public:
+        /// Get the user data of every visible proxy, the order is unspecified.
+        const std::vector<uint32_t>& GetVisible() const { return _visible; }
+
+        /// Get the number of visible proxies.
+        uint32_t GetCount() const { return static_cast<uint32_t>(_visible.size()); }
+
+    private:
+        friend class BoundingBoxTree;
+
+        struct ThreadData
+        {
+            std::vector<uint32_t> stack;
+            std::vector<uint32_t> visible;
+        };
+
+        std::vector<ThreadData> _threads;
+        std::vector<uint32_t> _frontier;
+        std::vector<uint32_t> _visible;
+    };
+
+    /// Dynamic bounding volume hierarchy. Leaves hold enlarged boxes so small moves do not touch the tree,
+    /// insertion picks the sibling with the lowest surface area cost and rotations keep the tree balanced.
+    class ALIMER_API BoundingBoxTree final
+    {
+    public:
+        static constexpr uint32_t NullNode = ~0u;
+
+        /// Constructor, margin enlarges leaf boxes on every side.
+        explicit BoundingBoxTree(float margin = 0.1f);
+
+        /// Destructor.
+        ~BoundingBoxTree();
+
+        BoundingBoxTree(const BoundingBoxTree&) = delete;
+        BoundingBoxTree& operator=(const BoundingBoxTree&) = delete;
+
+        /// Insert a box, returns the proxy id.
+        uint32_t CreateProxy(const BoundingBox& box, uint32_t userData);
+
+        /// Remove a proxy.
+        void DestroyProxy(uint32_t proxy);
+
+        /// Update the box of a proxy, returns true when the proxy had to be reinserted.
+        bool MoveProxy(uint32_t proxy, const BoundingBox& box);
+
+        /// Get the user data of a proxy.
+        uint32_t GetUserData(uint32_t proxy) const { return _nodes[proxy].userData; }
+
+        /// Get the enlarged box stored for a proxy.
+        const BoundingBox& GetFatBox(uint32_t proxy) const { return _nodes[proxy].box; }
+
+        /// Get the number of proxies.
+        uint32_t GetProxyCount() const { return _proxyCount; }
+
+        /// Get the height of the tree, 0 for a single leaf.
+        uint32_t GetHeight() const { return _root != NullNode ? static_cast<uint32_t>(_nodes[_root].height) : 0u; }
+
+        /// Call function(userData) for every proxy whose box overlaps box.
+        template <typename F>
+        void Query(const BoundingBox& box, F&& function) const
+        {
+            if (_root == NullNode) {
+                return;
+            }
+
+            std::vector<uint32_t> stack(1, _root);
+            while (!stack.empty())
+            {
+                const Node& node = _nodes[stack.back()];
+                stack.pop_back();
+                if (!node.box.Intersects(box)) {
+                    continue;
+                }
+
+                if (node.IsLeaf()) {
+                    function(node.userData);
+                }
+                else
+                {
+                    stack.push_back(node.child1);
+                    stack.push_back(node.child2);
+                }
+            }
+        }
+
+        /// Collect the proxies intersecting frustum. Several boxes are tested per SIMD instruction
+        /// and the top of the tree is split across jobs when given.
+        void Cull(const Frustum& frustum, VisibilityList& result, JobSystem* jobs = nullptr) const;
+
+    private:
+        struct Node
+        {
+            BoundingBox box;
+            uint32_t parent;
+            uint32_t child1;
+            uint32_t child2;
+            int32_t height;
+            uint32_t userData;
+
+            bool IsLeaf() const { return child1 == NullNode; }
+        };
+
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t index);
+        void InsertLeaf(uint32_t leaf);
+        void RemoveLeaf(uint32_t leaf);
+        void RefitAncestors(uint32_t index);
+        uint32_t Balance(uint32_t index);
+        void CullSubtree(const Frustum& frustum, uint32_t root, VisibilityList::ThreadData& thread) const;
+        void AddSubtree(uint32_t root, VisibilityList::ThreadData& thread) const;
+
+        std::vector<Node> _nodes;
+        uint32_t _root = NullNode;
+        uint32_t _freeList = NullNode;
+        uint32_t _proxyCount = 0;
+        float _margin;
+    };
+}
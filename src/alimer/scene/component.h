@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/platform.h"
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace alimer
+{
+    /// Maximum number of component types, masks are 64 bit.
+    static constexpr uint32_t MaxComponentTypes = 64;
+
+    using ComponentId = uint32_t;
+    using ComponentMask = uint64_t;
+
+    /// Type erased component description used by chunk storage.
+    struct ComponentInfo
+    {
+        /// Size of one element, 0 for tag components without data.
+        uint32_t size;
+        uint32_t alignment;
+        /// Default construct count elements.
+        void (*construct)(void* destination, uint32_t count);
+        /// Destroy count elements.
+        void (*destruct)(void* destination, uint32_t count);
+        /// Move construct count elements from source and destroy the source elements.
+        void (*relocate)(void* destination, void* source, uint32_t count);
+    };
+
+    /// Component read and write sets, used to order systems and to find the ones that can run in parallel.
+    struct ComponentAccess
+    {
+        ComponentMask read = 0;
+        ComponentMask write = 0;
+
+        /// Check if running alongside other could race, a write overlapping any access of the other side.
+        bool Conflicts(const ComponentAccess& other) const
+        {
+            return (write & (other.read | other.write)) != 0 || (other.write & read) != 0;
+        }
+
+        void Merge(const ComponentAccess& other)
+        {
+            read |= other.read;
+            write |= other.write;
+        }
+    };
+
+    namespace detail
+    {
+        ALIMER_API ComponentId RegisterComponent(const ComponentInfo& info);
+
+        template <typename T>
+        void ConstructComponents(void* destination, uint32_t count)
+        {
+            T* elements = static_cast<T*>(destination);
+            for (uint32_t i = 0; i < count; i++) {
+                new (elements + i) T();
+            }
+        }
+
+        template <typename T>
+        void DestructComponents(void* destination, uint32_t count)
+        {
+            T* elements = static_cast<T*>(destination);
+            for (uint32_t i = 0; i < count; i++) {
+                elements[i].~T();
+            }
+        }
+
+        template <typename T>
+        void RelocateComponents(void* destination, void* source, uint32_t count)
+        {
+            T* to = static_cast<T*>(destination);
+            T* from = static_cast<T*>(source);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                new (to + i) T(std::move(from[i]));
+                from[i].~T();
+            }
+        }
+
+        template <typename T>
+        ComponentInfo MakeComponentInfo()
+        {
+            static_assert(std::is_default_constructible<T>::value, "Components must be default constructible");
+            static_assert(std::is_move_constructible<T>::value, "Components must be move constructible");
+
+            ComponentInfo info;
+            info.size = std::is_empty<T>::value ? 0u : static_cast<uint32_t>(sizeof(T));
+            info.alignment = static_cast<uint32_t>(alignof(T));
+            info.construct = &ConstructComponents<T>;
+            info.destruct = &DestructComponents<T>;
+            info.relocate = &RelocateComponents<T>;
+            return info;
+        }
+
+        template <typename T>
+        struct ComponentType
+        {
+            static ComponentId GetId()
+            {
+                static const ComponentId id = RegisterComponent(MakeComponentInfo<T>());
+                return id;
+            }
+        };
+    }
+
+    /// Get the id of component type T, registered on first use.
+    template <typename T>
+    ComponentId GetComponentId()
+    {
+        return detail::ComponentType<typename std::remove_cv<T>::type>::GetId();
+    }
+
+    /// Get the mask bit of component type T.
+    template <typename T>
+    ComponentMask GetComponentMask()
+    {
+        return ComponentMask(1) << GetComponentId<T>();
+    }
+
+    /// Get the description of a registered component.
+    ALIMER_API const ComponentInfo& GetComponentInfo(ComponentId id);
+}
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "scene/entity_command_buffer.h"
+#include "foundation/allocator.h"
+
+namespace alimer
+{
+    namespace
+    {
+        enum class CommandType : uint32_t
+        {
+            CreateEntity,
+            DestroyEntity,
+            AddComponent,
+            RemoveComponent
+        };
+
+        /// Fixed header, AddComponent is followed by size bytes of component data padded to the header alignment.
+        struct CommandHeader
+        {
+            CommandType type;
+            ComponentId component;
+            Entity entity;
+            uint32_t size;
+        };
+
+        static_assert(sizeof(CommandHeader) % 4 == 0, "Command header must keep 4 byte alignment");
+    }
+
+    Entity EntityCommandBuffer::CreateEntity()
+    {
+        Entity entity;
+        entity.index = _pendingCount++;
+        entity.generation = PendingGeneration;
+
+        CommandHeader* header = static_cast<CommandHeader*>(Write(sizeof(CommandHeader)));
+        header->type = CommandType::CreateEntity;
+        header->component = 0;
+        header->entity = entity;
+        header->size = 0;
+        return entity;
+    }
+
+    void EntityCommandBuffer::DestroyEntity(Entity entity)
+    {
+        CommandHeader* header = static_cast<CommandHeader*>(Write(sizeof(CommandHeader)));
+        header->type = CommandType::DestroyEntity;
+        header->component = 0;
+        header->entity = entity;
+        header->size = 0;
+    }
+
+    void EntityCommandBuffer::WriteAddComponent(Entity entity, ComponentId id, const void* data, uint32_t size)
+    {
+        const uint32_t paddedSize = static_cast<uint32_t>(AlignTo(size, alignof(CommandHeader)));
+        uint8_t* command = static_cast<uint8_t*>(Write(sizeof(CommandHeader) + paddedSize));
+        CommandHeader* header = reinterpret_cast<CommandHeader*>(command);
+        header->type = CommandType::AddComponent;
+        header->component = id;
+        header->entity = entity;
+        header->size = paddedSize;
+        if (size > 0) {
+            memcpy(command + sizeof(CommandHeader), data, size);
+        }
+    }
+
+    void EntityCommandBuffer::WriteRemoveComponent(Entity entity, ComponentId id)
+    {
+        CommandHeader* header = static_cast<CommandHeader*>(Write(sizeof(CommandHeader)));
+        header->type = CommandType::RemoveComponent;
+        header->component = id;
+        header->entity = entity;
+        header->size = 0;
+    }
+
+    void* EntityCommandBuffer::Write(size_t size)
+    {
+        const size_t offset = _commands.size();
+        _commands.resize(offset + size);
+        return _commands.data() + offset;
+    }
+
+    void EntityCommandBuffer::Playback(World& world)
+    {
+        _created.resize(_pendingCount);
+
+        size_t offset = 0;
+        while (offset < _commands.size())
+        {
+            CommandHeader header;
+            memcpy(&header, _commands.data() + offset, sizeof(CommandHeader));
+            const uint8_t* data = _commands.data() + offset + sizeof(CommandHeader);
+            offset += sizeof(CommandHeader) + header.size;
+
+            Entity entity = header.entity;
+            if (header.type == CommandType::CreateEntity)
+            {
+                _created[entity.index] = world.CreateEntity();
+                continue;
+            }
+
+            if (IsPending(entity)) {
+                entity = _created[entity.index];
+            }
+
+            switch (header.type)
+            {
+            case CommandType::DestroyEntity:
+                world.DestroyEntity(entity);
+                break;
+
+            case CommandType::AddComponent:
+                if (world.IsAlive(entity))
+                {
+                    void* component = world.AddComponentById(entity, header.component);
+                    const uint32_t size = GetComponentInfo(header.component).size;
+                    if (component && size > 0) {
+                        memcpy(component, data, size);
+                    }
+                }
+                break;
+
+            case CommandType::RemoveComponent:
+                world.RemoveComponentById(entity, header.component);
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        Clear();
+    }
+
+    void EntityCommandBuffer::Clear()
+    {
+        _commands.clear();
+        _created.clear();
+        _pendingCount = 0;
+    }
+}
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "scene/world.h"
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace alimer
+{
+    /// Records structural changes while a world is being iterated and applies them later with Playback.
+    /// Entities created by the buffer get a pending handle that can be used by later commands of the same buffer.
+    class ALIMER_API EntityCommandBuffer final
+    {
+    public:
+        /// Generation used by pending handles.
+        static constexpr uint32_t PendingGeneration = ~0u;
+
+        /// Record creation of an entity, returns a pending handle.
+        Entity CreateEntity();
+
+        /// Record destruction of entity.
+        void DestroyEntity(Entity entity);
+
+        /// Record addition of component, existing components are overwritten.
+        template <typename T>
+        void AddComponent(Entity entity, const T& component)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Recorded components must be trivially copyable");
+            WriteAddComponent(entity, GetComponentId<T>(), std::is_empty<T>::value ? nullptr : &component, std::is_empty<T>::value ? 0u : static_cast<uint32_t>(sizeof(T)));
+        }
+
+        /// Record removal of component T.
+        template <typename T>
+        void RemoveComponent(Entity entity) { WriteRemoveComponent(entity, GetComponentId<T>()); }
+
+        /// Apply the recorded commands in order and clear the buffer.
+        void Playback(World& world);
+
+        /// Discard the recorded commands.
+        void Clear();
+
+        /// Check if nothing has been recorded.
+        bool IsEmpty() const { return _commands.empty(); }
+
+        /// Check if entity is a pending handle returned by CreateEntity.
+        static bool IsPending(Entity entity) { return entity.generation == PendingGeneration; }
+
+    private:
+        void WriteAddComponent(Entity entity, ComponentId id, const void* data, uint32_t size);
+        void WriteRemoveComponent(Entity entity, ComponentId id);
+        void* Write(size_t size);
+
+        std::vector<uint8_t> _commands;
+        std::vector<Entity> _created;
+        uint32_t _pendingCount = 0;
+    };
+}
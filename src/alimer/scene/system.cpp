@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "scene/system.h"
+
+namespace alimer
+{
+    EntityCommandBuffer& SystemContext::GetCommandBuffer() const
+    {
+        if (!_jobs) {
+            return _commandBuffers[0];
+        }
+
+        // Threads the job system does not own, like one driving the scheduler, share the last buffer.
+        const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+        if (threadIndex < _commandBuffers.size() - 1) {
+            return _commandBuffers[threadIndex];
+        }
+        return _commandBuffers.back();
+    }
+
+    SystemScheduler::SystemScheduler(World& world, JobSystem* jobs)
+        : _world(world)
+        , _jobs(jobs)
+    {
+    }
+
+    SystemScheduler::~SystemScheduler() = default;
+
+    System* SystemScheduler::AddSystem(std::unique_ptr<System> system)
+    {
+        _systems.push_back(std::move(system));
+        _stagesDirty = true;
+        return _systems.back().get();
+    }
+
+    void SystemScheduler::BuildStages()
+    {
+        _stages.clear();
+
+        std::vector<uint32_t> systemStages(_systems.size());
+        for (size_t i = 0; i < _systems.size(); i++)
+        {
+            uint32_t stage = 0;
+            for (size_t j = 0; j < i; j++)
+            {
+                if (_systems[i]->Conflicts(*_systems[j]) && systemStages[j] + 1 > stage) {
+                    stage = systemStages[j] + 1;
+                }
+            }
+
+            systemStages[i] = stage;
+            if (stage >= _stages.size()) {
+                _stages.resize(stage + 1);
+            }
+
+            _stages[stage].push_back(_systems[i].get());
+        }
+
+        _stagesDirty = false;
+    }
+
+    void SystemScheduler::Update(float deltaTime)
+    {
+        if (_stagesDirty) {
+            BuildStages();
+        }
+
+        // Workers are started lazily by the owner, size the buffers on every update. One extra for foreign threads.
+        const uint32_t bufferCount = _jobs ? _jobs->GetThreadCount() + 1 : 1u;
+        if (_commandBuffers.size() != bufferCount) {
+            _commandBuffers.resize(bufferCount);
+        }
+
+        const SystemContext context(_world, _jobs, _commandBuffers, deltaTime);
+        for (const std::vector<System*>& stage : _stages)
+        {
+            if (!_jobs || stage.size() == 1)
+            {
+                for (System* system : stage) {
+                    system->Update(context);
+                }
+                continue;
+            }
+
+            JobCounter counter;
+            for (System* system : stage) {
+                _jobs->Schedule(&counter, [system, &context]() { system->Update(context); });
+            }
+
+            _jobs->Wait(counter);
+        }
+
+        for (EntityCommandBuffer& commandBuffer : _commandBuffers)
+        {
+            if (!commandBuffer.IsEmpty()) {
+                commandBuffer.Playback(_world);
+            }
+        }
+    }
+}
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "scene/entity_command_buffer.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace alimer
+{
+    /// Per update state handed to systems.
+    class ALIMER_API SystemContext final
+    {
+    public:
+        SystemContext(World& world, JobSystem* jobs, std::vector<EntityCommandBuffer>& commandBuffers, float deltaTime)
+            : _world(world)
+            , _jobs(jobs)
+            , _commandBuffers(commandBuffers)
+            , _deltaTime(deltaTime)
+        {
+        }
+
+        /// Get the world being updated.
+        World& GetWorld() const { return _world; }
+
+        /// Get the job system, nullptr when systems run on the calling thread only.
+        JobSystem* GetJobs() const { return _jobs; }
+
+        /// Get the time elapsed since the previous update in seconds.
+        float GetDeltaTime() const { return _deltaTime; }
+
+        /// Get the command buffer of the calling thread, played back once every system has run. Threads the job
+        /// system does not own share one buffer, only one of them may run systems at a time.
+        EntityCommandBuffer& GetCommandBuffer() const;
+
+        /// Call function(const ChunkView&) for every chunk matching query, spread across jobs when available.
+        template <typename F>
+        void ForEachChunk(Query& query, F&& function) const
+        {
+            if (_jobs) {
+                _world.ParallelForEachChunk(query, *_jobs, std::forward<F>(function));
+            }
+            else {
+                _world.ForEachChunk(query, std::forward<F>(function));
+            }
+        }
+
+    private:
+        World& _world;
+        JobSystem* _jobs;
+        std::vector<EntityCommandBuffer>& _commandBuffers;
+        float _deltaTime;
+    };
+
+    /// Logic updating a set of components. The declared access decides which systems may run in parallel.
+    class ALIMER_API System
+    {
+    public:
+        /// Constructor.
+        explicit System(const std::string& name) : _name(name) {}
+
+        /// Destructor.
+        virtual ~System() = default;
+
+        System(const System&) = delete;
+        System& operator=(const System&) = delete;
+
+        /// Update the system, structural changes must go through the context command buffer.
+        virtual void Update(const SystemContext& context) = 0;
+
+        /// Get the name.
+        const std::string& GetName() const { return _name; }
+
+        /// Get the declared component access.
+        const ComponentAccess& GetAccess() const { return _access; }
+
+        /// Check if the system must run alone.
+        bool IsExclusive() const { return _exclusive; }
+
+        /// Check if running alongside other could race.
+        bool Conflicts(const System& other) const
+        {
+            return _exclusive || other._exclusive || _access.Conflicts(other._access);
+        }
+
+    protected:
+        /// Declare read access to T.
+        template <typename T>
+        void Reads() { _access.read |= GetComponentMask<T>(); }
+
+        /// Declare write access to T.
+        template <typename T>
+        void Writes() { _access.write |= GetComponentMask<T>(); }
+
+        /// Declare the access of query.
+        void Uses(const Query& query) { _access.Merge(query.GetAccess()); }
+
+        /// Run alone, for systems touching state outside the world.
+        void SetExclusive(bool exclusive) { _exclusive = exclusive; }
+
+    private:
+        std::string _name;
+        ComponentAccess _access;
+        bool _exclusive = false;
+    };
+
+    /// Runs systems as if in registration order, systems whose access does not conflict run in parallel.
+    /// Systems are grouped in stages, a system lands in the stage after the last earlier system it conflicts with.
+    class ALIMER_API SystemScheduler final
+    {
+    public:
+        /// Constructor, jobs may be nullptr to run every system on the calling thread.
+        SystemScheduler(World& world, JobSystem* jobs);
+
+        /// Destructor.
+        ~SystemScheduler();
+
+        SystemScheduler(const SystemScheduler&) = delete;
+        SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+        /// Add a system, the scheduler takes ownership.
+        System* AddSystem(std::unique_ptr<System> system);
+
+        /// Add a system constructed from args.
+        template <typename T, typename... Args>
+        T* AddSystem(Args&&... args)
+        {
+            return static_cast<T*>(AddSystem(std::unique_ptr<System>(new T(std::forward<Args>(args)...))));
+        }
+
+        /// Run every system then play back the recorded structural changes.
+        void Update(float deltaTime);
+
+        /// Get the number of stages.
+        uint32_t GetStageCount() const { return static_cast<uint32_t>(_stages.size()); }
+
+    private:
+        void BuildStages();
+
+        World& _world;
+        JobSystem* _jobs;
+        std::vector<std::unique_ptr<System>> _systems;
+        std::vector<std::vector<System*>> _stages;
+        std::vector<EntityCommandBuffer> _commandBuffers;
+        bool _stagesDirty = false;
+    };
+}
@@ -0,0 +1,335 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "scene/transform_hierarchy.h"
+#include <cassert>
+
+namespace alimer
+{
+    constexpr uint32_t TransformHierarchy::InvalidIndex;
+
+    TransformHierarchy::TransformHierarchy() = default;
+    TransformHierarchy::~TransformHierarchy() = default;
+
+    TransformId TransformHierarchy::Create(TransformId parent, const LocalTransform& local)
+    {
+        assert(parent == InvalidTransform || IsValid(parent));
+
+        TransformId id;
+        if (!_freeIds.empty())
+        {
+            id = _freeIds.back();
+            _freeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<TransformId>(_nodes.size());
+            _nodes.push_back({});
+        }
+
+        // New nodes are appended, they reach their breadth first slot on the next rebuild.
+        Node& node = _nodes[id];
+        node.index = static_cast<uint32_t>(_ids.size());
+        node.parent = InvalidTransform;
+        node.firstChild = InvalidTransform;
+        node.nextSibling = InvalidTransform;
+        Link(id, parent);
+
+        _ids.push_back(id);
+        _parentIndices.push_back(InvalidIndex);
+        _firstChildren.push_back(0);
+        _childCounts.push_back(0);
+        _locals.push_back(local);
+        _worlds.push_back(Matrix4());
+        _dirty.push_back(Clean);
+        MarkDirty(node.index);
+
+        _count++;
+        _layoutDirty = true;
+        return id;
+    }
+
+    void TransformHierarchy::Destroy(TransformId id)
+    {
+        if (!IsValid(id)) {
+            return;
+        }
+
+        Unlink(id);
+
+        // Walk the subtree through the id links, the breadth first ranges may be stale.
+        std::vector<TransformId> stack(1, id);
+        while (!stack.empty())
+        {
+            const TransformId current = stack.back();
+            stack.pop_back();
+
+            Node& node = _nodes[current];
+            for (TransformId child = node.firstChild; child != InvalidTransform; child = _nodes[child].nextSibling) {
+                stack.push_back(child);
+            }
+
+            _ids[node.index] = InvalidTransform;
+            _dirty[node.index] = Clean;
+            node.index = InvalidIndex;
+            _freeIds.push_back(current);
+            _count--;
+        }
+
+        _layoutDirty = true;
+    }
+
+    void TransformHierarchy::SetParent(TransformId id, TransformId parent)
+    {
+        assert(IsValid(id));
+        assert(parent == InvalidTransform || IsValid(parent));
+        if (_nodes[id].parent == parent) {
+            return;
+        }
+
+        for (TransformId ancestor = parent; ancestor != InvalidTransform; ancestor = _nodes[ancestor].parent)
+        {
+            if (ancestor == id)
+            {
+                assert(false && "Cannot parent a transform to one of its descendants");
+                return;
+            }
+        }
+
+        Unlink(id);
+        Link(id, parent);
+        MarkDirty(_nodes[id].index);
+        _layoutDirty = true;
+    }
+
+    void TransformHierarchy::SetLocal(TransformId id, const LocalTransform& local)
+    {
+        assert(IsValid(id));
+        const uint32_t index = _nodes[id].index;
+        _locals[index] = local;
+        MarkDirty(index);
+    }
+
+    void TransformHierarchy::Link(TransformId id, TransformId parent)
+    {
+        Node& node = _nodes[id];
+        node.parent = parent;
+        if (parent != InvalidTransform)
+        {
+            node.nextSibling = _nodes[parent].firstChild;
+            _nodes[parent].firstChild = id;
+        }
+        else
+        {
+            node.nextSibling = _firstRoot;
+            _firstRoot = id;
+        }
+    }
+
+    void TransformHierarchy::Unlink(TransformId id)
+    {
+        Node& node = _nodes[id];
+        TransformId* link = node.parent != InvalidTransform ? &_nodes[node.parent].firstChild : &_firstRoot;
+        while (*link != id) {
+            link = &_nodes[*link].nextSibling;
+        }
+
+        *link = node.nextSibling;
+        node.parent = InvalidTransform;
+        node.nextSibling = InvalidTransform;
+    }
+
+    void TransformHierarchy::MarkDirty(uint32_t index)
+    {
+        if (_dirty[index] == Clean)
+        {
+            _dirty[index] = Dirty;
+            _dirtyIds.push_back(_ids[index]);
+        }
+    }
+
+    void TransformHierarchy::RebuildLayout()
+    {
+        std::vector<TransformId> ids;
+        std::vector<uint32_t> parentIndices;
+        std::vector<uint32_t> firstChildren;
+        std::vector<uint32_t> childCounts;
+        std::vector<LocalTransform> locals;
+        std::vector<Matrix4> worlds;
+        std::vector<uint8_t> dirty;
+        ids.reserve(_count);
+        parentIndices.reserve(_count);
+        firstChildren.resize(_count);
+        childCounts.resize(_count);
+        locals.reserve(_count);
+        worlds.reserve(_count);
+        dirty.reserve(_count);
+
+        // Breadth first from the roots, ids doubles as the queue. Depth changes whenever the
+        // queue reaches the first node appended by the previous depth.
+        for (TransformId root = _firstRoot; root != InvalidTransform; root = _nodes[root].nextSibling)
+        {
+            ids.push_back(root);
+            parentIndices.push_back(InvalidIndex);
+        }
+
+        _depthCount = ids.empty() ? 0 : 1;
+        size_t depthEnd = ids.size();
+        for (size_t head = 0; head < ids.size(); head++)
+        {
+            if (head == depthEnd)
+            {
+                depthEnd = ids.size();
+                _depthCount++;
+            }
+
+            Node& node = _nodes[ids[head]];
+            firstChildren[head] = static_cast<uint32_t>(ids.size());
+            for (TransformId child = node.firstChild; child != InvalidTransform; child = _nodes[child].nextSibling)
+            {
+                ids.push_back(child);
+                parentIndices.push_back(static_cast<uint32_t>(head));
+            }
+            childCounts[head] = static_cast<uint32_t>(ids.size()) - firstChildren[head];
+
+            locals.push_back(_locals[node.index]);
+            worlds.push_back(_worlds[node.index]);
+            dirty.push_back(_dirty[node.index]);
+        }
+
+        assert(ids.size() == _count);
+        for (uint32_t index = 0; index < _count; index++) {
+            _nodes[ids[index]].index = index;
+        }
+
+        _ids.swap(ids);
+        _parentIndices.swap(parentIndices);
+        _firstChildren.swap(firstChildren);
+        _childCounts.swap(childCounts);
+        _locals.swap(locals);
+        _worlds.swap(worlds);
+        _dirty.swap(dirty);
+        _layoutDirty = false;
+    }
+
+    void TransformHierarchy::UpdateSubtree(uint32_t root, ThreadData& thread)
+    {
+        std::vector<uint32_t>& queue = thread.queue;
+        queue.clear();
+        queue.push_back(root);
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            const uint32_t index = queue[head];
+            const LocalTransform& local = _locals[index];
+            const Matrix4 localMatrix = Matrix4::Compose(local.position, local.rotation, local.scale);
+            const uint32_t parent = _parentIndices[index];
+            _worlds[index] = parent != InvalidIndex ? Multiply(_worlds[parent], localMatrix) : localMatrix;
+            _dirty[index] = Clean;
+            thread.changed.push_back(_ids[index]);
+
+            const uint32_t firstChild = _firstChildren[index];
+            const uint32_t childCount = _childCounts[index];
+            for (uint32_t child = firstChild; child < firstChild + childCount; child++) {
+                queue.push_back(child);
+            }
+        }
+    }
+
+    void TransformHierarchy::Update(JobSystem* jobs)
+    {
+        if (_layoutDirty) {
+            RebuildLayout();
+        }
+
+        // Keep the top most dirty nodes, their subtrees are disjoint and can be updated independently.
+        _roots.clear();
+        for (TransformId id : _dirtyIds)
+        {
+            if (!IsValid(id)) {
+                continue;
+            }
+
+            const uint32_t index = _nodes[id].index;
+            if (_dirty[index] != Dirty) {
+                continue;
+            }
+
+            bool covered = false;
+            for (uint32_t ancestor = _parentIndices[index]; ancestor != InvalidIndex; ancestor = _parentIndices[ancestor])
+            {
+                if (_dirty[ancestor] != Clean)
+                {
+                    covered = true;
+                    break;
+                }
+            }
+
+            if (!covered)
+            {
+                _dirty[index] = Scheduled;
+                _roots.push_back(index);
+            }
+        }
+        _dirtyIds.clear();
+
+        // The extra slot is shared by threads the job system does not own, they can run jobs while waiting.
+        const uint32_t threadCount = jobs ? jobs->GetThreadCount() : 1u;
+        if (_threads.size() < threadCount + 1) {
+            _threads.resize(threadCount + 1);
+        }
+
+        const uint32_t rootCount = static_cast<uint32_t>(_roots.size());
+        if (jobs && rootCount > 1)
+        {
+            const uint32_t batchSize = (rootCount + threadCount * 4 - 1) / (threadCount * 4);
+            jobs->ParallelFor(rootCount, batchSize, [this, threadCount](uint32_t begin, uint32_t end) {
+                const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+                if (threadIndex < threadCount)
+                {
+                    for (uint32_t i = begin; i < end; i++) {
+                        UpdateSubtree(_roots[i], _threads[threadIndex]);
+                    }
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(_foreignMutex);
+                for (uint32_t i = begin; i < end; i++) {
+                    UpdateSubtree(_roots[i], _threads[threadCount]);
+                }
+            });
+        }
+        else
+        {
+            for (uint32_t root : _roots) {
+                UpdateSubtree(root, _threads[0]);
+            }
+        }
+
+        _changed.clear();
+        for (ThreadData& thread : _threads)
+        {
+            _changed.insert(_changed.end(), thread.changed.begin(), thread.changed.end());
+            thread.changed.clear();
+        }
+    }
+}
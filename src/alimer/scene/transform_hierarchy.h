@@ -0,0 +1,151 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/job_system.h"
+#include "foundation/math/matrix4.h"
+#include <mutex>
+#include <vector>
+
+namespace alimer
+{
+    using TransformId = uint32_t;
+    static constexpr TransformId InvalidTransform = ~0u;
+
+    /// Transform relative to the parent.
+    struct LocalTransform
+    {
+        Vector3 position;
+        Quaternion rotation;
+        Vector3 scale = Vector3(1.0f);
+    };
+
+    /// Transform hierarchy with incremental world matrix propagation.
+    /// Nodes are stored breadth first, sorted by depth, with the children of a node contiguous.
+    /// Only subtrees below nodes changed since the last Update are recomputed, independent subtrees run on different jobs.
+    class ALIMER_API TransformHierarchy final
+    {
+    public:
+        /// Constructor.
+        TransformHierarchy();
+
+        /// Destructor.
+        ~TransformHierarchy();
+
+        TransformHierarchy(const TransformHierarchy&) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+        /// Create a node, parent may be InvalidTransform for a root.
+        TransformId Create(TransformId parent = InvalidTransform, const LocalTransform& local = LocalTransform());
+
+        /// Destroy a node and all its descendants.
+        void Destroy(TransformId id);
+
+        /// Check if id refers to a live node.
+        bool IsValid(TransformId id) const { return id < _nodes.size() && _nodes[id].index != InvalidIndex; }
+
+        /// Move a node under another parent, the local transform is kept.
+        void SetParent(TransformId id, TransformId parent);
+
+        /// Get the parent, InvalidTransform for roots.
+        TransformId GetParent(TransformId id) const { return _nodes[id].parent; }
+
+        /// Set the local transform, the world matrix of the subtree is refreshed on the next Update.
+        void SetLocal(TransformId id, const LocalTransform& local);
+
+        /// Get the local transform.
+        const LocalTransform& GetLocal(TransformId id) const { return _locals[_nodes[id].index]; }
+
+        /// Get the world matrix computed by the last Update.
+        const Matrix4& GetWorldMatrix(TransformId id) const { return _worlds[_nodes[id].index]; }
+
+        /// Recompute the world matrix of dirty subtrees, spread across jobs when given.
+        void Update(JobSystem* jobs = nullptr);
+
+        /// Get the nodes whose world matrix changed during the last Update.
+        const std::vector<TransformId>& GetChangedTransforms() const { return _changed; }
+
+        /// Get the number of live nodes.
+        uint32_t GetCount() const { return _count; }
+
+        /// Get the depth of the deepest node plus one, valid after Update.
+        uint32_t GetDepthCount() const { return _depthCount; }
+
+    private:
+        static constexpr uint32_t InvalidIndex = ~0u;
+
+        enum DirtyState : uint8_t
+        {
+            Clean = 0,
+            Dirty = 1,
+            Scheduled = 2
+        };
+
+        /// Stable per id links, the child lists are only walked when the layout is rebuilt.
+        struct Node
+        {
+            uint32_t index;
+            TransformId parent;
+            TransformId firstChild;
+            TransformId nextSibling;
+        };
+
+        /// Scratch owned by one job thread.
+        struct ThreadData
+        {
+            std::vector<uint32_t> queue;
+            std::vector<TransformId> changed;
+        };
+
+        void Link(TransformId id, TransformId parent);
+        void Unlink(TransformId id);
+        void MarkDirty(uint32_t index);
+        void RebuildLayout();
+        void UpdateSubtree(uint32_t root, ThreadData& thread);
+
+        std::vector<Node> _nodes;
+        std::vector<TransformId> _freeIds;
+        TransformId _firstRoot = InvalidTransform;
+
+        /// Breadth first storage, slots of destroyed nodes hold InvalidTransform until the next rebuild.
+        std::vector<TransformId> _ids;
+        std::vector<uint32_t> _parentIndices;
+        std::vector<uint32_t> _firstChildren;
+        std::vector<uint32_t> _childCounts;
+        std::vector<LocalTransform> _locals;
+        std::vector<Matrix4> _worlds;
+        std::vector<uint8_t> _dirty;
+
+        std::vector<TransformId> _dirtyIds;
+        std::vector<uint32_t> _roots;
+        /// Scratch per job thread plus one for foreign threads.
+        std::vector<ThreadData> _threads;
+        /// Guards the foreign thread scratch.
+        std::mutex _foreignMutex;
+        std::vector<TransformId> _changed;
+        uint32_t _count = 0;
+        uint32_t _depthCount = 0;
+        bool _layoutDirty = false;
+    };
+}
@@ -0,0 +1,404 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "scene/world.h"
+#include "foundation/allocator.h"
+#include <cstring>
+#include <mutex>
+
+namespace alimer
+{
+    static constexpr size_t ChunkAlignment = 64;
+
+    namespace
+    {
+        struct ComponentRegistry
+        {
+            std::mutex mutex;
+            ComponentInfo infos[MaxComponentTypes];
+            uint32_t count = 0;
+        };
+
+        ComponentRegistry& GetComponentRegistry()
+        {
+            static ComponentRegistry registry;
+            return registry;
+        }
+    }
+
+    namespace detail
+    {
+        ComponentId RegisterComponent(const ComponentInfo& info)
+        {
+            ComponentRegistry& registry = GetComponentRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            assert(registry.count < MaxComponentTypes && "Too many component types");
+            assert(info.alignment <= ChunkAlignment && "Component alignment exceeds chunk alignment");
+            registry.infos[registry.count] = info;
+            return registry.count++;
+        }
+    }
+
+    const ComponentInfo& GetComponentInfo(ComponentId id)
+    {
+        // Entries are written once before their id is published.
+        return GetComponentRegistry().infos[id];
+    }
+
+    Archetype::Archetype(ComponentMask mask)
+        : _mask(mask)
+    {
+        uint32_t rowSize = sizeof(Entity);
+        for (ComponentId id = 0; id < MaxComponentTypes; id++)
+        {
+            _offsets[id] = InvalidOffset;
+            if (HasComponent(id))
+            {
+                _components.push_back(id);
+                rowSize += GetComponentInfo(id).size;
+            }
+        }
+
+        // Shrink the capacity until every array fits with its alignment padding.
+        for (_chunkCapacity = ChunkSize / rowSize; _chunkCapacity > 0; _chunkCapacity--)
+        {
+            size_t offset = sizeof(Entity) * _chunkCapacity;
+            for (ComponentId id : _components)
+            {
+                const ComponentInfo& info = GetComponentInfo(id);
+                if (info.size == 0) {
+                    continue;
+                }
+
+                offset = AlignTo(offset, info.alignment);
+                _offsets[id] = static_cast<uint32_t>(offset);
+                offset += static_cast<size_t>(info.size) * _chunkCapacity;
+            }
+
+            if (offset <= ChunkSize) {
+                break;
+            }
+        }
+
+        assert(_chunkCapacity > 0 && "Components do not fit in a chunk");
+    }
+
+    Archetype::~Archetype()
+    {
+        for (Chunk& chunk : _chunks)
+        {
+            for (ComponentId id : _components)
+            {
+                void* array = GetComponentArray(chunk, id);
+                if (array) {
+                    GetComponentInfo(id).destruct(array, chunk.count);
+                }
+            }
+
+            GetTaggedAllocator(MemoryTag::Scene).Free(chunk.data);
+        }
+    }
+
+    void Archetype::AllocateRow(Entity entity, uint32_t& chunkIndex, uint32_t& row)
+    {
+        if (_chunks.empty() || _chunks.back().count == _chunkCapacity)
+        {
+            Chunk chunk;
+            chunk.data = static_cast<uint8_t*>(GetTaggedAllocator(MemoryTag::Scene).Allocate(ChunkSize, ChunkAlignment));
+            chunk.count = 0;
+            _chunks.push_back(chunk);
+        }
+
+        chunkIndex = static_cast<uint32_t>(_chunks.size() - 1);
+        Chunk& chunk = _chunks.back();
+        row = chunk.count++;
+        GetEntities(chunk)[row] = entity;
+        _entityCount++;
+    }
+
+    Entity Archetype::RemoveRow(uint32_t chunkIndex, uint32_t row)
+    {
+        Chunk& last = _chunks.back();
+        const uint32_t lastRow = last.count - 1;
+        Chunk& chunk = _chunks[chunkIndex];
+
+        Entity moved;
+        if (&chunk != &last || row != lastRow)
+        {
+            for (ComponentId id : _components)
+            {
+                const ComponentInfo& info = GetComponentInfo(id);
+                if (info.size == 0) {
+                    continue;
+                }
+
+                uint8_t* destination = static_cast<uint8_t*>(GetComponentArray(chunk, id)) + static_cast<size_t>(row) * info.size;
+                uint8_t* source = static_cast<uint8_t*>(GetComponentArray(last, id)) + static_cast<size_t>(lastRow) * info.size;
+                info.relocate(destination, source, 1);
+            }
+
+            moved = GetEntities(last)[lastRow];
+            GetEntities(chunk)[row] = moved;
+        }
+
+        last.count--;
+        _entityCount--;
+        if (last.count == 0)
+        {
+            GetTaggedAllocator(MemoryTag::Scene).Free(last.data);
+            _chunks.pop_back();
+        }
+
+        return moved;
+    }
+
+    World::World()
+    {
+        _emptyArchetype = GetArchetype(0);
+    }
+
+    World::~World()
+    {
+        _archetypes.clear();
+    }
+
+    Archetype* World::GetArchetype(ComponentMask mask)
+    {
+        auto it = _archetypeLookup.find(mask);
+        if (it != _archetypeLookup.end()) {
+            return it->second;
+        }
+
+        _archetypes.emplace_back(new Archetype(mask));
+        Archetype* archetype = _archetypes.back().get();
+        _archetypeLookup.emplace(mask, archetype);
+        return archetype;
+    }
+
+    Archetype* World::GetArchetypeWith(Archetype* source, ComponentId id)
+    {
+        Archetype*& edge = source->_addEdges[id];
+        if (!edge)
+        {
+            edge = GetArchetype(source->_mask | (ComponentMask(1) << id));
+            edge->_removeEdges[id] = source;
+        }
+
+        return edge;
+    }
+
+    Archetype* World::GetArchetypeWithout(Archetype* source, ComponentId id)
+    {
+        Archetype*& edge = source->_removeEdges[id];
+        if (!edge)
+        {
+            edge = GetArchetype(source->_mask & ~(ComponentMask(1) << id));
+            edge->_addEdges[id] = source;
+        }
+
+        return edge;
+    }
+
+    Entity World::AllocateEntity(Archetype* archetype, uint32_t& chunkIndex, uint32_t& row)
+    {
+        assert(_iterating.load(std::memory_order_relaxed) == 0 && "Structural change while iterating, use an EntityCommandBuffer");
+
+        Entity entity;
+        if (!_freeIndices.empty())
+        {
+            entity.index = _freeIndices.back();
+            _freeIndices.pop_back();
+        }
+        else
+        {
+            entity.index = static_cast<uint32_t>(_records.size());
+            _records.push_back({ nullptr, 0, 0, 0 });
+        }
+
+        EntityRecord& record = _records[entity.index];
+        entity.generation = record.generation;
+        archetype->AllocateRow(entity, chunkIndex, row);
+        record.archetype = archetype;
+        record.chunk = chunkIndex;
+        record.row = row;
+        _entityCount++;
+        return entity;
+    }
+
+    Entity World::CreateEntity()
+    {
+        uint32_t chunkIndex;
+        uint32_t row;
+        return AllocateEntity(_emptyArchetype, chunkIndex, row);
+    }
+
+    void World::RemoveRow(Archetype* archetype, uint32_t chunkIndex, uint32_t row)
+    {
+        const Entity moved = archetype->RemoveRow(chunkIndex, row);
+        if (moved.IsValid())
+        {
+            EntityRecord& record = _records[moved.index];
+            record.chunk = chunkIndex;
+            record.row = row;
+        }
+    }
+
+    void World::DestroyEntity(Entity entity)
+    {
+        assert(_iterating.load(std::memory_order_relaxed) == 0 && "Structural change while iterating, use an EntityCommandBuffer");
+        if (!IsAlive(entity)) {
+            return;
+        }
+
+        EntityRecord& record = _records[entity.index];
+        Archetype* archetype = record.archetype;
+        const Chunk& chunk = archetype->_chunks[record.chunk];
+        for (ComponentId id : archetype->_components)
+        {
+            const ComponentInfo& info = GetComponentInfo(id);
+            if (info.size > 0) {
+                info.destruct(static_cast<uint8_t*>(archetype->GetComponentArray(chunk, id)) + static_cast<size_t>(record.row) * info.size, 1);
+            }
+        }
+
+        const uint32_t chunkIndex = record.chunk;
+        const uint32_t row = record.row;
+        record.archetype = nullptr;
+        record.generation++;
+        _freeIndices.push_back(entity.index);
+        _entityCount--;
+        RemoveRow(archetype, chunkIndex, row);
+    }
+
+    void World::MoveEntity(EntityRecord& record, Archetype* destination)
+    {
+        Archetype* source = record.archetype;
+        const Chunk& sourceChunk = source->_chunks[record.chunk];
+        const Entity entity = source->GetEntities(sourceChunk)[record.row];
+
+        uint32_t chunkIndex;
+        uint32_t row;
+        destination->AllocateRow(entity, chunkIndex, row);
+        const Chunk& destinationChunk = destination->_chunks[chunkIndex];
+
+        // Carry over the shared components, destroy the ones the destination does not have.
+        for (ComponentId id : source->_components)
+        {
+            const ComponentInfo& info = GetComponentInfo(id);
+            if (info.size == 0) {
+                continue;
+            }
+
+            uint8_t* from = static_cast<uint8_t*>(source->GetComponentArray(sourceChunk, id)) + static_cast<size_t>(record.row) * info.size;
+            if (destination->HasComponent(id)) {
+                info.relocate(static_cast<uint8_t*>(destination->GetComponentArray(destinationChunk, id)) + static_cast<size_t>(row) * info.size, from, 1);
+            }
+            else {
+                info.destruct(from, 1);
+            }
+        }
+
+        RemoveRow(source, record.chunk, record.row);
+        record.archetype = destination;
+        record.chunk = chunkIndex;
+        record.row = row;
+    }
+
+    void* World::EmplaceComponent(Entity entity, ComponentId id, bool& created)
+    {
+        assert(_iterating.load(std::memory_order_relaxed) == 0 && "Structural change while iterating, use an EntityCommandBuffer");
+        assert(IsAlive(entity));
+
+        EntityRecord& record = _records[entity.index];
+        created = !record.archetype->HasComponent(id);
+        if (created) {
+            MoveEntity(record, GetArchetypeWith(record.archetype, id));
+        }
+
+        const Archetype* archetype = record.archetype;
+        void* array = archetype->GetComponentArray(archetype->_chunks[record.chunk], id);
+        return array ? static_cast<uint8_t*>(array) + static_cast<size_t>(record.row) * GetComponentInfo(id).size : nullptr;
+    }
+
+    void* World::AddComponentById(Entity entity, ComponentId id)
+    {
+        bool created;
+        void* component = EmplaceComponent(entity, id, created);
+        if (created && component) {
+            GetComponentInfo(id).construct(component, 1);
+        }
+
+        return component;
+    }
+
+    void World::RemoveComponentById(Entity entity, ComponentId id)
+    {
+        assert(_iterating.load(std::memory_order_relaxed) == 0 && "Structural change while iterating, use an EntityCommandBuffer");
+        if (!IsAlive(entity)) {
+            return;
+        }
+
+        EntityRecord& record = _records[entity.index];
+        if (record.archetype->HasComponent(id)) {
+            MoveEntity(record, GetArchetypeWithout(record.archetype, id));
+        }
+    }
+
+    void* World::GetComponentById(Entity entity, ComponentId id) const
+    {
+        if (!IsAlive(entity)) {
+            return nullptr;
+        }
+
+        const EntityRecord& record = _records[entity.index];
+        const Archetype* archetype = record.archetype;
+        void* array = archetype->GetComponentArray(archetype->_chunks[record.chunk], id);
+        return array ? static_cast<uint8_t*>(array) + static_cast<size_t>(record.row) * GetComponentInfo(id).size : nullptr;
+    }
+
+    ComponentMask World::GetComponentMask(Entity entity) const
+    {
+        return IsAlive(entity) ? _records[entity.index].archetype->_mask : 0;
+    }
+
+    void World::UpdateQuery(Query& query) const
+    {
+        if (query._world != this)
+        {
+            query._world = this;
+            query._scannedArchetypes = 0;
+            query._archetypes.clear();
+        }
+
+        // Archetypes are only ever appended, test the ones created since the last update.
+        for (size_t i = query._scannedArchetypes; i < _archetypes.size(); i++)
+        {
+            Archetype* archetype = _archetypes[i].get();
+            if (query.Matches(archetype->_mask)) {
+                query._archetypes.push_back(archetype);
+            }
+        }
+
+        query._scannedArchetypes = _archetypes.size();
+    }
+}
@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "foundation/job_system.h"
+#include "scene/component.h"
+#include "scene/entity.h"
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace alimer
+{
+    class World;
+
+    /// Size of the blocks component data is stored in.
+    static constexpr uint32_t ChunkSize = 16 * 1024;
+
+    /// Block holding up to the archetype chunk capacity entities, laid out as the entity array followed by one array per component.
+    struct Chunk
+    {
+        uint8_t* data = nullptr;
+        uint32_t count = 0;
+    };
+
+    /// Storage of every entity that has exactly the same set of components. Chunks are kept dense, only the last one is partially filled.
+    class ALIMER_API Archetype final
+    {
+    public:
+        /// Constructor.
+        explicit Archetype(ComponentMask mask);
+
+        /// Destructor, destroys the components still stored.
+        ~Archetype();
+
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        /// Get the component mask.
+        ComponentMask GetMask() const { return _mask; }
+
+        /// Check if the archetype has component id.
+        bool HasComponent(ComponentId id) const { return ((_mask >> id) & 1) != 0; }
+
+        /// Get the number of entities a chunk holds.
+        uint32_t GetChunkCapacity() const { return _chunkCapacity; }
+
+        /// Get the number of entities.
+        uint32_t GetEntityCount() const { return _entityCount; }
+
+        /// Get the number of chunks.
+        uint32_t GetChunkCount() const { return static_cast<uint32_t>(_chunks.size()); }
+
+        /// Get chunk by index.
+        const Chunk& GetChunk(uint32_t index) const { return _chunks[index]; }
+
+        /// Get the entity array of chunk.
+        Entity* GetEntities(const Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+
+        /// Get the array of component id in chunk, nullptr when the archetype does not have it or it is a tag.
+        void* GetComponentArray(const Chunk& chunk, ComponentId id) const
+        {
+            return _offsets[id] != InvalidOffset ? chunk.data + _offsets[id] : nullptr;
+        }
+
+    private:
+        friend class World;
+
+        static constexpr uint32_t InvalidOffset = ~0u;
+
+        /// Append a row for entity, component memory is left uninitialized.
+        void AllocateRow(Entity entity, uint32_t& chunkIndex, uint32_t& row);
+
+        /// Fill the hole at row with the last row, the components at row must be destroyed or relocated already.
+        /// Returns the entity that moved into the hole, an invalid handle when row was the last one.
+        Entity RemoveRow(uint32_t chunkIndex, uint32_t row);
+
+        ComponentMask _mask;
+        std::vector<ComponentId> _components;
+        uint32_t _offsets[MaxComponentTypes];
+        uint32_t _chunkCapacity = 0;
+        uint32_t _entityCount = 0;
+        std::vector<Chunk> _chunks;
+
+        /// Archetype graph, cached results of adding or removing one component.
+        Archetype* _addEdges[MaxComponentTypes] = {};
+        Archetype* _removeEdges[MaxComponentTypes] = {};
+    };
+
+    /// Access to the component arrays of one chunk.
+    class ChunkView final
+    {
+    public:
+        ChunkView(const Archetype* archetype, const Chunk* chunk)
+            : _archetype(archetype)
+            , _chunk(chunk)
+        {
+        }
+
+        /// Get the number of entities in the chunk.
+        uint32_t GetCount() const { return _chunk->count; }
+
+        /// Get the entity array.
+        const Entity* GetEntities() const { return _archetype->GetEntities(*_chunk); }
+
+        /// Get the array of component T, nullptr when absent or a tag. Use a const T for read access.
+        template <typename T>
+        T* Get() const { return static_cast<T*>(_archetype->GetComponentArray(*_chunk, GetComponentId<T>())); }
+
+        /// Check if the chunk has component T.
+        template <typename T>
+        bool Has() const { return _archetype->HasComponent(GetComponentId<T>()); }
+
+        /// Get the archetype of the chunk.
+        const Archetype* GetArchetype() const { return _archetype; }
+
+    private:
+        const Archetype* _archetype;
+        const Chunk* _chunk;
+    };
+
+    /// Component filter with declared access. Matching archetypes are cached, only archetypes created since the last use are tested.
+    /// A query must not be used by two threads at once.
+    class ALIMER_API Query final
+    {
+    public:
+        /// Require T, read only.
+        template <typename T>
+        Query& Read()
+        {
+            const ComponentMask mask = GetComponentMask<T>();
+            _all |= mask;
+            _access.read |= mask;
+            return *this;
+        }
+
+        /// Require T, read and write.
+        template <typename T>
+        Query& Write()
+        {
+            const ComponentMask mask = GetComponentMask<T>();
+            _all |= mask;
+            _access.write |= mask;
+            return *this;
+        }
+
+        /// Require T without accessing it, for tags.
+        template <typename T>
+        Query& With()
+        {
+            _all |= GetComponentMask<T>();
+            return *this;
+        }
+
+        /// Exclude entities that have T.
+        template <typename T>
+        Query& Without()
+        {
+            _none |= GetComponentMask<T>();
+            return *this;
+        }
+
+        /// Check if an archetype with mask matches.
+        bool Matches(ComponentMask mask) const { return (mask & _all) == _all && (mask & _none) == 0; }
+
+        /// Get the declared access.
+        const ComponentAccess& GetAccess() const { return _access; }
+
+    private:
+        friend class World;
+
+        struct ChunkRef
+        {
+            const Archetype* archetype;
+            const Chunk* chunk;
+        };
+
+        ComponentMask _all = 0;
+        ComponentMask _none = 0;
+        ComponentAccess _access;
+
+        const World* _world = nullptr;
+        size_t _scannedArchetypes = 0;
+        std::vector<Archetype*> _archetypes;
+        std::vector<ChunkRef> _chunks;
+    };
+
+    namespace detail
+    {
+        template <typename F, typename Tuple, size_t... I>
+        void InvokeForEach(F& function, const ChunkView& view, const Tuple& arrays, std::index_sequence<I...>)
+        {
+            const Entity* entities = view.GetEntities();
+            const uint32_t count = view.GetCount();
+            for (uint32_t i = 0; i < count; i++) {
+                function(entities[i], std::get<I>(arrays)[i]...);
+            }
+        }
+    }
+
+    /// Entity storage, entities live in archetypes and their components in 16KB chunks, one array per component.
+    /// Structural changes (create, destroy, add or remove components) are not allowed while iterating,
+    /// record them in an EntityCommandBuffer instead.
+    class ALIMER_API World final
+    {
+    public:
+        /// Constructor.
+        World();
+
+        /// Destructor.
+        ~World();
+
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        /// Create an entity without components.
+        Entity CreateEntity();
+
+        /// Create an entity with components, placed directly in its final archetype.
+        template <typename... Ts>
+        Entity CreateEntity(Ts&&... components)
+        {
+            const ComponentId ids[] = { GetComponentId<typename std::decay<Ts>::type>()... };
+            ComponentMask mask = 0;
+            for (ComponentId id : ids)
+            {
+                assert((mask & (ComponentMask(1) << id)) == 0 && "Duplicate component");
+                mask |= ComponentMask(1) << id;
+            }
+
+            uint32_t chunkIndex;
+            uint32_t row;
+            Archetype* archetype = GetArchetype(mask);
+            const Entity entity = AllocateEntity(archetype, chunkIndex, row);
+            const Chunk& chunk = archetype->_chunks[chunkIndex];
+            const int expand[] = { 0, (ConstructComponent(archetype->GetComponentArray(chunk, GetComponentId<typename std::decay<Ts>::type>()), row, std::forward<Ts>(components)), 0)... };
+            ALIMER_UNUSED(expand);
+            return entity;
+        }
+
+        /// Destroy an entity and its components.
+        void DestroyEntity(Entity entity);
+
+        /// Check if entity was created by this world and not destroyed since.
+        bool IsAlive(Entity entity) const
+        {
+            return entity.index < _records.size() && _records[entity.index].generation == entity.generation && _records[entity.index].archetype;
+        }
+
+        /// Add component T constructed from args, an existing component is overwritten.
+        template <typename T, typename... Args>
+        T& AddComponent(Entity entity, Args&&... args)
+        {
+            bool created;
+            T* component = static_cast<T*>(EmplaceComponent(entity, GetComponentId<T>(), created));
+            if (!component) {
+                // Tags have no storage, hand out a shared empty instance.
+                static T tag;
+                return tag;
+            }
+
+            if (created) {
+                new (component) T{ std::forward<Args>(args)... };
+            }
+            else {
+                *component = T{ std::forward<Args>(args)... };
+            }
+            return *component;
+        }
+
+        /// Remove component T if present.
+        template <typename T>
+        void RemoveComponent(Entity entity) { RemoveComponentById(entity, GetComponentId<T>()); }
+
+        /// Get component T, nullptr when absent.
+        template <typename T>
+        T* GetComponent(Entity entity) const { return static_cast<T*>(GetComponentById(entity, GetComponentId<T>())); }
+
+        /// Check if entity has component T.
+        template <typename T>
+        bool HasComponent(Entity entity) const { return (GetComponentMask(entity) & alimer::GetComponentMask<T>()) != 0; }
+
+        /// Add a default constructed component by id and return its storage, an existing component is kept.
+        void* AddComponentById(Entity entity, ComponentId id);
+
+        /// Remove a component by id if present.
+        void RemoveComponentById(Entity entity, ComponentId id);
+
+        /// Get a component by id, nullptr when absent or a tag.
+        void* GetComponentById(Entity entity, ComponentId id) const;
+
+        /// Get the component mask of entity.
+        ComponentMask GetComponentMask(Entity entity) const;
+
+        /// Get the number of live entities.
+        uint32_t GetEntityCount() const { return _entityCount; }
+
+        /// Get the number of archetypes, archetypes are never destroyed.
+        uint32_t GetArchetypeCount() const { return static_cast<uint32_t>(_archetypes.size()); }
+
+        /// Call function(const ChunkView&) for every non empty chunk matching query.
+        template <typename F>
+        void ForEachChunk(Query& query, F&& function)
+        {
+            UpdateQuery(query);
+            IterationScope scope(_iterating);
+            for (const Archetype* archetype : query._archetypes)
+            {
+                for (const Chunk& chunk : archetype->_chunks)
+                {
+                    if (chunk.count > 0) {
+                        function(ChunkView(archetype, &chunk));
+                    }
+                }
+            }
+        }
+
+        /// Call function(const ChunkView&) for every non empty chunk matching query, chunks are spread across jobs.
+        template <typename F>
+        void ParallelForEachChunk(Query& query, JobSystem& jobs, F&& function)
+        {
+            UpdateQuery(query);
+            IterationScope scope(_iterating);
+            query._chunks.clear();
+            for (const Archetype* archetype : query._archetypes)
+            {
+                for (const Chunk& chunk : archetype->_chunks)
+                {
+                    if (chunk.count > 0) {
+                        query._chunks.push_back({ archetype, &chunk });
+                    }
+                }
+            }
+
+            const Query::ChunkRef* chunks = query._chunks.data();
+            jobs.ParallelFor(static_cast<uint32_t>(query._chunks.size()), 1, [chunks, &function](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    function(ChunkView(chunks[i].archetype, chunks[i].chunk));
+                }
+            });
+        }
+
+        /// Call function(Entity, Ts&...) for every entity matching query, every T must hold data.
+        template <typename... Ts, typename F>
+        void ForEach(Query& query, F&& function)
+        {
+            ForEachChunk(query, [&function](const ChunkView& view) {
+                const auto arrays = std::make_tuple(view.Get<Ts>()...);
+                detail::InvokeForEach(function, view, arrays, std::index_sequence_for<Ts...>());
+            });
+        }
+
+    private:
+        struct EntityRecord
+        {
+            Archetype* archetype;
+            uint32_t chunk;
+            uint32_t row;
+            uint32_t generation;
+        };
+
+        /// Flags iteration so structural changes can be caught, several threads may iterate at once.
+        class IterationScope final
+        {
+        public:
+            explicit IterationScope(std::atomic<uint32_t>& counter) : _counter(counter) { _counter.fetch_add(1, std::memory_order_relaxed); }
+            ~IterationScope() { _counter.fetch_sub(1, std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint32_t>& _counter;
+        };
+
+        template <typename T>
+        static void ConstructComponent(void* array, uint32_t row, T&& value)
+        {
+            using Type = typename std::decay<T>::type;
+            if (array) {
+                new (static_cast<Type*>(array) + row) Type(std::forward<T>(value));
+            }
+        }
+
+        Archetype* GetArchetype(ComponentMask mask);
+        Archetype* GetArchetypeWith(Archetype* source, ComponentId id);
+        Archetype* GetArchetypeWithout(Archetype* source, ComponentId id);
+        Entity AllocateEntity(Archetype* archetype, uint32_t& chunkIndex, uint32_t& row);
+        void RemoveRow(Archetype* archetype, uint32_t chunkIndex, uint32_t row);
+        void MoveEntity(EntityRecord& record, Archetype* destination);
+        void* EmplaceComponent(Entity entity, ComponentId id, bool& created);
+        void UpdateQuery(Query& query) const;
+
+        std::vector<EntityRecord> _records;
+        std::vector<uint32_t> _freeIndices;
+        std::vector<std::unique_ptr<Archetype>> _archetypes;
+        std::unordered_map<ComponentMask, Archetype*> _archetypeLookup;
+        Archetype* _emptyArchetype = nullptr;
+        uint32_t _entityCount = 0;
+        std::atomic<uint32_t> _iterating{ 0 };
+    };
+}
@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "tests.h"
+#include "audio/audio_kernels.h"
+#include "foundation/math/math_helpers.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace alimer;
+using namespace alimer::tests;
+
+namespace
+{
+    float ReferenceFrame(const std::vector<float>& source, bool loop, uint64_t index)
+    {
+        if (index >= source.size())
+        {
+            if (!loop) {
+                return 0.0f;
+            }
+            index %= source.size();
+        }
+        return source[index];
+    }
+
+    float ReferenceResample(const std::vector<float>& source, bool loop, uint64_t position)
+    {
+        const uint64_t index = position >> AudioFractionBits;
+        if (index >= source.size() && !loop) {
+            return 0.0f;
+        }
+
+        const double t = static_cast<double>(position & (AudioFractionOne - 1)) / static_cast<double>(AudioFractionOne);
+        const double a = ReferenceFrame(source, loop, index);
+        const double b = ReferenceFrame(source, loop, index + 1);
+        return static_cast<float>(a + (b - a) * t);
+    }
+
+    void TestResampleLinear()
+    {
+        Random random;
+        std::vector<float> source(301);
+        for (float& sample : source) {
+            sample = random.Next(1.0f);
+        }
+
+        // Unity copy, up and down sampling, each with and without a loop and running past the end of the source.
+        const uint64_t steps[] = { AudioFractionOne, AudioFractionOne * 3 / 7, AudioFractionOne * 5 / 3, AudioFractionOne * 2 };
+        const uint64_t starts[] = { 0, AudioFractionOne * 250, AudioFractionOne * 17 + AudioFractionOne / 3 };
+        const uint32_t count = 1003;
+        std::vector<float> output(count);
+        uint32_t index = 0;
+        for (uint64_t step : steps)
+        {
+            for (uint64_t start : starts)
+            {
+                for (bool loop : { false, true })
+                {
+                    ResampleLinear(source.data(), static_cast<uint32_t>(source.size()), loop, start, step, output.data(), count);
+                    uint64_t position = start;
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        ExpectNear(output[i], ReferenceResample(source, loop, position), "ResampleLinear", index * count + i);
+                        position += step;
+                    }
+                    index++;
+                }
+            }
+        }
+
+        std::fill(output.begin(), output.end(), 1.0f);
+        ResampleLinear(source.data(), 0, true, 0, AudioFractionOne / 2, output.data(), count);
+        Expect(std::all_of(output.begin(), output.end(), [](float sample) { return sample == 0.0f; }), "ResampleLinear empty", 0);
+    }
+
+    void TestMixWithGainRamp()
+    {
+        Random random;
+        // Odd counts exercise the scalar tail after the lane loop.
+        for (uint32_t count : { 1u, 7u, 64u, 1027u })
+        {
+            std::vector<float> input(count);
+            std::vector<float> output(count);
+            std::vector<float> expected(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                input[i] = random.Next(1.0f);
+                output[i] = expected[i] = random.Next(1.0f);
+            }
+
+            const float gain = 0.8f;
+            const float gainStep = -0.5f / static_cast<float>(count);
+            for (uint32_t i = 0; i < count; i++) {
+                expected[i] += static_cast<float>(static_cast<double>(input[i]) * (gain + static_cast<double>(i) * gainStep));
+            }
+
+            MixWithGainRamp(input.data(), output.data(), count, gain, gainStep);
+            for (uint32_t i = 0; i < count; i++) {
+                ExpectNear(output[i], expected[i], "MixWithGainRamp", count + i, 2.0f);
+            }
+        }
+    }
+
+    void TestInterleaveStereo()
+    {
+        Random random;
+        const uint32_t count = 515;
+        std::vector<float> left(count);
+        std::vector<float> right(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            left[i] = random.Next(1.5f);
+            right[i] = random.Next(1.5f);
+        }
+
+        std::vector<float> output(count * 2);
+        InterleaveStereo(left.data(), right.data(), 0.9f, output.data(), count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            // The clamp must hold exactly, the device sees these samples as is.
+            Expect(output[i * 2 + 0] == std::min(std::max(left[i] * 0.9f, -1.0f), 1.0f), "InterleaveStereo left", i);
+            Expect(output[i * 2 + 1] == std::min(std::max(right[i] * 0.9f, -1.0f), 1.0f), "InterleaveStereo right", i);
+        }
+    }
+
+    void TestComputePanGains()
+    {
+        float left, right;
+        for (uint32_t i = 0; i <= 20; i++)
+        {
+            const float pan = static_cast<float>(i) * 0.1f - 1.0f;
+            ComputePanGains(pan, 1, left, right);
+            ExpectNear(left * left + right * right, 1.0f, "ComputePanGains constant power", i);
+
+            ComputePanGains(pan, 2, left, right);
+            Expect(std::max(left, right) == 1.0f && std::min(left, right) >= 0.0f, "ComputePanGains balance", i);
+        }
+
+        ComputePanGains(0.0f, 1, left, right);
+        ExpectNear(left, sqrtf(0.5f), "ComputePanGains center", 0);
+        ExpectNear(right, sqrtf(0.5f), "ComputePanGains center", 1);
+        ComputePanGains(-4.0f, 1, left, right);
+        ExpectNear(left, 1.0f, "ComputePanGains clamp", 0);
+        ExpectNear(right, 0.0f, "ComputePanGains clamp", 1);
+        ComputePanGains(0.25f, 2, left, right);
+        Expect(left == 0.75f && right == 1.0f, "ComputePanGains stereo", 0);
+    }
+}
+
+void alimer::tests::RunAudioTests()
+{
+    TestResampleLinear();
+    TestMixWithGainRamp();
+    TestInterleaveStereo();
+    TestComputePanGains();
+}
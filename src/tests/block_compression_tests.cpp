@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "tests.h"
+#include "graphics/block_compression.h"
+#include <cmath>
+#include <vector>
+
+using namespace alimer;
+using namespace alimer::tests;
+
+namespace
+{
+    /// Reference decoders, written from the format specifications independently of the encoder.
+    void DecodeRGB565(uint16_t value, int* rgb)
+    {
+        const int r = (value >> 11) & 31;
+        const int g = (value >> 5) & 63;
+        const int b = value & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    void DecodeBC1(const uint8_t* block, uint8_t* pixels)
+    {
+        const uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+        const uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+        int palette[4][3];
+        DecodeRGB565(c0, palette[0]);
+        DecodeRGB565(c1, palette[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            if (c0 > c1)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+
+        const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            const uint32_t index = (indices >> (2 * i)) & 3;
+            for (int c = 0; c < 3; c++) {
+                pixels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+            }
+        }
+    }
+
+    void DecodeBC4(const uint8_t* block, uint8_t* pixels, uint32_t channel)
+    {
+        int palette[8] = { block[0], block[1] };
+        if (palette[0] > palette[1])
+        {
+            for (int i = 2; i < 8; i++) {
+                palette[i] = ((8 - i) * palette[0] + (i - 1) * palette[1]) / 7;
+            }
+        }
+        else
+        {
+            for (int i = 2; i < 6; i++) {
+                palette[i] = ((6 - i) * palette[0] + (i - 1) * palette[1]) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (uint32_t i = 0; i < 6; i++) {
+            indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+        }
+        for (uint32_t i = 0; i < 16; i++) {
+            pixels[i * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+        }
+    }
+
+    /// Mode 6 only, the encoder emits nothing else. Returns false for other modes.
+    bool DecodeBC7(const uint8_t* block, uint8_t* pixels)
+    {
+        uint32_t position = 0;
+        auto read = [&](uint32_t bits) {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bits; i++, position++) {
+                value |= ((block[position >> 3] >> (position & 7)) & 1u) << i;
+            }
+            return value;
+        };
+
+        if (read(7) != 64) {
+            return false;
+        }
+
+        int endpoints[2][4];
+        for (int c = 0; c < 4; c++)
+        {
+            endpoints[0][c] = static_cast<int>(read(7));
+            endpoints[1][c] = static_cast<int>(read(7));
+        }
+        const int p0 = static_cast<int>(read(1));
+        const int p1 = static_cast<int>(read(1));
+        for (int c = 0; c < 4; c++)
+        {
+            endpoints[0][c] = endpoints[0][c] * 2 + p0;
+            endpoints[1][c] = endpoints[1][c] * 2 + p1;
+        }
+
+        static const int Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            const int weight = Weights[read(i == 0 ? 3 : 4)];
+            for (int c = 0; c < 4; c++) {
+                pixels[i * 4 + c] = static_cast<uint8_t>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+            }
+        }
+        return true;
+    }
+
+    /// Decode a surface and return the PSNR of the channels in channelMask against the source.
+    float RoundTrip(BlockFormat format, const std::vector<uint8_t>& source, uint32_t width, uint32_t height,
+        CompressionQuality quality, uint32_t channelMask, const char* test)
+    {
+        std::vector<uint8_t> compressed(GetCompressedSize(format, width, height));
+        CompressSurface(format, source.data(), width, height, compressed.data(), quality);
+
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t blockSize = GetBlockSize(format);
+        Expect(compressed.size() == static_cast<size_t>(blocksX) * blocksY * blockSize, test, 0);
+
+        double error = 0.0;
+        uint32_t samples = 0;
+        for (uint32_t by = 0; by < blocksY; by++)
+        {
+            for (uint32_t bx = 0; bx < blocksX; bx++)
+            {
+                const uint8_t* block = &compressed[(by * blocksX + bx) * blockSize];
+                uint8_t pixels[64] = {};
+                switch (format)
+                {
+                case BlockFormat::BC1:
+                    DecodeBC1(block, pixels);
+                    break;
+                case BlockFormat::BC4:
+                    DecodeBC4(block, pixels, 0);
+                    break;
+                case BlockFormat::BC7:
+                    Expect(DecodeBC7(block, pixels), test, by * blocksX + bx);
+                    break;
+                default:
+                    break;
+                }
+
+                // Pixels past the edge are padding.
+                for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++)
+                {
+                    for (uint32_t x = 0; x < 4 && bx * 4 + x < width; x++)
+                    {
+                        const uint8_t* expected = &source[((by * 4 + y) * width + bx * 4 + x) * 4];
+                        for (uint32_t c = 0; c < 4; c++)
+                        {
+                            if (channelMask & (1u << c))
+                            {
+                                const double difference = static_cast<double>(pixels[(y * 4 + x) * 4 + c]) - expected[c];
+                                error += difference * difference;
+                                samples++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        error /= samples;
+        return error > 0.0 ? static_cast<float>(10.0 * std::log10(255.0 * 255.0 / error)) : 99.0f;
+    }
+
+    void TestRoundTrip(BlockFormat format, uint32_t channelMask, float minSolidPsnr, float minPsnr, const char* test)
+    {
+        // A solid surface has to survive almost unchanged.
+        const uint32_t solidSize = 8;
+        std::vector<uint8_t> solid(solidSize * solidSize * 4);
+        for (uint32_t i = 0; i < solidSize * solidSize; i++)
+        {
+            solid[i * 4 + 0] = 200;
+            solid[i * 4 + 1] = 96;
+            solid[i * 4 + 2] = 33;
+            solid[i * 4 + 3] = 255;
+        }
+
+        // Smooth gradients with noise, the odd size covers partial edge blocks.
+        const uint32_t width = 37;
+        const uint32_t height = 21;
+        Random random;
+        std::vector<uint8_t> image(width * height * 4);
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                uint8_t* pixel = &image[(y * width + x) * 4];
+                pixel[0] = static_cast<uint8_t>(128.0f + 100.0f * std::sin(x * 0.2f) + random.Next(4.0f));
+                pixel[1] = static_cast<uint8_t>(y * 255 / height);
+                pixel[2] = static_cast<uint8_t>((x + y) * 4);
+                pixel[3] = static_cast<uint8_t>(255 - x * 6);
+            }
+        }
+
+        for (CompressionQuality quality : { CompressionQuality::Fast, CompressionQuality::Normal, CompressionQuality::High })
+        {
+            const uint32_t index = static_cast<uint32_t>(quality);
+            Expect(RoundTrip(format, solid, solidSize, solidSize, quality, channelMask, test) >= minSolidPsnr, test, index);
+            Expect(RoundTrip(format, image, width, height, quality, channelMask, test) >= minPsnr, test, index);
+        }
+    }
+}
+
+void alimer::tests::RunBlockCompressionTests()
+{
+    // Thresholds sit about 2 dB below what the encoder reaches on these inputs.
+    TestRoundTrip(BlockFormat::BC1, 0x7, 43.0f, 28.0f, "BC1 round trip");
+    TestRoundTrip(BlockFormat::BC4, 0x1, 99.0f, 40.0f, "BC4 round trip");
+    TestRoundTrip(BlockFormat::BC7, 0xf, 49.0f, 30.0f, "BC7 round trip");
+}
@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "tests.h"
+#include "scene/entity_command_buffer.h"
+#include "scene/world.h"
+#include <atomic>
+#include <vector>
+
+using namespace alimer;
+using namespace alimer::tests;
+
+namespace
+{
+    struct Position
+    {
+        float x;
+        float y;
+    };
+
+    struct Velocity
+    {
+        float x;
+        float y;
+    };
+
+    struct Frozen
+    {
+    };
+
+    /// Counts live instances so leaked or double destroyed components show up.
+    struct Tracked
+    {
+        static int live;
+
+        Tracked() { live++; }
+        Tracked(const Tracked& other) : value(other.value) { live++; }
+        Tracked(Tracked&& other) : value(other.value) { live++; }
+        Tracked(uint32_t value_) : value(value_) { live++; }
+        ~Tracked() { live--; }
+        Tracked& operator=(const Tracked& other) = default;
+
+        uint32_t value = 0;
+    };
+
+    int Tracked::live = 0;
+
+    uint32_t CountMatches(World& world, Query& query)
+    {
+        uint32_t count = 0;
+        world.ForEachChunk(query, [&count](const ChunkView& view) { count += view.GetCount(); });
+        return count;
+    }
+
+    void TestAddRemoveQuery()
+    {
+        // Enough entities to span several chunks per archetype.
+        const uint32_t count = 3000;
+        World world;
+        std::vector<Entity> entities;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const Entity entity = world.CreateEntity(Position{ static_cast<float>(i), 0.0f });
+            if (i % 2 == 0) {
+                world.AddComponent<Velocity>(entity, 1.0f, 2.0f);
+            }
+            if (i % 3 == 0) {
+                world.AddComponent<Frozen>(entity);
+            }
+            entities.push_back(entity);
+        }
+        Expect(world.GetEntityCount() == count, "ECS entity count", 0);
+
+        Query moving;
+        moving.Write<Position>().Read<Velocity>().Without<Frozen>();
+        Query positions;
+        positions.Read<Position>();
+        Expect(CountMatches(world, positions) == count, "ECS query all", 0);
+        Expect(CountMatches(world, moving) == (count + 5) / 6 * 2 - (count % 6 == 1 ? 1 : 0), "ECS query filters", 0);
+
+        world.ForEach<Position, const Velocity>(moving, [](Entity, Position& position, const Velocity& velocity) {
+            position.y += velocity.y;
+        });
+
+        // Removing every fourth entity's Position swaps rows inside chunks, the others keep their data.
+        for (uint32_t i = 0; i < count; i += 4) {
+            world.RemoveComponent<Position>(entities[i]);
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const Position* position = world.GetComponent<Position>(entities[i]);
+            if (i % 4 == 0)
+            {
+                Expect(position == nullptr && world.HasComponent<Velocity>(entities[i]), "ECS remove component", i);
+                continue;
+            }
+
+            const float expectedY = (i % 2 == 0 && i % 3 != 0) ? 2.0f : 0.0f;
+            Expect(position && position->x == static_cast<float>(i) && position->y == expectedY, "ECS component data", i);
+            Expect(world.HasComponent<Frozen>(entities[i]) == (i % 3 == 0), "ECS tag", i);
+        }
+        Expect(CountMatches(world, positions) == count - (count + 3) / 4, "ECS query after remove", 0);
+
+        // Destroyed handles go stale, a reused index gets a new generation.
+        world.DestroyEntity(entities[1]);
+        Expect(!world.IsAlive(entities[1]), "ECS destroy", 0);
+        const Entity reused = world.CreateEntity();
+        Expect(world.IsAlive(reused) && reused != entities[1], "ECS generation", 0);
+        Expect(world.GetEntityCount() == count, "ECS entity count after reuse", 0);
+    }
+
+    void TestComponentLifetime()
+    {
+        {
+            World world;
+            std::vector<Entity> entities;
+            for (uint32_t i = 0; i < 1000; i++) {
+                entities.push_back(world.CreateEntity(Tracked(i)));
+            }
+
+            // Archetype moves relocate the component, destroy and remove drop it.
+            for (uint32_t i = 0; i < 1000; i += 2) {
+                world.AddComponent<Position>(entities[i], 0.0f, 0.0f);
+            }
+            for (uint32_t i = 0; i < 1000; i += 5) {
+                world.DestroyEntity(entities[i]);
+            }
+            for (uint32_t i = 1; i < 1000; i += 10) {
+                world.RemoveComponent<Tracked>(entities[i]);
+            }
+
+            for (uint32_t i = 0; i < 1000; i++)
+            {
+                if (i % 5 == 0 || i % 10 == 1) {
+                    continue;
+                }
+                const Tracked* tracked = world.GetComponent<Tracked>(entities[i]);
+                Expect(tracked && tracked->value == i, "ECS relocated component", i);
+            }
+            Expect(Tracked::live == 1000 - 200 - 100, "ECS live components", static_cast<uint32_t>(Tracked::live));
+        }
+        Expect(Tracked::live == 0, "ECS components destroyed with the world", static_cast<uint32_t>(Tracked::live));
+    }
+
+    void TestCommandBuffer()
+    {
+        World world;
+        const Entity existing = world.CreateEntity(Position{ 1.0f, 1.0f });
+        const Entity doomed = world.CreateEntity(Position{ 2.0f, 2.0f });
+
+        EntityCommandBuffer commands;
+        const Entity pending = commands.CreateEntity();
+        Expect(EntityCommandBuffer::IsPending(pending), "ECS pending handle", 0);
+        commands.AddComponent(pending, Position{ 5.0f, 6.0f });
+        commands.AddComponent(pending, Velocity{ 7.0f, 8.0f });
+        commands.AddComponent(pending, Frozen());
+        commands.AddComponent(existing, Velocity{ 3.0f, 4.0f });
+        commands.AddComponent(existing, Position{ 9.0f, 9.0f });
+        commands.RemoveComponent<Position>(existing);
+        commands.DestroyEntity(doomed);
+
+        // Nothing is applied until playback.
+        Expect(!commands.IsEmpty() && world.GetEntityCount() == 2 && world.IsAlive(doomed), "ECS deferred", 0);
+        commands.Playback(world);
+        Expect(commands.IsEmpty(), "ECS playback clears", 0);
+
+        Expect(world.GetEntityCount() == 2 && !world.IsAlive(doomed), "ECS playback destroy", 0);
+        Expect(!world.HasComponent<Position>(existing), "ECS playback order", 0);
+        const Velocity* velocity = world.GetComponent<Velocity>(existing);
+        Expect(velocity && velocity->x == 3.0f && velocity->y == 4.0f, "ECS playback add", 0);
+
+        Query created;
+        created.Read<Position>().Read<Velocity>().With<Frozen>();
+        uint32_t matches = 0;
+        world.ForEach<const Position, const Velocity>(created, [&matches](Entity, const Position& position, const Velocity& v) {
+            matches++;
+            Expect(position.x == 5.0f && position.y == 6.0f && v.x == 7.0f && v.y == 8.0f, "ECS playback create", 0);
+        });
+        Expect(matches == 1, "ECS playback create count", matches);
+    }
+
+    void TestParallelForEachChunk()
+    {
+        JobSystem jobs;
+        jobs.Initialize(3);
+
+        World world;
+        const uint32_t count = 20000;
+        for (uint32_t i = 0; i < count; i++) {
+            world.CreateEntity(Position{ 1.0f, 0.0f }, Velocity{ 0.0f, static_cast<float>(i % 7) });
+        }
+
+        Query query;
+        query.Write<Position>().Read<Velocity>();
+        std::atomic<uint32_t> visited{ 0 };
+        world.ParallelForEachChunk(query, jobs, [&visited](const ChunkView& view) {
+            Position* positions = view.Get<Position>();
+            const Velocity* velocities = view.Get<const Velocity>();
+            for (uint32_t i = 0; i < view.GetCount(); i++) {
+                positions[i].y = velocities[i].y;
+            }
+            visited.fetch_add(view.GetCount(), std::memory_order_relaxed);
+        });
+        Expect(visited.load() == count, "ECS parallel visit", visited.load());
+
+        double sum = 0.0;
+        world.ForEach<const Position>(query, [&sum](Entity, const Position& position) { sum += position.y; });
+        double expected = 0.0;
+        for (uint32_t i = 0; i < count; i++) {
+            expected += i % 7;
+        }
+        Expect(sum == expected, "ECS parallel writes", 0);
+
+        jobs.Shutdown();
+    }
+}
+
+void alimer::tests::RunEcsTests()
+{
+    TestAddRemoveQuery();
+    TestComponentLifetime();
+    TestCommandBuffer();
+    TestParallelForEachChunk();
+}
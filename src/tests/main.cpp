@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "tests.h"
+#include "foundation/platform.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace alimer
+{
+    namespace tests
+    {
+        static uint32_t failures = 0;
+
+        void Expect(bool condition, const char* test, uint32_t index)
+        {
+            if (!condition)
+            {
+                std::printf("FAIL %s [%u]\n", test, index);
+                failures++;
+            }
+        }
+
+        void ExpectNear(float actual, float expected, const char* test, uint32_t index, float magnitude)
+        {
+            const float tolerance = 1e-5f * std::max(magnitude, std::fabs(expected));
+            if (!(std::fabs(actual - expected) <= tolerance))
+            {
+                std::printf("FAIL %s [%u]: %.9g, expected %.9g\n", test, index, actual, expected);
+                failures++;
+            }
+        }
+    }
+}
+
+int main()
+{
+#if ALIMER_SIMD_AVX2
+    std::printf("tests: AVX2\n");
+#elif ALIMER_SIMD_SSE2
+    std::printf("tests: SSE2\n");
+#elif ALIMER_SIMD_NEON
+    std::printf("tests: NEON\n");
+#else
+    std::printf("tests: scalar\n");
+#endif
+
+    alimer::tests::RunMathTests();
+    alimer::tests::RunRadixSortTests();
+    alimer::tests::RunBlockCompressionTests();
+    alimer::tests::RunEcsTests();
+    alimer::tests::RunTransformHierarchyTests();
+    alimer::tests::RunAudioTests();
+
+    if (alimer::tests::failures > 0)
+    {
+        std::printf("%u failures\n", alimer::tests::failures);
+        return 1;
+    }
+
+    std::printf("all passed\n");
+    return 0;
+}
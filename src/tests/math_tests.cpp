@@ -0,0 +1,261 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "tests.h"
+#include "foundation/math/math_batch.h"
+#include <cmath>
+#include <vector>
+
+using namespace alimer;
+using namespace alimer::tests;
+
+namespace
+{
+    void ExpectMatrixNear(const Matrix4& actual, const Matrix4& expected, const char* test, uint32_t index, float magnitude = 1.0f)
+    {
+        for (uint32_t i = 0; i < 16; i++) {
+            ExpectNear(actual.m[i], expected.m[i], test, index * 16 + i, magnitude);
+        }
+    }
+
+    Matrix4 NextMatrix(Random& random)
+    {
+        Matrix4 matrix;
+        for (float& value : matrix.m) {
+            value = random.Next(4.0f);
+        }
+        return matrix;
+    }
+
+    Matrix4 ReferenceMultiply(const Matrix4& a, const Matrix4& b)
+    {
+        Matrix4 result;
+        for (uint32_t column = 0; column < 4; column++)
+        {
+            for (uint32_t row = 0; row < 4; row++)
+            {
+                float sum = 0.0f;
+                for (uint32_t k = 0; k < 4; k++) {
+                    sum += a(row, k) * b(k, column);
+                }
+                result(row, column) = sum;
+            }
+        }
+        return result;
+    }
+
+    Vector3 ReferenceTransformPoint(const Matrix4& m, const Vector3& p)
+    {
+        return Vector3(
+            m(0, 0) * p.x + m(0, 1) * p.y + m(0, 2) * p.z + m(0, 3),
+            m(1, 0) * p.x + m(1, 1) * p.y + m(1, 2) * p.z + m(1, 3),
+            m(2, 0) * p.x + m(2, 1) * p.y + m(2, 2) * p.z + m(2, 3));
+    }
+
+    void TestMultiply()
+    {
+        Random random;
+        for (uint32_t i = 0; i < 64; i++)
+        {
+            const Matrix4 a = NextMatrix(random);
+            const Matrix4 b = NextMatrix(random);
+            ExpectMatrixNear(Multiply(a, b), ReferenceMultiply(a, b), "Multiply", i, 64.0f);
+        }
+    }
+
+    void TestTransform()
+    {
+        Random random;
+        for (uint32_t i = 0; i < 64; i++)
+        {
+            const Matrix4 m = NextMatrix(random);
+            const Vector4 v(random.Next(10.0f), random.Next(10.0f), random.Next(10.0f), random.Next(1.0f));
+            const Vector4 result = Transform(m, v);
+            for (uint32_t row = 0; row < 4; row++)
+            {
+                const float expected = m(row, 0) * v.x + m(row, 1) * v.y + m(row, 2) * v.z + m(row, 3) * v.w;
+                ExpectNear((&result.x)[row], expected, "Transform", i * 4 + row, 128.0f);
+            }
+        }
+    }
+
+    void TestInverse()
+    {
+        Random random;
+        for (uint32_t i = 0; i < 64; i++)
+        {
+            const Quaternion rotation = Normalize(Quaternion(random.Next(1.0f), random.Next(1.0f), random.Next(1.0f), random.Next(1.0f)));
+            const Vector3 translation(random.Next(10.0f), random.Next(10.0f), random.Next(10.0f));
+            const Vector3 scale(1.0f + std::fabs(random.Next(2.0f)), 1.0f + std::fabs(random.Next(2.0f)), 1.0f + std::fabs(random.Next(2.0f)));
+            const Matrix4 m = Matrix4::Compose(translation, rotation, scale);
+            ExpectMatrixNear(ReferenceMultiply(m, Inverse(m)), Matrix4::Identity(), "Inverse", i, 16.0f);
+            ExpectMatrixNear(ReferenceMultiply(m, InverseAffine(m)), Matrix4::Identity(), "InverseAffine", i, 16.0f);
+        }
+    }
+
+    void TestTransformPoints()
+    {
+        // Counts cover empty input, partial lanes and several full lanes plus a tail.
+        Random random;
+        const Matrix4 m = NextMatrix(random);
+        for (uint32_t count : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 17u, 64u, 67u })
+        {
+            std::vector<float> x(count), y(count), z(count), outX(count), outY(count), outZ(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                x[i] = random.Next(100.0f);
+                y[i] = random.Next(100.0f);
+                z[i] = random.Next(100.0f);
+            }
+
+            TransformPoints(m, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const Vector3 expected = ReferenceTransformPoint(m, Vector3(x[i], y[i], z[i]));
+                ExpectNear(outX[i], expected.x, "TransformPoints", i, 1280.0f);
+                ExpectNear(outY[i], expected.y, "TransformPoints", i, 1280.0f);
+                ExpectNear(outZ[i], expected.z, "TransformPoints", i, 1280.0f);
+            }
+
+            // In place.
+            TransformPoints(m, x.data(), y.data(), z.data(), x.data(), y.data(), z.data(), count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                ExpectNear(x[i], outX[i], "TransformPoints in place", i);
+                ExpectNear(y[i], outY[i], "TransformPoints in place", i);
+                ExpectNear(z[i], outZ[i], "TransformPoints in place", i);
+            }
+        }
+    }
+
+    void TestMultiplyMatrices()
+    {
+        Random random;
+        const uint32_t count = 19;
+        std::vector<Matrix4> a(count), b(count), result(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            a[i] = NextMatrix(random);
+            b[i] = NextMatrix(random);
+        }
+
+        MultiplyMatrices(a.data(), b.data(), result.data(), count);
+        for (uint32_t i = 0; i < count; i++) {
+            ExpectMatrixNear(result[i], ReferenceMultiply(a[i], b[i]), "MultiplyMatrices", i, 64.0f);
+        }
+
+        // Result aliasing a.
+        std::vector<Matrix4> expected(result);
+        MultiplyMatrices(a.data(), b.data(), a.data(), count);
+        for (uint32_t i = 0; i < count; i++) {
+            ExpectMatrixNear(a[i], expected[i], "MultiplyMatrices aliased", i);
+        }
+    }
+
+    void TestTransformBoundingBoxes()
+    {
+        Random random;
+        const uint32_t count = 23;
+        std::vector<Matrix4> matrices(count);
+        std::vector<float> local[6], world[6];
+        for (uint32_t component = 0; component < 6; component++)
+        {
+            local[component].resize(count);
+            world[component].resize(count);
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            matrices[i] = NextMatrix(random);
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                const float a = random.Next(50.0f);
+                const float b = random.Next(50.0f);
+                local[axis][i] = std::min(a, b);
+                local[axis + 3][i] = std::max(a, b);
+            }
+        }
+
+        const BoundingBoxArrays localArrays = { local[0].data(), local[1].data(), local[2].data(), local[3].data(), local[4].data(), local[5].data() };
+        const BoundingBoxArrays worldArrays = { world[0].data(), world[1].data(), world[2].data(), world[3].data(), world[4].data(), world[5].data() };
+        TransformBoundingBoxes(matrices.data(), localArrays, worldArrays, count);
+
+        // Reference: bounds of the eight transformed corners.
+        for (uint32_t i = 0; i < count; i++)
+        {
+            BoundingBox expected;
+            for (uint32_t corner = 0; corner < 8; corner++)
+            {
+                const Vector3 point(
+                    local[(corner & 1) ? 3 : 0][i],
+                    local[(corner & 2) ? 4 : 1][i],
+                    local[(corner & 4) ? 5 : 2][i]);
+                expected.Merge(ReferenceTransformPoint(matrices[i], point));
+            }
+
+            ExpectNear(world[0][i], expected.min.x, "TransformBoundingBoxes", i, 640.0f);
+            ExpectNear(world[1][i], expected.min.y, "TransformBoundingBoxes", i, 640.0f);
+            ExpectNear(world[2][i], expected.min.z, "TransformBoundingBoxes", i, 640.0f);
+            ExpectNear(world[3][i], expected.max.x, "TransformBoundingBoxes", i, 640.0f);
+            ExpectNear(world[4][i], expected.max.y, "TransformBoundingBoxes", i, 640.0f);
+            ExpectNear(world[5][i], expected.max.z, "TransformBoundingBoxes", i, 640.0f);
+        }
+    }
+
+    void TestComputeBoundingBox()
+    {
+        Random random;
+        for (uint32_t count : { 1u, 5u, 8u, 33u, 100u })
+        {
+            std::vector<float> x(count), y(count), z(count);
+            BoundingBox expected;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                x[i] = random.Next(1000.0f);
+                y[i] = random.Next(1000.0f);
+                z[i] = random.Next(1000.0f);
+                expected.Merge(Vector3(x[i], y[i], z[i]));
+            }
+
+            const BoundingBox box = ComputeBoundingBox(x.data(), y.data(), z.data(), count);
+            ExpectNear(box.min.x, expected.min.x, "ComputeBoundingBox", count);
+            ExpectNear(box.min.y, expected.min.y, "ComputeBoundingBox", count);
+            ExpectNear(box.min.z, expected.min.z, "ComputeBoundingBox", count);
+            ExpectNear(box.max.x, expected.max.x, "ComputeBoundingBox", count);
+            ExpectNear(box.max.y, expected.max.y, "ComputeBoundingBox", count);
+            ExpectNear(box.max.z, expected.max.z, "ComputeBoundingBox", count);
+        }
+
+        Expect(!ComputeBoundingBox(nullptr, nullptr, nullptr, 0).IsValid(), "ComputeBoundingBox empty", 0);
+    }
+}
+
+void alimer::tests::RunMathTests()
+{
+    TestMultiply();
+    TestTransform();
+    TestInverse();
+    TestTransformPoints();
+    TestMultiplyMatrices();
+    TestTransformBoundingBoxes();
+    TestComputeBoundingBox();
+}
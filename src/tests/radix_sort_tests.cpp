@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "tests.h"
+#include "foundation/radix_sort.h"
+#include <algorithm>
+#include <vector>
+
+using namespace alimer;
+using namespace alimer::tests;
+
+namespace
+{
+    /// Sort keys drawn with keyMask applied and check the order and stability against std::stable_sort.
+    void TestSort(const char* test, uint32_t count, uint64_t keyMask, JobSystem* jobs)
+    {
+        Random random;
+        std::vector<uint64_t> keys(count), keyScratch(count);
+        std::vector<uint32_t> values(count), valueScratch(count);
+        std::vector<std::pair<uint64_t, uint32_t>> expected(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            keys[i] = ((static_cast<uint64_t>(random.NextUInt()) << 32) | random.NextUInt()) & keyMask;
+            values[i] = i;
+            expected[i] = std::make_pair(keys[i], i);
+        }
+
+        std::stable_sort(expected.begin(), expected.end(), [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+            return a.first < b.first;
+        });
+
+        RadixSort(keys.data(), values.data(), keyScratch.data(), valueScratch.data(), count, jobs);
+        for (uint32_t i = 0; i < count; i++) {
+            Expect(keys[i] == expected[i].first && values[i] == expected[i].second, test, i);
+        }
+    }
+}
+
+void alimer::tests::RunRadixSortTests()
+{
+    // Few distinct keys exercise stability, narrow keys exercise skipped passes.
+    for (uint32_t count : { 0u, 1u, 2u, 255u, 1000u })
+    {
+        TestSort("RadixSort full keys", count, ~0ull, nullptr);
+        TestSort("RadixSort few keys", count, 0x7, nullptr);
+        TestSort("RadixSort sprite keys", count, 0xff00ff00ffull, nullptr);
+    }
+
+    // Large enough to be split into blocks sorted by jobs.
+    JobSystem jobs;
+    jobs.Initialize(3);
+    TestSort("RadixSort parallel full keys", 100000, ~0ull, &jobs);
+    TestSort("RadixSort parallel few keys", 100000, 0x30000000f, &jobs);
+    jobs.Shutdown();
+}
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace alimer
+{
+    namespace tests
+    {
+        /// Record a failure when condition is false.
+        void Expect(bool condition, const char* test, uint32_t index);
+
+        /// Compare against a reference. Fused multiply add changes rounding, the tolerance is relative to
+        /// magnitude, the largest partial sum the result is computed from.
+        void ExpectNear(float actual, float expected, const char* test, uint32_t index, float magnitude = 1.0f);
+
+        /// Deterministic xorshift values.
+        class Random
+        {
+        public:
+            uint32_t NextUInt()
+            {
+                _state ^= _state << 13;
+                _state ^= _state >> 17;
+                _state ^= _state << 5;
+                return _state;
+            }
+
+            /// Value in [-range, range].
+            float Next(float range)
+            {
+                return (static_cast<float>(NextUInt() & 0xffffff) / 8388607.5f - 1.0f) * range;
+            }
+
+        private:
+            uint32_t _state = 0x2545f491u;
+        };
+
+        void RunMathTests();
+        void RunRadixSortTests();
+        void RunBlockCompressionTests();
+        void RunEcsTests();
+        void RunTransformHierarchyTests();
+        void RunAudioTests();
+    }
+}
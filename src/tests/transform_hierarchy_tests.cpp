@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "tests.h"
+#include "scene/transform_hierarchy.h"
+#include <algorithm>
+#include <vector>
+
+using namespace alimer;
+using namespace alimer::tests;
+
+namespace
+{
+    /// Mirror of the hierarchy kept in creation order, parents always precede their children.
+    struct ReferenceNode
+    {
+        TransformId id;
+        uint32_t parent;
+        LocalTransform local;
+        Matrix4 world;
+    };
+
+    LocalTransform NextLocal(Random& random)
+    {
+        LocalTransform local;
+        local.position = Vector3(random.Next(2.0f), random.Next(2.0f), random.Next(2.0f));
+        const Vector3 axis = Normalize(Vector3(random.Next(1.0f), random.Next(1.0f), 1.5f));
+        local.rotation = Quaternion::FromAxisAngle(axis, random.Next(3.0f));
+        local.scale = Vector3(1.0f + random.Next(0.1f));
+        return local;
+    }
+
+    std::vector<ReferenceNode> BuildTree(TransformHierarchy& hierarchy, Random& random, uint32_t count)
+    {
+        std::vector<ReferenceNode> nodes;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            // A few roots, the rest hang off a random earlier node which yields both deep chains and wide fans.
+            const uint32_t parent = (i < 4) ? ~0u : random.NextUInt() % i;
+            const LocalTransform local = NextLocal(random);
+            const TransformId id = hierarchy.Create(parent != ~0u ? nodes[parent].id : InvalidTransform, local);
+            nodes.push_back({ id, parent, local, Matrix4() });
+        }
+        return nodes;
+    }
+
+    void ComputeReference(std::vector<ReferenceNode>& nodes)
+    {
+        for (ReferenceNode& node : nodes)
+        {
+            const Matrix4 local = Matrix4::Compose(node.local.position, node.local.rotation, node.local.scale);
+            node.world = node.parent != ~0u ? Multiply(nodes[node.parent].world, local) : local;
+        }
+    }
+
+    void ExpectWorldMatrices(const TransformHierarchy& hierarchy, const std::vector<ReferenceNode>& nodes, const char* test)
+    {
+        for (uint32_t i = 0; i < nodes.size(); i++)
+        {
+            const Matrix4& actual = hierarchy.GetWorldMatrix(nodes[i].id);
+            for (uint32_t j = 0; j < 16; j++) {
+                ExpectNear(actual.m[j], nodes[i].world.m[j], test, i * 16 + j, 16.0f);
+            }
+        }
+    }
+
+    void TestPropagation(JobSystem* jobs)
+    {
+        const uint32_t count = 4000;
+        Random random;
+        TransformHierarchy hierarchy;
+        std::vector<ReferenceNode> nodes = BuildTree(hierarchy, random, count);
+        hierarchy.Update(jobs);
+        ComputeReference(nodes);
+        ExpectWorldMatrices(hierarchy, nodes, "hierarchy initial update");
+        Expect(hierarchy.GetChangedTransforms().size() == count, "hierarchy initial changed", 0);
+
+        // A clean hierarchy reports no changes.
+        hierarchy.Update(jobs);
+        Expect(hierarchy.GetChangedTransforms().empty(), "hierarchy clean update", 0);
+
+        // Touch a handful of inner nodes, only their subtrees may change.
+        std::vector<bool> expectedChanged(count, false);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            const uint32_t node = 4 + random.NextUInt() % 200;
+            nodes[node].local = NextLocal(random);
+            hierarchy.SetLocal(nodes[node].id, nodes[node].local);
+            expectedChanged[node] = true;
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (nodes[i].parent != ~0u && expectedChanged[nodes[i].parent]) {
+                expectedChanged[i] = true;
+            }
+        }
+
+        hierarchy.Update(jobs);
+        ComputeReference(nodes);
+        ExpectWorldMatrices(hierarchy, nodes, "hierarchy incremental update");
+
+        std::vector<TransformId> changed = hierarchy.GetChangedTransforms();
+        std::vector<TransformId> expected;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (expectedChanged[i]) {
+                expected.push_back(nodes[i].id);
+            }
+        }
+        std::sort(changed.begin(), changed.end());
+        std::sort(expected.begin(), expected.end());
+        Expect(changed == expected, "hierarchy changed set", static_cast<uint32_t>(changed.size()));
+    }
+
+    void TestReparent()
+    {
+        TransformHierarchy hierarchy;
+        LocalTransform local;
+        local.position = Vector3(1.0f, 0.0f, 0.0f);
+        const TransformId a = hierarchy.Create(InvalidTransform, local);
+        local.position = Vector3(0.0f, 2.0f, 0.0f);
+        const TransformId b = hierarchy.Create(InvalidTransform, local);
+        local.position = Vector3(0.0f, 0.0f, 3.0f);
+        const TransformId child = hierarchy.Create(a, local);
+        const TransformId grandChild = hierarchy.Create(child, local);
+        hierarchy.Update();
+        Expect(hierarchy.GetWorldMatrix(grandChild)(0, 3) == 1.0f && hierarchy.GetWorldMatrix(grandChild)(2, 3) == 6.0f, "hierarchy translation", 0);
+
+        // The moved subtree picks up the new parent, the local transforms are kept.
+        hierarchy.SetParent(child, b);
+        hierarchy.Update();
+        const Matrix4& world = hierarchy.GetWorldMatrix(grandChild);
+        Expect(hierarchy.GetParent(child) == b, "hierarchy reparent", 0);
+        Expect(world(0, 3) == 0.0f && world(1, 3) == 2.0f && world(2, 3) == 6.0f, "hierarchy reparent world", 0);
+
+        hierarchy.Destroy(child);
+        Expect(!hierarchy.IsValid(child) && !hierarchy.IsValid(grandChild), "hierarchy destroy subtree", 0);
+        Expect(hierarchy.GetCount() == 2 && hierarchy.IsValid(a) && hierarchy.IsValid(b), "hierarchy count", hierarchy.GetCount());
+    }
+}
+
+void alimer::tests::RunTransformHierarchyTests()
+{
+    TestPropagation(nullptr);
+
+    JobSystem jobs;
+    jobs.Initialize(3);
+    TestPropagation(&jobs);
+    jobs.Shutdown();
+
+    TestReparent();
+}
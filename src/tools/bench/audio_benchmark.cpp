@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "benchmark.h"
+#include "audio/audio.h"
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+namespace alimer
+{
+    namespace
+    {
+        struct AudioOptions
+        {
+            uint32_t voices = 64;
+            double seconds = 10.0;
+            uint32_t blockFrames = 512;
+        };
+
+        /// One second of a looping tone at a rate different from the mixer, so every voice resamples.
+        std::shared_ptr<AudioClip> CreateTone(uint32_t channels, float frequency)
+        {
+            const uint32_t sampleRate = 44100;
+            std::vector<float> samples(static_cast<size_t>(sampleRate) * channels);
+            for (uint32_t frame = 0; frame < sampleRate; frame++)
+            {
+                const float value = 0.25f * std::sin(6.2831853f * frequency * static_cast<float>(frame) / static_cast<float>(sampleRate));
+                for (uint32_t channel = 0; channel < channels; channel++) {
+                    samples[frame * channels + channel] = value;
+                }
+            }
+            return std::make_shared<AudioClip>(samples.data(), sampleRate, channels, sampleRate);
+        }
+
+        int RunAudioBenchmark(const AudioOptions& options)
+        {
+            AudioSettings settings;
+            settings.blockFrames = options.blockFrames;
+            settings.maxVoices = std::max(options.voices, 1u);
+            settings.commandQueueCapacity = std::max(settings.commandQueueCapacity, settings.maxVoices * 2);
+
+            // Offline device, Render mixes as fast as the CPU allows.
+            Audio audio;
+            if (!audio.Initialize(std::unique_ptr<AudioDevice>(new NullAudioDevice(false)), settings))
+            {
+                std::cerr << "Failed to initialize the audio mixer" << std::endl;
+                return 1;
+            }
+
+            const std::shared_ptr<AudioClip> clips[2] = { CreateTone(1, 440.0f), CreateTone(2, 330.0f) };
+            for (uint32_t i = 0; i < settings.maxVoices; i++)
+            {
+                AudioVoiceParams params;
+                params.loop = true;
+                params.gain = 1.0f / static_cast<float>(settings.maxVoices);
+                params.pan = static_cast<float>(i % 9) * 0.25f - 1.0f;
+                params.pitch = 0.75f + static_cast<float>(i % 5) * 0.125f;
+                audio.Play(clips[i & 1], params);
+            }
+
+            const uint32_t frames = static_cast<uint32_t>(options.seconds * settings.sampleRate);
+            const BenchmarkTimer timer;
+            audio.Render(frames);
+            const double elapsed = timer.GetMilliseconds();
+
+            const AudioStats stats = audio.GetStats();
+            audio.Shutdown();
+
+            const double audioMs = static_cast<double>(stats.framesMixed) * 1000.0 / settings.sampleRate;
+            std::cout << "voices:          " << stats.activeVoices << std::endl;
+            std::cout << "blocks:          " << stats.blocksMixed << " x " << settings.blockFrames << " frames" << std::endl;
+            std::cout << "ms/block:        " << (stats.blocksMixed ? static_cast<double>(stats.mixTime) * 1e-6 / stats.blocksMixed : 0.0) << std::endl;
+            std::cout << "voices/ms:       " << stats.GetVoicesPerMillisecond() << std::endl;
+            std::cout << "realtime factor: " << (elapsed > 0.0 ? audioMs / elapsed : 0.0) << std::endl;
+            return stats.activeVoices == settings.maxVoices ? 0 : 1;
+        }
+    }
+
+    void RegisterAudioBenchmark(CLI::App& app, int& result)
+    {
+        auto options = std::make_shared<AudioOptions>();
+        CLI::App* command = app.add_subcommand("audio", "Software mixer throughput rendering looping voices offline");
+        command->add_option("-v,--voices", options->voices, "Voices playing at once", true);
+        command->add_option("-s,--seconds", options->seconds, "Seconds of audio rendered", true);
+        command->add_option("-b,--block", options->blockFrames, "Frames mixed per block", true);
+        command->callback([options, &result]() { result = RunAudioBenchmark(*options); });
+    }
+}
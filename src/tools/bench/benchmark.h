@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace alimer
+{
+    /// Wall clock timer for benchmark loops.
+    class BenchmarkTimer final
+    {
+    public:
+        BenchmarkTimer() : _start(std::chrono::steady_clock::now()) {}
+
+        /// Get the milliseconds elapsed since construction.
+        double GetMilliseconds() const
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    /// Get the value below which fraction of the samples fall, samples are sorted in place.
+    inline double GetPercentile(std::vector<double>& samples, double fraction)
+    {
+        if (samples.empty()) {
+            return 0.0;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        const size_t index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[index];
+    }
+
+    /// Register a benchmark subcommand, its callback stores the process exit code in result.
+    void RegisterAudioBenchmark(CLI::App& app, int& result);
+    void RegisterFrameBenchmark(CLI::App& app, int& result);
+    void RegisterJobBenchmark(CLI::App& app, int& result);
+    void RegisterMathBenchmark(CLI::App& app, int& result);
+    void RegisterSpriteBenchmark(CLI::App& app, int& result);
+}
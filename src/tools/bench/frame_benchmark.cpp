@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "benchmark.h"
+#include "core/application.h"
+#include "foundation/memory_tracker.h"
+#include <vgpu.h>
+#include <iostream>
+#include <memory>
+
+namespace alimer
+{
+    namespace
+    {
+        struct FrameOptions
+        {
+            uint32_t frames = 1000;
+            uint32_t warmupFrames = 60;
+            double budget = 0.0;
+        };
+
+        /// Application driven without a window, every frame runs against the null vgpu backend.
+        class HeadlessApplication final : public Application
+        {
+        public:
+            ~HeadlessApplication() override
+            {
+                shutdown();
+                vgpuShutdown();
+            }
+
+            bool Initialize(uint32_t width, uint32_t height)
+            {
+                VGpuRendererSettings settings = {};
+                settings.width = width;
+                settings.height = height;
+                settings.swapchain.imageCount = 3;
+                if (!vgpuInitialize("alimer-bench", &settings)) {
+                    return false;
+                }
+
+                initialize();
+                return true;
+            }
+
+            void Frame() { frame(); }
+        };
+
+        int RunFrameBenchmark(const FrameOptions& options)
+        {
+#if defined(VGPU_NULL)
+            std::unique_ptr<HeadlessApplication> application(new HeadlessApplication());
+            if (!application->Initialize(1280, 720))
+            {
+                std::cerr << "Failed to initialize the null vgpu backend" << std::endl;
+                return 1;
+            }
+
+            for (uint32_t i = 0; i < options.warmupFrames; i++) {
+                application->Frame();
+            }
+
+            std::vector<double> frameTimes;
+            frameTimes.reserve(options.frames);
+            uint64_t draws = 0;
+            uint64_t pipelineBinds = 0;
+            uint64_t bytesUploaded = 0;
+            uint64_t allocations = 0;
+            const BenchmarkTimer total;
+            for (uint32_t i = 0; i < options.frames; i++)
+            {
+                const BenchmarkTimer timer;
+                application->Frame();
+                frameTimes.push_back(timer.GetMilliseconds());
+
+                VGpuNullCounters counters;
+                vgpuNullGetCounters(&counters);
+                draws += counters.draws;
+                pipelineBinds += counters.pipelineBinds;
+                bytesUploaded += counters.bytesUploaded;
+                allocations += MemoryTracker::GetTotalStats().frameAllocations;
+            }
+
+            const double totalTime = total.GetMilliseconds();
+            const double frames = static_cast<double>(std::max(options.frames, 1u));
+            const double mean = totalTime / frames;
+            std::cout << "frames:          " << options.frames << std::endl;
+            std::cout << "mean ms/frame:   " << mean << std::endl;
+            std::cout << "median ms/frame: " << GetPercentile(frameTimes, 0.5) << std::endl;
+            std::cout << "p99 ms/frame:    " << GetPercentile(frameTimes, 0.99) << std::endl;
+            std::cout << "max ms/frame:    " << GetPercentile(frameTimes, 1.0) << std::endl;
+            std::cout << "draws/frame:     " << draws / frames << std::endl;
+            std::cout << "binds/frame:     " << pipelineBinds / frames << std::endl;
+            std::cout << "uploads/frame:   " << bytesUploaded / frames << " bytes" << std::endl;
+            std::cout << "allocs/frame:    " << allocations / frames << std::endl;
+
+            if (options.budget > 0.0 && mean > options.budget)
+            {
+                std::cerr << "Mean frame time " << mean << " ms exceeds the budget of " << options.budget << " ms" << std::endl;
+                return 1;
+            }
+            return 0;
+#else
+            ALIMER_UNUSED(options);
+            std::cerr << "The frame benchmark needs the null vgpu backend, configure with -DVGPU_RENDERER=NULL" << std::endl;
+            return 1;
+#endif
+        }
+    }
+
+    void RegisterFrameBenchmark(CLI::App& app, int& result)
+    {
+        auto options = std::make_shared<FrameOptions>();
+        CLI::App* command = app.add_subcommand("frame", "CPU cost of Application::frame() on the null vgpu backend");
+        command->add_option("-n,--frames", options->frames, "Measured frames", true);
+        command->add_option("--warmup", options->warmupFrames, "Frames run before measuring", true);
+        command->add_option("--budget-ms", options->budget, "Fail when the mean frame time exceeds this, 0 disables the check", true);
+        command->callback([options, &result]() { result = RunFrameBenchmark(*options); });
+    }
+}
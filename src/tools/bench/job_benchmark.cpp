@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "benchmark.h"
+#include "foundation/job_system.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace alimer
+{
+    namespace
+    {
+        struct JobOptions
+        {
+            uint32_t maxThreads = 0;
+            uint32_t items = 1u << 20;
+            uint32_t batchSize = 1024;
+            uint32_t iterations = 64;
+            uint32_t repeats = 5;
+        };
+
+        /// Compute bound work per item, enough to dwarf the scheduling cost of a batch.
+        float ProcessItem(uint32_t item, uint32_t iterations)
+        {
+            float value = static_cast<float>(item & 1023) * 0.001f;
+            for (uint32_t i = 0; i < iterations; i++) {
+                value = std::sin(value) * 0.5f + std::sqrt(value + 1.0f);
+            }
+            return value;
+        }
+
+        int RunJobBenchmark(const JobOptions& options)
+        {
+            uint32_t maxThreads = options.maxThreads;
+            if (maxThreads == 0) {
+                maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+            }
+
+#if !defined(ALIMER_THREADING)
+            std::cout << "Built without ALIMER_THREADING, only the main thread runs jobs" << std::endl;
+            maxThreads = 1;
+#endif
+
+            std::vector<float> results(options.items);
+            double baseline = 0.0;
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "threads        ms   speedup  efficiency    stolen" << std::endl;
+            for (uint32_t threads = 1; threads <= maxThreads; threads++)
+            {
+                JobSystem jobs;
+                jobs.Initialize(threads - 1);
+
+                // Best of several runs, the first one also warms up the workers.
+                double best = 0.0;
+                for (uint32_t repeat = 0; repeat < options.repeats; repeat++)
+                {
+                    const BenchmarkTimer timer;
+                    jobs.ParallelFor(options.items, options.batchSize, [&](uint32_t begin, uint32_t end) {
+                        for (uint32_t i = begin; i < end; i++) {
+                            results[i] = ProcessItem(i, options.iterations);
+                        }
+                    });
+
+                    const double time = timer.GetMilliseconds();
+                    best = repeat == 0 ? time : std::min(best, time);
+                }
+
+                const JobSystemStats stats = jobs.GetStats();
+                jobs.Shutdown();
+
+                if (threads == 1) {
+                    baseline = best;
+                }
+
+                const double speedup = baseline / best;
+                std::cout << std::setw(7) << threads << std::setw(10) << best << std::setw(10) << speedup
+                    << std::setw(12) << speedup / threads << std::setw(10) << stats.stolen << std::endl;
+            }
+
+            // Keeps the work observable.
+            double checksum = 0.0;
+            for (float value : results) {
+                checksum += value;
+            }
+            std::cout << "checksum: " << checksum << std::endl;
+            return 0;
+        }
+    }
+
+    void RegisterJobBenchmark(CLI::App& app, int& result)
+    {
+        auto options = std::make_shared<JobOptions>();
+        CLI::App* command = app.add_subcommand("jobs", "JobSystem::ParallelFor scaling from 1 to N threads");
+        command->add_option("-t,--max-threads", options->maxThreads, "Highest thread count, 0 uses every hardware thread", true);
+        command->add_option("-n,--items", options->items, "Items processed per run", true);
+        command->add_option("-b,--batch", options->batchSize, "Items per job", true);
+        command->add_option("-i,--iterations", options->iterations, "Work per item", true);
+        command->add_option("-r,--repeats", options->repeats, "Runs per thread count, the fastest one is reported", true);
+        command->callback([options, &result]() { result = RunJobBenchmark(*options); });
+    }
+}
@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "benchmark.h"
+#include "foundation/math/math_batch.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace alimer
+{
+    namespace
+    {
+        struct MathOptions
+        {
+            uint32_t count = 1u << 16;
+            uint32_t repeats = 50;
+        };
+
+        /// Fastest of repeats runs of body, in nanoseconds per element.
+        template <typename Body>
+        double Measure(const MathOptions& options, Body body)
+        {
+            double best = 0.0;
+            for (uint32_t repeat = 0; repeat < options.repeats; repeat++)
+            {
+                const BenchmarkTimer timer;
+                body();
+                const double time = timer.GetMilliseconds();
+                best = repeat == 0 ? time : std::min(best, time);
+            }
+            return best * 1e6 / static_cast<double>(std::max(options.count, 1u));
+        }
+
+        void Report(const char* name, double batch, double scalar)
+        {
+            std::cout << std::left << std::setw(24) << name << std::right << std::setw(12) << batch
+                << std::setw(12) << scalar << std::setw(10) << scalar / batch << std::endl;
+        }
+
+        int RunMathBenchmark(const MathOptions& options)
+        {
+            const uint32_t count = options.count;
+            std::vector<float> x(count), y(count), z(count), outX(count), outY(count), outZ(count);
+            std::vector<Matrix4> a(count), b(count), products(count);
+            std::vector<float> bounds[12];
+            for (std::vector<float>& component : bounds) {
+                component.resize(count);
+            }
+
+            uint32_t random = 0x9e3779b9u;
+            auto next = [&random]() {
+                random ^= random << 13;
+                random ^= random >> 17;
+                random ^= random << 5;
+                return static_cast<float>(random & 0xffff) / 32768.0f - 1.0f;
+            };
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                x[i] = next() * 100.0f;
+                y[i] = next() * 100.0f;
+                z[i] = next() * 100.0f;
+                for (uint32_t j = 0; j < 16; j++)
+                {
+                    a[i].m[j] = next();
+                    b[i].m[j] = next();
+                }
+                for (uint32_t axis = 0; axis < 3; axis++)
+                {
+                    const float extent = std::abs(next()) + 0.1f;
+                    bounds[axis][i] = -extent;
+                    bounds[axis + 3][i] = extent;
+                }
+            }
+
+            const Matrix4 matrix = a[0];
+            const BoundingBoxArrays local = { bounds[0].data(), bounds[1].data(), bounds[2].data(), bounds[3].data(), bounds[4].data(), bounds[5].data() };
+            const BoundingBoxArrays world = { bounds[6].data(), bounds[7].data(), bounds[8].data(), bounds[9].data(), bounds[10].data(), bounds[11].data() };
+
+#if ALIMER_SIMD_AVX2
+            std::cout << "SIMD: AVX2" << std::endl;
+#elif ALIMER_SIMD_SSE2
+            std::cout << "SIMD: SSE2" << std::endl;
+#elif ALIMER_SIMD_NEON
+            std::cout << "SIMD: NEON" << std::endl;
+#else
+            std::cout << "SIMD: none" << std::endl;
+#endif
+            std::cout << std::fixed << std::setprecision(3);
+            std::cout << "elements: " << count << std::endl;
+            std::cout << "function             batch ns/op  scalar ns/op   speedup" << std::endl;
+
+            // Scalar columns call the per element functions the batch versions replace.
+            Report("TransformPoints",
+                Measure(options, [&]() { TransformPoints(matrix, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count); }),
+                Measure(options, [&]() {
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        const Vector3 p = TransformPoint(matrix, Vector3(x[i], y[i], z[i]));
+                        outX[i] = p.x;
+                        outY[i] = p.y;
+                        outZ[i] = p.z;
+                    }
+                }));
+
+            Report("MultiplyMatrices",
+                Measure(options, [&]() { MultiplyMatrices(a.data(), b.data(), products.data(), count); }),
+                Measure(options, [&]() {
+                    for (uint32_t i = 0; i < count; i++) {
+                        products[i] = Multiply(a[i], b[i]);
+                    }
+                }));
+
+            Report("TransformBoundingBoxes",
+                Measure(options, [&]() { TransformBoundingBoxes(a.data(), local, world, count); }),
+                Measure(options, [&]() {
+                    // Same center and absolute matrix extents method as the batch version, only the data layout differs.
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        const BoundingBox box = Transform(BoundingBox(
+                            Vector3(local.minX[i], local.minY[i], local.minZ[i]),
+                            Vector3(local.maxX[i], local.maxY[i], local.maxZ[i])), a[i]);
+                        world.minX[i] = box.min.x;
+                        world.minY[i] = box.min.y;
+                        world.minZ[i] = box.min.z;
+                        world.maxX[i] = box.max.x;
+                        world.maxY[i] = box.max.y;
+                        world.maxZ[i] = box.max.z;
+                    }
+                }));
+
+            BoundingBox pointBounds;
+            Report("ComputeBoundingBox",
+                Measure(options, [&]() { pointBounds = ComputeBoundingBox(x.data(), y.data(), z.data(), count); }),
+                Measure(options, [&]() {
+                    BoundingBox box;
+                    for (uint32_t i = 0; i < count; i++) {
+                        box.Merge(Vector3(x[i], y[i], z[i]));
+                    }
+                    pointBounds.Merge(box);
+                }));
+
+            // Keeps the work observable.
+            double checksum = pointBounds.max.x;
+            for (uint32_t i = 0; i < count; i++) {
+                checksum += outX[i] + products[i].m[0] + world.maxX[i];
+            }
+            std::cout << "checksum: " << checksum << std::endl;
+            return 0;
+        }
+    }
+
+    void RegisterMathBenchmark(CLI::App& app, int& result)
+    {
+        auto options = std::make_shared<MathOptions>();
+        CLI::App* command = app.add_subcommand("math", "Batched math kernels against their per element scalar loops");
+        command->add_option("-n,--count", options->count, "Elements per call", true);
+        command->add_option("-r,--repeats", options->repeats, "Runs per kernel, the fastest one is reported", true);
+        command->callback([options, &result]() { result = RunMathBenchmark(*options); });
+    }
+}
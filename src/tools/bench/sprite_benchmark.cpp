@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "benchmark.h"
+#include "graphics/sprite_batch.h"
+#include <vgpu.h>
+#include <iostream>
+#include <memory>
+
+namespace alimer
+{
+    namespace
+    {
+        struct SpriteOptions
+        {
+            uint32_t sprites = 100000;
+            uint32_t frames = 200;
+            uint32_t warmupFrames = 10;
+            uint32_t textures = 16;
+            uint32_t layers = 4;
+        };
+
+        int RunSpriteBenchmark(const SpriteOptions& options)
+        {
+#if defined(VGPU_NULL)
+            const uint32_t textureCount = std::max(options.textures, 1u);
+            const uint32_t layerCount = std::max(options.layers, 1u);
+
+            // Instance data of every sprite lives in the transient ring for the frame.
+            VGpuRendererSettings settings = {};
+            settings.width = 1280;
+            settings.height = 720;
+            settings.swapchain.imageCount = 3;
+            settings.transientBufferSize = options.sprites * SpriteBatch::InstanceStride + (1u << 20);
+            if (!vgpuInitialize("alimer-bench", &settings))
+            {
+                std::cerr << "Failed to initialize the null vgpu backend" << std::endl;
+                return 1;
+            }
+
+            VGpuRenderPipelineDescriptor pipelineDesc = {};
+            pipelineDesc.shader = vgpuCreateShader("void main() {}", "void main() {}");
+            pipelineDesc.primitiveTopology = VGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+            SpriteBatch::GetVertexDescriptor(&pipelineDesc.vertexDescriptor);
+            const VGpuPipeline pipeline = vgpuCreateRenderPipeline(&pipelineDesc);
+
+            std::vector<VGpuTexture> textures(textureCount);
+            for (VGpuTexture& texture : textures)
+            {
+                VGpuTextureDescriptor textureDesc = {};
+                textureDesc.textureType = VGPU_TEXTURE_TYPE_2D;
+                textureDesc.pixelFormat = VGPU_PIXEL_FORMAT_RGBA8_UNORM;
+                textureDesc.size = { 4, 4, 1 };
+                textureDesc.mipLevels = 1;
+                textureDesc.arrayLayers = 1;
+                textureDesc.samples = VGPU_SAMPLE_COUNT1;
+                textureDesc.usage = VGPU_TEXTURE_USAGE_SHADER_READ;
+                texture = vgpuCreateTexture(&textureDesc, nullptr);
+            }
+
+            // Textures and layers are interleaved the way a scene submits them, the batch has to sort.
+            std::vector<Sprite> sprites(options.sprites);
+            std::vector<uint32_t> spriteTextures(options.sprites);
+            uint32_t random = 0x9e3779b9u;
+            for (uint32_t i = 0; i < options.sprites; i++)
+            {
+                random ^= random << 13;
+                random ^= random >> 17;
+                random ^= random << 5;
+                Sprite& sprite = sprites[i];
+                sprite.x = static_cast<float>(random % 1280);
+                sprite.y = static_cast<float>((random >> 11) % 720);
+                sprite.width = 16.0f;
+                sprite.height = 16.0f;
+                sprite.rotation = (i & 3) == 0 ? 0.5f : 0.0f;
+                sprite.layer = static_cast<uint16_t>((random >> 7) % layerCount);
+                spriteTextures[i] = (random >> 3) % textureCount;
+            }
+
+            SpriteBatch batch;
+            batch.RegisterPipeline(pipeline);
+            const VGpuCommandBuffer commandBuffer = vgpuCreateCommandBuffer(64 * 1024);
+            const Matrix4 identity = Matrix4::Identity();
+
+            std::vector<double> frameTimes;
+            frameTimes.reserve(options.frames);
+            uint64_t draws = 0;
+            for (uint32_t frame = 0; frame < options.warmupFrames + options.frames; frame++)
+            {
+                const BenchmarkTimer timer;
+                vgpuBeginCommandBuffer(commandBuffer);
+                vgpuCmdBeginDefaultRenderPass(commandBuffer, { 0.0f, 0.0f, 0.0f, 1.0f }, 1.0f, 0);
+                batch.Begin(identity, identity);
+                for (uint32_t i = 0; i < options.sprites; i++) {
+                    batch.Draw(textures[spriteTextures[i]], sprites[i]);
+                }
+                batch.End(commandBuffer);
+                vgpuCmdEndRenderPass(commandBuffer);
+                vgpuEndCommandBuffer(commandBuffer);
+                vgpuSubmitCommandBuffer(commandBuffer);
+                vgpuFrame();
+
+                if (frame >= options.warmupFrames)
+                {
+                    frameTimes.push_back(timer.GetMilliseconds());
+                    draws += batch.GetStats().draws;
+                }
+            }
+
+            vgpuDestroyCommandBuffer(commandBuffer);
+            for (VGpuTexture texture : textures) {
+                vgpuDestroyTexture(texture);
+            }
+            vgpuDestroyPipeline(pipeline);
+            vgpuDestroyShader(pipelineDesc.shader);
+            vgpuShutdown();
+
+            const double frames = static_cast<double>(std::max(options.frames, 1u));
+            double total = 0.0;
+            for (double time : frameTimes) {
+                total += time;
+            }
+            const double mean = total / frames;
+            std::cout << "sprites/frame:   " << options.sprites << std::endl;
+            std::cout << "mean ms/frame:   " << mean << std::endl;
+            std::cout << "median ms/frame: " << GetPercentile(frameTimes, 0.5) << std::endl;
+            std::cout << "p99 ms/frame:    " << GetPercentile(frameTimes, 0.99) << std::endl;
+            std::cout << "sprites/ms:      " << (mean > 0.0 ? options.sprites / mean : 0.0) << std::endl;
+            std::cout << "draws/frame:     " << draws / frames << std::endl;
+            return 0;
+#else
+            ALIMER_UNUSED(options);
+            std::cerr << "The sprite benchmark needs the null vgpu backend, configure with -DVGPU_RENDERER=NULL" << std::endl;
+            return 1;
+#endif
+        }
+    }
+
+    void RegisterSpriteBenchmark(CLI::App& app, int& result)
+    {
+        auto options = std::make_shared<SpriteOptions>();
+        CLI::App* command = app.add_subcommand("sprites", "SpriteBatch throughput on the null vgpu backend");
+        command->add_option("-n,--sprites", options->sprites, "Sprites drawn per frame", true);
+        command->add_option("-f,--frames", options->frames, "Measured frames", true);
+        command->add_option("--warmup", options->warmupFrames, "Frames run before measuring", true);
+        command->add_option("-t,--textures", options->textures, "Distinct textures the sprites are spread over", true);
+        command->add_option("-l,--layers", options->layers, "Distinct layers the sprites are spread over", true);
+        command->callback([options, &result]() { result = RunSpriteBenchmark(*options); });
+    }
+}
@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "archive_packer.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#else
+#   include <dirent.h>
+#   include <sys/stat.h>
+#endif
+
+// Provided by stb_image_write, not declared by its header.
+extern "C" unsigned char* stbi_zlib_compress(unsigned char* data, int data_len, int* out_len, int quality);
+
+namespace alimer
+{
+    namespace
+    {
+        struct PackedEntry
+        {
+            const PackInput* input;
+            uint64_t size = 0;
+            /// Compressed chunks, empty when stored.
+            std::vector<std::vector<uint8_t>> chunks;
+            std::string error;
+        };
+
+        bool ReadFile(const std::string& path, std::vector<uint8_t>& data)
+        {
+            std::ifstream stream(path, std::ios::binary | std::ios::ate);
+            if (!stream) {
+                return false;
+            }
+
+            data.resize(static_cast<size_t>(stream.tellg()));
+            stream.seekg(0);
+            return data.empty() || stream.read(reinterpret_cast<char*>(data.data()), data.size()).good();
+        }
+
+        std::string GetExtension(const std::string& name)
+        {
+            const size_t dot = name.find_last_of('.');
+            const size_t slash = name.find_last_of('/');
+            if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+                return std::string();
+            }
+
+            std::string extension = name.substr(dot);
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+            return extension;
+        }
+
+        void Compress(PackedEntry& entry, const std::vector<uint8_t>& data, const PackOptions& options)
+        {
+            const uint64_t size = data.size();
+            if (size < options.compressMinSize
+                || std::find(options.storeExtensions.begin(), options.storeExtensions.end(), GetExtension(entry.input->name)) != options.storeExtensions.end())
+            {
+                return;
+            }
+
+            uint64_t storedSize = 0;
+            for (uint64_t offset = 0; offset < size; offset += options.chunkSize)
+            {
+                const int chunkSize = static_cast<int>(std::min<uint64_t>(options.chunkSize, size - offset));
+                int compressedSize = 0;
+                unsigned char* compressed = stbi_zlib_compress(const_cast<uint8_t*>(data.data()) + offset, chunkSize, &compressedSize, options.compressionLevel);
+
+                // Chunks that do not shrink are stored, the reader copies them.
+                std::vector<uint8_t> chunk;
+                if (compressed && compressedSize < chunkSize) {
+                    chunk.assign(compressed, compressed + compressedSize);
+                }
+                else {
+                    chunk.assign(data.begin() + offset, data.begin() + offset + chunkSize);
+                }
+                free(compressed);
+
+                storedSize += chunk.size();
+                entry.chunks.push_back(std::move(chunk));
+            }
+
+            // Keep entries usable in place unless compression saves at least an eighth.
+            if (storedSize > size - size / 8) {
+                entry.chunks.clear();
+            }
+        }
+
+        /// Streams the archive to disk so only compressed chunks are held in memory.
+        class ArchiveStream final
+        {
+        public:
+            explicit ArchiveStream(const std::string& path)
+                : _stream(path, std::ios::binary)
+            {
+            }
+
+            bool IsValid() const { return _stream.good(); }
+
+            uint64_t Write(const void* data, size_t size, uint32_t alignment)
+            {
+                static const char zeros[ArchiveAlignment] = {};
+                const uint64_t offset = (_offset + alignment - 1) & ~uint64_t(alignment - 1);
+                _stream.write(zeros, static_cast<std::streamsize>(offset - _offset));
+                _stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                _offset = offset + size;
+                return offset;
+            }
+
+            bool WriteHeader(const ArchiveHeader& header)
+            {
+                _stream.seekp(0);
+                _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                _stream.flush();
+                return _stream.good();
+            }
+
+            uint64_t GetOffset() const { return _offset; }
+
+        private:
+            std::ofstream _stream;
+            uint64_t _offset = 0;
+        };
+    }
+
+    bool CollectFiles(const std::string& directory, std::vector<PackInput>& inputs, std::string& log)
+    {
+        std::vector<std::string> pending(1, std::string());
+        while (!pending.empty())
+        {
+            const std::string relative = pending.back();
+            pending.pop_back();
+            const std::string path = relative.empty() ? directory : directory + "/" + relative;
+
+#if defined(_WIN32)
+            WIN32_FIND_DATAA data;
+            HANDLE find = FindFirstFileA((path + "/*").c_str(), &data);
+            if (find == INVALID_HANDLE_VALUE)
+            {
+                log += "failed to open directory '" + path + "'\n";
+                return false;
+            }
+
+            do
+            {
+                const std::string name = data.cFileName;
+                if (name == "." || name == "..") {
+                    continue;
+                }
+
+                const std::string child = relative.empty() ? name : relative + "/" + name;
+                if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                    pending.push_back(child);
+                }
+                else {
+                    inputs.push_back({ child, directory + "/" + child });
+                }
+            } while (FindNextFileA(find, &data));
+            FindClose(find);
+#else
+            DIR* dir = opendir(path.c_str());
+            if (!dir)
+            {
+                log += "failed to open directory '" + path + "'\n";
+                return false;
+            }
+
+            while (dirent* item = readdir(dir))
+            {
+                const std::string name = item->d_name;
+                if (name == "." || name == "..") {
+                    continue;
+                }
+
+                const std::string child = relative.empty() ? name : relative + "/" + name;
+                struct stat info;
+                if (stat((directory + "/" + child).c_str(), &info) != 0) {
+                    continue;
+                }
+
+                if (S_ISDIR(info.st_mode)) {
+                    pending.push_back(child);
+                }
+                else if (S_ISREG(info.st_mode)) {
+                    inputs.push_back({ child, directory + "/" + child });
+                }
+            }
+            closedir(dir);
+#endif
+        }
+
+        return true;
+    }
+
+    bool WriteArchive(const std::string& path, std::vector<PackInput> inputs, const PackOptions& options, std::string& log)
+    {
+        // Later inputs override earlier ones with the same name.
+        std::map<std::string, size_t> names;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            names[inputs[i].name] = i;
+        }
+
+        std::vector<PackedEntry> entries;
+        entries.reserve(names.size());
+        for (const auto& it : names)
+        {
+            PackedEntry entry;
+            entry.input = &inputs[it.second];
+            entries.push_back(std::move(entry));
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const PackedEntry& a, const PackedEntry& b) {
+            const uint64_t hashA = ArchivePathHash(a.input->name.c_str());
+            const uint64_t hashB = ArchivePathHash(b.input->name.c_str());
+            return hashA != hashB ? hashA < hashB : a.input->name < b.input->name;
+        });
+
+        std::atomic<uint32_t> next{ 0 };
+        auto worker = [&]() {
+            for (uint32_t index = next++; index < entries.size(); index = next++)
+            {
+                PackedEntry& entry = entries[index];
+                std::vector<uint8_t> data;
+                if (!ReadFile(entry.input->path, data)) {
+                    entry.error = "failed to read '" + entry.input->path + "'\n";
+                }
+                else {
+                    entry.size = data.size();
+                    Compress(entry, data, options);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < std::min<size_t>(options.threadCount, entries.size()); ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        for (const PackedEntry& entry : entries) {
+            log += entry.error;
+        }
+        if (!log.empty()) {
+            return false;
+        }
+
+        ArchiveStream stream(path);
+        ArchiveHeader header = {};
+        stream.Write(&header, sizeof(header), 16);
+
+        std::vector<ArchiveEntry> entryTable;
+        std::vector<ArchiveChunk> chunkTable;
+        std::vector<char> strings;
+        for (const PackedEntry& entry : entries)
+        {
+            ArchiveEntry item = {};
+            item.pathHash = ArchivePathHash(entry.input->name.c_str());
+            item.nameOffset = static_cast<uint32_t>(strings.size());
+            item.size = entry.size;
+            strings.insert(strings.end(), entry.input->name.begin(), entry.input->name.end());
+            strings.push_back('\0');
+
+            if (entry.chunks.empty())
+            {
+                // Stored entries are read again here instead of being kept around since the first pass.
+                std::vector<uint8_t> data;
+                if (!ReadFile(entry.input->path, data) || data.size() != entry.size)
+                {
+                    log += "'" + entry.input->path + "' changed while packing\n";
+                    return false;
+                }
+
+                item.compression = ArchiveCompression::None;
+                item.offset = stream.Write(data.data(), data.size(), ArchiveAlignment);
+                item.storedSize = item.size;
+            }
+            else
+            {
+                // Chunks of one entry are contiguous, only the first is page aligned.
+                item.compression = ArchiveCompression::Deflate;
+                item.firstChunk = static_cast<uint32_t>(chunkTable.size());
+                item.chunkCount = static_cast<uint32_t>(entry.chunks.size());
+                for (size_t i = 0; i < entry.chunks.size(); ++i)
+                {
+                    ArchiveChunk chunk = {};
+                    chunk.offset = stream.Write(entry.chunks[i].data(), entry.chunks[i].size(), i == 0 ? ArchiveAlignment : 1);
+                    chunk.storedSize = static_cast<uint32_t>(entry.chunks[i].size());
+                    chunkTable.push_back(chunk);
+                }
+                item.offset = chunkTable[item.firstChunk].offset;
+                item.storedSize = chunkTable.back().offset + chunkTable.back().storedSize - item.offset;
+            }
+            entryTable.push_back(item);
+        }
+
+        header.magic = ArchiveMagic;
+        header.version = ArchiveVersion;
+        header.entryCount = static_cast<uint32_t>(entryTable.size());
+        header.chunkCount = static_cast<uint32_t>(chunkTable.size());
+        header.chunkSize = options.chunkSize;
+        header.entriesOffset = stream.Write(entryTable.data(), entryTable.size() * sizeof(ArchiveEntry), 16);
+        header.chunksOffset = stream.Write(chunkTable.data(), chunkTable.size() * sizeof(ArchiveChunk), 16);
+        header.stringsOffset = stream.Write(strings.data(), strings.size(), 16);
+        header.stringsSize = static_cast<uint32_t>(strings.size());
+        header.fileSize = stream.GetOffset();
+        if (!stream.IsValid() || !stream.WriteHeader(header))
+        {
+            log += "failed to write '" + path + "'\n";
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "content/archive_format.h"
+#include <string>
+#include <vector>
+
+namespace alimer
+{
+    struct PackInput
+    {
+        /// Path inside the archive with '/' separators.
+        std::string name;
+        /// Path on disk.
+        std::string path;
+    };
+
+    struct PackOptions
+    {
+        /// Uncompressed size of a compression chunk.
+        uint32_t chunkSize = 64 * 1024;
+        /// Files smaller than this are stored uncompressed so they can be used in place.
+        uint64_t compressMinSize = 64 * 1024;
+        /// stb zlib quality, higher is smaller and slower.
+        int compressionLevel = 8;
+        /// Extensions of already compressed formats that are always stored, lowercase with the dot.
+        std::vector<std::string> storeExtensions;
+        uint32_t threadCount = 1;
+    };
+
+    /// Collect every regular file below directory, names are relative to it.
+    bool CollectFiles(const std::string& directory, std::vector<PackInput>& inputs, std::string& log);
+
+    /// Write inputs to an archive at path, later inputs with the same name replace earlier ones.
+    bool WriteArchive(const std::string& path, std::vector<PackInput> inputs, const PackOptions& options, std::string& log);
+}
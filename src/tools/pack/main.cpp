@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "archive_packer.h"
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+using namespace alimer;
+
+int main(int argc, char** argv)
+{
+    CLI::App app{ "alimer-pack: packs asset directories into a memory mappable archive" };
+
+    std::vector<std::string> inputs;
+    std::string output;
+    PackOptions options;
+    options.threadCount = std::max(1u, std::thread::hardware_concurrency());
+    options.storeExtensions = { ".png", ".jpg", ".jpeg", ".ogg", ".mp3", ".ktx", ".dds", ".alsl" };
+    bool noCompression = false;
+
+    app.add_option("inputs", inputs, "Asset directories, files in later directories replace earlier ones")->required()->check(CLI::ExistingDirectory);
+    app.add_option("-o,--output", output, "Output archive")->required();
+    app.add_option("--chunk-size", options.chunkSize, "Uncompressed size of a compression chunk", true);
+    app.add_option("--compress-min", options.compressMinSize, "Files smaller than this are stored uncompressed", true);
+    app.add_option("-l,--level", options.compressionLevel, "Compression level", true);
+    app.add_flag("--no-compression", noCompression, "Store every file uncompressed");
+    app.add_option("-j,--jobs", options.threadCount, "Number of compression threads", true);
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (options.chunkSize == 0)
+    {
+        std::cerr << "chunk size cannot be zero" << std::endl;
+        return 1;
+    }
+
+    if (noCompression) {
+        options.compressMinSize = UINT64_MAX;
+    }
+
+    std::string log;
+    std::vector<PackInput> files;
+    for (const std::string& input : inputs)
+    {
+        if (!CollectFiles(input, files, log))
+        {
+            std::cerr << log;
+            return 1;
+        }
+    }
+
+    if (!WriteArchive(output, files, options, log))
+    {
+        std::cerr << log;
+        return 1;
+    }
+
+    std::cout << "Packed " << files.size() << " files to " << output << std::endl;
+    return 0;
+}
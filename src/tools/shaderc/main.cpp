@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "shader_compiler.h"
+#include <CLI/CLI.hpp>
+#include <glslang/Public/ShaderLang.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+using namespace alimer;
+
+namespace
+{
+    /// Run task(index) for [0, count) on up to threadCount threads.
+    void ParallelFor(uint32_t count, uint32_t threadCount, const std::function<void(uint32_t)>& task)
+    {
+        std::atomic<uint32_t> next{ 0 };
+        auto worker = [&]() {
+            for (uint32_t index = next++; index < count; index = next++) {
+                task(index);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < std::min(threadCount, count); ++i) {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::vector<ShaderDefine> ParseDefines(const std::string& text)
+    {
+        std::vector<ShaderDefine> defines;
+        size_t begin = 0;
+        while (begin <= text.size())
+        {
+            size_t end = text.find(',', begin);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+
+            const std::string define = text.substr(begin, end - begin);
+            if (!define.empty())
+            {
+                const size_t equals = define.find('=');
+                if (equals == std::string::npos) {
+                    defines.emplace_back(define, std::string());
+                }
+                else {
+                    defines.emplace_back(define.substr(0, equals), define.substr(equals + 1));
+                }
+            }
+
+            begin = end + 1;
+        }
+
+        return defines;
+    }
+
+    bool IsValidProgram(const ShaderProgramSource& program)
+    {
+        uint32_t stageMask = 0;
+        for (const ShaderStageSource& stage : program.stages) {
+            stageMask |= 1u << static_cast<uint32_t>(stage.stage);
+        }
+
+        const uint32_t compute = 1u << static_cast<uint32_t>(ShaderLibraryStage::Compute);
+        const uint32_t graphics = (1u << static_cast<uint32_t>(ShaderLibraryStage::Vertex)) | (1u << static_cast<uint32_t>(ShaderLibraryStage::Fragment));
+        return stageMask == compute || ((stageMask & graphics) == graphics && (stageMask & compute) == 0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    CLI::App app{ "alimer-shaderc: compiles shader sources into a packed shader library" };
+
+    std::vector<std::string> inputs;
+    std::string output;
+    std::string target = "glsl330";
+    std::vector<std::string> defines;
+    std::vector<std::string> variants;
+    ShaderCompileOptions options;
+    uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    app.add_option("inputs", inputs, "Shader source files (.vert, .frag, .comp, .hlsl), listed before repeatable options")->required()->check(CLI::ExistingFile);
+    app.add_option("-o,--output", output, "Output library")->required();
+    app.add_set("-t,--target", target, { "glsl330", "glsl430", "gles300", "gles310", "spirv" }, "Target code format", true);
+    app.add_option("-I,--include", options.includeDirectories, "Include directory");
+    app.add_option("-D,--define", defines, "Define for every program, NAME or NAME=VALUE");
+    app.add_option("-V,--variant", variants, "Extra program variant, program:NAME[=VALUE][,NAME...]");
+    app.add_flag("-g,--debug", options.debugInfo, "Emit SPIR-V debug information");
+    app.add_option("-j,--jobs", threadCount, "Number of compile threads", true);
+
+    CLI11_PARSE(app, argc, argv);
+
+    static const char* targetNames[] = { "glsl330", "glsl430", "gles300", "gles310", "spirv" };
+    options.target = static_cast<ShaderLibraryTarget>(std::find(std::begin(targetNames), std::end(targetNames), target) - std::begin(targetNames));
+    for (const std::string& define : defines)
+    {
+        std::vector<ShaderDefine> parsed = ParseDefines(define);
+        options.defines.insert(options.defines.end(), parsed.begin(), parsed.end());
+    }
+
+    std::string log;
+    std::vector<ShaderProgramSource> programs;
+    for (const std::string& input : inputs)
+    {
+        if (!LoadShaderSource(input, programs, log))
+        {
+            std::cerr << log;
+            return 1;
+        }
+    }
+
+    if (programs.empty())
+    {
+        std::cerr << "no shader programs found" << std::endl;
+        return 1;
+    }
+
+    for (const ShaderProgramSource& program : programs)
+    {
+        if (!IsValidProgram(program))
+        {
+            std::cerr << program.name << ": a program needs vertex and fragment stages, or a single compute stage" << std::endl;
+            return 1;
+        }
+    }
+
+    // Variants copy the base program with extra defines, named "program+NAME+NAME".
+    const size_t baseCount = programs.size();
+    for (const std::string& variant : variants)
+    {
+        const size_t colon = variant.find(':');
+        const std::string name = variant.substr(0, colon);
+        auto base = std::find_if(programs.begin(), programs.begin() + baseCount, [&name](const ShaderProgramSource& program) {
+            return program.name == name;
+        });
+
+        if (colon == std::string::npos || base == programs.begin() + baseCount)
+        {
+            std::cerr << "invalid variant '" << variant << "'" << std::endl;
+            return 1;
+        }
+
+        ShaderProgramSource program = *base;
+        program.defines = ParseDefines(variant.substr(colon + 1));
+        for (const ShaderDefine& define : program.defines) {
+            program.name += "+" + define.first;
+        }
+        programs.push_back(std::move(program));
+    }
+
+    struct StageJob
+    {
+        uint32_t program;
+        uint32_t stage;
+    };
+
+    std::vector<StageJob> jobs;
+    std::vector<CompiledProgram> compiled(programs.size());
+    for (uint32_t programIndex = 0; programIndex < programs.size(); ++programIndex)
+    {
+        compiled[programIndex].name = programs[programIndex].name;
+        compiled[programIndex].stages.resize(programs[programIndex].stages.size());
+        for (uint32_t stageIndex = 0; stageIndex < programs[programIndex].stages.size(); ++stageIndex) {
+            jobs.push_back({ programIndex, stageIndex });
+        }
+    }
+
+    glslang::InitializeProcess();
+
+    std::vector<std::string> logs(std::max(jobs.size(), programs.size()));
+    std::atomic<bool> failed{ false };
+    ParallelFor(static_cast<uint32_t>(jobs.size()), threadCount, [&](uint32_t index) {
+        const StageJob& job = jobs[index];
+        const ShaderProgramSource& program = programs[job.program];
+        if (!CompileStage(program, program.stages[job.stage], options, compiled[job.program].stages[job.stage], logs[index])) {
+            failed = true;
+        }
+    });
+
+    if (!failed)
+    {
+        ParallelFor(static_cast<uint32_t>(compiled.size()), threadCount, [&](uint32_t index) {
+            if (!CrossCompileProgram(options, compiled[index], logs[index])) {
+                failed = true;
+            }
+        });
+    }
+
+    glslang::FinalizeProcess();
+
+    for (const std::string& message : logs) {
+        std::cerr << message;
+    }
+
+    if (failed || !WriteShaderLibrary(output, options.target, compiled, log))
+    {
+        std::cerr << log;
+        return 1;
+    }
+
+    std::cout << "Compiled " << compiled.size() << " programs to " << output << std::endl;
+    return 0;
+}
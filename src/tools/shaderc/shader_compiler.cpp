@@ -0,0 +1,359 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "shader_compiler.h"
+#include <ResourceLimits.h>
+#include <SPIRV/GlslangToSpv.h>
+#include <glslang/Public/ShaderLang.h>
+#include <spirv_glsl.hpp>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <tuple>
+
+namespace alimer
+{
+    namespace
+    {
+        EShLanguage ToGlslangStage(ShaderLibraryStage stage)
+        {
+            switch (stage)
+            {
+            case ShaderLibraryStage::Vertex: return EShLangVertex;
+            case ShaderLibraryStage::TessControl: return EShLangTessControl;
+            case ShaderLibraryStage::TessEvaluation: return EShLangTessEvaluation;
+            case ShaderLibraryStage::Geometry: return EShLangGeometry;
+            case ShaderLibraryStage::Fragment: return EShLangFragment;
+            default: return EShLangCompute;
+            }
+        }
+
+        /// Resolves #include relative to the including file, then the include directories.
+        class Includer final : public glslang::TShader::Includer
+        {
+        public:
+            explicit Includer(const std::vector<std::string>& directories)
+                : _directories(directories)
+            {
+            }
+
+            IncludeResult* includeLocal(const char* headerName, const char* includerName, size_t /*inclusionDepth*/) override
+            {
+                std::string directory = includerName;
+                const size_t slash = directory.find_last_of("/\\");
+                directory = slash == std::string::npos ? std::string() : directory.substr(0, slash + 1);
+                return Open(directory + headerName);
+            }
+
+            IncludeResult* includeSystem(const char* headerName, const char* /*includerName*/, size_t /*inclusionDepth*/) override
+            {
+                for (const std::string& directory : _directories)
+                {
+                    if (IncludeResult* result = Open(directory + "/" + headerName)) {
+                        return result;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            void releaseInclude(IncludeResult* result) override
+            {
+                if (result)
+                {
+                    delete static_cast<std::string*>(result->userData);
+                    delete result;
+                }
+            }
+
+        private:
+            IncludeResult* Open(const std::string& path)
+            {
+                std::ifstream stream(path, std::ios::binary);
+                if (!stream) {
+                    return nullptr;
+                }
+
+                std::ostringstream buffer;
+                buffer << stream.rdbuf();
+                std::string* text = new std::string(buffer.str());
+                return new IncludeResult(path, text->data(), text->size(), text);
+            }
+
+            const std::vector<std::string>& _directories;
+        };
+
+        ShaderLibraryBaseType ToBaseType(const spirv_cross::SPIRType& type)
+        {
+            switch (type.basetype)
+            {
+            case spirv_cross::SPIRType::Int:
+            case spirv_cross::SPIRType::Short:
+            case spirv_cross::SPIRType::SByte:
+                return ShaderLibraryBaseType::Int;
+            case spirv_cross::SPIRType::UInt:
+            case spirv_cross::SPIRType::UShort:
+            case spirv_cross::SPIRType::UByte:
+                return ShaderLibraryBaseType::UInt;
+            default:
+                return ShaderLibraryBaseType::Float;
+            }
+        }
+
+        void GetTargetVersion(ShaderLibraryTarget target, bool compute, uint32_t& version, bool& es)
+        {
+            switch (target)
+            {
+            case ShaderLibraryTarget::GLSL330:
+            case ShaderLibraryTarget::GLSL430:
+                es = false;
+                version = (compute || target == ShaderLibraryTarget::GLSL430) ? 430 : 330;
+                break;
+            default:
+                es = true;
+                version = (compute || target == ShaderLibraryTarget::GLSLES310) ? 310 : 300;
+                break;
+            }
+        }
+
+        struct ResourceKey
+        {
+            uint32_t set;
+            uint32_t binding;
+            ShaderLibraryResourceType type;
+
+            bool operator<(const ResourceKey& other) const
+            {
+                return std::tie(set, binding, type) < std::tie(other.set, other.binding, other.type);
+            }
+        };
+
+        void AddResource(std::map<ResourceKey, CompiledResource>& resources, const spirv_cross::Compiler& compiler,
+            const spirv_cross::Resource& resource, ShaderLibraryResourceType type, uint32_t stageMask, const std::string& name)
+        {
+            const spirv_cross::SPIRType& spirType = compiler.get_type(resource.type_id);
+            CompiledResource compiled;
+            compiled.name = name;
+            compiled.type = type;
+            compiled.set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            compiled.binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            compiled.stageMask = stageMask;
+            compiled.size = 0;
+            compiled.arraySize = spirType.array.empty() ? 1 : spirType.array[0];
+            if (type == ShaderLibraryResourceType::UniformBuffer
+                || type == ShaderLibraryResourceType::StorageBuffer
+                || type == ShaderLibraryResourceType::PushConstant)
+            {
+                compiled.size = static_cast<uint32_t>(compiler.get_declared_struct_size(compiler.get_type(resource.base_type_id)));
+            }
+
+            const ResourceKey key = { compiled.set, compiled.binding, type };
+            auto it = resources.find(key);
+            if (it == resources.end())
+            {
+                resources.emplace(key, compiled);
+            }
+            else
+            {
+                it->second.stageMask |= stageMask;
+                it->second.size = std::max(it->second.size, compiled.size);
+            }
+        }
+    }
+
+    bool CompileStage(const ShaderProgramSource& program, const ShaderStageSource& stage, const ShaderCompileOptions& options, CompiledStage& output, std::string& log)
+    {
+        const EShLanguage language = ToGlslangStage(stage.stage);
+        const bool hlsl = program.language == ShaderLanguage::HLSL;
+
+        std::string preamble;
+        if (!hlsl) {
+            preamble += "#extension GL_GOOGLE_include_directive : enable\n";
+        }
+
+        for (const std::vector<ShaderDefine>* defines : { &options.defines, &program.defines })
+        {
+            for (const ShaderDefine& define : *defines) {
+                preamble += "#define " + define.first + " " + (define.second.empty() ? std::string("1") : define.second) + "\n";
+            }
+        }
+
+        const char* strings[] = { stage.source.c_str() };
+        const int lengths[] = { static_cast<int>(stage.source.size()) };
+        const char* names[] = { stage.fileName.c_str() };
+
+        glslang::TShader shader(language);
+        shader.setStringsWithLengthsAndNames(strings, lengths, names, 1);
+        shader.setPreamble(preamble.c_str());
+        shader.setEntryPoint(stage.entryPoint.c_str());
+        shader.setEnvInput(hlsl ? glslang::EShSourceHlsl : glslang::EShSourceGlsl, language, glslang::EShClientVulkan, 100);
+        shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_0);
+        shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+        shader.setAutoMapLocations(true);
+        shader.setAutoMapBindings(true);
+
+        EShMessages messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+        if (hlsl) {
+            messages = static_cast<EShMessages>(messages | EShMsgReadHlsl);
+        }
+
+        Includer includer(options.includeDirectories);
+        if (!shader.parse(&glslang::DefaultTBuiltInResource, 100, false, messages, includer))
+        {
+            log += shader.getInfoLog();
+            return false;
+        }
+
+        glslang::TProgram linker;
+        linker.addShader(&shader);
+        if (!linker.link(messages) || !linker.mapIO())
+        {
+            log += linker.getInfoLog();
+            return false;
+        }
+
+        glslang::SpvOptions spvOptions;
+        spvOptions.generateDebugInfo = options.debugInfo;
+        output.stage = stage.stage;
+        output.spirv.clear();
+        glslang::GlslangToSpv(*linker.getIntermediate(language), output.spirv, &spvOptions);
+        return true;
+    }
+
+    bool CrossCompileProgram(const ShaderCompileOptions& options, CompiledProgram& program, std::string& log)
+    {
+        const bool glsl = options.target != ShaderLibraryTarget::SPIRV;
+        std::map<ResourceKey, CompiledResource> resources;
+
+        for (CompiledStage& stage : program.stages)
+        {
+            spirv_cross::CompilerGLSL compiler(stage.spirv);
+            const uint32_t stageMask = 1u << static_cast<uint32_t>(stage.stage);
+
+            if (glsl) {
+                // GL has no separate samplers.
+                compiler.build_combined_image_samplers();
+            }
+
+            spirv_cross::ShaderResources shaderResources = compiler.get_shader_resources();
+
+            // Pre 4.10 GLSL matches varyings by name, give both sides of every interface the same location based name.
+            if (stage.stage != ShaderLibraryStage::Vertex)
+            {
+                for (const spirv_cross::Resource& resource : shaderResources.stage_inputs) {
+                    compiler.set_name(resource.id, "alimer_varying" + std::to_string(compiler.get_decoration(resource.id, spv::DecorationLocation)));
+                }
+            }
+
+            if (stage.stage != ShaderLibraryStage::Fragment)
+            {
+                for (const spirv_cross::Resource& resource : shaderResources.stage_outputs) {
+                    compiler.set_name(resource.id, "alimer_varying" + std::to_string(compiler.get_decoration(resource.id, spv::DecorationLocation)));
+                }
+            }
+
+            if (glsl)
+            {
+                for (const spirv_cross::CombinedImageSampler& combined : compiler.get_combined_image_samplers())
+                {
+                    compiler.set_name(combined.combined_id, compiler.get_name(combined.image_id));
+                    compiler.set_decoration(combined.combined_id, spv::DecorationDescriptorSet, compiler.get_decoration(combined.image_id, spv::DecorationDescriptorSet));
+                    compiler.set_decoration(combined.combined_id, spv::DecorationBinding, compiler.get_decoration(combined.image_id, spv::DecorationBinding));
+                }
+
+                spirv_cross::CompilerGLSL::Options glslOptions;
+                GetTargetVersion(options.target, stage.stage == ShaderLibraryStage::Compute, glslOptions.version, glslOptions.es);
+                glslOptions.vulkan_semantics = false;
+                glslOptions.enable_420pack_extension = false;
+                compiler.set_common_options(glslOptions);
+                stage.code = compiler.compile();
+                if (stage.code.empty())
+                {
+                    log += program.name + ": cross compilation failed\n";
+                    return false;
+                }
+            }
+
+            if (stage.stage == ShaderLibraryStage::Vertex)
+            {
+                for (const spirv_cross::Resource& resource : shaderResources.stage_inputs)
+                {
+                    const spirv_cross::SPIRType& type = compiler.get_type(resource.type_id);
+                    CompiledVertexInput input;
+                    input.name = compiler.get_name(resource.id);
+                    input.location = compiler.get_decoration(resource.id, spv::DecorationLocation);
+                    input.baseType = ToBaseType(type);
+                    input.componentCount = type.vecsize;
+                    program.vertexInputs.push_back(input);
+                }
+
+                std::sort(program.vertexInputs.begin(), program.vertexInputs.end(), [](const CompiledVertexInput& a, const CompiledVertexInput& b) {
+                    return a.location < b.location;
+                });
+            }
+
+            if (stage.stage == ShaderLibraryStage::Compute)
+            {
+                for (uint32_t i = 0; i < 3; ++i) {
+                    program.localSize[i] = compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, i);
+                }
+            }
+
+            // Names are final only after compile(), block names are the ones GL resolves.
+            for (const spirv_cross::Resource& resource : shaderResources.uniform_buffers) {
+                AddResource(resources, compiler, resource, ShaderLibraryResourceType::UniformBuffer, stageMask, glsl ? compiler.get_remapped_declared_block_name(resource.id) : resource.name);
+            }
+            for (const spirv_cross::Resource& resource : shaderResources.storage_buffers) {
+                AddResource(resources, compiler, resource, ShaderLibraryResourceType::StorageBuffer, stageMask, glsl ? compiler.get_remapped_declared_block_name(resource.id) : resource.name);
+            }
+            for (const spirv_cross::Resource& resource : shaderResources.push_constant_buffers) {
+                AddResource(resources, compiler, resource, ShaderLibraryResourceType::PushConstant, stageMask, compiler.get_name(resource.id));
+            }
+            for (const spirv_cross::Resource& resource : shaderResources.storage_images) {
+                AddResource(resources, compiler, resource, ShaderLibraryResourceType::StorageTexture, stageMask, compiler.get_name(resource.id));
+            }
+            for (const spirv_cross::Resource& resource : shaderResources.sampled_images) {
+                AddResource(resources, compiler, resource, ShaderLibraryResourceType::CombinedTextureSampler, stageMask, compiler.get_name(resource.id));
+            }
+
+            if (!glsl)
+            {
+                for (const spirv_cross::Resource& resource : shaderResources.separate_images) {
+                    AddResource(resources, compiler, resource, ShaderLibraryResourceType::SampledTexture, stageMask, compiler.get_name(resource.id));
+                }
+                for (const spirv_cross::Resource& resource : shaderResources.separate_samplers) {
+                    AddResource(resources, compiler, resource, ShaderLibraryResourceType::Sampler, stageMask, compiler.get_name(resource.id));
+                }
+            }
+        }
+
+        program.resources.clear();
+        for (const auto& resource : resources) {
+            program.resources.push_back(resource.second);
+        }
+
+        return true;
+    }
+}
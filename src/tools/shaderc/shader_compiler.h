@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "graphics/shader_library_format.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace alimer
+{
+    enum class ShaderLanguage : uint32_t
+    {
+        GLSL,
+        HLSL
+    };
+
+    using ShaderDefine = std::pair<std::string, std::string>;
+
+    /// Source of a single stage.
+    struct ShaderStageSource
+    {
+        ShaderLibraryStage stage;
+        std::string fileName;
+        std::string source;
+        std::string entryPoint;
+    };
+
+    /// Program variant to compile, stages share the language and defines.
+    struct ShaderProgramSource
+    {
+        std::string name;
+        ShaderLanguage language = ShaderLanguage::GLSL;
+        std::vector<ShaderDefine> defines;
+        std::vector<ShaderStageSource> stages;
+    };
+
+    struct ShaderCompileOptions
+    {
+        ShaderLibraryTarget target = ShaderLibraryTarget::GLSL330;
+        std::vector<std::string> includeDirectories;
+        std::vector<ShaderDefine> defines;
+        bool debugInfo = false;
+    };
+
+    struct CompiledStage
+    {
+        ShaderLibraryStage stage;
+        std::vector<uint32_t> spirv;
+        std::string code;
+    };
+
+    struct CompiledVertexInput
+    {
+        std::string name;
+        uint32_t location;
+        ShaderLibraryBaseType baseType;
+        uint32_t componentCount;
+    };
+
+    struct CompiledResource
+    {
+        std::string name;
+        ShaderLibraryResourceType type;
+        uint32_t set;
+        uint32_t binding;
+        uint32_t stageMask;
+        uint32_t size;
+        uint32_t arraySize;
+    };
+
+    struct CompiledProgram
+    {
+        std::string name;
+        std::vector<CompiledStage> stages;
+        std::vector<CompiledVertexInput> vertexInputs;
+        std::vector<CompiledResource> resources;
+        uint32_t localSize[3] = { 0, 0, 0 };
+    };
+
+    /// Load shader sources from a file: GLSL stage files (.vert, .frag, .comp, ...) or HLSL files with
+    /// common/vertex_shader/fragment_shader/compute_shader [[ ]] blocks. GLSL stages with the same base name
+    /// are merged into one program.
+    bool LoadShaderSource(const std::string& path, std::vector<ShaderProgramSource>& programs, std::string& log);
+
+    /// Compile one stage of program to SPIR-V, safe to call from multiple threads.
+    bool CompileStage(const ShaderProgramSource& program, const ShaderStageSource& stage, const ShaderCompileOptions& options, CompiledStage& output, std::string& log);
+
+    /// Link the compiled stages: reflect the interface and cross compile to the library target.
+    bool CrossCompileProgram(const ShaderCompileOptions& options, CompiledProgram& program, std::string& log);
+
+    /// Write the packed library.
+    bool WriteShaderLibrary(const std::string& path, ShaderLibraryTarget target, std::vector<CompiledProgram>& programs, std::string& log);
+}
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "shader_compiler.h"
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+
+namespace alimer
+{
+    namespace
+    {
+        class LibraryWriter final
+        {
+        public:
+            uint32_t Write(const void* data, size_t size, uint32_t alignment)
+            {
+                const size_t offset = (_data.size() + alignment - 1) & ~size_t(alignment - 1);
+                _data.resize(offset + size);
+                if (size) {
+                    memcpy(_data.data() + offset, data, size);
+                }
+                return static_cast<uint32_t>(offset);
+            }
+
+            template <typename T>
+            uint32_t WriteArray(const std::vector<T>& items)
+            {
+                return Write(items.data(), items.size() * sizeof(T), ShaderLibraryAlignment);
+            }
+
+            uint32_t AddString(const std::string& value)
+            {
+                const uint32_t offset = static_cast<uint32_t>(_strings.size());
+                _strings.insert(_strings.end(), value.begin(), value.end());
+                _strings.push_back('\0');
+                return offset;
+            }
+
+            std::vector<uint8_t>& GetData() { return _data; }
+            const std::vector<char>& GetStrings() const { return _strings; }
+
+        private:
+            std::vector<uint8_t> _data;
+            std::vector<char> _strings;
+        };
+
+        constexpr uint32_t SlotClassCount = 6;
+
+        /// GL binding namespace of a resource: uniform buffers, storage buffers, textures, images and samplers.
+        /// Push constants become plain uniforms and get a namespace of their own.
+        uint32_t GetSlotClass(ShaderLibraryResourceType type)
+        {
+            switch (type)
+            {
+            case ShaderLibraryResourceType::UniformBuffer:
+                return 0;
+            case ShaderLibraryResourceType::StorageBuffer:
+                return 1;
+            case ShaderLibraryResourceType::SampledTexture:
+            case ShaderLibraryResourceType::CombinedTextureSampler:
+                return 2;
+            case ShaderLibraryResourceType::StorageTexture:
+                return 3;
+            case ShaderLibraryResourceType::Sampler:
+                return 4;
+            default:
+                return 5;
+            }
+        }
+    }
+
+    bool WriteShaderLibrary(const std::string& path, ShaderLibraryTarget target, std::vector<CompiledProgram>& programs, std::string& log)
+    {
+        for (CompiledProgram& program : programs)
+        {
+            // Stable stage order so output is reproducible.
+            std::sort(program.stages.begin(), program.stages.end(), [](const CompiledStage& a, const CompiledStage& b) {
+                return a.stage < b.stage;
+            });
+        }
+
+        std::sort(programs.begin(), programs.end(), [](const CompiledProgram& a, const CompiledProgram& b) {
+            const uint64_t hashA = ShaderLibraryHash(a.name.c_str());
+            const uint64_t hashB = ShaderLibraryHash(b.name.c_str());
+            return hashA != hashB ? hashA < hashB : a.name < b.name;
+        });
+
+        for (size_t i = 1; i < programs.size(); ++i)
+        {
+            if (programs[i].name == programs[i - 1].name)
+            {
+                log += "duplicate program '" + programs[i].name + "'\n";
+                return false;
+            }
+        }
+
+        LibraryWriter writer;
+        ShaderLibraryHeader header = {};
+        writer.Write(&header, sizeof(header), ShaderLibraryAlignment);
+
+        std::vector<ShaderLibraryProgram> programEntries;
+        std::vector<ShaderLibraryStageCode> stageEntries;
+        std::vector<ShaderLibraryVertexInput> inputEntries;
+        std::vector<ShaderLibraryResource> resourceEntries;
+        for (const CompiledProgram& program : programs)
+        {
+            ShaderLibraryProgram entry = {};
+            entry.nameHash = ShaderLibraryHash(program.name.c_str());
+            entry.nameOffset = writer.AddString(program.name);
+            entry.firstStage = static_cast<uint32_t>(stageEntries.size());
+            entry.stageCount = static_cast<uint32_t>(program.stages.size());
+            entry.firstVertexInput = static_cast<uint32_t>(inputEntries.size());
+            entry.vertexInputCount = static_cast<uint32_t>(program.vertexInputs.size());
+            entry.firstResource = static_cast<uint32_t>(resourceEntries.size());
+            entry.resourceCount = static_cast<uint32_t>(program.resources.size());
+            memcpy(entry.localSize, program.localSize, sizeof(entry.localSize));
+
+            for (const CompiledStage& stage : program.stages)
+            {
+                entry.stageMask |= 1u << static_cast<uint32_t>(stage.stage);
+
+                ShaderLibraryStageCode stageEntry = {};
+                stageEntry.stage = stage.stage;
+                stageEntry.spirvOffset = writer.WriteArray(stage.spirv);
+                stageEntry.spirvSize = static_cast<uint32_t>(stage.spirv.size() * sizeof(uint32_t));
+                if (target == ShaderLibraryTarget::SPIRV)
+                {
+                    stageEntry.codeOffset = ShaderLibraryInvalidOffset;
+                }
+                else
+                {
+                    stageEntry.codeOffset = writer.Write(stage.code.c_str(), stage.code.size() + 1, ShaderLibraryAlignment);
+                    stageEntry.codeSize = static_cast<uint32_t>(stage.code.size());
+                }
+                stageEntries.push_back(stageEntry);
+            }
+
+            for (const CompiledVertexInput& input : program.vertexInputs)
+            {
+                ShaderLibraryVertexInput inputEntry = {};
+                inputEntry.nameOffset = writer.AddString(input.name);
+                inputEntry.location = input.location;
+                inputEntry.baseType = input.baseType;
+                inputEntry.componentCount = input.componentCount;
+                inputEntries.push_back(inputEntry);
+            }
+
+            // Resources come sorted by set and binding, slots are counted per class from there.
+            uint32_t slotCounts[SlotClassCount] = {};
+            for (const CompiledResource& resource : program.resources)
+            {
+                ShaderLibraryResource resourceEntry = {};
+                const uint32_t slotClass = GetSlotClass(resource.type);
+                resourceEntry.slot = slotCounts[slotClass];
+                slotCounts[slotClass] += resource.arraySize > 0 ? resource.arraySize : 1;
+                resourceEntry.nameOffset = writer.AddString(resource.name);
+                resourceEntry.type = resource.type;
+                resourceEntry.set = resource.set;
+                resourceEntry.binding = resource.binding;
+                resourceEntry.stageMask = resource.stageMask;
+                resourceEntry.size = resource.size;
+                resourceEntry.arraySize = resource.arraySize;
+                resourceEntries.push_back(resourceEntry);
+            }
+
+            programEntries.push_back(entry);
+        }
+
+        header.magic = ShaderLibraryMagic;
+        header.version = ShaderLibraryVersion;
+        header.target = target;
+        header.programCount = static_cast<uint32_t>(programEntries.size());
+        header.programsOffset = writer.WriteArray(programEntries);
+        header.stagesOffset = writer.WriteArray(stageEntries);
+        header.vertexInputsOffset = writer.WriteArray(inputEntries);
+        header.resourcesOffset = writer.WriteArray(resourceEntries);
+        header.stringsOffset = writer.WriteArray(writer.GetStrings());
+        header.stringsSize = static_cast<uint32_t>(writer.GetStrings().size());
+
+        std::vector<uint8_t>& data = writer.GetData();
+        header.fileSize = static_cast<uint32_t>(data.size());
+        memcpy(data.data(), &header, sizeof(header));
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream.write(reinterpret_cast<const char*>(data.data()), data.size()))
+        {
+            log += path + ": cannot write file\n";
+            return false;
+        }
+
+        return true;
+    }
+}
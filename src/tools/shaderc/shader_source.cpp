@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "shader_compiler.h"
+#include <ctype.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+
+namespace alimer
+{
+    namespace
+    {
+        bool ReadFile(const std::string& path, std::string& text)
+        {
+            std::ifstream stream(path, std::ios::binary);
+            if (!stream) {
+                return false;
+            }
+
+            std::ostringstream buffer;
+            buffer << stream.rdbuf();
+            text = buffer.str();
+            return true;
+        }
+
+        std::string GetBaseName(const std::string& path)
+        {
+            const size_t slash = path.find_last_of("/\\");
+            const size_t start = slash == std::string::npos ? 0 : slash + 1;
+            const size_t dot = path.find_last_of('.');
+            return path.substr(start, (dot == std::string::npos || dot < start) ? std::string::npos : dot - start);
+        }
+
+        std::string GetExtension(const std::string& path)
+        {
+            const size_t dot = path.find_last_of('.');
+            const size_t slash = path.find_last_of("/\\");
+            if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+                return std::string();
+            }
+
+            std::string extension = path.substr(dot + 1);
+            for (char& c : extension) {
+                c = static_cast<char>(tolower(c));
+            }
+            return extension;
+        }
+
+        bool GetStageFromExtension(const std::string& extension, ShaderLibraryStage& stage)
+        {
+            static const struct { const char* extension; ShaderLibraryStage stage; } stages[] = {
+                { "vert", ShaderLibraryStage::Vertex },
+                { "tesc", ShaderLibraryStage::TessControl },
+                { "tese", ShaderLibraryStage::TessEvaluation },
+                { "geom", ShaderLibraryStage::Geometry },
+                { "frag", ShaderLibraryStage::Fragment },
+                { "comp", ShaderLibraryStage::Compute },
+            };
+
+            for (const auto& entry : stages)
+            {
+                if (extension == entry.extension)
+                {
+                    stage = entry.stage;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool IsIdentifierChar(char c)
+        {
+            return isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool ContainsFunction(const std::string& source, const char* name)
+        {
+            const size_t length = strlen(name);
+            for (size_t pos = source.find(name); pos != std::string::npos; pos = source.find(name, pos + 1))
+            {
+                if (pos > 0 && IsIdentifierChar(source[pos - 1])) {
+                    continue;
+                }
+
+                size_t next = pos + length;
+                while (next < source.size() && isspace(static_cast<unsigned char>(source[next]))) {
+                    ++next;
+                }
+
+                if (next < source.size() && source[next] == '(') {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /// HLSL compute entry points are named freely, take the function following [numthreads(...)].
+        std::string FindEntryPoint(const std::string& source, ShaderLibraryStage stage)
+        {
+            if (ContainsFunction(source, "main") || stage != ShaderLibraryStage::Compute) {
+                return "main";
+            }
+
+            size_t pos = source.find("numthreads");
+            if (pos == std::string::npos || (pos = source.find(']', pos)) == std::string::npos) {
+                return "main";
+            }
+
+            // Skip the return type, the entry point is the identifier right before '('.
+            const size_t paren = source.find('(', pos);
+            if (paren == std::string::npos) {
+                return "main";
+            }
+
+            size_t end = paren;
+            while (end > pos && isspace(static_cast<unsigned char>(source[end - 1]))) {
+                --end;
+            }
+
+            size_t begin = end;
+            while (begin > pos && IsIdentifierChar(source[begin - 1])) {
+                --begin;
+            }
+
+            return begin < end ? source.substr(begin, end - begin) : std::string("main");
+        }
+
+        bool LoadBlockSource(const std::string& path, const std::string& text, std::vector<ShaderProgramSource>& programs, std::string& log)
+        {
+            static const struct { const char* name; ShaderLibraryStage stage; } blockStages[] = {
+                { "vertex_shader", ShaderLibraryStage::Vertex },
+                { "hull_shader", ShaderLibraryStage::TessControl },
+                { "domain_shader", ShaderLibraryStage::TessEvaluation },
+                { "geometry_shader", ShaderLibraryStage::Geometry },
+                { "fragment_shader", ShaderLibraryStage::Fragment },
+                { "pixel_shader", ShaderLibraryStage::Fragment },
+                { "compute_shader", ShaderLibraryStage::Compute },
+            };
+
+            struct Block
+            {
+                std::string name;
+                uint32_t line;
+                std::string body;
+            };
+
+            // Blocks are "name [[" and end at a line holding only "]]", so nested brackets in code are fine.
+            std::vector<Block> blocks;
+            std::istringstream stream(text);
+            std::string line;
+            uint32_t lineNumber = 0;
+            Block* current = nullptr;
+            while (std::getline(stream, line))
+            {
+                ++lineNumber;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+
+                const size_t first = line.find_first_not_of(" \t");
+                const size_t last = line.find_last_not_of(" \t");
+                const std::string trimmed = first == std::string::npos ? std::string() : line.substr(first, last - first + 1);
+                if (current)
+                {
+                    if (trimmed == "]]") {
+                        current = nullptr;
+                    }
+                    else {
+                        current->body += line + "\n";
+                    }
+                    continue;
+                }
+
+                if (trimmed.empty() || trimmed.compare(0, 2, "//") == 0) {
+                    continue;
+                }
+
+                const size_t open = trimmed.find("[[");
+                if (open == std::string::npos || open + 2 != trimmed.size())
+                {
+                    log += path + "(" + std::to_string(lineNumber) + "): expected 'name [['\n";
+                    return false;
+                }
+
+                std::string name = trimmed.substr(0, open);
+                name.erase(name.find_last_not_of(" \t") + 1);
+                blocks.push_back({ name, lineNumber + 1, std::string() });
+                current = &blocks.back();
+            }
+
+            if (current)
+            {
+                log += path + ": unterminated block '" + current->name + "'\n";
+                return false;
+            }
+
+            std::string common;
+            uint32_t commonLine = 0;
+            for (const Block& block : blocks)
+            {
+                if (block.name == "common")
+                {
+                    common = block.body;
+                    commonLine = block.line;
+                }
+            }
+
+            ShaderProgramSource program;
+            program.name = GetBaseName(path);
+            program.language = ShaderLanguage::HLSL;
+            for (const Block& block : blocks)
+            {
+                if (block.name == "common") {
+                    continue;
+                }
+
+                bool found = false;
+                for (const auto& blockStage : blockStages)
+                {
+                    if (block.name != blockStage.name) {
+                        continue;
+                    }
+
+                    ShaderStageSource stage;
+                    stage.stage = blockStage.stage;
+                    stage.fileName = path;
+                    if (!common.empty()) {
+                        stage.source = "#line " + std::to_string(commonLine) + "\n" + common;
+                    }
+                    stage.source += "#line " + std::to_string(block.line) + "\n" + block.body;
+                    stage.entryPoint = FindEntryPoint(block.body, stage.stage);
+                    program.stages.push_back(std::move(stage));
+                    found = true;
+                    break;
+                }
+
+                if (!found)
+                {
+                    log += path + ": unknown block '" + block.name + "'\n";
+                    return false;
+                }
+            }
+
+            // Compute blocks are independent programs, graphics stages are linked together.
+            ShaderProgramSource graphics = program;
+            graphics.stages.clear();
+            for (ShaderStageSource& stage : program.stages)
+            {
+                if (stage.stage == ShaderLibraryStage::Compute)
+                {
+                    ShaderProgramSource compute = program;
+                    compute.name += "_cs";
+                    compute.stages.assign(1, stage);
+                    programs.push_back(std::move(compute));
+                }
+                else
+                {
+                    graphics.stages.push_back(stage);
+                }
+            }
+
+            if (!graphics.stages.empty()) {
+                programs.push_back(std::move(graphics));
+            }
+
+            return true;
+        }
+    }
+
+    bool LoadShaderSource(const std::string& path, std::vector<ShaderProgramSource>& programs, std::string& log)
+    {
+        std::string text;
+        if (!ReadFile(path, text))
+        {
+            log += path + ": cannot read file\n";
+            return false;
+        }
+
+        const std::string extension = GetExtension(path);
+        if (extension == "hlsl") {
+            return LoadBlockSource(path, text, programs, log);
+        }
+
+        ShaderLibraryStage stage;
+        if (!GetStageFromExtension(extension, stage))
+        {
+            log += path + ": unknown shader extension\n";
+            return false;
+        }
+
+        const std::string name = GetBaseName(path);
+        ShaderProgramSource* program = nullptr;
+        for (ShaderProgramSource& existing : programs)
+        {
+            if (existing.name == name && existing.language == ShaderLanguage::GLSL) {
+                program = &existing;
+            }
+        }
+
+        if (!program)
+        {
+            programs.emplace_back();
+            program = &programs.back();
+            program->name = name;
+        }
+
+        for (const ShaderStageSource& existing : program->stages)
+        {
+            if (existing.stage == stage)
+            {
+                log += path + ": duplicate stage for program '" + name + "'\n";
+                return false;
+            }
+        }
+
+        ShaderStageSource stageSource;
+        stageSource.stage = stage;
+        stageSource.fileName = path;
+        stageSource.source = std::move(text);
+        stageSource.entryPoint = "main";
+        program->stages.push_back(std::move(stageSource));
+        return true;
+    }
+}
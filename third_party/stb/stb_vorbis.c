@@ -0,0 +1,2 @@
+#define STB_VORBIS_NO_STDIO
+#include "stb_vorbis.h"
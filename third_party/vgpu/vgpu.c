@@ -23,6 +23,8 @@
 #include "vgpu.h"
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 static void _vgpu_default_log_fn(void *userdata, vgpu_log_type type, const char *message);
 static vgpu_log_fn s_vgpu_log_fn = _vgpu_default_log_fn;
@@ -65,6 +67,659 @@ void _vgpu_log(vgpu_log_type type, const char *message) {
     s_vgpu_log_fn(s_vgpu_log_userdata, type, message);
 }
 
+/* Allocation */
+static VGpuAllocationCallbacks s_vgpu_allocator = { 0 };
+static VGpuMemoryStats s_vgpu_memory = { 0 };
+
+void vgpuSetAllocationCallbacks(const VGpuAllocationCallbacks* callbacks) {
+    if (callbacks) {
+        assert(callbacks->allocate && callbacks->reallocate && callbacks->free);
+        s_vgpu_allocator = *callbacks;
+    }
+    else {
+        memset(&s_vgpu_allocator, 0, sizeof(s_vgpu_allocator));
+    }
+}
+
+void* _vgpu_alloc(size_t size) {
+    if (s_vgpu_allocator.allocate) {
+        return s_vgpu_allocator.allocate(s_vgpu_allocator.userData, size);
+    }
+
+    return malloc(size);
+}
+
+void* _vgpu_calloc(size_t size) {
+    if (s_vgpu_allocator.allocate) {
+        void* ptr = s_vgpu_allocator.allocate(s_vgpu_allocator.userData, size);
+        if (ptr) {
+            memset(ptr, 0, size);
+        }
+        return ptr;
+    }
+
+    return calloc(1, size);
+}
+
+void* _vgpu_realloc(void* ptr, size_t oldSize, size_t newSize) {
+    if (s_vgpu_allocator.reallocate) {
+        return s_vgpu_allocator.reallocate(s_vgpu_allocator.userData, ptr, oldSize, newSize);
+    }
+
+    return realloc(ptr, newSize);
+}
+
+void _vgpu_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    if (s_vgpu_allocator.free) {
+        s_vgpu_allocator.free(s_vgpu_allocator.userData, ptr);
+        return;
+    }
+
+    free(ptr);
+}
+
+/* Memory estimates, called by the backends when a non external resource is created or destroyed. */
+uint64_t _vgpu_texture_memory_size(const VGpuTextureDescriptor* descriptor) {
+    const uint64_t samples = descriptor->samples > 1 ? (uint64_t)descriptor->samples : 1u;
+    return vgpuGetTextureDataSize(descriptor) * samples;
+}
+
+void _vgpu_track_texture(uint64_t size, VGpuTextureUsageFlags usage, bool created) {
+    const bool renderTarget = (usage & VGPU_TEXTURE_USAGE_RENDER_TARGET) != 0;
+    if (created) {
+        s_vgpu_memory.textureCount++;
+        s_vgpu_memory.textureBytes += size;
+        if (renderTarget) {
+            s_vgpu_memory.renderTargetCount++;
+            s_vgpu_memory.renderTargetBytes += size;
+        }
+        return;
+    }
+
+    assert(s_vgpu_memory.textureCount > 0 && s_vgpu_memory.textureBytes >= size);
+    s_vgpu_memory.textureCount--;
+    s_vgpu_memory.textureBytes -= size;
+    if (renderTarget) {
+        s_vgpu_memory.renderTargetCount--;
+        s_vgpu_memory.renderTargetBytes -= size;
+    }
+}
+
+void _vgpu_track_buffer(uint64_t size, bool created) {
+    if (created) {
+        s_vgpu_memory.bufferCount++;
+        s_vgpu_memory.bufferBytes += size;
+        return;
+    }
+
+    assert(s_vgpu_memory.bufferCount > 0 && s_vgpu_memory.bufferBytes >= size);
+    s_vgpu_memory.bufferCount--;
+    s_vgpu_memory.bufferBytes -= size;
+}
+
+void vgpuGetMemoryStats(VGpuMemoryStats* stats) {
+    assert(stats);
+    *stats = s_vgpu_memory;
+    stats->totalBytes = s_vgpu_memory.textureBytes + s_vgpu_memory.bufferBytes;
+}
+
+/* Object pools, shared by the backends.
+ * Objects of one type live in a contiguous array. A handle is the 1-based slot index in the low bits and the
+ * slot generation in the high bits, so 0 is never a valid handle and a handle goes stale when its slot is destroyed.
+ * Destroyed slots are retired in frame order and reused only once the frame that last used them has completed. */
+#define _VGPU_POOL_INDEX_BITS (16u)
+#define _VGPU_POOL_INDEX_MASK ((1u << _VGPU_POOL_INDEX_BITS) - 1u)
+#define _VGPU_DEFAULT_POOL_CAPACITY (4096u)
+
+typedef struct _VGpuPool {
+    uint32_t    capacity;
+    uint32_t    itemSize;
+    uint8_t*    items;
+    uint32_t*   ids;            /* id of the live object in each slot, 0 when free or retired */
+    uint16_t*   generations;
+    uint32_t*   freeSlots;
+    uint32_t    freeCount;
+    uint32_t*   retiredSlots;   /* FIFO ordered by frame */
+    uint32_t*   retiredFrames;
+    uint32_t    retiredHead;
+    uint32_t    retiredCount;
+} _VGpuPool;
+
+void _vgpu_pool_destroy(_VGpuPool* pool);
+
+_VGpuPool* _vgpu_pool_create(uint32_t capacity, uint32_t itemSize) {
+    if (capacity == 0) {
+        capacity = _VGPU_DEFAULT_POOL_CAPACITY;
+    }
+    if (capacity >= _VGPU_POOL_INDEX_MASK) {
+        capacity = _VGPU_POOL_INDEX_MASK - 1;
+    }
+
+    _VGpuPool* pool = (_VGpuPool*)_vgpu_calloc(sizeof(_VGpuPool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->capacity = capacity;
+    pool->itemSize = itemSize;
+    pool->items = (uint8_t*)_vgpu_calloc((size_t)capacity * itemSize);
+    pool->ids = (uint32_t*)_vgpu_calloc(sizeof(uint32_t) * capacity);
+    pool->generations = (uint16_t*)_vgpu_calloc(sizeof(uint16_t) * capacity);
+    pool->freeSlots = (uint32_t*)_vgpu_alloc(sizeof(uint32_t) * capacity);
+    pool->retiredSlots = (uint32_t*)_vgpu_alloc(sizeof(uint32_t) * capacity);
+    pool->retiredFrames = (uint32_t*)_vgpu_alloc(sizeof(uint32_t) * capacity);
+    if (!pool->items || !pool->ids || !pool->generations || !pool->freeSlots || !pool->retiredSlots || !pool->retiredFrames) {
+        _vgpu_pool_destroy(pool);
+        return NULL;
+    }
+
+    /* Hand out low slots first. */
+    for (uint32_t i = 0; i < capacity; i++) {
+        pool->freeSlots[i] = capacity - 1 - i;
+    }
+    pool->freeCount = capacity;
+    return pool;
+}
+
+void _vgpu_pool_destroy(_VGpuPool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    _vgpu_free(pool->items);
+    _vgpu_free(pool->ids);
+    _vgpu_free(pool->generations);
+    _vgpu_free(pool->freeSlots);
+    _vgpu_free(pool->retiredSlots);
+    _vgpu_free(pool->retiredFrames);
+    _vgpu_free(pool);
+}
+
+/* Pools are NULL before vgpuInitialize and after vgpuShutdown, every entry point treats that as empty. */
+uint32_t _vgpu_pool_alloc(_VGpuPool* pool, void** item) {
+    if (!pool || pool->freeCount == 0) {
+        *item = NULL;
+        return 0;
+    }
+
+    const uint32_t slot = pool->freeSlots[--pool->freeCount];
+    const uint32_t id = ((uint32_t)pool->generations[slot] << _VGPU_POOL_INDEX_BITS) | (slot + 1);
+    pool->ids[slot] = id;
+    *item = pool->items + (size_t)slot * pool->itemSize;
+    memset(*item, 0, pool->itemSize);
+    return id;
+}
+
+void* _vgpu_pool_get(const _VGpuPool* pool, uint32_t id) {
+    if (!pool) {
+        return NULL;
+    }
+
+    const uint32_t slot = (id & _VGPU_POOL_INDEX_MASK) - 1;
+    if (slot >= pool->capacity || pool->ids[slot] != id) {
+        return NULL;
+    }
+
+    return pool->items + (size_t)slot * pool->itemSize;
+}
+
+void _vgpu_pool_retire(_VGpuPool* pool, uint32_t id, uint32_t frame) {
+    if (!pool) {
+        return;
+    }
+
+    const uint32_t slot = (id & _VGPU_POOL_INDEX_MASK) - 1;
+    assert(slot < pool->capacity && pool->ids[slot] == id);
+    assert(pool->retiredCount < pool->capacity);
+
+    /* The handle is stale from now on, the object itself stays until the frame completes. */
+    pool->ids[slot] = 0;
+    pool->generations[slot]++;
+    const uint32_t tail = (pool->retiredHead + pool->retiredCount) % pool->capacity;
+    pool->retiredSlots[tail] = slot;
+    pool->retiredFrames[tail] = frame;
+    pool->retiredCount++;
+}
+
+void* _vgpu_pool_collect(_VGpuPool* pool, uint32_t completedFrame) {
+    if (!pool || pool->retiredCount == 0 || (int32_t)(pool->retiredFrames[pool->retiredHead] - completedFrame) > 0) {
+        return NULL;
+    }
+
+    /* The caller releases the object before the next allocation can reuse the slot. */
+    const uint32_t slot = pool->retiredSlots[pool->retiredHead];
+    pool->retiredHead = (pool->retiredHead + 1) % pool->capacity;
+    pool->retiredCount--;
+    pool->freeSlots[pool->freeCount++] = slot;
+    return pool->items + (size_t)slot * pool->itemSize;
+}
+
+uint32_t _vgpu_pool_live_count(const _VGpuPool* pool) {
+    if (!pool) {
+        return 0;
+    }
+    return pool->capacity - pool->freeCount - pool->retiredCount;
+}
+
+/* CommandBuffer */
+typedef enum _VGpuCommandType {
+    _VGPU_COMMAND_BEGIN_DEFAULT_RENDER_PASS = 0,
+    _VGPU_COMMAND_BEGIN_RENDER_PASS,
+    _VGPU_COMMAND_END_RENDER_PASS,
+    _VGPU_COMMAND_SET_VIEWPORT,
+    _VGPU_COMMAND_SET_SCISSOR,
+    _VGPU_COMMAND_BIND_PIPELINE,
+    _VGPU_COMMAND_SET_UNIFORM_BUFFER,
+    _VGPU_COMMAND_SET_TEXTURE,
+    _VGPU_COMMAND_SET_VERTEX_BUFFERS,
+    _VGPU_COMMAND_SET_INDEX_BUFFER,
+    _VGPU_COMMAND_DRAW,
+    _VGPU_COMMAND_DRAW_INDEXED,
+    _VGPU_COMMAND_DRAW_INDIRECT,
+    _VGPU_COMMAND_DRAW_INDEXED_INDIRECT,
+    _VGPU_COMMAND_DISPATCH,
+    _VGPU_COMMAND_COUNT
+} _VGpuCommandType;
+
+/* Every command is an 8 byte header followed by a tightly packed payload. */
+typedef struct _VGpuCommandHeader {
+    uint32_t    type;
+    uint32_t    size;
+} _VGpuCommandHeader;
+
+typedef struct _VGpuCommandBeginDefaultRenderPass {
+    VGpuColor   clearColor;
+    float       clearDepth;
+    uint8_t     clearStencil;
+} _VGpuCommandBeginDefaultRenderPass;
+
+typedef struct _VGpuCommandViewport {
+    float       x;
+    float       y;
+    float       width;
+    float       height;
+} _VGpuCommandViewport;
+
+typedef struct _VGpuCommandUniformBuffer {
+    VGpuBuffer  buffer;
+    uint64_t    offset;
+    uint64_t    size;
+    uint32_t    binding;
+} _VGpuCommandUniformBuffer;
+
+typedef struct _VGpuCommandTexture {
+    VGpuTexture texture;
+    uint32_t    binding;
+} _VGpuCommandTexture;
+
+typedef struct _VGpuCommandVertexBuffers {
+    VGpuBuffer  buffers[VGPU_MAX_VERTEX_BUFFER_BINDINGS];
+    uint64_t    offsets[VGPU_MAX_VERTEX_BUFFER_BINDINGS];
+    uint32_t    firstBinding;
+    uint32_t    count;
+} _VGpuCommandVertexBuffers;
+
+typedef struct _VGpuCommandDraw {
+    uint32_t    vertexCount;
+    uint32_t    instanceCount;
+    uint32_t    firstVertex;
+} _VGpuCommandDraw;
+
+typedef struct _VGpuCommandIndexBuffer {
+    VGpuBuffer      buffer;
+    uint64_t        offset;
+    VGpuIndexType   indexType;
+} _VGpuCommandIndexBuffer;
+
+typedef struct _VGpuCommandDrawIndexed {
+    uint32_t    indexCount;
+    uint32_t    instanceCount;
+    uint32_t    firstIndex;
+    int32_t     baseVertex;
+} _VGpuCommandDrawIndexed;
+
+typedef struct _VGpuCommandDrawIndirect {
+    VGpuBuffer  buffer;
+    uint64_t    offset;
+    uint32_t    drawCount;
+    uint32_t    stride;
+} _VGpuCommandDrawIndirect;
+
+typedef struct _VGpuCommandDispatch {
+    VGpuShader  shader;
+    uint32_t    groupCountX;
+    uint32_t    groupCountY;
+    uint32_t    groupCountZ;
+} _VGpuCommandDispatch;
+
+typedef struct VGpuCommandBuffer_T {
+    uint8_t*    data;
+    uint32_t    size;
+    uint32_t    capacity;
+    uint32_t    commandCount;
+    bool        recording;
+    bool        outOfMemory;
+} VGpuCommandBuffer_T;
+
+VGpuCommandBuffer vgpuCreateCommandBuffer(uint32_t initialCapacity) {
+    VGpuCommandBuffer commandBuffer = (VGpuCommandBuffer)_vgpu_calloc(sizeof(VGpuCommandBuffer_T));
+    if (!commandBuffer) {
+        return NULL;
+    }
+
+    if (initialCapacity > 0) {
+        commandBuffer->data = (uint8_t*)_vgpu_alloc(initialCapacity);
+        commandBuffer->capacity = commandBuffer->data ? initialCapacity : 0;
+    }
+
+    return commandBuffer;
+}
+
+void vgpuDestroyCommandBuffer(VGpuCommandBuffer commandBuffer) {
+    if (!commandBuffer) {
+        return;
+    }
+
+    _vgpu_free(commandBuffer->data);
+    _vgpu_free(commandBuffer);
+}
+
+VGpuResult vgpuBeginCommandBuffer(VGpuCommandBuffer commandBuffer) {
+    assert(commandBuffer);
+    if (commandBuffer->recording) {
+        return VGPU_ERROR_COMMAND_BUFFER_ALREADY_RECORDING;
+    }
+
+    commandBuffer->size = 0;
+    commandBuffer->commandCount = 0;
+    commandBuffer->outOfMemory = false;
+    commandBuffer->recording = true;
+    return VGPU_SUCCESS;
+}
+
+VGpuResult vgpuEndCommandBuffer(VGpuCommandBuffer commandBuffer) {
+    assert(commandBuffer);
+    if (!commandBuffer->recording) {
+        return VGPU_ERROR_COMMAND_BUFFER_NOT_RECORDING;
+    }
+
+    commandBuffer->recording = false;
+    return commandBuffer->outOfMemory ? VGPU_ERROR_OUT_OF_HOST_MEMORY : VGPU_SUCCESS;
+}
+
+static void _vgpuCmdWrite(VGpuCommandBuffer commandBuffer, _VGpuCommandType type, const void* payload, uint32_t payloadSize) {
+    assert(commandBuffer);
+    assert(commandBuffer->recording);
+    if (!commandBuffer->recording || commandBuffer->outOfMemory) {
+        return;
+    }
+
+    /* Sizes are computed in 64 bits, a command buffer holds at most 4GB. */
+    const uint64_t requiredSize = (uint64_t)commandBuffer->size + sizeof(_VGpuCommandHeader) + payloadSize;
+    if (requiredSize > UINT32_MAX) {
+        _vgpu_log(vgpu_log_type_error, "command buffer exceeds 4GB");
+        commandBuffer->outOfMemory = true;
+        return;
+    }
+
+    if (requiredSize > commandBuffer->capacity) {
+        uint64_t newCapacity = commandBuffer->capacity > 0 ? (uint64_t)commandBuffer->capacity * 2u : 1024u;
+        while (newCapacity < requiredSize) {
+            newCapacity *= 2u;
+        }
+        if (newCapacity > UINT32_MAX) {
+            newCapacity = UINT32_MAX;
+        }
+
+        uint8_t* data = (uint8_t*)_vgpu_realloc(commandBuffer->data, commandBuffer->capacity, (size_t)newCapacity);
+        if (!data) {
+            commandBuffer->outOfMemory = true;
+            return;
+        }
+
+        commandBuffer->data = data;
+        commandBuffer->capacity = (uint32_t)newCapacity;
+    }
+
+    _VGpuCommandHeader header;
+    header.type = (uint32_t)type;
+    header.size = payloadSize;
+    memcpy(commandBuffer->data + commandBuffer->size, &header, sizeof(header));
+    if (payloadSize > 0) {
+        memcpy(commandBuffer->data + commandBuffer->size + sizeof(header), payload, payloadSize);
+    }
+
+    commandBuffer->size = (uint32_t)requiredSize;
+    commandBuffer->commandCount++;
+}
+
+void vgpuCmdBeginDefaultRenderPass(VGpuCommandBuffer commandBuffer, VGpuColor clearColor, float clearDepth, uint8_t clearStencil) {
+    _VGpuCommandBeginDefaultRenderPass command;
+    command.clearColor = clearColor;
+    command.clearDepth = clearDepth;
+    command.clearStencil = clearStencil;
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_BEGIN_DEFAULT_RENDER_PASS, &command, sizeof(command));
+}
+
+void vgpuCmdBeginRenderPass(VGpuCommandBuffer commandBuffer, const VGpuRenderPassBeginDescriptor* descriptor) {
+    assert(descriptor);
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_BEGIN_RENDER_PASS, descriptor, sizeof(VGpuRenderPassBeginDescriptor));
+}
+
+void vgpuCmdEndRenderPass(VGpuCommandBuffer commandBuffer) {
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_END_RENDER_PASS, NULL, 0);
+}
+
+void vgpuCmdSetViewport(VGpuCommandBuffer commandBuffer, float x, float y, float width, float height) {
+    _VGpuCommandViewport command = { x, y, width, height };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_SET_VIEWPORT, &command, sizeof(command));
+}
+
+void vgpuCmdSetScissor(VGpuCommandBuffer commandBuffer, int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    VGpuRect2D command = { x, y, width, height };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_SET_SCISSOR, &command, sizeof(command));
+}
+
+void vgpuCmdBindPipeline(VGpuCommandBuffer commandBuffer, VGpuPipeline pipeline) {
+    assert(pipeline);
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_BIND_PIPELINE, &pipeline, sizeof(pipeline));
+}
+
+void vgpuCmdSetUniformBuffer(VGpuCommandBuffer commandBuffer, uint32_t binding, VGpuBuffer buffer, uint64_t offset, uint64_t size) {
+    _VGpuCommandUniformBuffer command = { buffer, offset, size, binding };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_SET_UNIFORM_BUFFER, &command, sizeof(command));
+}
+
+void vgpuCmdSetTexture(VGpuCommandBuffer commandBuffer, uint32_t binding, VGpuTexture texture) {
+    _VGpuCommandTexture command = { texture, binding };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_SET_TEXTURE, &command, sizeof(command));
+}
+
+void vgpuCmdSetVertexBuffers(VGpuCommandBuffer commandBuffer, uint32_t firstBinding, uint32_t count, const VGpuBuffer* buffers, const uint64_t* offsets) {
+    assert(count <= VGPU_MAX_VERTEX_BUFFER_BINDINGS);
+    _VGpuCommandVertexBuffers command;
+    memset(&command, 0, sizeof(command));
+    command.firstBinding = firstBinding;
+    command.count = count;
+    memcpy(command.buffers, buffers, sizeof(VGpuBuffer) * count);
+    if (offsets) {
+        memcpy(command.offsets, offsets, sizeof(uint64_t) * count);
+    }
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_SET_VERTEX_BUFFERS, &command, sizeof(command));
+}
+
+void vgpuCmdSetIndexBuffer(VGpuCommandBuffer commandBuffer, VGpuBuffer buffer, uint64_t offset, VGpuIndexType indexType) {
+    _VGpuCommandIndexBuffer command = { buffer, offset, indexType };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_SET_INDEX_BUFFER, &command, sizeof(command));
+}
+
+void vgpuCmdDraw(VGpuCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex) {
+    _VGpuCommandDraw command = { vertexCount, instanceCount, firstVertex };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_DRAW, &command, sizeof(command));
+}
+
+void vgpuCmdDrawIndexed(VGpuCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex) {
+    _VGpuCommandDrawIndexed command = { indexCount, instanceCount, firstIndex, baseVertex };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_DRAW_INDEXED, &command, sizeof(command));
+}
+
+void vgpuCmdDrawIndirect(VGpuCommandBuffer commandBuffer, VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride) {
+    _VGpuCommandDrawIndirect command = { indirectBuffer, offset, drawCount, stride };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_DRAW_INDIRECT, &command, sizeof(command));
+}
+
+void vgpuCmdDrawIndexedIndirect(VGpuCommandBuffer commandBuffer, VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride) {
+    _VGpuCommandDrawIndirect command = { indirectBuffer, offset, drawCount, stride };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_DRAW_INDEXED_INDIRECT, &command, sizeof(command));
+}
+
+void vgpuCmdDispatch(VGpuCommandBuffer commandBuffer, VGpuShader computeShader, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+    _VGpuCommandDispatch command = { computeShader, groupCountX, groupCountY, groupCountZ };
+    _vgpuCmdWrite(commandBuffer, _VGPU_COMMAND_DISPATCH, &command, sizeof(command));
+}
+
+static void _vgpuExecuteCommandBuffer(VGpuCommandBuffer commandBuffer) {
+    const uint8_t* ptr = commandBuffer->data;
+    const uint8_t* end = commandBuffer->data + commandBuffer->size;
+    while (ptr < end) {
+        _VGpuCommandHeader header;
+        memcpy(&header, ptr, sizeof(header));
+        const uint8_t* payload = ptr + sizeof(header);
+        ptr = payload + header.size;
+
+        switch (header.type) {
+        case _VGPU_COMMAND_BEGIN_DEFAULT_RENDER_PASS: {
+            _VGpuCommandBeginDefaultRenderPass command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuBeginDefaultRenderPass(command.clearColor, command.clearDepth, command.clearStencil);
+            break;
+        }
+
+        case _VGPU_COMMAND_BEGIN_RENDER_PASS: {
+            VGpuRenderPassBeginDescriptor descriptor;
+            memcpy(&descriptor, payload, sizeof(descriptor));
+            vgpuBeginRenderPass(&descriptor);
+            break;
+        }
+
+        case _VGPU_COMMAND_END_RENDER_PASS:
+            vgpuEndRenderPass();
+            break;
+
+        case _VGPU_COMMAND_SET_VIEWPORT: {
+            _VGpuCommandViewport command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuSetViewport(command.x, command.y, command.width, command.height);
+            break;
+        }
+
+        case _VGPU_COMMAND_SET_SCISSOR: {
+            VGpuRect2D command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuSetScissor(command.x, command.y, command.width, command.height);
+            break;
+        }
+
+        case _VGPU_COMMAND_BIND_PIPELINE: {
+            VGpuPipeline pipeline;
+            memcpy(&pipeline, payload, sizeof(pipeline));
+            vgpuBindPipeline(pipeline);
+            break;
+        }
+
+        case _VGPU_COMMAND_SET_UNIFORM_BUFFER: {
+            _VGpuCommandUniformBuffer command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuSetUniformBuffer(command.binding, command.buffer, command.offset, command.size);
+            break;
+        }
+
+        case _VGPU_COMMAND_SET_TEXTURE: {
+            _VGpuCommandTexture command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuSetTexture(command.binding, command.texture);
+            break;
+        }
+
+        case _VGPU_COMMAND_SET_VERTEX_BUFFERS: {
+            _VGpuCommandVertexBuffers command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuSetVertexBuffers(command.firstBinding, command.count, command.buffers, command.offsets);
+            break;
+        }
+
+        case _VGPU_COMMAND_SET_INDEX_BUFFER: {
+            _VGpuCommandIndexBuffer command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuSetIndexBuffer(command.buffer, command.offset, command.indexType);
+            break;
+        }
+
+        case _VGPU_COMMAND_DRAW: {
+            _VGpuCommandDraw command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuDraw(command.vertexCount, command.instanceCount, command.firstVertex);
+            break;
+        }
+
+        case _VGPU_COMMAND_DRAW_INDEXED: {
+            _VGpuCommandDrawIndexed command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuDrawIndexed(command.indexCount, command.instanceCount, command.firstIndex, command.baseVertex);
+            break;
+        }
+
+        case _VGPU_COMMAND_DRAW_INDIRECT: {
+            _VGpuCommandDrawIndirect command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuDrawIndirect(command.buffer, command.offset, command.drawCount, command.stride);
+            break;
+        }
+
+        case _VGPU_COMMAND_DRAW_INDEXED_INDIRECT: {
+            _VGpuCommandDrawIndirect command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuDrawIndexedIndirect(command.buffer, command.offset, command.drawCount, command.stride);
+            break;
+        }
+
+        case _VGPU_COMMAND_DISPATCH: {
+            _VGpuCommandDispatch command;
+            memcpy(&command, payload, sizeof(command));
+            vgpuDispatch(command.shader, command.groupCountX, command.groupCountY, command.groupCountZ);
+            break;
+        }
+
+        default:
+            assert(false);
+            return;
+        }
+    }
+}
+
+VGpuResult vgpuSubmitCommandBuffers(uint32_t count, const VGpuCommandBuffer* commandBuffers) {
+    for (uint32_t i = 0; i < count; i++) {
+        assert(commandBuffers[i]);
+        if (commandBuffers[i]->recording) {
+            return VGPU_ERROR_COMMAND_BUFFER_ALREADY_RECORDING;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        _vgpuExecuteCommandBuffer(commandBuffers[i]);
+    }
+
+    return VGPU_SUCCESS;
+}
+
+VGpuResult vgpuSubmitCommandBuffer(VGpuCommandBuffer commandBuffer) {
+    return vgpuSubmitCommandBuffers(1, &commandBuffer);
+}
+
 /* Pixel Format */
 typedef struct VgpuPixelFormatDesc
 {
@@ -258,3 +913,90 @@ const char* vgpuGetFormatName(VGpuPixelFormat format)
     assert(FormatDesc[(uint32_t)format].format == format);
     return FormatDesc[(uint32_t)format].name;
 }
+
+void vgpuGetSurfaceLayout(VGpuPixelFormat format, uint32_t width, uint32_t height, uint32_t* rowPitch, uint32_t* rowCount, uint64_t* slicePitch)
+{
+    assert(FormatDesc[(uint32_t)format].format == format);
+    const VgpuPixelFormatDesc* desc = &FormatDesc[(uint32_t)format];
+
+    uint32_t blocksX = (width + desc->compression.blockWidth - 1) / desc->compression.blockWidth;
+    uint32_t blocksY = (height + desc->compression.blockHeight - 1) / desc->compression.blockHeight;
+    if (blocksX < desc->compression.minBlockX) {
+        blocksX = desc->compression.minBlockX;
+    }
+    if (blocksY < desc->compression.minBlockY) {
+        blocksY = desc->compression.minBlockY;
+    }
+
+    const uint32_t pitch = blocksX * desc->compression.blockSize;
+    if (rowPitch) {
+        *rowPitch = pitch;
+    }
+    if (rowCount) {
+        *rowCount = blocksY;
+    }
+    if (slicePitch) {
+        *slicePitch = (uint64_t)pitch * blocksY;
+    }
+}
+
+static uint32_t _vgpuMipExtent(uint32_t extent, uint32_t mip)
+{
+    const uint32_t value = extent >> mip;
+    return value > 0 ? value : 1;
+}
+
+uint32_t vgpuGetTextureLayerCount(const VGpuTextureDescriptor* descriptor)
+{
+    const uint32_t arrayLayers = descriptor->arrayLayers > 0 ? descriptor->arrayLayers : 1;
+    switch (descriptor->textureType)
+    {
+    case VGPU_TEXTURE_TYPE_3D:
+        return 1;
+    case VGPU_TEXTURE_TYPE_CUBE:
+        return arrayLayers * 6;
+    default:
+        return arrayLayers;
+    }
+}
+
+uint64_t vgpuGetTextureDataSize(const VGpuTextureDescriptor* descriptor)
+{
+    const uint32_t mipLevels = descriptor->mipLevels > 0 ? descriptor->mipLevels : 1;
+    const uint32_t layerCount = vgpuGetTextureLayerCount(descriptor);
+
+    uint64_t layerSize = 0;
+    for (uint32_t mip = 0; mip < mipLevels; mip++) {
+        const uint32_t width = _vgpuMipExtent(descriptor->size.width, mip);
+        const uint32_t height = _vgpuMipExtent(descriptor->size.height, mip);
+        uint32_t depth = 1;
+        if (descriptor->textureType == VGPU_TEXTURE_TYPE_3D) {
+            depth = _vgpuMipExtent(descriptor->size.depth, mip);
+        }
+
+        uint64_t slicePitch;
+        vgpuGetSurfaceLayout(descriptor->pixelFormat, width, height, NULL, NULL, &slicePitch);
+        layerSize += slicePitch * depth;
+    }
+
+    return layerSize * layerCount;
+}
+
+uint64_t vgpuGetPrimitiveCount(VGpuPrimitiveTopology topology, uint32_t vertexCount)
+{
+    switch (topology)
+    {
+    case VGPU_PRIMITIVE_TOPOLOGY_POINT_LIST:
+        return vertexCount;
+    case VGPU_PRIMITIVE_TOPOLOGY_LINE_LIST:
+        return vertexCount / 2;
+    case VGPU_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+        return vertexCount > 1 ? vertexCount - 1 : 0;
+    case VGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST:
+        return vertexCount / 3;
+    case VGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+        return vertexCount > 2 ? vertexCount - 2 : 0;
+    default:
+        return 0;
+    }
+}
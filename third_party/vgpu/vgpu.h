@@ -25,6 +25,7 @@
 #define VGPU_INCLUDED (1)
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifndef VGPU_BUILD_SHARED
 #   define VGPU_BUILD_SHARED 0
@@ -66,22 +67,28 @@
 #       define WIN32_LEAN_AND_MEAN
 #   endif
 #   include <Windows.h>
-#elif defined(__linux__)
+#elif defined(__linux__) && !defined(VGPU_NULL)
 #   include <X11/Xlib-xcb.h>
 #endif
 
 typedef uint32_t VgpuFlags;
 typedef uint32_t VgpuBool32;
+/// Texture, framebuffer, buffer, shader and pipeline handles are 32-bit pool ids (slot index and generation) carried in a pointer type,
+/// NULL is the invalid handle. A destroyed handle goes stale immediately and is rejected, the object is released once the GPU is done with it.
 VGPU_DEFINE_HANDLE(VGpuTexture);
 VGPU_DEFINE_HANDLE(VGpuFramebuffer);
 VGPU_DEFINE_HANDLE(VGpuBuffer);
 VGPU_DEFINE_HANDLE(VGpuShader);
 VGPU_DEFINE_HANDLE(VGpuPipeline);
+VGPU_DEFINE_HANDLE(VGpuCommandBuffer);
 
 enum {
     VGPU_MAX_COLOR_ATTACHMENTS = 8u,
     VGPU_MAX_VERTEX_BUFFER_BINDINGS = 4u,
-    VGPU_MAX_VERTEX_ATTRIBUTES = 16u
+    VGPU_MAX_VERTEX_ATTRIBUTES = 16u,
+    VGPU_MAX_UNIFORM_BUFFER_BINDINGS = 12u,
+    VGPU_MAX_TEXTURE_BINDINGS = 16u,
+    VGPU_MAX_TIMED_RENDER_PASSES = 16u
 };
 
 typedef enum vgpu_log_type {
@@ -93,6 +100,15 @@ typedef enum vgpu_log_type {
 
 typedef void(*vgpu_log_fn)(void *userdata, vgpu_log_type type, const char *message);
 
+/// Host memory hooks, every allocation made by vgpu goes through them. Returned memory must be aligned for any type.
+typedef struct VGpuAllocationCallbacks {
+    void*   userData;
+    void*   (*allocate)(void* userData, size_t size);
+    /// Resize ptr from oldSize to newSize bytes, ptr may be NULL.
+    void*   (*reallocate)(void* userData, void* ptr, size_t oldSize, size_t newSize);
+    void    (*free)(void* userData, void* ptr);
+} VGpuAllocationCallbacks;
+
 typedef enum VGpuResult {
     VGPU_SUCCESS = 0,
     VGPU_NOT_READY = 1,
@@ -354,6 +370,11 @@ typedef enum VGpuShaderStageFlagBits {
 } VGpuShaderStageFlagBits;
 typedef VgpuFlags VGpuShaderStageFlags;
 
+typedef enum VGpuShaderResourceType {
+    VGPU_SHADER_RESOURCE_TYPE_UNIFORM_BUFFER = 0,
+    VGPU_SHADER_RESOURCE_TYPE_TEXTURE = 1
+} VGpuShaderResourceType;
+
 typedef enum VGpuVertexFormat {
     VGPU_VERTEX_FORMAT_UNKNOWN = 0,
     VGPU_VERTEX_FORMAT_FLOAT = 1,
@@ -415,6 +436,53 @@ typedef enum VGpuStencilOperation {
     VGPU_STENCIL_OPERATION_DECREMENT_WRAP,
 } VGpuStencilOperation;
 
+typedef enum VGpuBlendFactor {
+    VGPU_BLEND_FACTOR_ZERO = 0,
+    VGPU_BLEND_FACTOR_ONE,
+    VGPU_BLEND_FACTOR_SRC_COLOR,
+    VGPU_BLEND_FACTOR_ONE_MINUS_SRC_COLOR,
+    VGPU_BLEND_FACTOR_SRC_ALPHA,
+    VGPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+    VGPU_BLEND_FACTOR_DST_COLOR,
+    VGPU_BLEND_FACTOR_ONE_MINUS_DST_COLOR,
+    VGPU_BLEND_FACTOR_DST_ALPHA,
+    VGPU_BLEND_FACTOR_ONE_MINUS_DST_ALPHA,
+    VGPU_BLEND_FACTOR_SRC_ALPHA_SATURATED,
+    VGPU_BLEND_FACTOR_BLEND_COLOR,
+    VGPU_BLEND_FACTOR_ONE_MINUS_BLEND_COLOR,
+} VGpuBlendFactor;
+
+typedef enum VGpuBlendOperation {
+    VGPU_BLEND_OPERATION_ADD = 0,
+    VGPU_BLEND_OPERATION_SUBTRACT,
+    VGPU_BLEND_OPERATION_REVERSE_SUBTRACT,
+    VGPU_BLEND_OPERATION_MIN,
+    VGPU_BLEND_OPERATION_MAX,
+} VGpuBlendOperation;
+
+typedef enum VGpuColorWriteMaskFlags {
+    /// Zero selects all channels, use NONE to disable color writes.
+    VGPU_COLOR_WRITE_MASK_DEFAULT = 0,
+    VGPU_COLOR_WRITE_MASK_RED = 1 << 0,
+    VGPU_COLOR_WRITE_MASK_GREEN = 1 << 1,
+    VGPU_COLOR_WRITE_MASK_BLUE = 1 << 2,
+    VGPU_COLOR_WRITE_MASK_ALPHA = 1 << 3,
+    VGPU_COLOR_WRITE_MASK_ALL = 0x0F,
+    VGPU_COLOR_WRITE_MASK_NONE = 0x10,
+} VGpuColorWriteMaskFlags;
+typedef VgpuFlags VGpuColorWriteMask;
+
+typedef enum VGpuCullMode {
+    VGPU_CULL_MODE_NONE = 0,
+    VGPU_CULL_MODE_FRONT,
+    VGPU_CULL_MODE_BACK,
+} VGpuCullMode;
+
+typedef enum VGpuFrontFace {
+    VGPU_FRONT_FACE_CCW = 0,
+    VGPU_FRONT_FACE_CW,
+} VGpuFrontFace;
+
 typedef struct VGpuExtent2D {
     uint32_t    width;
     uint32_t    height;
@@ -478,9 +546,12 @@ typedef struct VGpuPlatformHandle {
 #if defined(_WIN32)
     HINSTANCE                           hinstance;
     HWND                                hwnd;
-#elif defined(__linux__)
+#elif defined(__linux__) && !defined(VGPU_NULL)
     xcb_connection_t*                   connection;
     xcb_window_t                        window;
+#else
+    /// Unused by headless backends, keeps the struct from being empty.
+    void*                               window;
 #endif
 } VGpuPlatformHandle;
 
@@ -501,8 +572,44 @@ typedef struct VGpuRendererSettings {
     uint32_t                width;
     uint32_t                height;
     VGpuSwapchainDescriptor swapchain;
+    /// Per frame capacity of each transient ring in bytes, 0 selects the default.
+    uint32_t                transientBufferSize;
+    /// Measure the GPU time of render passes with timer queries where supported, see VGpuFrameStats.
+    VgpuBool32              gpuTiming;
+    /// Capacity of the object pools, including destroyed objects waiting for their frame to complete. 0 selects 4096, the maximum is 65534.
+    uint32_t                maxTextures;
+    uint32_t                maxFramebuffers;
+    uint32_t                maxBuffers;
+    uint32_t                maxShaders;
+    uint32_t                maxPipelines;
 } VGpuRendererSettings;
 
+/// Memory sub-allocated from a transient ring, valid until the frame it belongs to is reused.
+typedef struct VGpuTransientAllocation {
+    VGpuBuffer  buffer;
+    uint64_t    offset;
+    void*       data;
+} VGpuTransientAllocation;
+
+/// Arguments of one vgpuDrawIndirect draw, matches the GL and Vulkan layout.
+typedef struct VGpuDrawIndirectCommand {
+    uint32_t    vertexCount;
+    uint32_t    instanceCount;
+    uint32_t    firstVertex;
+    /// Must be 0 unless the backend supports base instance.
+    uint32_t    firstInstance;
+} VGpuDrawIndirectCommand;
+
+/// Arguments of one vgpuDrawIndexedIndirect draw, matches the GL and Vulkan layout.
+typedef struct VGpuDrawIndexedIndirectCommand {
+    uint32_t    indexCount;
+    uint32_t    instanceCount;
+    uint32_t    firstIndex;
+    int32_t     baseVertex;
+    /// Must be 0 unless the backend supports base instance.
+    uint32_t    firstInstance;
+} VGpuDrawIndexedIndirectCommand;
+
 typedef struct VGpuTextureDescriptor {
     VGpuTextureType         textureType;
     VGpuPixelFormat         pixelFormat;
@@ -514,6 +621,15 @@ typedef struct VGpuTextureDescriptor {
     const char*             label;
 } VGpuTextureDescriptor;
 
+/// Initial contents of one texture subresource, pitches of 0 mean tightly packed.
+typedef struct VGpuTextureData {
+    const void*             data;
+    /// Bytes between rows of pixels, or rows of blocks for compressed formats.
+    uint32_t                rowPitch;
+    /// Bytes between depth slices, 3D textures only.
+    uint32_t                slicePitch;
+} VGpuTextureData;
+
 typedef struct VGpuFramebufferAttachment {
     /// The texture attachment.
     VGpuTexture texture;
@@ -560,12 +676,29 @@ typedef struct VGpuRenderPassBeginDescriptor {
 } VGpuRenderPassBeginDescriptor;
 
 
+typedef struct VGpuBlendAttachmentState {
+    bool                    blendEnabled;
+    VGpuBlendFactor         srcColorBlendFactor;
+    VGpuBlendFactor         dstColorBlendFactor;
+    VGpuBlendOperation      colorBlendOperation;
+    VGpuBlendFactor         srcAlphaBlendFactor;
+    VGpuBlendFactor         dstAlphaBlendFactor;
+    VGpuBlendOperation      alphaBlendOperation;
+    VGpuColorWriteMask      colorWriteMask;
+} VGpuBlendAttachmentState;
+
 typedef struct VGpuBlendState {
-    uint32_t dummy;
+    /// When false attachments[0] applies to every color attachment.
+    bool                        independentBlendEnabled;
+    VGpuBlendAttachmentState    attachments[VGPU_MAX_COLOR_ATTACHMENTS];
 } VGpuBlendState;
 
 typedef struct VGpuRasterizerState {
-    bool alphaToCoverageEnabled;
+    bool                    alphaToCoverageEnabled;
+    VGpuFrontFace           frontFace;
+    VGpuCullMode            cullMode;
+    float                   depthBias;
+    float                   depthBiasSlopeScale;
 } VGpuRasterizerState;
 
 typedef struct VGpuStencilDescriptor {
@@ -594,6 +727,8 @@ typedef struct VGpuVertexAttributeDescriptor {
     VGpuVertexFormat            format;
     uint32_t                    offset;
     uint32_t                    bufferIndex;
+    /// Optional shader input name, by default attribute i feeds the input at location i.
+    const char*                 name;
 } VGpuVertexAttributeDescriptor;
 
 typedef struct VGpuVertexDescriptor {
@@ -601,6 +736,35 @@ typedef struct VGpuVertexDescriptor {
     VGpuVertexAttributeDescriptor       attributes[VGPU_MAX_VERTEX_ATTRIBUTES];
 } VGpuVertexDescriptor;
 
+typedef struct VGpuShaderStageDescriptor {
+    /// Complete source including #version for GL backends, not required to be null terminated.
+    const void*                 code;
+    uint64_t                    codeSize;
+} VGpuShaderStageDescriptor;
+
+/// Reflected vertex input, bound to its location before linking.
+typedef struct VGpuShaderVertexInput {
+    const char*                 name;
+    uint32_t                    location;
+} VGpuShaderVertexInput;
+
+/// Reflected resource, name is the uniform block or sampler name.
+typedef struct VGpuShaderResourceBinding {
+    const char*                 name;
+    VGpuShaderResourceType      type;
+    uint32_t                    binding;
+} VGpuShaderResourceBinding;
+
+typedef struct VGpuShaderDescriptor {
+    VGpuShaderStageDescriptor   vertex;
+    VGpuShaderStageDescriptor   fragment;
+    VGpuShaderStageDescriptor   compute;
+    /// Optional reflection, when empty it is queried from the linked program.
+    uint32_t                            vertexInputCount;
+    const VGpuShaderVertexInput*        vertexInputs;
+    uint32_t                            resourceCount;
+    const VGpuShaderResourceBinding*    resources;
+} VGpuShaderDescriptor;
 
 typedef struct VGpuRenderPipelineDescriptor {
     VGpuShader                  shader;
@@ -612,7 +776,99 @@ typedef struct VGpuRenderPipelineDescriptor {
     VGpuPrimitiveTopology       primitiveTopology;
 } VGpuRenderPipelineDescriptor;
 
+/// Counters tracked by the null backend.
+typedef struct VGpuNullCounters {
+    /// Index of the last completed frame.
+    uint32_t    frameIndex;
+
+    /// Live objects.
+    uint32_t    textures;
+    uint32_t    framebuffers;
+    uint32_t    buffers;
+    uint32_t    shaders;
+    uint32_t    pipelines;
+
+    /// Totals since initialization.
+    uint64_t    objectsCreated;
+    uint64_t    objectsDestroyed;
+
+    /// Work recorded during the last completed frame.
+    uint32_t    renderPasses;
+    uint32_t    draws;
+    uint32_t    pipelineBinds;
+    uint32_t    dispatches;
+    uint64_t    vertices;
+    uint64_t    instances;
+    uint64_t    bytesUploaded;
+} VGpuNullCounters;
+
+/// Redundant state filtering counters of the last completed frame.
+typedef struct VGpuStateCacheCounters {
+    /// State calls issued to the driver.
+    uint32_t    stateCalls;
+    /// State calls skipped because the value was already set.
+    uint32_t    skippedCalls;
+    /// Draws that found their vertex array in the cache.
+    uint32_t    vertexArrayHits;
+    /// Draws that had to build a vertex array.
+    uint32_t    vertexArrayMisses;
+    /// Live cached vertex arrays.
+    uint32_t    vertexArrays;
+    /// Pipeline binds that changed the current pipeline.
+    uint32_t    pipelineSwitches;
+    /// Shader program changes.
+    uint32_t    programSwitches;
+    /// Texture unit binding changes.
+    uint32_t    textureSwitches;
+} VGpuStateCacheCounters;
+
+/// Work and resource activity of the last completed frame.
+typedef struct VGpuFrameStats {
+    /// Index of the frame the CPU side counters belong to.
+    uint32_t    frameIndex;
+    uint32_t    renderPasses;
+    /// Draw calls, each draw of an indirect call counts once.
+    uint32_t    draws;
+    uint32_t    dispatches;
+    /// Instances and primitives drawn, indirect arguments the CPU cannot read are not counted.
+    uint64_t    instances;
+    uint64_t    primitives;
+    /// Binds that changed device state.
+    uint32_t    pipelineBinds;
+    uint32_t    programBinds;
+    uint32_t    textureBinds;
+    uint32_t    bufferBinds;
+    /// Objects created and destroyed during the frame.
+    uint32_t    resourcesCreated;
+    uint32_t    resourcesDestroyed;
+    /// Bytes written to buffers and textures by the CPU.
+    uint64_t    bytesUploaded;
+    /// Frame the GPU timings belong to, timings lag a few frames behind to avoid stalls.
+    uint32_t    gpuFrameIndex;
+    /// Number of timed render passes, 0 when GPU timing is disabled or unsupported.
+    uint32_t    gpuPassCount;
+    /// GPU time of the timed render passes in milliseconds, in begin order.
+    float       gpuPassTimes[VGPU_MAX_TIMED_RENDER_PASSES];
+    /// Sum of gpuPassTimes.
+    float       gpuTime;
+} VGpuFrameStats;
+
+/// Estimated device memory of live resources, computed from sizes and formats. External resources are not counted.
+typedef struct VGpuMemoryStats {
+    uint32_t    textureCount;
+    uint64_t    textureBytes;
+    /// Textures created with VGPU_TEXTURE_USAGE_RENDER_TARGET, included in the texture totals.
+    uint32_t    renderTargetCount;
+    uint64_t    renderTargetBytes;
+    uint32_t    bufferCount;
+    uint64_t    bufferBytes;
+    /// Sum of texture and buffer bytes.
+    uint64_t    totalBytes;
+} VGpuMemoryStats;
+
 VGPU_API void vgpu_set_log_callback(vgpu_log_fn callback, void *userdata);
+/// Route host allocations through callbacks, NULL restores malloc and free. Must be called before vgpuInitialize or after vgpuShutdown.
+VGPU_API void vgpuSetAllocationCallbacks(const VGpuAllocationCallbacks* callbacks);
 
 VGPU_API VGpuBackend vgpuGetBackend();
 
@@ -623,7 +879,9 @@ VGPU_API void vgpuQueryLimits(VGpuLimits* pLimits);
 VGPU_API uint32_t vgpuFrame();
 
 /* Texture */
-VGPU_API VGpuTexture vgpuCreateTexture(const VGpuTextureDescriptor* descriptor);
+/// Create a texture, initialData is NULL or holds one entry per subresource ordered by layer then mip: [layer * mipLevels + mip].
+/// Cube faces count as layers, entries with NULL data are left undefined.
+VGPU_API VGpuTexture vgpuCreateTexture(const VGpuTextureDescriptor* descriptor, const VGpuTextureData* initialData);
 VGPU_API VGpuTexture vgpuCreateExternalTexture(const VGpuTextureDescriptor* descriptor, void* handle);
 VGPU_API void vgpuDestroyTexture(VGpuTexture texture);
 
@@ -634,30 +892,93 @@ VGPU_API void vgpuDestroyFramebuffer(VGpuFramebuffer framebuffer);
 /* Buffer */
 VGPU_API VGpuBuffer vgpuCreateBuffer(uint64_t size, VGpuBufferUsage usage, VGpuResourceUsage resourceUsage, const void* data);
 VGPU_API void vgpuDestroyBuffer(VGpuBuffer buffer);
+/// Get the persistent CPU pointer of a DYNAMIC or STREAM buffer, NULL for other usages.
+VGPU_API void* vgpuMapBuffer(VGpuBuffer buffer);
+/// Make CPU writes to the given range of a mapped buffer visible to the GPU.
+VGPU_API void vgpuFlushBuffer(VGpuBuffer buffer, uint64_t offset, uint64_t size);
+/// Write data into a non IMMUTABLE buffer, the caller must not overwrite a range the GPU may still read.
+VGPU_API void vgpuUpdateBuffer(VGpuBuffer buffer, uint64_t offset, uint64_t size, const void* data);
+/// Allocate per frame memory from the fenced ring matching usage (vertex, index or uniform), flush it with vgpuFlushBuffer.
+VGPU_API VGpuResult vgpuAllocateTransient(VGpuBufferUsage usage, uint64_t size, uint64_t alignment, VGpuTransientAllocation* allocation);
 
 /* Shader */
 VGPU_API VGpuShader vgpuCreateShader(const char* vertexSource, const char* fragmentSource);
 VGPU_API VGpuShader vgpuCreateComputeShader(const char* source);
+/// Create a shader from precompiled stage code (vertex and fragment, or compute), no header is prepended.
+VGPU_API VGpuShader vgpuCreateShaderWithDescriptor(const VGpuShaderDescriptor* descriptor);
 VGPU_API void vgpuDestroyShader(VGpuShader shader);
 
 /* Pipeline */
 VGPU_API VGpuPipeline vgpuCreateRenderPipeline(const VGpuRenderPipelineDescriptor* descriptor);
 VGPU_API void vgpuDestroyPipeline(VGpuPipeline pipeline);
 
-/// Get frame command buffer for recording.
+/// Immediate commands, executed directly on the thread that owns the device.
 VGPU_API void vgpuBeginDefaultRenderPass(VGpuColor clearColor, float clearDepth, uint8_t clearStencil);
 VGPU_API void vgpuBeginRenderPass(const VGpuRenderPassBeginDescriptor* descriptor);
 VGPU_API void vgpuEndRenderPass();
-//VGPU_API void vgpuCmdSetViewport(VGpuCommandBuffer commandBuffer, float x, float y, float width, float height);
-//VGPU_API void vgpuCmdSetScissor(VGpuCommandBuffer commandBuffer, int32_t x, int32_t y, uint32_t width, uint32_t height);
-//VGPU_API void vgpuSubmitCommandBuffer(VGpuCommandBuffer commandBuffer);
+VGPU_API void vgpuSetViewport(float x, float y, float width, float height);
+VGPU_API void vgpuSetScissor(int32_t x, int32_t y, uint32_t width, uint32_t height);
 
 VGPU_API void vgpuBindPipeline(VGpuPipeline pipeline);
+/// Bind a uniform buffer range to binding, size 0 binds the whole buffer. Applied at draw time for the bindings the pipeline reads.
+VGPU_API void vgpuSetUniformBuffer(uint32_t binding, VGpuBuffer buffer, uint64_t offset, uint64_t size);
+/// Bind a texture to binding. Applied at draw time for the bindings the pipeline reads.
+VGPU_API void vgpuSetTexture(uint32_t binding, VGpuTexture texture);
+/// Bind vertex buffers to bindings [firstBinding, firstBinding + count), offsets may be NULL for zero offsets.
+VGPU_API void vgpuSetVertexBuffers(uint32_t firstBinding, uint32_t count, const VGpuBuffer* buffers, const uint64_t* offsets);
+/// Bind the index buffer read by indexed draws, offset must be a multiple of the index size.
+VGPU_API void vgpuSetIndexBuffer(VGpuBuffer buffer, uint64_t offset, VGpuIndexType indexType);
 VGPU_API void vgpuDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex);
+/// Draw indexCount indices starting at firstIndex, baseVertex is added to every index before fetching vertices.
+VGPU_API void vgpuDrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex);
+/// Issue drawCount VGpuDrawIndirectCommand draws read from buffer at offset, stride 0 means tightly packed.
+VGPU_API void vgpuDrawIndirect(VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride);
+/// Issue drawCount VGpuDrawIndexedIndirectCommand draws read from buffer at offset, stride 0 means tightly packed.
+VGPU_API void vgpuDrawIndexedIndirect(VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride);
+
+/* CommandBuffer */
+/// Create a deferred command buffer, recording can happen on any thread but one thread at a time.
+VGPU_API VGpuCommandBuffer vgpuCreateCommandBuffer(uint32_t initialCapacity);
+VGPU_API void vgpuDestroyCommandBuffer(VGpuCommandBuffer commandBuffer);
+/// Begin recording, previous content is discarded while the allocated memory is kept.
+VGPU_API VGpuResult vgpuBeginCommandBuffer(VGpuCommandBuffer commandBuffer);
+VGPU_API VGpuResult vgpuEndCommandBuffer(VGpuCommandBuffer commandBuffer);
+VGPU_API void vgpuCmdBeginDefaultRenderPass(VGpuCommandBuffer commandBuffer, VGpuColor clearColor, float clearDepth, uint8_t clearStencil);
+VGPU_API void vgpuCmdBeginRenderPass(VGpuCommandBuffer commandBuffer, const VGpuRenderPassBeginDescriptor* descriptor);
+VGPU_API void vgpuCmdEndRenderPass(VGpuCommandBuffer commandBuffer);
+VGPU_API void vgpuCmdSetViewport(VGpuCommandBuffer commandBuffer, float x, float y, float width, float height);
+VGPU_API void vgpuCmdSetScissor(VGpuCommandBuffer commandBuffer, int32_t x, int32_t y, uint32_t width, uint32_t height);
+VGPU_API void vgpuCmdBindPipeline(VGpuCommandBuffer commandBuffer, VGpuPipeline pipeline);
+VGPU_API void vgpuCmdSetUniformBuffer(VGpuCommandBuffer commandBuffer, uint32_t binding, VGpuBuffer buffer, uint64_t offset, uint64_t size);
+VGPU_API void vgpuCmdSetTexture(VGpuCommandBuffer commandBuffer, uint32_t binding, VGpuTexture texture);
+VGPU_API void vgpuCmdSetVertexBuffers(VGpuCommandBuffer commandBuffer, uint32_t firstBinding, uint32_t count, const VGpuBuffer* buffers, const uint64_t* offsets);
+VGPU_API void vgpuCmdSetIndexBuffer(VGpuCommandBuffer commandBuffer, VGpuBuffer buffer, uint64_t offset, VGpuIndexType indexType);
+VGPU_API void vgpuCmdDraw(VGpuCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex);
+VGPU_API void vgpuCmdDrawIndexed(VGpuCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex);
+VGPU_API void vgpuCmdDrawIndirect(VGpuCommandBuffer commandBuffer, VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride);
+VGPU_API void vgpuCmdDrawIndexedIndirect(VGpuCommandBuffer commandBuffer, VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride);
+VGPU_API void vgpuCmdDispatch(VGpuCommandBuffer commandBuffer, VGpuShader computeShader, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+/// Replay recorded command buffers in order, must be called on the thread that owns the device.
+VGPU_API VGpuResult vgpuSubmitCommandBuffers(uint32_t count, const VGpuCommandBuffer* commandBuffers);
+VGPU_API VGpuResult vgpuSubmitCommandBuffer(VGpuCommandBuffer commandBuffer);
 
 /// Compute API
 VGPU_API void vgpuDispatch(VGpuShader computeShader, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
 
+/// Get the statistics of the last completed frame, they stay unchanged until the next vgpuFrame.
+VGPU_API void vgpuGetFrameStats(VGpuFrameStats* stats);
+
+/// Get the estimated device memory held by live textures and buffers.
+VGPU_API void vgpuGetMemoryStats(VGpuMemoryStats* stats);
+
+/// Get redundant state filtering counters, backends without a state cache report zeros.
+VGPU_API void vgpuGetStateCacheCounters(VGpuStateCacheCounters* counters);
+
+#if defined(VGPU_NULL)
+/// Null backend only: get object and per-frame counters, available when built with VGPU_RENDERER=NULL.
+VGPU_API void vgpuNullGetCounters(VGpuNullCounters* counters);
+#endif
+
 /// Get the number of bits per format
 VGPU_API uint32_t vgpuGetFormatBitsPerPixel(VGpuPixelFormat format);
 VGPU_API uint32_t vgpuGetFormatBlockSize(VGpuPixelFormat format);
@@ -679,3 +1000,12 @@ VGPU_API VgpuBool32 vgpuIsDepthStencilFormat(VGpuPixelFormat format);
 VGPU_API VgpuBool32 vgpuIsCompressedFormat(VGpuPixelFormat format);
 /// Get format string name.
 VGPU_API const char* vgpuGetFormatName(VGpuPixelFormat format);
+
+/// Get the tightly packed layout of a width x height surface: bytes per row, number of rows and bytes per slice, rows are rows of blocks for compressed formats.
+VGPU_API void vgpuGetSurfaceLayout(VGpuPixelFormat format, uint32_t width, uint32_t height, uint32_t* rowPitch, uint32_t* rowCount, uint64_t* slicePitch);
+/// Get the number of primitives drawn from vertexCount vertices, patch lists count as 0.
+VGPU_API uint64_t vgpuGetPrimitiveCount(VGpuPrimitiveTopology topology, uint32_t vertexCount);
+/// Get the number of layers addressed by texture data, six per cube and one for 3D textures.
+VGPU_API uint32_t vgpuGetTextureLayerCount(const VGpuTextureDescriptor* descriptor);
+/// Get the size in bytes of tightly packed data for every subresource of a texture.
+VGPU_API uint64_t vgpuGetTextureDataSize(const VGpuTextureDescriptor* descriptor);
@@ -23,6 +23,8 @@
 #if defined(VGPU_GL) || defined(VGPU_GLES) || defined(VGPU_WEBGL)
 #include "vgpu.h"
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #if defined(_WIN32) || defined(_WIN64)
 #   include <malloc.h>
 #   undef    alloca
@@ -32,10 +34,29 @@
 #   include <alloca.h>
 #endif
 
-#define _VGPU_ALLOC(type)           ((type*) malloc(sizeof(type)))
-#define _VGPU_ALLOCN(type, n)       ((type*) malloc(sizeof(type) * n))
-#define _VGPU_FREE(ptr)             (free((void*)(ptr)))
-#define _VGPU_ALLOC_HANDLE(type)    ((type) calloc(1, sizeof(type##_T)))
+/* Host allocations go through the callbacks set with vgpuSetAllocationCallbacks. */
+extern void* _vgpu_alloc(size_t size);
+extern void* _vgpu_calloc(size_t size);
+extern void _vgpu_free(void* ptr);
+extern uint64_t _vgpu_texture_memory_size(const VGpuTextureDescriptor* descriptor);
+extern void _vgpu_track_texture(uint64_t size, VGpuTextureUsageFlags usage, bool created);
+extern void _vgpu_track_buffer(uint64_t size, bool created);
+
+/* Object pools, see vgpu.c */
+typedef struct _VGpuPool _VGpuPool;
+extern _VGpuPool* _vgpu_pool_create(uint32_t capacity, uint32_t itemSize);
+extern void _vgpu_pool_destroy(_VGpuPool* pool);
+extern uint32_t _vgpu_pool_alloc(_VGpuPool* pool, void** item);
+extern void* _vgpu_pool_get(const _VGpuPool* pool, uint32_t id);
+extern void _vgpu_pool_retire(_VGpuPool* pool, uint32_t id, uint32_t frame);
+extern void* _vgpu_pool_collect(_VGpuPool* pool, uint32_t completedFrame);
+extern uint32_t _vgpu_pool_live_count(const _VGpuPool* pool);
+
+#define _VGPU_ALLOC(type)           ((type*) _vgpu_alloc(sizeof(type)))
+#define _VGPU_ALLOCN(type, n)       ((type*) _vgpu_alloc(sizeof(type) * n))
+#define _VGPU_FREE(ptr)             (_vgpu_free((void*)(ptr)))
+#define _VGPU_HANDLE(type, id)      ((type)(uintptr_t)(id))
+#define _VGPU_HANDLE_ID(handle)     ((uint32_t)(uintptr_t)(handle))
 
 #ifndef _VGPU_ASSERT
 #   include <assert.h>
@@ -81,12 +102,74 @@
 #define GL_PATCHES 0x000E
 #endif
 
+/* Texture formats exposed only through extensions on some GL flavours. */
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#define GL_COMPRESSED_SIGNED_RED_RGTC1 0x8DBC
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#define GL_COMPRESSED_SIGNED_RG_RGTC2 0x8DBE
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#define GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT 0x8E8E
+#define GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT 0x8E8F
+#endif
+
+#ifndef GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG
+#define GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG 0x8C00
+#define GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG 0x8C01
+#define GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG 0x8C02
+#define GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG 0x8C03
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#define GL_COMPRESSED_RGBA_ASTC_5x5_KHR 0x93B2
+#define GL_COMPRESSED_RGBA_ASTC_6x6_KHR 0x93B4
+#define GL_COMPRESSED_RGBA_ASTC_8x5_KHR 0x93B5
+#define GL_COMPRESSED_RGBA_ASTC_8x6_KHR 0x93B6
+#define GL_COMPRESSED_RGBA_ASTC_8x8_KHR 0x93B7
+#define GL_COMPRESSED_RGBA_ASTC_10x10_KHR 0x93BB
+#define GL_COMPRESSED_RGBA_ASTC_12x12_KHR 0x93BD
+#endif
+
+#ifndef GL_R16
+#define GL_R16 0x822A
+#define GL_RG16 0x822C
+#define GL_RGBA16 0x805B
+#define GL_R16_SNORM 0x8F98
+#define GL_RG16_SNORM 0x8F99
+#define GL_RGBA16_SNORM 0x8F9B
+#endif
+
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+
+#ifndef GL_STENCIL_INDEX
+#define GL_STENCIL_INDEX 0x1901
+#endif
+
 /* GL only types */
-#define _VGPU_GL_MAX_TEXTURES (16u)
-//#define _VGPU_GL_SHADER_POSITION 0
-//#define _VGPU_GL_SHADER_NORMAL 1
-//#define _VGPU_GL_SHADER_TEX_COORD 2
-//#define _VGPU_GL_SHADER_VERTEX_COLOR 3
+#define _VGPU_GL_MAX_TEXTURES (VGPU_MAX_TEXTURE_BINDINGS)
+#define _VGPU_GL_MAX_FRAMES_IN_FLIGHT (4u)
+#define _VGPU_GL_DEFAULT_TRANSIENT_SIZE (2u * 1024u * 1024u)
+#define _VGPU_GL_VERTEX_ARRAY_CACHE_SIZE (256u)  /* power of two */
+#define _VGPU_GL_VERTEX_ARRAY_PROBE_COUNT (8u)
 
 typedef enum _VGpuGLBufferType {
     _VGPU_GL_BUFFER_VERTEX,
@@ -96,21 +179,23 @@ typedef enum _VGpuGLBufferType {
     _VGPU_GL_BUFFER_TYPE_COUNT
 } _VGpuGLBufferType;
 
-/* Handle declaration */
-typedef struct VGpuTexture_T {
+/* Pooled objects, handles index into _gl.textures, _gl.buffers, _gl.shaders and _gl.pipelines */
+typedef struct _VGpuGLTexture {
     VGpuTextureType         textureType;
     VGpuPixelFormat         pixelFormat;
     VGpuExtent3D            size;
     uint32_t                mipLevels;
     uint32_t                arrayLayers;
+    uint32_t                layerCount;     /* array layers, six per cube */
     VgpuSampleCount         samples;
     VGpuTextureUsageFlags   usage;
+    uint64_t                memorySize;     /* estimated device bytes */
     bool                    external_handle;
     GLenum                  gl_target;
     GLuint                  gl_handle;
-} VGpuTexture_T;
+} _VGpuGLTexture;
 
-typedef struct VGpuBuffer_T {
+typedef struct _VGpuGLBuffer {
     uint64_t            size;
     VGpuBufferUsage     usage;
     VGpuBufferUsage     resourceUsage;
@@ -118,12 +203,25 @@ typedef struct VGpuBuffer_T {
     _VGpuGLBufferType   gl_type;
     GLenum              gl_target;
     GLuint              gl_handle;
-    void*               gl_data;
-} VGpuBuffer_T;
-
-typedef struct VGpuShader_T {
-    GLuint          gl_handle;
-} VGpuShader_T;
+    void*               gl_data;        /* persistent mapping or CPU shadow for DYNAMIC and STREAM usage */
+    bool                gl_persistent;
+} _VGpuGLBuffer;
+
+/* Binding slots a program reads, resolved once so draws only walk these tables. */
+typedef struct _VGpuGLBindingTable {
+    uint8_t                 uniformBufferCount;
+    uint8_t                 textureCount;
+    uint8_t                 uniformBuffers[VGPU_MAX_UNIFORM_BUFFER_BINDINGS];
+    uint8_t                 textures[VGPU_MAX_TEXTURE_BINDINGS];
+    GLint                   uniformBufferSizes[VGPU_MAX_UNIFORM_BUFFER_BINDINGS];
+} _VGpuGLBindingTable;
+
+typedef struct _VGpuGLShader {
+    GLuint                  gl_handle;
+    uint32_t                gl_inputMask;           /* vertex input locations read by the program */
+    uint32_t                gl_integerInputMask;    /* inputs declared with an int or uint type */
+    _VGpuGLBindingTable     gl_bindings;
+} _VGpuGLShader;
 
 typedef struct _VGpuGLVertexAttribute {
     int8_t vb_index;        /* -1 if attr is not enabled */
@@ -136,12 +234,78 @@ typedef struct _VGpuGLVertexAttribute {
     bool integer;
 } _VGpuGLVertexAttribute;
 
-typedef struct VGpuPipeline_T {
-    VGpuShader              shader;
+typedef struct _VGpuGLStencilFace {
+    GLenum  func;
+    GLenum  fail;
+    GLenum  depthFail;
+    GLenum  pass;
+} _VGpuGLStencilFace;
+
+typedef struct _VGpuGLBlendAttachment {
+    bool    enabled;
+    GLenum  srcRGB;
+    GLenum  dstRGB;
+    GLenum  opRGB;
+    GLenum  srcAlpha;
+    GLenum  dstAlpha;
+    GLenum  opAlpha;
+    uint8_t writeMask;      /* VGPU_COLOR_WRITE_MASK_RED..ALPHA bits */
+} _VGpuGLBlendAttachment;
+
+/* Fixed function state resolved to GL values, diffed against the cache on pipeline bind. */
+typedef struct _VGpuGLRenderState {
+    /* depth stencil */
+    bool                    depthTest;
+    bool                    depthWrite;
+    GLenum                  depthFunc;
+    bool                    stencilTest;
+    GLuint                  stencilReadMask;
+    GLuint                  stencilWriteMask;
+    _VGpuGLStencilFace      stencilFront;
+    _VGpuGLStencilFace      stencilBack;
+
+    /* blend */
+    bool                    independentBlend;
+    _VGpuGLBlendAttachment  blend[VGPU_MAX_COLOR_ATTACHMENTS];
+
+    /* rasterizer */
+    bool                    alphaToCoverage;
+    bool                    cullEnabled;
+    GLenum                  cullFace;
+    GLenum                  frontFace;
+    float                   depthBias;
+    float                   depthBiasSlopeScale;
+} _VGpuGLRenderState;
+
+typedef struct _VGpuGLPipeline {
+    GLuint                  gl_program;     /* program of the shader, which must outlive the pipeline */
     GLenum                  topology;
+    VGpuPrimitiveTopology   primitiveTopology;
     bool                    vertex_layout_valid[VGPU_MAX_VERTEX_BUFFER_BINDINGS];
     _VGpuGLVertexAttribute  gl_attrs[VGPU_MAX_VERTEX_ATTRIBUTES];
-} VGpuPipeline_T;
+    _VGpuGLRenderState      gl_state;
+    _VGpuGLBindingTable     gl_bindings;
+} _VGpuGLPipeline;
+
+typedef struct _VGpuGLUniformBufferBinding {
+    GLuint                  buffer;
+    GLintptr                offset;
+    GLsizeiptr              size;   /* 0 for the whole buffer */
+} _VGpuGLUniformBufferBinding;
+
+typedef struct _VGpuGLVertexBindings {
+    GLuint                  buffers[VGPU_MAX_VERTEX_BUFFER_BINDINGS];
+    GLintptr                offsets[VGPU_MAX_VERTEX_BUFFER_BINDINGS];
+    GLuint                  indexBuffer;    /* element array binding is vertex array state */
+} _VGpuGLVertexBindings;
+
+/* Cached vertex array object, keyed on the pipeline, the vertex buffers it reads and the index buffer.
+ * Offsets are not part of the key, they are re-pointed on the cached object when they change. */
+typedef struct _VGpuGLVertexArray {
+    const _VGpuGLPipeline*  pipeline;   /* NULL for free entries */
+    _VGpuGLVertexBindings   bindings;
+    GLuint                  vao;
+} _VGpuGLVertexArray;
 
 typedef struct _vgpu_gl_features {
     bool    independentBlend;
@@ -168,38 +332,92 @@ typedef struct _vgpu_gl_features {
     bool    textureStorageMultisample;  /* glTexStorage2DMultisample = 4.3 or GL_ARB_texture_storage_multisample*/
     bool    bufferStorage;              /* glBufferStorage = 4.4 or GL_ARB_buffer_storage*/
     bool    clipControl;
+    bool    drawIndirect;               /* glDrawArraysIndirect = 4.0, GLES 3.1 or GL_ARB_draw_indirect */
+    bool    multiDrawIndirect;          /* glMultiDrawArraysIndirect = 4.3 or GL_ARB_multi_draw_indirect */
+    bool    vertexAttribBinding;        /* glBindVertexBuffer = 4.3, GLES 3.1 or GL_ARB_vertex_attrib_binding */
 } _vgpu_gl_features;
 
 typedef struct _vgpu_gl_cache {
     /* rasterizer state */
     uint32_t                primitiveRestart;
 
-    /* depth stencil state*/
-    VGpuCompareFunction     depthCompareFunction;
-    bool                    depthWriteEnabled;
-    bool                    stencilEnabled;
+    /* depth stencil, blend and rasterizer state */
+    _VGpuGLRenderState      render;
+    GLint                   stencilRef;
 
-    /* blend state */
-    bool                    alphaToCoverage;
+    /* vertex input */
+    _VGpuGLVertexBindings   vertexBindings;
+    GLuint                  vertexArray;
+    bool                    vertexArrayValid;
+
+    /* index buffer, the buffer itself is part of vertexBindings */
+    GLintptr                indexOffset;
+    GLenum                  indexType;
+    uint32_t                indexSize;
+
+    /* indirect draw arguments */
+    GLuint                  indirectBuffer;
 
     /* program */
     GLuint                  program;
-    VGpuPipeline            currentPipeline;
+    const _VGpuGLPipeline*  currentPipeline;
 
     /* Texture */
     GLuint                  activeTexture;
-    VGpuTexture             textures[_VGPU_GL_MAX_TEXTURES];
+    const _VGpuGLTexture*   textures[_VGPU_GL_MAX_TEXTURES];
+
+    /* resources set through vgpuSetUniformBuffer and vgpuSetTexture, applied at draw */
+    _VGpuGLUniformBufferBinding uniformBuffers[VGPU_MAX_UNIFORM_BUFFER_BINDINGS];
+    _VGpuGLUniformBufferBinding boundUniformBuffers[VGPU_MAX_UNIFORM_BUFFER_BINDINGS];
+    const _VGpuGLTexture*   textureBindings[VGPU_MAX_TEXTURE_BINDINGS];
 
     /* Buffer */
     uint32_t                buffers[_VGPU_GL_BUFFER_TYPE_COUNT];
 } _vgpu_gl_cache;
 
-struct {
+typedef struct _vgpu_gl_transient_ring {
+    VGpuBuffer              buffer;
+    uint64_t                offset;
+    uint32_t                frameIndex;
+} _vgpu_gl_transient_ring;
+
+/* One segment per frame in flight, a segment is reused once the fence of the frame that last wrote it signals. */
+typedef struct _vgpu_gl_transient {
+    uint64_t                frameSize;
+    uint32_t                frameCount;
+    bool                    waited;
+    GLsync                  fences[_VGPU_GL_MAX_FRAMES_IN_FLIGHT];
+    _vgpu_gl_transient_ring rings[_VGPU_GL_BUFFER_TYPE_COUNT];
+} _vgpu_gl_transient;
+
+/* GL_TIME_ELAPSED queries per render pass, read back when the frame slot comes around again so results are normally ready. */
+typedef struct _vgpu_gl_timer {
+    bool                    enabled;
+    bool                    active;
+    GLuint                  queries[_VGPU_GL_MAX_FRAMES_IN_FLIGHT][VGPU_MAX_TIMED_RENDER_PASSES];
+    uint32_t                counts[_VGPU_GL_MAX_FRAMES_IN_FLIGHT];
+    uint32_t                frames[_VGPU_GL_MAX_FRAMES_IN_FLIGHT];
+} _vgpu_gl_timer;
+
+static struct {
     bool                    initialized;
     uint32_t                frameIndex;
     _vgpu_gl_features       features;
     VGpuLimits              limits;
     _vgpu_gl_cache          state;
+    _vgpu_gl_transient      transient;
+    uint32_t                completedFrame; /* every frame up to this one finished on the GPU */
+    _VGpuPool*              textures;
+    _VGpuPool*              buffers;
+    _VGpuPool*              shaders;
+    _VGpuPool*              pipelines;
+    _VGpuGLVertexArray      vertexArrays[_VGPU_GL_VERTEX_ARRAY_CACHE_SIZE];
+    uint32_t                vertexArrayCount;
+    VGpuStateCacheCounters  counters;       /* last completed frame */
+    VGpuStateCacheCounters  frameCounters;  /* frame being recorded */
+    VGpuFrameStats          stats;          /* last completed frame */
+    VGpuFrameStats          frameStats;     /* frame being recorded */
+    _vgpu_gl_timer          timer;
     bool                    srgb;
     GLsizei                 width;
     GLsizei                 height;
@@ -215,6 +433,28 @@ struct {
 
 extern void _vgpu_log(vgpu_log_type type, const char *message);
 
+/* Resolve a handle, NULL handles resolve to NULL silently while stale ones and use after vgpuShutdown are reported. */
+static void* _vgpuGLLookup(const _VGpuPool* pool, uint32_t id, const char* function) {
+    void* item = _vgpu_pool_get(pool, id);
+    if (!item && id) {
+        char message[128];
+        snprintf(message, sizeof(message), pool ? "%s: invalid or destroyed handle\n" : "%s: vgpu is not initialized\n", function);
+        _vgpu_log(vgpu_log_type_error, message);
+    }
+    return item;
+}
+
+#define _VGPU_GL_TEXTURE(handle)    ((_VGpuGLTexture*)_vgpuGLLookup(_gl.textures, _VGPU_HANDLE_ID(handle), __func__))
+#define _VGPU_GL_BUFFER(handle)     ((_VGpuGLBuffer*)_vgpuGLLookup(_gl.buffers, _VGPU_HANDLE_ID(handle), __func__))
+#define _VGPU_GL_SHADER(handle)     ((_VGpuGLShader*)_vgpuGLLookup(_gl.shaders, _VGPU_HANDLE_ID(handle), __func__))
+#define _VGPU_GL_PIPELINE(handle)   ((_VGpuGLPipeline*)_vgpuGLLookup(_gl.pipelines, _VGPU_HANDLE_ID(handle), __func__))
+
+static void _vgpuGLCollectRetired(uint32_t completedFrame);
+
+/* Evaluates to changed and counts the state call as issued or skipped. */
+#define _VGPU_GL_STATE_CHANGED(changed) \
+    ((changed) ? (_gl.frameCounters.stateCalls++, true) : (_gl.frameCounters.skippedCalls++, false))
+
 static int32_t _vgpuGLGetInt(GLenum param) {
     GLint attr = 0;
     glGetIntegerv(param, &attr);
@@ -337,6 +577,50 @@ static GLenum _vgpuConvertCompareFunction(VGpuCompareFunction func)
     return GL_ALWAYS;
 }
 
+static GLenum _vgpuGLConvertStencilOperation(VGpuStencilOperation operation) {
+    switch (operation) {
+    case VGPU_STENCIL_OPERATION_KEEP: return GL_KEEP;
+    case VGPU_STENCIL_OPERATION_ZERO: return GL_ZERO;
+    case VGPU_STENCIL_OPERATION_REPLACE: return GL_REPLACE;
+    case VGPU_STENCIL_OPERATION_INCREMENT_CLAMP: return GL_INCR;
+    case VGPU_STENCIL_OPERATION_INVERT: return GL_INVERT;
+    case VGPU_STENCIL_OPERATION_DECREMENT_CLAMP: return GL_DECR;
+    case VGPU_STENCIL_OPERATION_INCREMENT_WRAP: return GL_INCR_WRAP;
+    case VGPU_STENCIL_OPERATION_DECREMENT_WRAP: return GL_DECR_WRAP;
+    default: _VGPU_UNREACHABLE; return GL_KEEP;
+    }
+}
+
+static GLenum _vgpuGLConvertBlendFactor(VGpuBlendFactor factor) {
+    switch (factor) {
+    case VGPU_BLEND_FACTOR_ZERO: return GL_ZERO;
+    case VGPU_BLEND_FACTOR_ONE: return GL_ONE;
+    case VGPU_BLEND_FACTOR_SRC_COLOR: return GL_SRC_COLOR;
+    case VGPU_BLEND_FACTOR_ONE_MINUS_SRC_COLOR: return GL_ONE_MINUS_SRC_COLOR;
+    case VGPU_BLEND_FACTOR_SRC_ALPHA: return GL_SRC_ALPHA;
+    case VGPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA: return GL_ONE_MINUS_SRC_ALPHA;
+    case VGPU_BLEND_FACTOR_DST_COLOR: return GL_DST_COLOR;
+    case VGPU_BLEND_FACTOR_ONE_MINUS_DST_COLOR: return GL_ONE_MINUS_DST_COLOR;
+    case VGPU_BLEND_FACTOR_DST_ALPHA: return GL_DST_ALPHA;
+    case VGPU_BLEND_FACTOR_ONE_MINUS_DST_ALPHA: return GL_ONE_MINUS_DST_ALPHA;
+    case VGPU_BLEND_FACTOR_SRC_ALPHA_SATURATED: return GL_SRC_ALPHA_SATURATE;
+    case VGPU_BLEND_FACTOR_BLEND_COLOR: return GL_CONSTANT_COLOR;
+    case VGPU_BLEND_FACTOR_ONE_MINUS_BLEND_COLOR: return GL_ONE_MINUS_CONSTANT_COLOR;
+    default: _VGPU_UNREACHABLE; return GL_ONE;
+    }
+}
+
+static GLenum _vgpuGLConvertBlendOperation(VGpuBlendOperation operation) {
+    switch (operation) {
+    case VGPU_BLEND_OPERATION_ADD: return GL_FUNC_ADD;
+    case VGPU_BLEND_OPERATION_SUBTRACT: return GL_FUNC_SUBTRACT;
+    case VGPU_BLEND_OPERATION_REVERSE_SUBTRACT: return GL_FUNC_REVERSE_SUBTRACT;
+    case VGPU_BLEND_OPERATION_MIN: return GL_MIN;
+    case VGPU_BLEND_OPERATION_MAX: return GL_MAX;
+    default: _VGPU_UNREACHABLE; return GL_FUNC_ADD;
+    }
+}
+
 static GLenum _vgpuGLConvertTextureType(VGpuTextureType type, bool is_array) {
     switch (type)
     {
@@ -357,13 +641,110 @@ static GLenum _vgpuGLConvertTextureType(VGpuTextureType type, bool is_array) {
     }
 }
 
+typedef struct _VGpuGLPixelFormat {
+    VGpuPixelFormat pixelFormat;
+    GLenum          internalFormat;
+    GLenum          format;         /* 0 for compressed formats */
+    GLenum          type;
+} _VGpuGLPixelFormat;
+
+static const _VGpuGLPixelFormat _vgpuGLPixelFormats[] = {
+    { VGPU_PIXEL_FORMAT_UNDEFINED,          0,                                          0,                  0 },
+    /* A8 is stored in the red channel. */
+    { VGPU_PIXEL_FORMAT_A8_UNORM,           GL_R8,                                      GL_RED,             GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_R8_UNORM,           GL_R8,                                      GL_RED,             GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_R8_SNORM,           GL_R8_SNORM,                                GL_RED,             GL_BYTE },
+    { VGPU_PIXEL_FORMAT_R8_UINT,            GL_R8UI,                                    GL_RED_INTEGER,     GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_R8_SINT,            GL_R8I,                                     GL_RED_INTEGER,     GL_BYTE },
+    { VGPU_PIXEL_FORMAT_R16_UNORM,          GL_R16,                                     GL_RED,             GL_UNSIGNED_SHORT },
+    { VGPU_PIXEL_FORMAT_R16_SNORM,          GL_R16_SNORM,                               GL_RED,             GL_SHORT },
+    { VGPU_PIXEL_FORMAT_R16_UINT,           GL_R16UI,                                   GL_RED_INTEGER,     GL_UNSIGNED_SHORT },
+    { VGPU_PIXEL_FORMAT_R16_SINT,           GL_R16I,                                    GL_RED_INTEGER,     GL_SHORT },
+    { VGPU_PIXEL_FORMAT_R16_FLOAT,          GL_R16F,                                    GL_RED,             GL_HALF_FLOAT },
+    { VGPU_PIXEL_FORMAT_RG8_UNORM,          GL_RG8,                                     GL_RG,              GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_RG8_SNORM,          GL_RG8_SNORM,                               GL_RG,              GL_BYTE },
+    { VGPU_PIXEL_FORMAT_RG8_UINT,           GL_RG8UI,                                   GL_RG_INTEGER,      GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_RG8_SINT,           GL_RG8I,                                    GL_RG_INTEGER,      GL_BYTE },
+    { VGPU_PIXEL_FORMAT_R5G6B5_UNORM,       GL_RGB565,                                  GL_RGB,             GL_UNSIGNED_SHORT_5_6_5 },
+    { VGPU_PIXEL_FORMAT_RGBA4_UNORM,        GL_RGBA4,                                   GL_RGBA,            GL_UNSIGNED_SHORT_4_4_4_4 },
+    { VGPU_PIXEL_FORMAT_R32_UINT,           GL_R32UI,                                   GL_RED_INTEGER,     GL_UNSIGNED_INT },
+    { VGPU_PIXEL_FORMAT_R32_SINT,           GL_R32I,                                    GL_RED_INTEGER,     GL_INT },
+    { VGPU_PIXEL_FORMAT_R32_FLOAT,          GL_R32F,                                    GL_RED,             GL_FLOAT },
+    { VGPU_PIXEL_FORMAT_RG16_UNORM,         GL_RG16,                                    GL_RG,              GL_UNSIGNED_SHORT },
+    { VGPU_PIXEL_FORMAT_RG16_SNORM,         GL_RG16_SNORM,                              GL_RG,              GL_SHORT },
+    { VGPU_PIXEL_FORMAT_RG16_UINT,          GL_RG16UI,                                  GL_RG_INTEGER,      GL_UNSIGNED_SHORT },
+    { VGPU_PIXEL_FORMAT_RG16_SINT,          GL_RG16I,                                   GL_RG_INTEGER,      GL_SHORT },
+    { VGPU_PIXEL_FORMAT_RG16_FLOAT,         GL_RG16F,                                   GL_RG,              GL_HALF_FLOAT },
+    { VGPU_PIXEL_FORMAT_RGBA8_UNORM,        GL_RGBA8,                                   GL_RGBA,            GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_RGBA8_UNORM_SRGB,   GL_SRGB8_ALPHA8,                            GL_RGBA,            GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_RGBA8_SNORM,        GL_RGBA8_SNORM,                             GL_RGBA,            GL_BYTE },
+    { VGPU_PIXEL_FORMAT_RGBA8_UINT,         GL_RGBA8UI,                                 GL_RGBA_INTEGER,    GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_RGBA8_SINT,         GL_RGBA8I,                                  GL_RGBA_INTEGER,    GL_BYTE },
+    { VGPU_PIXEL_FORMAT_BGRA8_UNORM,        GL_RGBA8,                                   GL_BGRA,            GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_BGRA8_UNORM_SRGB,   GL_SRGB8_ALPHA8,                            GL_BGRA,            GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_RGB10A2_UNORM,      GL_RGB10_A2,                                GL_RGBA,            GL_UNSIGNED_INT_2_10_10_10_REV },
+    { VGPU_PIXEL_FORMAT_RGB10A2_UINT,       GL_RGB10_A2UI,                              GL_RGBA_INTEGER,    GL_UNSIGNED_INT_2_10_10_10_REV },
+    { VGPU_PIXEL_FORMAT_RG11B10_FLOAT,      GL_R11F_G11F_B10F,                          GL_RGB,             GL_UNSIGNED_INT_10F_11F_11F_REV },
+    { VGPU_PIXEL_FORMAT_RGB9E5_FLOAT,       GL_RGB9_E5,                                 GL_RGB,             GL_UNSIGNED_INT_5_9_9_9_REV },
+    { VGPU_PIXEL_FORMAT_RG32_UINT,          GL_RG32UI,                                  GL_RG_INTEGER,      GL_UNSIGNED_INT },
+    { VGPU_PIXEL_FORMAT_RG32_SINT,          GL_RG32I,                                   GL_RG_INTEGER,      GL_INT },
+    { VGPU_PIXEL_FORMAT_RG32_FLOAT,         GL_RG32F,                                   GL_RG,              GL_FLOAT },
+    { VGPU_PIXEL_FORMAT_RGBA16_UNORM,       GL_RGBA16,                                  GL_RGBA,            GL_UNSIGNED_SHORT },
+    { VGPU_PIXEL_FORMAT_RGBA16_SNORM,       GL_RGBA16_SNORM,                            GL_RGBA,            GL_SHORT },
+    { VGPU_PIXEL_FORMAT_RGBA16_UINT,        GL_RGBA16UI,                                GL_RGBA_INTEGER,    GL_UNSIGNED_SHORT },
+    { VGPU_PIXEL_FORMAT_RGBA16_SINT,        GL_RGBA16I,                                 GL_RGBA_INTEGER,    GL_SHORT },
+    { VGPU_PIXEL_FORMAT_RGBA16_FLOAT,       GL_RGBA16F,                                 GL_RGBA,            GL_HALF_FLOAT },
+    { VGPU_PIXEL_FORMAT_RGBA32_UINT,        GL_RGBA32UI,                                GL_RGBA_INTEGER,    GL_UNSIGNED_INT },
+    { VGPU_PIXEL_FORMAT_RGBA32_SINT,        GL_RGBA32I,                                 GL_RGBA_INTEGER,    GL_INT },
+    { VGPU_PIXEL_FORMAT_RGBA32_FLOAT,       GL_RGBA32F,                                 GL_RGBA,            GL_FLOAT },
+    { VGPU_PIXEL_FORMAT_D16_UNORM,          GL_DEPTH_COMPONENT16,                       GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT },
+    { VGPU_PIXEL_FORMAT_D32_FLOAT,          GL_DEPTH_COMPONENT32F,                      GL_DEPTH_COMPONENT, GL_FLOAT },
+    { VGPU_PIXEL_FORMAT_D24_UNORM_S8_UINT,  GL_DEPTH24_STENCIL8,                        GL_DEPTH_STENCIL,   GL_UNSIGNED_INT_24_8 },
+    { VGPU_PIXEL_FORMAT_D32_FLOAT_S8_UINT,  GL_DEPTH32F_STENCIL8,                       GL_DEPTH_STENCIL,   GL_FLOAT_32_UNSIGNED_INT_24_8_REV },
+    { VGPU_PIXEL_FORMAT_S8,                 GL_STENCIL_INDEX8,                          GL_STENCIL_INDEX,   GL_UNSIGNED_BYTE },
+    { VGPU_PIXEL_FORMAT_BC1_UNORM,          GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,           0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC1_UNORM_SRGB,     GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,     0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC2_UNORM,          GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,           0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC2_UNORM_SRGB,     GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,     0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC3_UNORM,          GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,           0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC3_UNORM_SRGB,     GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,     0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC4_UNORM,          GL_COMPRESSED_RED_RGTC1,                    0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC4_SNORM,          GL_COMPRESSED_SIGNED_RED_RGTC1,             0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC5_UNORM,          GL_COMPRESSED_RG_RGTC2,                     0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC5_SNORM,          GL_COMPRESSED_SIGNED_RG_RGTC2,              0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC6HS16,            GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,        0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC6HU16,            GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,      0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC7_UNORM,          GL_COMPRESSED_RGBA_BPTC_UNORM,              0,                  0 },
+    { VGPU_PIXEL_FORMAT_BC7_UNORM_SRGB,     GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,        0,                  0 },
+    { VGPU_PIXEL_FORMAT_PVRTC_RGB2,         GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG,         0,                  0 },
+    { VGPU_PIXEL_FORMAT_PVRTC_RGBA2,        GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG,        0,                  0 },
+    { VGPU_PIXEL_FORMAT_PVRTC_RGB4,         GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG,         0,                  0 },
+    { VGPU_PIXEL_FORMAT_PVRTC_RGBA4,        GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG,        0,                  0 },
+    { VGPU_PIXEL_FORMAT_ETC2_RGB8,          GL_COMPRESSED_RGB8_ETC2,                    0,                  0 },
+    { VGPU_PIXEL_FORMAT_ETC2_RGB8A1,        GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC4x4,            GL_COMPRESSED_RGBA_ASTC_4x4_KHR,            0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC5x5,            GL_COMPRESSED_RGBA_ASTC_5x5_KHR,            0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC6x6,            GL_COMPRESSED_RGBA_ASTC_6x6_KHR,            0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC8x5,            GL_COMPRESSED_RGBA_ASTC_8x5_KHR,            0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC8x6,            GL_COMPRESSED_RGBA_ASTC_8x6_KHR,            0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC8x8,            GL_COMPRESSED_RGBA_ASTC_8x8_KHR,            0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC10x10,          GL_COMPRESSED_RGBA_ASTC_10x10_KHR,          0,                  0 },
+    { VGPU_PIXEL_FORMAT_ASTC12x12,          GL_COMPRESSED_RGBA_ASTC_12x12_KHR,          0,                  0 },
+};
+
+static const _VGpuGLPixelFormat* _vgpuGLGetPixelFormat(VGpuPixelFormat format) {
+    _VGPU_ASSERT(format < VGPU_PIXEL_FORMAT_COUNT);
+    _VGPU_ASSERT(_vgpuGLPixelFormats[format].pixelFormat == format);
+    return &_vgpuGLPixelFormats[format];
+}
+
 static _VGpuGLBufferType _vgpuGLConvertBufferUsage(VGpuBufferUsage usage) {
     if (usage & VGPU_BUFFER_USAGE_UNIFORM) {
         return _VGPU_GL_BUFFER_UNIFORM;
     }
 
     if ((usage & VGPU_BUFFER_USAGE_STORAGE_READ)
-        || (usage & VGPU_BUFFER_USAGE_STORAGE_READ)) {
+        || (usage & VGPU_BUFFER_USAGE_STORAGE_WRITE)) {
         return _VGPU_GL_BUFFER_SHADER_STORAGE;
     }
 
@@ -372,7 +753,7 @@ static _VGpuGLBufferType _vgpuGLConvertBufferUsage(VGpuBufferUsage usage) {
     }
 
     if (usage & VGPU_BUFFER_USAGE_INDEX) {
-        return _VGPU_GL_BUFFER_UNIFORM;
+        return _VGPU_GL_BUFFER_INDEX;
     }
 
     return 0;
@@ -467,7 +848,7 @@ void _vgpu_gl_reset_state_cache()
 
     for (uint32_t i = 0; i < _VGPU_GL_BUFFER_TYPE_COUNT; ++i) {
         _gl.state.buffers[i] = 0;
-        glBindBuffer(_vgpuGLConvertBufferType(i), 0);
+        glBindBuffer(i == _VGPU_GL_BUFFER_INDEX ? GL_COPY_WRITE_BUFFER : _vgpuGLConvertBufferType(i), 0);
     }
     _VGPU_CHECK_ERROR();
 
@@ -476,6 +857,24 @@ void _vgpu_gl_reset_state_cache()
         _VGPU_CHECK_ERROR();
     }
 
+    memset(&_gl.state.vertexBindings, 0, sizeof(_gl.state.vertexBindings));
+    _gl.state.indexOffset = 0;
+    _gl.state.indexType = GL_UNSIGNED_SHORT;
+    _gl.state.indexSize = 2;
+#if !defined(VGPU_WEBGL)
+    _gl.state.indirectBuffer = 0;
+    if (_gl.features.drawIndirect) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+#endif
+    memset(_gl.state.uniformBuffers, 0, sizeof(_gl.state.uniformBuffers));
+    memset(_gl.state.boundUniformBuffers, 0, sizeof(_gl.state.boundUniformBuffers));
+    memset(_gl.state.textures, 0, sizeof(_gl.state.textures));
+    memset(_gl.state.textureBindings, 0, sizeof(_gl.state.textureBindings));
+    _gl.state.vertexArray = _gl.default_vao;
+    _gl.state.vertexArrayValid = false;
+    glBindVertexArray(_gl.default_vao);
+
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 #ifndef VGPU_WEBGL
@@ -489,30 +888,30 @@ void _vgpu_gl_reset_state_cache()
     }
 #endif
 
-    /* depth-stencil state */
-    _gl.state.depthWriteEnabled = true;
-    _gl.state.depthCompareFunction = VGPU_COMPARE_FUNCTION_LESS_EQUAL;
-    if (_gl.state.depthCompareFunction == VGPU_COMPARE_FUNCTION_ALWAYS
-        && !_gl.state.depthWriteEnabled)
-    {
-        glDisable(GL_DEPTH_TEST);
-
-    }
-    else
-    {
-        glEnable(GL_DEPTH_TEST);
-    }
-
-    if (_gl.state.depthWriteEnabled) {
-        glDepthMask(GL_TRUE);
-    }
-    else {
-        glDepthMask(GL_FALSE);
-    }
-
-    glDepthFunc(_vgpuConvertCompareFunction(_gl.state.depthCompareFunction));
+    /* Mirror of the GL defaults below, pipelines are diffed against it. */
+    _VGpuGLRenderState* render = &_gl.state.render;
+    memset(render, 0, sizeof(*render));
+    render->depthTest = true;
+    render->depthWrite = true;
+    render->depthFunc = GL_LEQUAL;
+    render->stencilFront.func = render->stencilBack.func = GL_ALWAYS;
+    render->stencilFront.fail = render->stencilBack.fail = GL_KEEP;
+    render->stencilFront.depthFail = render->stencilBack.depthFail = GL_KEEP;
+    render->stencilFront.pass = render->stencilBack.pass = GL_KEEP;
+    for (uint32_t i = 0; i < VGPU_MAX_COLOR_ATTACHMENTS; i++) {
+        render->blend[i].srcRGB = render->blend[i].srcAlpha = GL_ONE;
+        render->blend[i].dstRGB = render->blend[i].dstAlpha = GL_ZERO;
+        render->blend[i].opRGB = render->blend[i].opAlpha = GL_FUNC_ADD;
+        render->blend[i].writeMask = VGPU_COLOR_WRITE_MASK_ALL;
+    }
+    render->cullFace = GL_BACK;
+    render->frontFace = GL_CW;
+    _gl.state.stencilRef = 0;
 
-    _gl.state.stencilEnabled = false;
+    /* depth-stencil state */
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LEQUAL);
     glDisable(GL_STENCIL_TEST);
     glStencilFunc(GL_ALWAYS, 0, 0);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
@@ -524,10 +923,8 @@ void _vgpu_gl_reset_state_cache()
     glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glBlendColor(0.0f, 0.0f, 0.0f, 0.0f);
-    _gl.state.alphaToCoverage = false;
     glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
 
-
     /* rasterizer state */
     glPolygonOffset(0.0f, 0.0f);
     glDisable(GL_POLYGON_OFFSET_FILL);
@@ -535,9 +932,7 @@ void _vgpu_gl_reset_state_cache()
     glCullFace(GL_BACK);
     glFrontFace(GL_CW);
     glEnable(GL_SCISSOR_TEST);
-    glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
     glEnable(GL_DITHER);
-    glDisable(GL_POLYGON_OFFSET_FILL);
     //glLineWidth(1.0f);
 #ifdef VGPU_GLES
     //glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
@@ -549,13 +944,14 @@ void _vgpu_gl_reset_state_cache()
 #endif
 }
 
-static void _vgpuGLBindTexture(VGpuTexture texture, uint32_t slot)
+static void _vgpuGLBindTexture(const _VGpuGLTexture* texture, uint32_t slot)
 {
-    _VGPU_ASSERT(slot >= 0 && slot < _VGPU_GL_MAX_TEXTURES);
+    _VGPU_ASSERT(slot < _VGPU_GL_MAX_TEXTURES);
     //texture = texture ? texture : _vgpuGLGetDefaultTexture();
 
-    if (texture != _gl.state.textures[slot]) {
+    if (_VGPU_GL_STATE_CHANGED(texture != _gl.state.textures[slot])) {
         _gl.state.textures[slot] = texture;
+        _gl.frameCounters.textureSwitches++;
         if (_gl.state.activeTexture != slot) {
             glActiveTexture(GL_TEXTURE0 + slot);
             _gl.state.activeTexture = slot;
@@ -566,33 +962,440 @@ static void _vgpuGLBindTexture(VGpuTexture texture, uint32_t slot)
 }
 
 
-static void _vgpuGLBindBuffer(VGpuBuffer buffer) {
-    if (_gl.state.buffers[buffer->gl_type] != buffer->gl_handle) {
+static void _vgpuGLBindBuffer(const _VGpuGLBuffer* buffer) {
+    if (_VGPU_GL_STATE_CHANGED(_gl.state.buffers[buffer->gl_type] != buffer->gl_handle)) {
         _gl.state.buffers[buffer->gl_type] = buffer->gl_handle;
+        _gl.frameStats.bufferBinds++;
         glBindBuffer(buffer->gl_target, buffer->gl_handle);
         _VGPU_CHECK_ERROR();
     }
 }
 
 static void _vgpuGLUseProgram(uint32_t program) {
-    if (_gl.state.program != program) {
+    if (_VGPU_GL_STATE_CHANGED(_gl.state.program != program)) {
         _gl.state.program = program;
+        _gl.frameCounters.programSwitches++;
         glUseProgram(program);
         _VGPU_CHECK_ERROR();
-        /* TODO: Increate shader switches stats */
     }
 }
 
-static void _vgpuGLSetupTexture(VGpuTexture texture, const VGpuTextureDescriptor* descriptor)
+static void _vgpuGLApplyBlendState(const _VGpuGLRenderState* state) {
+    _VGpuGLBlendAttachment* cache = _gl.state.render.blend;
+
+#if defined(VGPU_GL)
+    if (state->independentBlend && _gl.features.independentBlend) {
+        for (GLuint i = 0; i < VGPU_MAX_COLOR_ATTACHMENTS; i++) {
+            const _VGpuGLBlendAttachment* blend = &state->blend[i];
+            if (_VGPU_GL_STATE_CHANGED(cache[i].enabled != blend->enabled)) {
+                if (blend->enabled) {
+                    glEnablei(GL_BLEND, i);
+                }
+                else {
+                    glDisablei(GL_BLEND, i);
+                }
+                cache[i].enabled = blend->enabled;
+            }
+
+            if (blend->enabled) {
+                if (_VGPU_GL_STATE_CHANGED(cache[i].srcRGB != blend->srcRGB || cache[i].dstRGB != blend->dstRGB
+                    || cache[i].srcAlpha != blend->srcAlpha || cache[i].dstAlpha != blend->dstAlpha)) {
+                    glBlendFuncSeparatei(i, blend->srcRGB, blend->dstRGB, blend->srcAlpha, blend->dstAlpha);
+                    cache[i].srcRGB = blend->srcRGB;
+                    cache[i].dstRGB = blend->dstRGB;
+                    cache[i].srcAlpha = blend->srcAlpha;
+                    cache[i].dstAlpha = blend->dstAlpha;
+                }
+
+                if (_VGPU_GL_STATE_CHANGED(cache[i].opRGB != blend->opRGB || cache[i].opAlpha != blend->opAlpha)) {
+                    glBlendEquationSeparatei(i, blend->opRGB, blend->opAlpha);
+                    cache[i].opRGB = blend->opRGB;
+                    cache[i].opAlpha = blend->opAlpha;
+                }
+            }
+
+            if (_VGPU_GL_STATE_CHANGED(cache[i].writeMask != blend->writeMask)) {
+                glColorMaski(i,
+                    (blend->writeMask & VGPU_COLOR_WRITE_MASK_RED) != 0,
+                    (blend->writeMask & VGPU_COLOR_WRITE_MASK_GREEN) != 0,
+                    (blend->writeMask & VGPU_COLOR_WRITE_MASK_BLUE) != 0,
+                    (blend->writeMask & VGPU_COLOR_WRITE_MASK_ALPHA) != 0);
+                cache[i].writeMask = blend->writeMask;
+            }
+        }
+        return;
+    }
+#endif
+
+    /* Shared state, every attachment has to match attachment 0. */
+    const _VGpuGLBlendAttachment* blend = &state->blend[0];
+    bool enabledChanged = false;
+    bool funcChanged = false;
+    bool equationChanged = false;
+    bool maskChanged = false;
+    for (uint32_t i = 0; i < VGPU_MAX_COLOR_ATTACHMENTS; i++) {
+        enabledChanged |= cache[i].enabled != blend->enabled;
+        funcChanged |= cache[i].srcRGB != blend->srcRGB || cache[i].dstRGB != blend->dstRGB
+            || cache[i].srcAlpha != blend->srcAlpha || cache[i].dstAlpha != blend->dstAlpha;
+        equationChanged |= cache[i].opRGB != blend->opRGB || cache[i].opAlpha != blend->opAlpha;
+        maskChanged |= cache[i].writeMask != blend->writeMask;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(enabledChanged)) {
+        if (blend->enabled) {
+            glEnable(GL_BLEND);
+        }
+        else {
+            glDisable(GL_BLEND);
+        }
+    }
+
+    /* Factors and equations are ignored while blending is disabled. */
+    funcChanged = funcChanged && blend->enabled;
+    equationChanged = equationChanged && blend->enabled;
+    if (_VGPU_GL_STATE_CHANGED(funcChanged)) {
+        glBlendFuncSeparate(blend->srcRGB, blend->dstRGB, blend->srcAlpha, blend->dstAlpha);
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(equationChanged)) {
+        glBlendEquationSeparate(blend->opRGB, blend->opAlpha);
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(maskChanged)) {
+        glColorMask(
+            (blend->writeMask & VGPU_COLOR_WRITE_MASK_RED) != 0,
+            (blend->writeMask & VGPU_COLOR_WRITE_MASK_GREEN) != 0,
+            (blend->writeMask & VGPU_COLOR_WRITE_MASK_BLUE) != 0,
+            (blend->writeMask & VGPU_COLOR_WRITE_MASK_ALPHA) != 0);
+    }
+
+    for (uint32_t i = 0; i < VGPU_MAX_COLOR_ATTACHMENTS; i++) {
+        cache[i].enabled = blend->enabled;
+        cache[i].writeMask = blend->writeMask;
+        if (funcChanged) {
+            cache[i].srcRGB = blend->srcRGB;
+            cache[i].dstRGB = blend->dstRGB;
+            cache[i].srcAlpha = blend->srcAlpha;
+            cache[i].dstAlpha = blend->dstAlpha;
+        }
+        if (equationChanged) {
+            cache[i].opRGB = blend->opRGB;
+            cache[i].opAlpha = blend->opAlpha;
+        }
+    }
+}
+
+static void _vgpuGLApplyStencilFace(GLenum face, const _VGpuGLStencilFace* stencil, _VGpuGLStencilFace* cache, GLuint readMask) {
+    if (_VGPU_GL_STATE_CHANGED(cache->func != stencil->func || _gl.state.render.stencilReadMask != readMask)) {
+        glStencilFuncSeparate(face, stencil->func, _gl.state.stencilRef, readMask);
+        cache->func = stencil->func;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(cache->fail != stencil->fail || cache->depthFail != stencil->depthFail || cache->pass != stencil->pass)) {
+        glStencilOpSeparate(face, stencil->fail, stencil->depthFail, stencil->pass);
+        cache->fail = stencil->fail;
+        cache->depthFail = stencil->depthFail;
+        cache->pass = stencil->pass;
+    }
+}
+
+static void _vgpuGLApplyRenderState(const _VGpuGLRenderState* state) {
+    _VGpuGLRenderState* cache = &_gl.state.render;
+
+    /* depth stencil */
+    if (_VGPU_GL_STATE_CHANGED(cache->depthTest != state->depthTest)) {
+        if (state->depthTest) {
+            glEnable(GL_DEPTH_TEST);
+        }
+        else {
+            glDisable(GL_DEPTH_TEST);
+        }
+        cache->depthTest = state->depthTest;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(cache->depthWrite != state->depthWrite)) {
+        glDepthMask(state->depthWrite ? GL_TRUE : GL_FALSE);
+        cache->depthWrite = state->depthWrite;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(cache->depthFunc != state->depthFunc)) {
+        glDepthFunc(state->depthFunc);
+        cache->depthFunc = state->depthFunc;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(cache->stencilTest != state->stencilTest)) {
+        if (state->stencilTest) {
+            glEnable(GL_STENCIL_TEST);
+        }
+        else {
+            glDisable(GL_STENCIL_TEST);
+        }
+        cache->stencilTest = state->stencilTest;
+    }
+
+    if (state->stencilTest) {
+        if (_VGPU_GL_STATE_CHANGED(cache->stencilWriteMask != state->stencilWriteMask)) {
+            glStencilMask(state->stencilWriteMask);
+            cache->stencilWriteMask = state->stencilWriteMask;
+        }
+
+        _vgpuGLApplyStencilFace(GL_FRONT, &state->stencilFront, &cache->stencilFront, state->stencilReadMask);
+        _vgpuGLApplyStencilFace(GL_BACK, &state->stencilBack, &cache->stencilBack, state->stencilReadMask);
+        cache->stencilReadMask = state->stencilReadMask;
+    }
+
+    /* blend */
+    _vgpuGLApplyBlendState(state);
+
+    /* rasterizer */
+    if (_VGPU_GL_STATE_CHANGED(cache->alphaToCoverage != state->alphaToCoverage)) {
+        if (state->alphaToCoverage) {
+            glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+        }
+        else {
+            glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+        }
+        cache->alphaToCoverage = state->alphaToCoverage;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(cache->cullEnabled != state->cullEnabled)) {
+        if (state->cullEnabled) {
+            glEnable(GL_CULL_FACE);
+        }
+        else {
+            glDisable(GL_CULL_FACE);
+        }
+        cache->cullEnabled = state->cullEnabled;
+    }
+
+    if (state->cullEnabled && _VGPU_GL_STATE_CHANGED(cache->cullFace != state->cullFace)) {
+        glCullFace(state->cullFace);
+        cache->cullFace = state->cullFace;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(cache->frontFace != state->frontFace)) {
+        glFrontFace(state->frontFace);
+        cache->frontFace = state->frontFace;
+    }
+
+    const bool depthBias = state->depthBias != 0.0f || state->depthBiasSlopeScale != 0.0f;
+    const bool cachedDepthBias = cache->depthBias != 0.0f || cache->depthBiasSlopeScale != 0.0f;
+    if (_VGPU_GL_STATE_CHANGED(depthBias != cachedDepthBias)) {
+        if (depthBias) {
+            glEnable(GL_POLYGON_OFFSET_FILL);
+        }
+        else {
+            glDisable(GL_POLYGON_OFFSET_FILL);
+        }
+    }
+
+    if (depthBias && _VGPU_GL_STATE_CHANGED(cache->depthBias != state->depthBias || cache->depthBiasSlopeScale != state->depthBiasSlopeScale)) {
+        glPolygonOffset(state->depthBiasSlopeScale, state->depthBias);
+    }
+    cache->depthBias = state->depthBias;
+    cache->depthBiasSlopeScale = state->depthBiasSlopeScale;
+    _VGPU_CHECK_ERROR();
+}
+
+static uint32_t _vgpuGLHashVertexArray(const _VGpuGLPipeline* pipeline, const _VGpuGLVertexBindings* bindings) {
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+    const uint8_t* bytes = (const uint8_t*)&pipeline;
+    for (size_t i = 0; i < sizeof(pipeline); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    bytes = (const uint8_t*)bindings->buffers;
+    for (size_t i = 0; i < sizeof(bindings->buffers); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    bytes = (const uint8_t*)&bindings->indexBuffer;
+    for (size_t i = 0; i < sizeof(bindings->indexBuffer); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void _vgpuGLReleaseVertexArray(_VGpuGLVertexArray* entry) {
+    if (!entry->pipeline) {
+        return;
+    }
+
+    if (_gl.state.vertexArray == entry->vao) {
+        glBindVertexArray(_gl.default_vao);
+        _gl.state.vertexArray = _gl.default_vao;
+        _gl.state.vertexArrayValid = false;
+    }
+
+    glDeleteVertexArrays(1, &entry->vao);
+    memset(entry, 0, sizeof(*entry));
+    _gl.vertexArrayCount--;
+}
+
+/* Drop cached vertex arrays that reference a destroyed pipeline or buffer. */
+static void _vgpuGLInvalidateVertexArrays(const _VGpuGLPipeline* pipeline, GLuint buffer) {
+    for (uint32_t i = 0; i < _VGPU_GL_VERTEX_ARRAY_CACHE_SIZE; i++) {
+        _VGpuGLVertexArray* entry = &_gl.vertexArrays[i];
+        if (!entry->pipeline) {
+            continue;
+        }
+
+        bool release = (pipeline && entry->pipeline == pipeline) || (buffer && entry->bindings.indexBuffer == buffer);
+        for (uint32_t binding = 0; binding < VGPU_MAX_VERTEX_BUFFER_BINDINGS && buffer && !release; binding++) {
+            release = entry->bindings.buffers[binding] == buffer;
+        }
+
+        if (release) {
+            _vgpuGLReleaseVertexArray(entry);
+        }
+    }
+}
+
+/* Point the attributes of the bound vertex array that read a binding in mask at the current buffer offsets. */
+static void _vgpuGLPointVertexAttributes(const _VGpuGLPipeline* pipeline, const _VGpuGLVertexBindings* bindings, uint32_t mask) {
+    if (_gl.features.vertexAttribBinding) {
+        for (uint32_t binding = 0; binding < VGPU_MAX_VERTEX_BUFFER_BINDINGS; binding++) {
+            if (!(mask & (1u << binding)) || !bindings->buffers[binding]) {
+                continue;
+            }
+
+            for (uint32_t i = 0; i < VGPU_MAX_VERTEX_ATTRIBUTES; i++) {
+                if (pipeline->gl_attrs[i].vb_index == (int8_t)binding) {
+                    glBindVertexBuffer(binding, bindings->buffers[binding], bindings->offsets[binding], pipeline->gl_attrs[i].stride);
+                    break;
+                }
+            }
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < VGPU_MAX_VERTEX_ATTRIBUTES; i++) {
+        const _VGpuGLVertexAttribute* gl_attr = &pipeline->gl_attrs[i];
+        if (gl_attr->vb_index < 0 || !(mask & (1u << gl_attr->vb_index))) {
+            continue;
+        }
+
+        const GLuint buffer = bindings->buffers[gl_attr->vb_index];
+        if (!buffer) {
+            continue;
+        }
+
+        if (_gl.state.buffers[_VGPU_GL_BUFFER_VERTEX] != buffer) {
+            _gl.state.buffers[_VGPU_GL_BUFFER_VERTEX] = buffer;
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        }
+
+        const GLintptr offset = bindings->offsets[gl_attr->vb_index] + gl_attr->offset;
+        if (gl_attr->integer) {
+            glVertexAttribIPointer(i, gl_attr->size, gl_attr->type, gl_attr->stride, (const GLvoid*)offset);
+        }
+        else {
+            glVertexAttribPointer(i, gl_attr->size, gl_attr->type, gl_attr->normalized, gl_attr->stride, (const GLvoid*)offset);
+        }
+    }
+}
+
+static GLuint _vgpuGLCreateVertexArray(const _VGpuGLPipeline* pipeline, const _VGpuGLVertexBindings* bindings) {
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    _gl.state.vertexArray = vao;
+
+    if (bindings->indexBuffer) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bindings->indexBuffer);
+    }
+
+    for (uint32_t i = 0; i < VGPU_MAX_VERTEX_ATTRIBUTES; i++) {
+        const _VGpuGLVertexAttribute* gl_attr = &pipeline->gl_attrs[i];
+        if (gl_attr->vb_index < 0 || !bindings->buffers[gl_attr->vb_index]) {
+            continue;
+        }
+
+        if (_gl.features.vertexAttribBinding) {
+            /* Format is fixed per pipeline, only the buffer binding moves. */
+            if (gl_attr->integer) {
+                glVertexAttribIFormat(i, gl_attr->size, gl_attr->type, (GLuint)gl_attr->offset);
+            }
+            else {
+                glVertexAttribFormat(i, gl_attr->size, gl_attr->type, gl_attr->normalized, (GLuint)gl_attr->offset);
+            }
+            glVertexAttribBinding(i, (GLuint)gl_attr->vb_index);
+            glVertexBindingDivisor((GLuint)gl_attr->vb_index, gl_attr->divisor);
+        }
+        else {
+            glVertexAttribDivisor(i, gl_attr->divisor);
+        }
+        glEnableVertexAttribArray(i);
+    }
+
+    _vgpuGLPointVertexAttributes(pipeline, bindings, (1u << VGPU_MAX_VERTEX_BUFFER_BINDINGS) - 1u);
+    _VGPU_CHECK_ERROR();
+
+    return vao;
+}
+
+static GLuint _vgpuGLGetVertexArray(const _VGpuGLPipeline* pipeline, const _VGpuGLVertexBindings* bindings) {
+    const uint32_t hash = _vgpuGLHashVertexArray(pipeline, bindings);
+    _VGpuGLVertexArray* entry = NULL;
+    for (uint32_t probe = 0; probe < _VGPU_GL_VERTEX_ARRAY_PROBE_COUNT; probe++) {
+        _VGpuGLVertexArray* candidate = &_gl.vertexArrays[(hash + probe) & (_VGPU_GL_VERTEX_ARRAY_CACHE_SIZE - 1)];
+        if (candidate->pipeline == pipeline
+            && candidate->bindings.indexBuffer == bindings->indexBuffer
+            && memcmp(candidate->bindings.buffers, bindings->buffers, sizeof(bindings->buffers)) == 0) {
+            _gl.frameCounters.vertexArrayHits++;
+
+            uint32_t changed = 0;
+            for (uint32_t binding = 0; binding < VGPU_MAX_VERTEX_BUFFER_BINDINGS; binding++) {
+                if (candidate->bindings.offsets[binding] != bindings->offsets[binding]) {
+                    candidate->bindings.offsets[binding] = bindings->offsets[binding];
+                    changed |= 1u << binding;
+                }
+            }
+
+            if (changed) {
+                if (_gl.state.vertexArray != candidate->vao) {
+                    glBindVertexArray(candidate->vao);
+                    _gl.state.vertexArray = candidate->vao;
+                }
+                _vgpuGLPointVertexAttributes(pipeline, bindings, changed);
+                _VGPU_CHECK_ERROR();
+            }
+            return candidate->vao;
+        }
+
+        if (!entry && !candidate->pipeline) {
+            entry = candidate;
+        }
+    }
+
+    /* Probe window full, evict the home slot. */
+    if (!entry) {
+        entry = &_gl.vertexArrays[hash & (_VGPU_GL_VERTEX_ARRAY_CACHE_SIZE - 1)];
+        _vgpuGLReleaseVertexArray(entry);
+    }
+
+    _gl.frameCounters.vertexArrayMisses++;
+    entry->pipeline = pipeline;
+    entry->bindings = *bindings;
+    entry->vao = _vgpuGLCreateVertexArray(pipeline, bindings);
+    _gl.vertexArrayCount++;
+    return entry->vao;
+}
+
+static void _vgpuGLSetupTexture(_VGpuGLTexture* texture, const VGpuTextureDescriptor* descriptor)
 {
     texture->textureType = descriptor->textureType;
     texture->pixelFormat = descriptor->pixelFormat;
     texture->size = descriptor->size;
-    texture->mipLevels = descriptor->mipLevels;
-    texture->arrayLayers = descriptor->arrayLayers;
+    texture->mipLevels = descriptor->mipLevels > 0 ? descriptor->mipLevels : 1;
+    texture->arrayLayers = descriptor->arrayLayers > 0 ? descriptor->arrayLayers : 1;
+    texture->layerCount = vgpuGetTextureLayerCount(descriptor);
     texture->samples = descriptor->samples;
     texture->usage = descriptor->usage;
     texture->gl_target = _vgpuGLConvertTextureType(descriptor->textureType, descriptor->arrayLayers > 1);
+    if (texture->gl_target == GL_TEXTURE_CUBE_MAP) {
+        /* Cube arrays are unsupported, only the first cube is addressable. */
+        texture->layerCount = 6;
+    }
 }
 
 VGpuBackend vgpuGetBackend() {
@@ -728,6 +1531,20 @@ bool vgpuInitialize(const char* appName, const VGpuRendererSettings* settings)
             _gl.features.clipControl = true;
         }
     }
+
+    // Core in 4.0/4.3 and GLES 3.1, only usable when the loader resolved the entry points.
+    _gl.features.drawIndirect = glDrawArraysIndirect != NULL && glDrawElementsIndirect != NULL;
+    _gl.features.multiDrawIndirect = _gl.features.drawIndirect
+        && glMultiDrawArraysIndirect != NULL && glMultiDrawElementsIndirect != NULL;
+    // Core in 4.3 and GLES 3.1, desktop GL only loads the entry points through GL_ARB_vertex_attrib_binding.
+#if defined(VGPU_GLES)
+    _gl.features.vertexAttribBinding = _gl.version_major > 3 || (_gl.version_major == 3 && _gl.version_minor >= 1);
+#else
+    _gl.features.vertexAttribBinding = GLAD_GL_ARB_vertex_attrib_binding != 0;
+#endif
+    _gl.features.vertexAttribBinding = _gl.features.vertexAttribBinding
+        && glBindVertexBuffer != NULL && glVertexAttribFormat != NULL && glVertexAttribIFormat != NULL
+        && glVertexAttribBinding != NULL && glVertexBindingDivisor != NULL;
 #endif
 
 #if defined(VGPU_GLES) || defined(VGPU_WEBGL)
@@ -815,10 +1632,37 @@ bool vgpuInitialize(const char* appName, const VGpuRendererSettings* settings)
     _gl.srgb = settings->swapchain.srgb;
     _gl.width = settings->width;
     _gl.height = settings->height;
+
+    _gl.textures = _vgpu_pool_create(settings->maxTextures, sizeof(_VGpuGLTexture));
+    _gl.buffers = _vgpu_pool_create(settings->maxBuffers, sizeof(_VGpuGLBuffer));
+    _gl.shaders = _vgpu_pool_create(settings->maxShaders, sizeof(_VGpuGLShader));
+    _gl.pipelines = _vgpu_pool_create(settings->maxPipelines, sizeof(_VGpuGLPipeline));
+    if (!_gl.textures || !_gl.buffers || !_gl.shaders || !_gl.pipelines) {
+        _vgpu_log(vgpu_log_type_error, "vgpu failed to allocate object pools");
+        return false;
+    }
+
+    /* Transient rings are created on first use. */
+    _gl.transient.frameCount = settings->swapchain.imageCount ? settings->swapchain.imageCount : 2;
+    if (_gl.transient.frameCount > _VGPU_GL_MAX_FRAMES_IN_FLIGHT) {
+        _gl.transient.frameCount = _VGPU_GL_MAX_FRAMES_IN_FLIGHT;
+    }
+    _gl.transient.frameSize = settings->transientBufferSize ? settings->transientBufferSize : _VGPU_GL_DEFAULT_TRANSIENT_SIZE;
+    /* Keep every segment start aligned for uniform buffer offsets. */
+    _gl.transient.frameSize = (_gl.transient.frameSize + 4095u) & ~(uint64_t)4095u;
     _vgpu_gl_reset_state_cache();
 
+#if defined(VGPU_GL)
+    /* Timer queries are core in 3.3, GLES and WebGL only expose them through disjoint timer extensions. */
+    if (settings->gpuTiming && glGenQueries != NULL && glGetQueryObjectui64v != NULL) {
+        glGenQueries(_VGPU_GL_MAX_FRAMES_IN_FLIGHT * VGPU_MAX_TIMED_RENDER_PASSES, &_gl.timer.queries[0][0]);
+        _gl.timer.enabled = true;
+    }
+#endif
+
     _vgpu_log(vgpu_log_type_debug, "vgpu initialized with success");
     _gl.frameIndex = true;
+    _gl.completedFrame = 0;
     _gl.initialized = true;
     return true;
 }
@@ -829,6 +1673,45 @@ void vgpuShutdown()
         return;
     }
 
+    for (uint32_t i = 0; i < _VGPU_GL_BUFFER_TYPE_COUNT; i++) {
+        vgpuDestroyBuffer(_gl.transient.rings[i].buffer);
+    }
+
+    /* Nothing is in flight after glFinish, release every destroyed object. */
+    glFinish();
+    _vgpuGLCollectRetired(_gl.frameIndex);
+
+    const uint32_t leaked = _vgpu_pool_live_count(_gl.textures) + _vgpu_pool_live_count(_gl.buffers)
+        + _vgpu_pool_live_count(_gl.shaders) + _vgpu_pool_live_count(_gl.pipelines);
+    if (leaked > 0) {
+        char message[128];
+        snprintf(message, sizeof(message), "vgpu shutdown with %u live objects\n", leaked);
+        _vgpu_log(vgpu_log_type_warn, message);
+    }
+    _vgpu_pool_destroy(_gl.textures);
+    _vgpu_pool_destroy(_gl.buffers);
+    _vgpu_pool_destroy(_gl.shaders);
+    _vgpu_pool_destroy(_gl.pipelines);
+    _gl.textures = _gl.buffers = _gl.shaders = _gl.pipelines = NULL;
+
+    for (uint32_t i = 0; i < _VGPU_GL_MAX_FRAMES_IN_FLIGHT; i++) {
+        if (_gl.transient.fences[i]) {
+            glDeleteSync(_gl.transient.fences[i]);
+        }
+    }
+    memset(&_gl.transient, 0, sizeof(_gl.transient));
+
+#if defined(VGPU_GL)
+    if (_gl.timer.enabled) {
+        glDeleteQueries(_VGPU_GL_MAX_FRAMES_IN_FLIGHT * VGPU_MAX_TIMED_RENDER_PASSES, &_gl.timer.queries[0][0]);
+    }
+#endif
+    memset(&_gl.timer, 0, sizeof(_gl.timer));
+
+    for (uint32_t i = 0; i < _VGPU_GL_VERTEX_ARRAY_CACHE_SIZE; i++) {
+        _vgpuGLReleaseVertexArray(&_gl.vertexArrays[i]);
+    }
+
     // Delete default VAO.
     glDeleteVertexArrays(1, &_gl.default_vao);
     _VGPU_CHECK_ERROR();
@@ -864,7 +1747,7 @@ bool vgpuQueryFeature(VGpuFeature feature) {
         return true;
 
     case VGPU_FEATURE_DRAW_INDIRECT:
-        return true;
+        return _gl.features.drawIndirect;
 
     case VGPU_FEATURE_FILL_MODE_NON_SOLID:
         return true;
@@ -911,117 +1794,566 @@ void vgpuQueryLimits(VGpuLimits* pLimits) {
     memcpy(pLimits, &_gl.limits, sizeof(VGpuLimits));
 }
 
-uint32_t vgpuFrame() {
-    return  _gl.frameIndex++;
-}
+/* Read the pass timings of the frame that last used slot before it gets reused, pending results are dropped rather than waited for. */
+static void _vgpuGLResolvePassTimers(uint32_t slot) {
+    _gl.stats.gpuPassCount = 0;
+    _gl.stats.gpuTime = 0.0f;
+#if defined(VGPU_GL)
+    const uint32_t count = _gl.timer.counts[slot];
+    _gl.timer.counts[slot] = 0;
+    if (count == 0) {
+        return;
+    }
 
-/* Texture */
-VGpuTexture vgpuCreateTexture(const VGpuTextureDescriptor* descriptor) {
-    VGpuTexture texture = _VGPU_ALLOC_HANDLE(VGpuTexture);
-    texture->external_handle = false;
-    _vgpuGLSetupTexture(texture, descriptor);
+    GLuint available = 0;
+    glGetQueryObjectuiv(_gl.timer.queries[slot][count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
 
-    glGenTextures(1, &texture->gl_handle);
+    for (uint32_t i = 0; i < count; i++) {
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(_gl.timer.queries[slot][i], GL_QUERY_RESULT, &elapsed);
+        _gl.stats.gpuPassTimes[i] = (float)((double)elapsed * 1e-6);
+        _gl.stats.gpuTime += _gl.stats.gpuPassTimes[i];
+    }
+
+    _gl.stats.gpuPassCount = count;
+    _gl.stats.gpuFrameIndex = _gl.timer.frames[slot];
+    _VGPU_CHECK_ERROR();
+#else
+    (void)slot;
+#endif
+}
+
+static void _vgpuGLBeginPass() {
+    _gl.frameStats.renderPasses++;
+#if defined(VGPU_GL)
+    const uint32_t slot = _gl.frameIndex % _gl.transient.frameCount;
+    if (_gl.timer.enabled && !_gl.timer.active && _gl.timer.counts[slot] < VGPU_MAX_TIMED_RENDER_PASSES) {
+        glBeginQuery(GL_TIME_ELAPSED, _gl.timer.queries[slot][_gl.timer.counts[slot]++]);
+        _gl.timer.frames[slot] = _gl.frameIndex;
+        _gl.timer.active = true;
+    }
+#endif
+}
+
+/* Advance completedFrame over the submitted frames whose fence signaled, without blocking. */
+static void _vgpuGLPollCompletedFrames() {
+    while (_gl.completedFrame != _gl.frameIndex) {
+        const uint32_t frame = _gl.completedFrame + 1;
+        /* The slot holds the fence of this frame or of a later one, or nothing once a wait consumed it. */
+        GLsync fence = _gl.transient.fences[frame % _gl.transient.frameCount];
+        if (fence && glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            break;
+        }
+        _gl.completedFrame = frame;
+    }
+}
+
+uint32_t vgpuFrame() {
+    /* Fence the transient segment written this frame, replacing an older fence nobody waited for. */
+    GLsync* fence = &_gl.transient.fences[_gl.frameIndex % _gl.transient.frameCount];
+    if (*fence) {
+        glDeleteSync(*fence);
+    }
+    *fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _gl.transient.waited = false;
+
+    _vgpuGLPollCompletedFrames();
+    _vgpuGLCollectRetired(_gl.completedFrame);
+
+    if (_gl.timer.active) {
+        _vgpu_log(vgpu_log_type_error, "vgpuFrame: frame submitted inside render pass");
+    }
+
+    _gl.frameStats.frameIndex = _gl.frameIndex;
+    _gl.frameStats.pipelineBinds = _gl.frameCounters.pipelineSwitches;
+    _gl.frameStats.programBinds = _gl.frameCounters.programSwitches;
+    _gl.frameStats.textureBinds = _gl.frameCounters.textureSwitches;
+    _gl.stats = _gl.frameStats;
+    memset(&_gl.frameStats, 0, sizeof(_gl.frameStats));
+    _vgpuGLResolvePassTimers((_gl.frameIndex + 1) % _gl.transient.frameCount);
+
+    _gl.counters = _gl.frameCounters;
+    memset(&_gl.frameCounters, 0, sizeof(_gl.frameCounters));
+
+    return  _gl.frameIndex++;
+}
+
+void vgpuGetFrameStats(VGpuFrameStats* stats) {
+    _VGPU_ASSERT(stats);
+    *stats = _gl.stats;
+}
+
+void vgpuGetStateCacheCounters(VGpuStateCacheCounters* counters) {
+    _VGPU_ASSERT(counters);
+    *counters = _gl.counters;
+    counters->vertexArrays = _gl.vertexArrayCount;
+}
+
+/* Texture */
+static uint32_t _vgpuGLMipExtent(uint32_t extent, uint32_t mip) {
+    const uint32_t value = extent >> mip;
+    return value > 0 ? value : 1;
+}
+
+static void _vgpuGLTexImage(const _VGpuGLTexture* texture, const _VGpuGLPixelFormat* format, uint32_t mip, uint32_t layer,
+    uint32_t width, uint32_t height, uint32_t depth, GLsizei size, const void* data) {
+    switch (texture->gl_target)
+    {
+    case GL_TEXTURE_2D:
+    case GL_TEXTURE_CUBE_MAP:
+    {
+        const GLenum target = texture->gl_target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer : GL_TEXTURE_2D;
+        if (format->format == 0) {
+            glCompressedTexImage2D(target, (GLint)mip, format->internalFormat, (GLsizei)width, (GLsizei)height, 0, size, data);
+        }
+        else {
+            glTexImage2D(target, (GLint)mip, (GLint)format->internalFormat, (GLsizei)width, (GLsizei)height, 0, format->format, format->type, data);
+        }
+        break;
+    }
+    default:
+        if (format->format == 0) {
+            glCompressedTexImage3D(texture->gl_target, (GLint)mip, format->internalFormat, (GLsizei)width, (GLsizei)height, (GLsizei)depth, 0, size, data);
+        }
+        else {
+            glTexImage3D(texture->gl_target, (GLint)mip, (GLint)format->internalFormat, (GLsizei)width, (GLsizei)height, (GLsizei)depth, 0, format->format, format->type, data);
+        }
+        break;
+    }
+}
+
+/* Upload a box of one subresource, layer is the face of cube maps and the slice of arrays. */
+static void _vgpuGLTexSubImage(const _VGpuGLTexture* texture, const _VGpuGLPixelFormat* format, uint32_t mip, uint32_t layer,
+    uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth, GLsizei size, const void* data) {
+    switch (texture->gl_target)
+    {
+    case GL_TEXTURE_2D:
+    case GL_TEXTURE_CUBE_MAP:
+    {
+        const GLenum target = texture->gl_target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer : GL_TEXTURE_2D;
+        if (format->format == 0) {
+            glCompressedTexSubImage2D(target, (GLint)mip, 0, (GLint)y, (GLsizei)width, (GLsizei)height, format->internalFormat, size, data);
+        }
+        else {
+            glTexSubImage2D(target, (GLint)mip, 0, (GLint)y, (GLsizei)width, (GLsizei)height, format->format, format->type, data);
+        }
+        break;
+    }
+    default:
+    {
+        const GLint zoffset = (GLint)(texture->gl_target == GL_TEXTURE_3D ? z : layer);
+        if (format->format == 0) {
+            glCompressedTexSubImage3D(texture->gl_target, (GLint)mip, 0, (GLint)y, zoffset, (GLsizei)width, (GLsizei)height, (GLsizei)depth, format->internalFormat, size, data);
+        }
+        else {
+            glTexSubImage3D(texture->gl_target, (GLint)mip, 0, (GLint)y, zoffset, (GLsizei)width, (GLsizei)height, (GLsizei)depth, format->format, format->type, data);
+        }
+        break;
+    }
+    }
+}
+
+static void _vgpuGLAllocateTexture(const _VGpuGLTexture* texture, const _VGpuGLPixelFormat* format) {
+    const GLenum target = texture->gl_target;
+    const bool is3D = target != GL_TEXTURE_2D && target != GL_TEXTURE_CUBE_MAP;
+    const uint32_t depth = target == GL_TEXTURE_3D ? texture->size.depth : texture->layerCount;
+
+#if !defined(VGPU_WEBGL)
+    if (_gl.features.textureStorage) {
+        if (is3D) {
+            glTexStorage3D(target, (GLsizei)texture->mipLevels, format->internalFormat, (GLsizei)texture->size.width, (GLsizei)texture->size.height, (GLsizei)depth);
+        }
+        else {
+            glTexStorage2D(target, (GLsizei)texture->mipLevels, format->internalFormat, (GLsizei)texture->size.width, (GLsizei)texture->size.height);
+        }
+        return;
+    }
+#endif
+
+    /* Mutable storage: define every level, compressed levels need a size even without data. */
+    for (uint32_t mip = 0; mip < texture->mipLevels; mip++) {
+        const uint32_t width = _vgpuGLMipExtent(texture->size.width, mip);
+        const uint32_t height = _vgpuGLMipExtent(texture->size.height, mip);
+        const uint32_t mipDepth = target == GL_TEXTURE_3D ? _vgpuGLMipExtent(depth, mip) : depth;
+        uint64_t slicePitch;
+        vgpuGetSurfaceLayout(texture->pixelFormat, width, height, NULL, NULL, &slicePitch);
+
+        if (target == GL_TEXTURE_CUBE_MAP) {
+            for (uint32_t face = 0; face < 6; face++) {
+                _vgpuGLTexImage(texture, format, mip, face, width, height, 1, (GLsizei)slicePitch, NULL);
+            }
+        }
+        else {
+            _vgpuGLTexImage(texture, format, mip, 0, width, height, mipDepth, (GLsizei)(slicePitch * (is3D ? mipDepth : 1)), NULL);
+        }
+    }
+}
+
+static void _vgpuGLUploadTexture(const _VGpuGLTexture* texture, const _VGpuGLPixelFormat* format, const VGpuTextureData* initialData) {
+    const bool compressed = format->format == 0;
+    const uint32_t blockHeight = vgpuGetFormatBlockHeight(texture->pixelFormat);
+    const uint32_t blockSize = vgpuGetFormatBlockSize(texture->pixelFormat);
+    bool unpackChanged = false;
+
+    for (uint32_t layer = 0; layer < texture->layerCount; layer++) {
+        for (uint32_t mip = 0; mip < texture->mipLevels; mip++) {
+            const VGpuTextureData* subresource = &initialData[layer * texture->mipLevels + mip];
+            if (!subresource->data) {
+                continue;
+            }
+
+            const uint32_t width = _vgpuGLMipExtent(texture->size.width, mip);
+            const uint32_t height = _vgpuGLMipExtent(texture->size.height, mip);
+            const uint32_t depth = texture->gl_target == GL_TEXTURE_3D ? _vgpuGLMipExtent(texture->size.depth, mip) : 1;
+
+            uint32_t packedRowPitch, rowCount;
+            uint64_t packedSlicePitch;
+            vgpuGetSurfaceLayout(texture->pixelFormat, width, height, &packedRowPitch, &rowCount, &packedSlicePitch);
+            _gl.frameStats.bytesUploaded += packedSlicePitch * depth;
+            const uint32_t rowPitch = subresource->rowPitch ? subresource->rowPitch : packedRowPitch;
+            const uint64_t slicePitch = subresource->slicePitch ? subresource->slicePitch : (uint64_t)rowPitch * rowCount;
+            _VGPU_ASSERT(rowPitch >= packedRowPitch && slicePitch >= (uint64_t)rowPitch * rowCount);
+
+            if (rowPitch == packedRowPitch && (depth == 1 || slicePitch == packedSlicePitch)) {
+                _vgpuGLTexSubImage(texture, format, mip, layer, 0, 0, width, height, depth, (GLsizei)(packedSlicePitch * depth), subresource->data);
+                continue;
+            }
+
+            if (!compressed) {
+                /* Padded rows and slices are described through the unpack state. */
+                _VGPU_ASSERT(rowPitch % blockSize == 0 && slicePitch % rowPitch == 0);
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)(rowPitch / blockSize));
+                glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, (GLint)(slicePitch / rowPitch));
+                unpackChanged = true;
+                _vgpuGLTexSubImage(texture, format, mip, layer, 0, 0, width, height, depth, 0, subresource->data);
+                continue;
+            }
+
+            /* Compressed unpack state is not portable, upload padded data one row of blocks at a time. */
+            const uint8_t* slice = (const uint8_t*)subresource->data;
+            for (uint32_t z = 0; z < depth; z++, slice += slicePitch) {
+                for (uint32_t row = 0; row < rowCount; row++) {
+                    const uint32_t y = row * blockHeight;
+                    const uint32_t rowHeight = (height - y) < blockHeight ? height - y : blockHeight;
+                    _vgpuGLTexSubImage(texture, format, mip, layer, y, z, width, rowHeight, 1, (GLsizei)packedRowPitch, slice + (size_t)row * rowPitch);
+                }
+            }
+        }
+    }
+
+    if (unpackChanged) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+    }
+}
+
+VGpuTexture vgpuCreateTexture(const VGpuTextureDescriptor* descriptor, const VGpuTextureData* initialData) {
+    _VGPU_ASSERT(descriptor);
+    const _VGpuGLPixelFormat* format = _vgpuGLGetPixelFormat(descriptor->pixelFormat);
+    if (format->internalFormat == 0) {
+        _vgpu_log(vgpu_log_type_error, "vgpuCreateTexture: unsupported pixel format");
+        return NULL;
+    }
+
+    _VGpuGLTexture* texture;
+    const uint32_t id = _vgpu_pool_alloc(_gl.textures, (void**)&texture);
+    if (!id) {
+        _vgpu_log(vgpu_log_type_error, "vgpuCreateTexture: texture pool is full");
+        return NULL;
+    }
+
+    texture->external_handle = false;
+    _vgpuGLSetupTexture(texture, descriptor);
+
+    glGenTextures(1, &texture->gl_handle);
     _vgpuGLBindTexture(texture, 0);
+    glTexParameteri(texture->gl_target, GL_TEXTURE_MAX_LEVEL, (GLint)(texture->mipLevels - 1));
+    _vgpuGLAllocateTexture(texture, format);
+    if (initialData) {
+        _vgpuGLUploadTexture(texture, format, initialData);
+    }
     _VGPU_CHECK_ERROR();
-    return texture;
+    texture->memorySize = _vgpu_texture_memory_size(descriptor);
+    _vgpu_track_texture(texture->memorySize, texture->usage, true);
+    _gl.frameStats.resourcesCreated++;
+    return _VGPU_HANDLE(VGpuTexture, id);
 }
 
 VGpuTexture vgpuCreateExternalTexture(const VGpuTextureDescriptor* descriptor, void* handle) {
-    VGpuTexture texture = _VGPU_ALLOC_HANDLE(VGpuTexture);
+    _VGpuGLTexture* texture;
+    const uint32_t id = _vgpu_pool_alloc(_gl.textures, (void**)&texture);
+    if (!id) {
+        _vgpu_log(vgpu_log_type_error, "vgpuCreateExternalTexture: texture pool is full");
+        return NULL;
+    }
+
     _vgpuGLSetupTexture(texture, descriptor);
     texture->gl_handle = *(GLuint*)handle;
     texture->external_handle = true;
-    return texture;
+    return _VGPU_HANDLE(VGpuTexture, id);
 }
 
-void vgpuDestroyTexture(VGpuTexture texture) {
-    if (!texture || texture->external_handle) {
+static void _vgpuGLReleaseTexture(_VGpuGLTexture* texture) {
+    if (texture->external_handle) {
         return;
     }
 
-    _VGPU_CHECK_ERROR();
     if (texture->gl_handle) {
         glDeleteTextures(1, &texture->gl_handle);
     }
-    _VGPU_FREE(texture);
-    _VGPU_CHECK_ERROR();
+    _vgpu_track_texture(texture->memorySize, texture->usage, false);
+}
+
+void vgpuDestroyTexture(VGpuTexture handle) {
+    const _VGpuGLTexture* texture = _VGPU_GL_TEXTURE(handle);
+    if (!texture) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < _VGPU_GL_MAX_TEXTURES; i++) {
+        if (_gl.state.textures[i] == texture) {
+            _gl.state.textures[i] = NULL;
+        }
+        if (_gl.state.textureBindings[i] == texture) {
+            _gl.state.textureBindings[i] = NULL;
+        }
+    }
+
+    /* Frames in flight may still sample it, the GL texture is deleted once this frame completes. */
+    if (!texture->external_handle) {
+        _gl.frameStats.resourcesDestroyed++;
+    }
+    _vgpu_pool_retire(_gl.textures, _VGPU_HANDLE_ID(handle), _gl.frameIndex);
 }
 
 /* Buffer */
 VGpuBuffer vgpuCreateBuffer(uint64_t size, VGpuBufferUsage usage, VGpuResourceUsage resourceUsage, const void* data) {
     _VGPU_CHECK_ERROR();
-    VGpuBuffer buffer = _VGPU_ALLOC_HANDLE(VGpuBuffer);
+    _VGpuGLBuffer* buffer;
+    const uint32_t id = _vgpu_pool_alloc(_gl.buffers, (void**)&buffer);
+    if (!id) {
+        _vgpu_log(vgpu_log_type_error, "vgpuCreateBuffer: buffer pool is full");
+        return NULL;
+    }
+
     buffer->size = size;
     buffer->usage = usage;
     buffer->resourceUsage = resourceUsage;
     buffer->external_handle = false;
     buffer->gl_type = _vgpuGLConvertBufferUsage(usage);
-    buffer->gl_target = _vgpuGLConvertBufferType(buffer->gl_type);
+    /* The element array binding belongs to the bound vertex array, index buffers are accessed through the copy target. */
+    buffer->gl_target = buffer->gl_type == _VGPU_GL_BUFFER_INDEX ? GL_COPY_WRITE_BUFFER : _vgpuGLConvertBufferType(buffer->gl_type);
     glGenBuffers(1, &buffer->gl_handle);
     _vgpuGLBindBuffer(buffer);
 
-#if defined(VGPU_WEBGL)
-    buffer->gl_data = malloc(size);
-    _VGPU_ASSERT(buffer->gl_data);
-    glBufferData(buffer->gl_target, size, data, _vgpuGLConvertResourceUsage(usage));
-
-    if (data) {
-        memcpy(buffer->gl_data, data, size);
-    }
-#else
+    const bool dynamic = resourceUsage == VGPU_RESOURCE_USAGE_DYNAMIC || resourceUsage == VGPU_RESOURCE_USAGE_STREAM;
+#if !defined(VGPU_WEBGL)
     if (_gl.features.bufferStorage) {
-        const bool readable = false;
-        const bool dynamic = usage == VGPU_RESOURCE_USAGE_DYNAMIC || usage == VGPU_RESOURCE_USAGE_STREAM;
-        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+        GLbitfield flags = 0;
         if (dynamic) {
-            flags |= GL_DYNAMIC_STORAGE_BIT;
+            flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_DYNAMIC_STORAGE_BIT;
         }
-        if (readable) {
-            flags |= GL_MAP_READ_BIT;
+        else if (resourceUsage == VGPU_RESOURCE_USAGE_STATIC) {
+            flags = GL_DYNAMIC_STORAGE_BIT;
         }
         glBufferStorage(buffer->gl_target, size, data, flags);
-        buffer->gl_data = glMapBufferRange(buffer->gl_target, 0, size, flags | GL_MAP_FLUSH_EXPLICIT_BIT);
-    }
-    else {
-        glBufferData(buffer->gl_target, size, data, _vgpuGLConvertResourceUsage(usage));
+
+        if (dynamic) {
+            buffer->gl_data = glMapBufferRange(buffer->gl_target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+            buffer->gl_persistent = true;
+        }
     }
+    else
 #endif
+    {
+        glBufferData(buffer->gl_target, size, data, _vgpuGLConvertResourceUsage(resourceUsage));
+
+        if (dynamic) {
+            /* CPU shadow, flushed ranges are uploaded with glBufferSubData. */
+            buffer->gl_data = _vgpu_alloc(size);
+            _VGPU_ASSERT(buffer->gl_data);
+            if (data) {
+                memcpy(buffer->gl_data, data, size);
+            }
+        }
+    }
     _VGPU_CHECK_ERROR();
 
-    return buffer;
+    if (data) {
+        _gl.frameStats.bytesUploaded += size;
+    }
+    _vgpu_track_buffer(size, true);
+    _gl.frameStats.resourcesCreated++;
+    return _VGPU_HANDLE(VGpuBuffer, id);
 }
 
-void vgpuDestroyBuffer(VGpuBuffer buffer) {
+static void _vgpuGLReleaseBuffer(_VGpuGLBuffer* buffer) {
+    /* Deleting the buffer releases a persistent mapping. */
+    if (buffer->gl_handle) {
+        glDeleteBuffers(1, &buffer->gl_handle);
+    }
+
+    if (!buffer->gl_persistent) {
+        _VGPU_FREE(buffer->gl_data);
+    }
+    _vgpu_track_buffer(buffer->size, false);
+}
+
+void vgpuDestroyBuffer(VGpuBuffer handle) {
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(handle);
     if (!buffer || buffer->external_handle) {
         return;
     }
 
-    _VGPU_CHECK_ERROR();
+    /* Drop cached bindings now, the GL name stays allocated until the frame completes so it cannot be reused meanwhile. */
     if (buffer->gl_handle) {
-        glDeleteBuffers(1, &buffer->gl_handle);
-
-#ifndef VGPU_WEBGL
-        if (!_gl.features.bufferStorage) {
-#endif
-            free(buffer->gl_data);
-#ifndef VGPU_WEBGL
+        _vgpuGLInvalidateVertexArrays(NULL, buffer->gl_handle);
+        for (uint32_t i = 0; i < _VGPU_GL_BUFFER_TYPE_COUNT; i++) {
+            if (_gl.state.buffers[i] == buffer->gl_handle) {
+                _gl.state.buffers[i] = 0;
+            }
+        }
+        for (uint32_t i = 0; i < VGPU_MAX_VERTEX_BUFFER_BINDINGS; i++) {
+            if (_gl.state.vertexBindings.buffers[i] == buffer->gl_handle) {
+                _gl.state.vertexBindings.buffers[i] = 0;
+                _gl.state.vertexArrayValid = false;
+            }
         }
+        if (_gl.state.vertexBindings.indexBuffer == buffer->gl_handle) {
+            _gl.state.vertexBindings.indexBuffer = 0;
+            _gl.state.vertexArrayValid = false;
+        }
+        if (_gl.state.indirectBuffer == buffer->gl_handle) {
+            _gl.state.indirectBuffer = 0;
+        }
+        /* Deleting resets the indexed bindings of the buffer too. */
+        for (uint32_t i = 0; i < VGPU_MAX_UNIFORM_BUFFER_BINDINGS; i++) {
+            if (_gl.state.uniformBuffers[i].buffer == buffer->gl_handle) {
+                memset(&_gl.state.uniformBuffers[i], 0, sizeof(_VGpuGLUniformBufferBinding));
+            }
+            if (_gl.state.boundUniformBuffers[i].buffer == buffer->gl_handle) {
+                memset(&_gl.state.boundUniformBuffers[i], 0, sizeof(_VGpuGLUniformBufferBinding));
+            }
+        }
+    }
+
+    _gl.frameStats.resourcesDestroyed++;
+    _vgpu_pool_retire(_gl.buffers, _VGPU_HANDLE_ID(handle), _gl.frameIndex);
+}
+
+void* vgpuMapBuffer(VGpuBuffer handle) {
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(handle);
+    return buffer ? buffer->gl_data : NULL;
+}
+
+static void _vgpuGLFlushBuffer(const _VGpuGLBuffer* buffer, uint64_t offset, uint64_t size) {
+    _VGPU_ASSERT(buffer->gl_data);
+    _VGPU_ASSERT(offset + size <= buffer->size);
+
+    _vgpuGLBindBuffer(buffer);
+#if !defined(VGPU_WEBGL)
+    if (buffer->gl_persistent) {
+        glFlushMappedBufferRange(buffer->gl_target, (GLintptr)offset, (GLsizeiptr)size);
+    }
+    else
 #endif
+    {
+        glBufferSubData(buffer->gl_target, (GLintptr)offset, (GLsizeiptr)size, (const uint8_t*)buffer->gl_data + offset);
+    }
+    _gl.frameStats.bytesUploaded += size;
+    _VGPU_CHECK_ERROR();
+}
 
+void vgpuFlushBuffer(VGpuBuffer handle, uint64_t offset, uint64_t size) {
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(handle);
+    if (buffer) {
+        _vgpuGLFlushBuffer(buffer, offset, size);
     }
-    _VGPU_FREE(buffer);
+}
+
+void vgpuUpdateBuffer(VGpuBuffer handle, uint64_t offset, uint64_t size, const void* data) {
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(handle);
+    if (!buffer) {
+        return;
+    }
+
+    _VGPU_ASSERT(data);
+    _VGPU_ASSERT(buffer->resourceUsage != VGPU_RESOURCE_USAGE_IMMUTABLE);
+    _VGPU_ASSERT(offset + size <= buffer->size);
+
+    if (buffer->gl_data) {
+        memcpy((uint8_t*)buffer->gl_data + offset, data, size);
+        _vgpuGLFlushBuffer(buffer, offset, size);
+        return;
+    }
+
+    _vgpuGLBindBuffer(buffer);
+    glBufferSubData(buffer->gl_target, (GLintptr)offset, (GLsizeiptr)size, data);
+    _gl.frameStats.bytesUploaded += size;
     _VGPU_CHECK_ERROR();
 }
 
-/* Shader */
-const char* _vgpuGLShaderVertexPrefix = ""
-"in vec3 vgpuPosition; \n"
-"in vec3 vgpuNormal; \n"
-"in vec2 vgpuTexCoord; \n"
-"in vec4 vgpuVertexColor; \n"
-"#line 0 \n";
+static void _vgpuGLWaitTransientFrame() {
+    if (_gl.transient.waited) {
+        return;
+    }
+
+    _gl.transient.waited = true;
+    GLsync* fence = &_gl.transient.fences[_gl.frameIndex % _gl.transient.frameCount];
+    if (*fence) {
+        GLenum result = glClientWaitSync(*fence, 0, 0);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(*fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+        glDeleteSync(*fence);
+        *fence = NULL;
+    }
+}
+
+VGpuResult vgpuAllocateTransient(VGpuBufferUsage usage, uint64_t size, uint64_t alignment, VGpuTransientAllocation* allocation) {
+    _VGPU_ASSERT(_gl.initialized && allocation);
+
+    const _VGpuGLBufferType type = _vgpuGLConvertBufferUsage(usage);
+    _vgpu_gl_transient_ring* ring = &_gl.transient.rings[type];
+    if (!ring->buffer) {
+        ring->buffer = vgpuCreateBuffer(_gl.transient.frameSize * _gl.transient.frameCount, usage, VGPU_RESOURCE_USAGE_STREAM, NULL);
+        if (!ring->buffer) {
+            return VGPU_ERROR_TOO_MANY_OBJECTS;
+        }
+    }
+
+    if (alignment == 0) {
+        alignment = 16;
+    }
+    if (type == _VGPU_GL_BUFFER_UNIFORM && alignment < _gl.limits.minUniformBufferOffsetAlignment) {
+        alignment = _gl.limits.minUniformBufferOffsetAlignment;
+    }
+    _VGPU_ASSERT((alignment & (alignment - 1)) == 0);
+
+    _vgpuGLWaitTransientFrame();
+    if (ring->frameIndex != _gl.frameIndex) {
+        ring->frameIndex = _gl.frameIndex;
+        ring->offset = 0;
+    }
 
+    const uint64_t offset = (ring->offset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > _gl.transient.frameSize) {
+        return VGPU_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    ring->offset = offset + size;
+
+    const uint64_t segmentOffset = (_gl.frameIndex % _gl.transient.frameCount) * _gl.transient.frameSize;
+    const _VGpuGLBuffer* buffer = (const _VGpuGLBuffer*)_vgpu_pool_get(_gl.buffers, _VGPU_HANDLE_ID(ring->buffer));
+    allocation->buffer = ring->buffer;
+    allocation->offset = segmentOffset + offset;
+    allocation->data = (uint8_t*)buffer->gl_data + allocation->offset;
+    return VGPU_SUCCESS;
+}
+
+/* Shader */
 const char* _vgpuGLShaderComputeESHeader = ""
 "#version 310 es \n"
 "#line 0 \n";
@@ -1030,9 +2362,9 @@ const char* _vgpuGLShaderComputeHeader = ""
 "#version 430 \n"
 "#line 0 \n";
 
-static GLuint _vgpuGLCompileShader(GLenum type, const char** sources, int count) {
+static GLuint _vgpuGLCompileShader(GLenum type, const char** sources, const GLint* lengths, int count) {
     GLuint shader = glCreateShader(type);
-    glShaderSource(shader, count, sources, NULL);
+    glShaderSource(shader, count, sources, lengths);
     glCompileShader(shader);
 
     int isShaderCompiled;
@@ -1042,7 +2374,7 @@ static GLuint _vgpuGLCompileShader(GLenum type, const char** sources, int count)
         glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
         if (logLength > 0)
         {
-            char* log = malloc(logLength);
+            char* log = _VGPU_ALLOCN(char, logLength);
             _VGPU_ASSERT(log);
             glGetShaderInfoLog(shader, logLength, &logLength, log);
             const char* name;
@@ -1053,8 +2385,13 @@ static GLuint _vgpuGLCompileShader(GLenum type, const char** sources, int count)
             default: name = "shader"; break;
             }
 
-            //_vgpu_log(vgpu_log_type_error, "Could not compile %s:\n%s", name, log);
-            free(log);
+            const size_t messageSize = (size_t)logLength + 64;
+            char* message = _VGPU_ALLOCN(char, messageSize);
+            _VGPU_ASSERT(message);
+            snprintf(message, messageSize, "Could not compile %s:\n%s\n", name, log);
+            _vgpu_log(vgpu_log_type_error, message);
+            _VGPU_FREE(message);
+            _VGPU_FREE(log);
         }
     }
     _VGPU_CHECK_ERROR();
@@ -1070,16 +2407,206 @@ static GLuint _vgpuGLLinkProgram(GLuint program) {
     if (!isLinked) {
         int logLength;
         glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
-        char* log = malloc(logLength);
-        _VGPU_ASSERT(log);
-        glGetProgramInfoLog(program, logLength, &logLength, log);
-        //_vgpu_log(vgpu_log_type_error, "Could not link shader:\n%s", log);
+        if (logLength > 0) {
+            char* log = _VGPU_ALLOCN(char, logLength);
+            _VGPU_ASSERT(log);
+            glGetProgramInfoLog(program, logLength, &logLength, log);
+
+            const size_t messageSize = (size_t)logLength + 64;
+            char* message = _VGPU_ALLOCN(char, messageSize);
+            _VGPU_ASSERT(message);
+            snprintf(message, messageSize, "Could not link shader:\n%s\n", log);
+            _vgpu_log(vgpu_log_type_error, message);
+            _VGPU_FREE(message);
+            _VGPU_FREE(log);
+        }
     }
 
     return program;
 }
 
 
+static bool _vgpuGLIsIntegerType(GLenum type) {
+    switch (type) {
+    case GL_INT:
+    case GL_INT_VEC2:
+    case GL_INT_VEC3:
+    case GL_INT_VEC4:
+    case GL_UNSIGNED_INT:
+    case GL_UNSIGNED_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC4:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool _vgpuGLIsSamplerType(GLenum type) {
+    switch (type) {
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+#if defined(VGPU_GL)
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_SAMPLER_BUFFER:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
+static int32_t _vgpuGLFindResourceBinding(const VGpuShaderDescriptor* descriptor, VGpuShaderResourceType type, const char* name) {
+    if (!descriptor) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < descriptor->resourceCount; i++) {
+        const VGpuShaderResourceBinding* resource = &descriptor->resources[i];
+        if (resource->type != type) {
+            continue;
+        }
+
+        /* GL reports arrays as "name[0]" */
+        const size_t length = strlen(resource->name);
+        if (strncmp(resource->name, name, length) == 0 && (name[length] == '\0' || name[length] == '[')) {
+            return (int32_t)resource->binding;
+        }
+    }
+
+    return -1;
+}
+
+/* Claims binding, or the lowest free slot when it is out of range or already taken. Returns count when full. */
+static uint32_t _vgpuGLClaimSlot(uint32_t* usedMask, GLint binding, uint32_t count) {
+    uint32_t slot = (uint32_t)binding;
+    if (binding < 0 || slot >= count || (*usedMask & (1u << slot))) {
+        for (slot = 0; slot < count && (*usedMask & (1u << slot)); slot++) {
+        }
+    }
+
+    if (slot < count) {
+        *usedMask |= 1u << slot;
+    }
+    return slot;
+}
+
+/* Resolve vertex inputs, uniform blocks and samplers of a linked program into the shader binding table. */
+static void _vgpuGLReflectProgram(_VGpuGLShader* shader, const VGpuShaderDescriptor* descriptor) {
+    const GLuint program = shader->gl_handle;
+    _VGpuGLBindingTable* table = &shader->gl_bindings;
+    char name[128];
+    GLint count = 0;
+    GLint size;
+    GLenum type;
+
+    /* glUniform1i below applies to the bound program */
+    _vgpuGLUseProgram(program);
+
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+    for (GLint i = 0; i < count; i++) {
+        glGetActiveAttrib(program, (GLuint)i, sizeof(name), NULL, &size, &type, name);
+        const GLint location = glGetAttribLocation(program, name);
+        /* built-ins such as gl_VertexID have no location */
+        if (location < 0 || location >= VGPU_MAX_VERTEX_ATTRIBUTES) {
+            continue;
+        }
+
+        shader->gl_inputMask |= 1u << location;
+        if (_vgpuGLIsIntegerType(type)) {
+            shader->gl_integerInputMask |= 1u << location;
+        }
+    }
+
+    uint32_t usedMask = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    for (GLint i = 0; i < count; i++) {
+        glGetActiveUniformBlockName(program, (GLuint)i, sizeof(name), NULL, name);
+        GLint binding = _vgpuGLFindResourceBinding(descriptor, VGPU_SHADER_RESOURCE_TYPE_UNIFORM_BUFFER, name);
+        if (binding < 0) {
+            glGetActiveUniformBlockiv(program, (GLuint)i, GL_UNIFORM_BLOCK_BINDING, &binding);
+        }
+
+        const uint32_t slot = _vgpuGLClaimSlot(&usedMask, binding, VGPU_MAX_UNIFORM_BUFFER_BINDINGS);
+        if (slot == VGPU_MAX_UNIFORM_BUFFER_BINDINGS) {
+            _vgpu_log(vgpu_log_type_warn, "Too many uniform blocks in program");
+            break;
+        }
+
+        glUniformBlockBinding(program, (GLuint)i, slot);
+        table->uniformBuffers[table->uniformBufferCount] = (uint8_t)slot;
+        glGetActiveUniformBlockiv(program, (GLuint)i, GL_UNIFORM_BLOCK_DATA_SIZE, &table->uniformBufferSizes[table->uniformBufferCount]);
+        table->uniformBufferCount++;
+    }
+
+    usedMask = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; i++) {
+        glGetActiveUniform(program, (GLuint)i, sizeof(name), NULL, &size, &type, name);
+        if (!_vgpuGLIsSamplerType(type)) {
+            continue;
+        }
+
+        const GLint location = glGetUniformLocation(program, name);
+        if (location < 0) {
+            continue;
+        }
+
+        GLint binding = _vgpuGLFindResourceBinding(descriptor, VGPU_SHADER_RESOURCE_TYPE_TEXTURE, name);
+        if (binding < 0) {
+            glGetUniformiv(program, location, &binding);
+        }
+
+        const uint32_t slot = _vgpuGLClaimSlot(&usedMask, binding, VGPU_MAX_TEXTURE_BINDINGS);
+        if (slot == VGPU_MAX_TEXTURE_BINDINGS) {
+            _vgpu_log(vgpu_log_type_warn, "Too many samplers in program");
+            break;
+        }
+
+        glUniform1i(location, (GLint)slot);
+        table->textures[table->textureCount++] = (uint8_t)slot;
+    }
+    _VGPU_CHECK_ERROR();
+}
+
+static void _vgpuGLBindVertexInputs(GLuint program, const VGpuShaderDescriptor* descriptor) {
+    for (uint32_t i = 0; i < descriptor->vertexInputCount; i++) {
+        _VGPU_ASSERT(descriptor->vertexInputs[i].location < VGPU_MAX_VERTEX_ATTRIBUTES);
+        glBindAttribLocation(program, descriptor->vertexInputs[i].location, descriptor->vertexInputs[i].name);
+    }
+}
+
+static VGpuShader _vgpuGLCreateShader(GLuint program, const VGpuShaderDescriptor* descriptor) {
+    _VGpuGLShader* shader;
+    const uint32_t id = _vgpu_pool_alloc(_gl.shaders, (void**)&shader);
+    if (!id) {
+        _vgpu_log(vgpu_log_type_error, "vgpuCreateShader: shader pool is full");
+        glDeleteProgram(program);
+        return NULL;
+    }
+
+    shader->gl_handle = program;
+    _vgpuGLReflectProgram(shader, descriptor);
+    _gl.frameStats.resourcesCreated++;
+    return _VGPU_HANDLE(VGpuShader, id);
+}
+
 VGpuShader vgpuCreateShader(const char* vertexSource, const char* fragmentSource) {
 #if defined(VGPU_WEBGL) || defined(VGPU_GLES)
     const char* vertexHeader = "#version 300 es\nprecision mediump float;\nprecision mediump int;\n";
@@ -1089,20 +2616,16 @@ VGpuShader vgpuCreateShader(const char* vertexSource, const char* fragmentSource
     const char* fragmentHeader = "#version 150\n";
 #endif
 
-    const char* vertexSources[] = { vertexHeader/*, _vgpuGLShaderVertexPrefix*/, vertexSource };
-    GLuint vertexShader = _vgpuGLCompileShader(GL_VERTEX_SHADER, vertexSources, sizeof(vertexSources) / sizeof(vertexSources[0]));
+    const char* vertexSources[] = { vertexHeader, vertexSource };
+    GLuint vertexShader = _vgpuGLCompileShader(GL_VERTEX_SHADER, vertexSources, NULL, sizeof(vertexSources) / sizeof(vertexSources[0]));
 
     // Fragment
     const char* fragmentSources[] = { fragmentHeader, fragmentSource };
-    GLuint fragmentShader = _vgpuGLCompileShader(GL_FRAGMENT_SHADER, fragmentSources, sizeof(fragmentSources) / sizeof(fragmentSources[0]));
+    GLuint fragmentShader = _vgpuGLCompileShader(GL_FRAGMENT_SHADER, fragmentSources, NULL, sizeof(fragmentSources) / sizeof(fragmentSources[0]));
 
     GLuint program = glCreateProgram();
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
-    //glBindAttribLocation(program, _VGPU_GL_SHADER_POSITION, "vgpuPosition");
-    //glBindAttribLocation(program, _VGPU_GL_SHADER_NORMAL, "vgpuNormal");
-    //glBindAttribLocation(program, _VGPU_GL_SHADER_TEX_COORD, "vgpuTexCoord");
-    //glBindAttribLocation(program, _VGPU_GL_SHADER_VERTEX_COLOR, "vgpuVertexColor");
     _vgpuGLLinkProgram(program);
     glDetachShader(program, vertexShader);
     glDeleteShader(vertexShader);
@@ -1110,12 +2633,7 @@ VGpuShader vgpuCreateShader(const char* vertexSource, const char* fragmentSource
     glDeleteShader(fragmentShader);
     _VGPU_CHECK_ERROR();
 
-    // Bind program and get reflection data.
-    _vgpuGLUseProgram(program);
-
-    VGpuShader shader = _VGPU_ALLOC_HANDLE(VGpuShader);
-    shader->gl_handle = program;
-    return shader;
+    return _vgpuGLCreateShader(program, NULL);
 }
 
 VGpuShader vgpuCreateComputeShader(const char* source) {
@@ -1133,38 +2651,95 @@ VGpuShader vgpuCreateComputeShader(const char* source) {
 #endif
 
     GLuint program = glCreateProgram();
-    GLuint computeShader = _vgpuGLCompileShader(GL_COMPUTE_SHADER, sources, sizeof(sources) / sizeof(sources[0]));
+    GLuint computeShader = _vgpuGLCompileShader(GL_COMPUTE_SHADER, sources, NULL, sizeof(sources) / sizeof(sources[0]));
     glAttachShader(program, computeShader);
     _vgpuGLLinkProgram(program);
     glDetachShader(program, computeShader);
     glDeleteShader(computeShader);
     _VGPU_CHECK_ERROR();
 
-    VGpuShader shader = _VGPU_ALLOC_HANDLE(VGpuShader);
-    shader->gl_handle = program;
-    //shader->gl_type = VGPU_SHADER_TYPE_COMPUTE;
-    /* TODO: Load uniforms, ubo etc*/
-    return shader;
+    return _vgpuGLCreateShader(program, NULL);
 #endif
 }
 
-void vgpuDestroyShader(VGpuShader shader) {
-    if (!shader) {
-        return;
+static GLuint _vgpuGLCompileShaderStage(GLenum type, const VGpuShaderStageDescriptor* stage) {
+    const char* source = (const char*)stage->code;
+    GLint length = (GLint)stage->codeSize;
+    return _vgpuGLCompileShader(type, &source, &length, 1);
+}
+
+VGpuShader vgpuCreateShaderWithDescriptor(const VGpuShaderDescriptor* descriptor) {
+    _VGPU_ASSERT(descriptor);
+
+    GLuint program = glCreateProgram();
+    GLuint shaders[2];
+    uint32_t shaderCount = 0;
+    if (descriptor->compute.code) {
+#if defined(VGPU_WEBGL)
+        _VGPU_THROW("Compute shaders are not supported on WebGL");
+#else
+        shaders[shaderCount++] = _vgpuGLCompileShaderStage(GL_COMPUTE_SHADER, &descriptor->compute);
+#endif
+    }
+    else {
+        _VGPU_ASSERT(descriptor->vertex.code && descriptor->fragment.code);
+        shaders[shaderCount++] = _vgpuGLCompileShaderStage(GL_VERTEX_SHADER, &descriptor->vertex);
+        shaders[shaderCount++] = _vgpuGLCompileShaderStage(GL_FRAGMENT_SHADER, &descriptor->fragment);
     }
 
-    _VGPU_CHECK_ERROR();
-    if (shader->gl_handle) {
-        glDeleteProgram(shader->gl_handle);
+    for (uint32_t i = 0; i < shaderCount; i++) {
+        glAttachShader(program, shaders[i]);
+    }
+    _vgpuGLBindVertexInputs(program, descriptor);
+    _vgpuGLLinkProgram(program);
+    for (uint32_t i = 0; i < shaderCount; i++) {
+        glDetachShader(program, shaders[i]);
+        glDeleteShader(shaders[i]);
     }
-    _VGPU_FREE(shader);
     _VGPU_CHECK_ERROR();
+
+    return _vgpuGLCreateShader(program, descriptor);
+}
+
+static void _vgpuGLReleaseShader(_VGpuGLShader* shader) {
+    if (!shader->gl_handle) {
+        return;
+    }
+
+    /* A deleted program stays alive while current, unbind it so the name is freed and the cache stays truthful. */
+    if (_gl.state.program == shader->gl_handle) {
+        glUseProgram(0);
+        _gl.state.program = 0;
+    }
+    glDeleteProgram(shader->gl_handle);
+}
+
+void vgpuDestroyShader(VGpuShader handle) {
+    if (!_VGPU_GL_SHADER(handle)) {
+        return;
+    }
+
+    _gl.frameStats.resourcesDestroyed++;
+    _vgpu_pool_retire(_gl.shaders, _VGPU_HANDLE_ID(handle), _gl.frameIndex);
 }
 
 VGpuPipeline vgpuCreateRenderPipeline(const VGpuRenderPipelineDescriptor* descriptor) {
-    VGpuPipeline pipeline = _VGPU_ALLOC_HANDLE(VGpuPipeline);
-    pipeline->shader = descriptor->shader;
+    const _VGpuGLShader* shader = _VGPU_GL_SHADER(descriptor->shader);
+    if (!shader) {
+        return NULL;
+    }
+
+    _VGpuGLPipeline* pipeline;
+    const uint32_t id = _vgpu_pool_alloc(_gl.pipelines, (void**)&pipeline);
+    if (!id) {
+        _vgpu_log(vgpu_log_type_error, "vgpuCreateRenderPipeline: pipeline pool is full");
+        return NULL;
+    }
+
+    pipeline->gl_program = shader->gl_handle;
     pipeline->topology = _vgpuGLConvertPrimitiveTopology(descriptor->primitiveTopology);
+    pipeline->primitiveTopology = descriptor->primitiveTopology;
+    pipeline->gl_bindings = shader->gl_bindings;
 
     /* resolve vertex attributes */
     for (unsigned i = 0; i < VGPU_MAX_VERTEX_ATTRIBUTES; i++) {
@@ -1181,10 +2756,12 @@ VGpuPipeline vgpuCreateRenderPipeline(const VGpuRenderPipelineDescriptor* descri
         const VGpuVertexBufferLayoutDescriptor* buffer_layout_desc = &descriptor->vertexDescriptor.layouts[attr_desc->bufferIndex];
         const VGpuVertexInputRate inputRate = buffer_layout_desc->inputRate;
         GLint attr_loc = i;
-        /*if (!_sg_strempty(&shd->attrs[attr_index].name)) {
-            attr_loc = glGetAttribLocation(pip->shader->gl_prog, _sg_strptr(&shd->attrs[attr_index].name));
-        }*/
-        if (attr_loc != -1) {
+        if (attr_desc->name) {
+            attr_loc = glGetAttribLocation(shader->gl_handle, attr_desc->name);
+        }
+
+        /* Attributes the program does not read are left disabled. */
+        if (attr_loc >= 0 && attr_loc < VGPU_MAX_VERTEX_ATTRIBUTES && (shader->gl_inputMask & (1u << attr_loc))) {
             _VGpuGLVertexAttribute* gl_attribute = &pipeline->gl_attrs[attr_loc];
             _VGPU_ASSERT(gl_attribute->vb_index == -1);
             gl_attribute->vb_index = (int8_t)attr_desc->bufferIndex;
@@ -1200,27 +2777,105 @@ VGpuPipeline vgpuCreateRenderPipeline(const VGpuRenderPipelineDescriptor* descri
             gl_attribute->size = _vgpuGLGetVertexFormatSize(attr_desc->format);
             gl_attribute->type = _vgpuGLGetVertexFormatType(attr_desc->format);
             gl_attribute->normalized = _vgpuGLConvertVertexFormatNormalized(attr_desc->format);
+            gl_attribute->integer = (shader->gl_integerInputMask & (1u << attr_loc)) && !gl_attribute->normalized && gl_attribute->type != GL_FLOAT;
             pipeline->vertex_layout_valid[attr_desc->bufferIndex] = true;
         }
+    }
+
+    /* resolve fixed function state */
+    _VGpuGLRenderState* state = &pipeline->gl_state;
+    const VGpuDepthStencilState* depthStencil = &descriptor->depthStencil;
+    state->depthTest = depthStencil->depthCompareFunction != VGPU_COMPARE_FUNCTION_ALWAYS || depthStencil->depthWriteEnabled;
+    state->depthWrite = depthStencil->depthWriteEnabled;
+    state->depthFunc = _vgpuConvertCompareFunction(depthStencil->depthCompareFunction);
+    state->stencilTest = depthStencil->stencilTestEnable;
+    state->stencilReadMask = depthStencil->stencilReadMask;
+    state->stencilWriteMask = depthStencil->stencilWriteMask;
+    state->stencilFront.func = _vgpuConvertCompareFunction(depthStencil->frontFace.compareFunction);
+    state->stencilFront.fail = _vgpuGLConvertStencilOperation(depthStencil->frontFace.failOperation);
+    state->stencilFront.depthFail = _vgpuGLConvertStencilOperation(depthStencil->frontFace.depthFailOperation);
+    state->stencilFront.pass = _vgpuGLConvertStencilOperation(depthStencil->frontFace.passOperation);
+    state->stencilBack.func = _vgpuConvertCompareFunction(depthStencil->backFace.compareFunction);
+    state->stencilBack.fail = _vgpuGLConvertStencilOperation(depthStencil->backFace.failOperation);
+    state->stencilBack.depthFail = _vgpuGLConvertStencilOperation(depthStencil->backFace.depthFailOperation);
+    state->stencilBack.pass = _vgpuGLConvertStencilOperation(depthStencil->backFace.passOperation);
+
+    state->independentBlend = descriptor->blendState.independentBlendEnabled;
+    for (uint32_t i = 0; i < VGPU_MAX_COLOR_ATTACHMENTS; i++) {
+        const VGpuBlendAttachmentState* blend_desc = &descriptor->blendState.attachments[state->independentBlend ? i : 0];
+        _VGpuGLBlendAttachment* blend = &state->blend[i];
+        blend->enabled = blend_desc->blendEnabled;
+        blend->srcRGB = _vgpuGLConvertBlendFactor(blend_desc->srcColorBlendFactor);
+        blend->dstRGB = _vgpuGLConvertBlendFactor(blend_desc->dstColorBlendFactor);
+        blend->opRGB = _vgpuGLConvertBlendOperation(blend_desc->colorBlendOperation);
+        blend->srcAlpha = _vgpuGLConvertBlendFactor(blend_desc->srcAlphaBlendFactor);
+        blend->dstAlpha = _vgpuGLConvertBlendFactor(blend_desc->dstAlphaBlendFactor);
+        blend->opAlpha = _vgpuGLConvertBlendOperation(blend_desc->alphaBlendOperation);
+        if (blend_desc->colorWriteMask == VGPU_COLOR_WRITE_MASK_DEFAULT) {
+            blend->writeMask = VGPU_COLOR_WRITE_MASK_ALL;
+        }
+        else if (blend_desc->colorWriteMask & VGPU_COLOR_WRITE_MASK_NONE) {
+            blend->writeMask = 0;
+        }
         else {
+            blend->writeMask = (uint8_t)(blend_desc->colorWriteMask & VGPU_COLOR_WRITE_MASK_ALL);
         }
     }
 
-    return pipeline;
+    const VGpuRasterizerState* rasterizer = &descriptor->rasterizerState;
+    state->alphaToCoverage = rasterizer->alphaToCoverageEnabled;
+    state->cullEnabled = rasterizer->cullMode != VGPU_CULL_MODE_NONE;
+    state->cullFace = rasterizer->cullMode == VGPU_CULL_MODE_FRONT ? GL_FRONT : GL_BACK;
+    state->frontFace = rasterizer->frontFace == VGPU_FRONT_FACE_CW ? GL_CW : GL_CCW;
+    state->depthBias = rasterizer->depthBias;
+    state->depthBiasSlopeScale = rasterizer->depthBiasSlopeScale;
+
+    _gl.frameStats.resourcesCreated++;
+    return _VGPU_HANDLE(VGpuPipeline, id);
 }
 
-void vgpuDestroyPipeline(VGpuPipeline pipeline) {
+void vgpuDestroyPipeline(VGpuPipeline handle) {
+    const _VGpuGLPipeline* pipeline = _VGPU_GL_PIPELINE(handle);
     if (!pipeline) {
         return;
     }
 
     _VGPU_CHECK_ERROR();
-    _VGPU_FREE(pipeline);
+    _vgpuGLInvalidateVertexArrays(pipeline, 0);
+    if (_gl.state.currentPipeline == pipeline) {
+        _gl.state.currentPipeline = NULL;
+    }
+    _gl.frameStats.resourcesDestroyed++;
+    _vgpu_pool_retire(_gl.pipelines, _VGPU_HANDLE_ID(handle), _gl.frameIndex);
+    _VGPU_CHECK_ERROR();
+}
+
+/* Release objects destroyed during frames the GPU has completed. */
+static void _vgpuGLCollectRetired(uint32_t completedFrame) {
+    _VGpuGLTexture* texture;
+    while ((texture = (_VGpuGLTexture*)_vgpu_pool_collect(_gl.textures, completedFrame)) != NULL) {
+        _vgpuGLReleaseTexture(texture);
+    }
+
+    _VGpuGLBuffer* buffer;
+    while ((buffer = (_VGpuGLBuffer*)_vgpu_pool_collect(_gl.buffers, completedFrame)) != NULL) {
+        _vgpuGLReleaseBuffer(buffer);
+    }
+
+    _VGpuGLShader* shader;
+    while ((shader = (_VGpuGLShader*)_vgpu_pool_collect(_gl.shaders, completedFrame)) != NULL) {
+        _vgpuGLReleaseShader(shader);
+    }
+
+    /* Pipelines own no GL object. */
+    while (_vgpu_pool_collect(_gl.pipelines, completedFrame) != NULL) {
+    }
     _VGPU_CHECK_ERROR();
 }
 
 /* Commands */
 void vgpuBeginDefaultRenderPass(VGpuColor clearColor, float clearDepth, uint8_t clearStencil) {
+    _vgpuGLBeginPass();
     glBindFramebuffer(GL_FRAMEBUFFER, _gl.default_framebuffer);
     glViewport(0, 0, _gl.width, _gl.height);
     glScissor(0, 0, _gl.width, _gl.height);
@@ -1238,48 +2893,170 @@ void vgpuBeginDefaultRenderPass(VGpuColor clearColor, float clearDepth, uint8_t
     glDepthMask(GL_TRUE);
     glClearBufferfv(GL_DEPTH, 0, &clearDepth);
     _VGPU_CHECK_ERROR();
+
+    /* Keep the cache in sync with the masks the clear needed. */
+    _gl.state.render.blend[0].writeMask = VGPU_COLOR_WRITE_MASK_ALL;
+    _gl.state.render.depthWrite = true;
 }
 
 void vgpuBeginRenderPass(const VGpuRenderPassBeginDescriptor* descriptor) {
+    _vgpuGLBeginPass();
 }
 
 void vgpuEndRenderPass() {
+#if defined(VGPU_GL)
+    if (_gl.timer.active) {
+        glEndQuery(GL_TIME_ELAPSED);
+        _gl.timer.active = false;
+    }
+#endif
+}
+
+void vgpuSetViewport(float x, float y, float width, float height) {
+    glViewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
+    _VGPU_CHECK_ERROR();
+}
+
+void vgpuSetScissor(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    glScissor(x, y, (GLsizei)width, (GLsizei)height);
+    _VGPU_CHECK_ERROR();
 }
 
-void vgpuBindPipeline(VGpuPipeline pipeline) {
-    if (_gl.state.currentPipeline != pipeline)
+void vgpuBindPipeline(VGpuPipeline handle) {
+    const _VGpuGLPipeline* pipeline = _VGPU_GL_PIPELINE(handle);
+    if (!pipeline) {
+        return;
+    }
+
+    if (_VGPU_GL_STATE_CHANGED(_gl.state.currentPipeline != pipeline))
     {
         _gl.state.currentPipeline = pipeline;
+        _gl.state.vertexArrayValid = false;
+        _gl.frameCounters.pipelineSwitches++;
 
         /* Bind program */
-        _vgpuGLUseProgram(pipeline->shader->gl_handle);
+        _vgpuGLUseProgram(pipeline->gl_program);
+
+        /* Issue only the fixed function state that differs from the cache */
+        _vgpuGLApplyRenderState(&pipeline->gl_state);
     }
 }
 
-static void _vgpuGLPrepareDraw() {
-    /* vertex attributes */
-    uint32_t vb_offset = 0;
-    for (uint32_t i = 0; i < VGPU_MAX_VERTEX_ATTRIBUTES; i++) {
-        _VGpuGLVertexAttribute* gl_attr = &_gl.state.currentPipeline->gl_attrs[i];
-        if (gl_attr->vb_index >= 0) {
-            vb_offset = gl_attr->offset;
+void vgpuSetUniformBuffer(uint32_t binding, VGpuBuffer handle, uint64_t offset, uint64_t size) {
+    _VGPU_ASSERT(binding < VGPU_MAX_UNIFORM_BUFFER_BINDINGS);
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(handle);
+    _VGpuGLUniformBufferBinding* slot = &_gl.state.uniformBuffers[binding];
+    slot->buffer = buffer ? buffer->gl_handle : 0;
+    slot->offset = (GLintptr)offset;
+    slot->size = (GLsizeiptr)size;
+}
 
-            if (gl_attr->integer) {
-                glVertexAttribIPointer(i, gl_attr->size, gl_attr->type, gl_attr->stride, (const GLvoid*)(GLintptr)vb_offset);
+void vgpuSetTexture(uint32_t binding, VGpuTexture handle) {
+    _VGPU_ASSERT(binding < VGPU_MAX_TEXTURE_BINDINGS);
+    _gl.state.textureBindings[binding] = _VGPU_GL_TEXTURE(handle);
+}
+
+void vgpuSetVertexBuffers(uint32_t firstBinding, uint32_t count, const VGpuBuffer* buffers, const uint64_t* offsets) {
+    _VGPU_ASSERT(firstBinding + count <= VGPU_MAX_VERTEX_BUFFER_BINDINGS);
+    _VGpuGLVertexBindings* bindings = &_gl.state.vertexBindings;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t slot = firstBinding + i;
+        const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(buffers[i]);
+        const GLuint handle = buffer ? buffer->gl_handle : 0;
+        const GLintptr offset = offsets ? (GLintptr)offsets[i] : 0;
+        if (_VGPU_GL_STATE_CHANGED(bindings->buffers[slot] != handle || bindings->offsets[slot] != offset)) {
+            bindings->buffers[slot] = handle;
+            bindings->offsets[slot] = offset;
+            _gl.state.vertexArrayValid = false;
+        }
+    }
+}
+
+void vgpuSetIndexBuffer(VGpuBuffer indexBuffer, uint64_t offset, VGpuIndexType indexType) {
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(indexBuffer);
+    const GLuint handle = buffer ? buffer->gl_handle : 0;
+    _VGPU_ASSERT(!buffer || (buffer->usage & VGPU_BUFFER_USAGE_INDEX));
+    if (_VGPU_GL_STATE_CHANGED(_gl.state.vertexBindings.indexBuffer != handle)) {
+        _gl.state.vertexBindings.indexBuffer = handle;
+        _gl.state.vertexArrayValid = false;
+    }
+
+    _gl.state.indexSize = indexType == VGPU_INDEX_TYPE_UINT32 ? 4 : 2;
+    _gl.state.indexType = indexType == VGPU_INDEX_TYPE_UINT32 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    _gl.state.indexOffset = (GLintptr)offset;
+    _VGPU_ASSERT((offset % _gl.state.indexSize) == 0);
+}
+
+/* Walk the binding table of the current program, issuing only the bindings that changed. */
+static void _vgpuGLApplyBindings(const _VGpuGLBindingTable* table) {
+    for (uint32_t i = 0; i < table->uniformBufferCount; i++) {
+        const uint32_t slot = table->uniformBuffers[i];
+        const _VGpuGLUniformBufferBinding* binding = &_gl.state.uniformBuffers[slot];
+        _VGpuGLUniformBufferBinding* bound = &_gl.state.boundUniformBuffers[slot];
+        _VGPU_ASSERT(binding->size == 0 || binding->size >= table->uniformBufferSizes[i]);
+        if (_VGPU_GL_STATE_CHANGED(bound->buffer != binding->buffer || bound->offset != binding->offset || bound->size != binding->size)) {
+            *bound = *binding;
+            _gl.frameStats.bufferBinds++;
+            if (binding->size > 0) {
+                glBindBufferRange(GL_UNIFORM_BUFFER, slot, binding->buffer, binding->offset, binding->size);
             }
             else {
-                glVertexAttribPointer(i, gl_attr->size, gl_attr->type, gl_attr->normalized, gl_attr->stride, (const GLvoid*)(GLintptr)vb_offset);
+                glBindBufferBase(GL_UNIFORM_BUFFER, slot, binding->buffer);
             }
-            glVertexAttribDivisor(i, gl_attr->divisor);
-            glEnableVertexAttribArray(i);
+
+            /* indexed binds replace the generic binding too */
+            _gl.state.buffers[_VGPU_GL_BUFFER_UNIFORM] = binding->buffer;
+        }
+    }
+
+    for (uint32_t i = 0; i < table->textureCount; i++) {
+        const uint32_t slot = table->textures[i];
+        if (_gl.state.textureBindings[slot]) {
+            _vgpuGLBindTexture(_gl.state.textureBindings[slot], slot);
         }
     }
+    _VGPU_CHECK_ERROR();
+}
+
+static void _vgpuGLPrepareDraw() {
+    const _VGpuGLPipeline* pipeline = _gl.state.currentPipeline;
+    _vgpuGLApplyBindings(&pipeline->gl_bindings);
+
+    /* vertex arrays are cached per pipeline and vertex buffers, offsets are re-pointed on the cached object */
+    if (!_VGPU_GL_STATE_CHANGED(!_gl.state.vertexArrayValid)) {
+        return;
+    }
+
+    _VGpuGLVertexBindings bindings;
+    memset(&bindings, 0, sizeof(bindings));
+    for (uint32_t i = 0; i < VGPU_MAX_VERTEX_BUFFER_BINDINGS; i++) {
+        if (pipeline->vertex_layout_valid[i]) {
+            bindings.buffers[i] = _gl.state.vertexBindings.buffers[i];
+            bindings.offsets[i] = _gl.state.vertexBindings.offsets[i];
+        }
+    }
+    bindings.indexBuffer = _gl.state.vertexBindings.indexBuffer;
+
+    const GLuint vao = _vgpuGLGetVertexArray(pipeline, &bindings);
+    if (_gl.state.vertexArray != vao) {
+        glBindVertexArray(vao);
+        _gl.state.vertexArray = vao;
+    }
+    _gl.state.vertexArrayValid = true;
+}
+
+static void _vgpuGLCountDraw(uint32_t vertexCount, uint32_t instanceCount) {
+    const uint32_t instances = instanceCount > 1 ? instanceCount : 1;
+    _gl.frameStats.draws++;
+    _gl.frameStats.instances += instances;
+    _gl.frameStats.primitives += vgpuGetPrimitiveCount(_gl.state.currentPipeline->primitiveTopology, vertexCount) * instances;
 }
 
 void vgpuDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex) {
     GLenum primitive_type = _gl.state.currentPipeline->topology;
 
     _vgpuGLPrepareDraw();
+    _vgpuGLCountDraw(vertexCount, instanceCount);
 
     if (instanceCount > 1) {
         glDrawArraysInstanced(primitive_type, firstVertex, vertexCount, instanceCount);
@@ -1290,6 +3067,108 @@ void vgpuDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex
     _VGPU_CHECK_ERROR();
 }
 
+void vgpuDrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex) {
+    _VGPU_ASSERT(_gl.state.vertexBindings.indexBuffer);
+    GLenum primitive_type = _gl.state.currentPipeline->topology;
+
+    _vgpuGLPrepareDraw();
+    _vgpuGLCountDraw(indexCount, instanceCount);
+
+    const GLvoid* indices = (const GLvoid*)(_gl.state.indexOffset + (GLintptr)firstIndex * _gl.state.indexSize);
+    if (baseVertex != 0) {
+#if defined(VGPU_WEBGL)
+        _vgpu_log(vgpu_log_type_error, "vgpuDrawIndexed: base vertex is not supported on WebGL");
+        return;
+#else
+        glDrawElementsInstancedBaseVertex(primitive_type, (GLsizei)indexCount, _gl.state.indexType, indices, instanceCount > 1 ? (GLsizei)instanceCount : 1, baseVertex);
+#endif
+    }
+    else if (instanceCount > 1) {
+        glDrawElementsInstanced(primitive_type, (GLsizei)indexCount, _gl.state.indexType, indices, (GLsizei)instanceCount);
+    }
+    else {
+        glDrawElements(primitive_type, (GLsizei)indexCount, _gl.state.indexType, indices);
+    }
+    _VGPU_CHECK_ERROR();
+}
+
+#if !defined(VGPU_WEBGL)
+static void _vgpuGLBindIndirectBuffer(const _VGpuGLBuffer* buffer) {
+    _VGPU_ASSERT(_gl.features.drawIndirect);
+    _VGPU_ASSERT(buffer->usage & VGPU_BUFFER_USAGE_INDIRECT);
+    if (_VGPU_GL_STATE_CHANGED(_gl.state.indirectBuffer != buffer->gl_handle)) {
+        _gl.state.indirectBuffer = buffer->gl_handle;
+        _gl.frameStats.bufferBinds++;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer->gl_handle);
+    }
+}
+#endif
+
+void vgpuDrawIndirect(VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride) {
+#if defined(VGPU_WEBGL)
+    _vgpu_log(vgpu_log_type_error, "vgpuDrawIndirect: indirect draws are not supported on WebGL");
+#else
+    GLenum primitive_type = _gl.state.currentPipeline->topology;
+    if (stride == 0) {
+        stride = sizeof(VGpuDrawIndirectCommand);
+    }
+
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(indirectBuffer);
+    if (!buffer) {
+        return;
+    }
+
+    _vgpuGLPrepareDraw();
+    _vgpuGLBindIndirectBuffer(buffer);
+    _gl.frameStats.draws += drawCount;
+
+    /* Without multi draw the loop still saves the CPU side argument setup of each draw. */
+    if (drawCount > 1 && _gl.features.multiDrawIndirect) {
+        glMultiDrawArraysIndirect(primitive_type, (const void*)(uintptr_t)offset, (GLsizei)drawCount, (GLsizei)stride);
+    }
+    else {
+        for (uint32_t i = 0; i < drawCount; i++) {
+            glDrawArraysIndirect(primitive_type, (const void*)(uintptr_t)(offset + (uint64_t)i * stride));
+        }
+    }
+    _VGPU_CHECK_ERROR();
+#endif
+}
+
+void vgpuDrawIndexedIndirect(VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride) {
+#if defined(VGPU_WEBGL)
+    _vgpu_log(vgpu_log_type_error, "vgpuDrawIndexedIndirect: indirect draws are not supported on WebGL");
+#else
+    _VGPU_ASSERT(_gl.state.vertexBindings.indexBuffer);
+    GLenum primitive_type = _gl.state.currentPipeline->topology;
+    if (stride == 0) {
+        stride = sizeof(VGpuDrawIndexedIndirectCommand);
+    }
+
+    /* GL reads firstIndex relative to the start of the index buffer, the bound offset cannot be applied. */
+    _VGPU_ASSERT(_gl.state.indexOffset == 0);
+
+    const _VGpuGLBuffer* buffer = _VGPU_GL_BUFFER(indirectBuffer);
+    if (!buffer) {
+        return;
+    }
+
+    _vgpuGLPrepareDraw();
+    _vgpuGLBindIndirectBuffer(buffer);
+    _gl.frameStats.draws += drawCount;
+
+    if (drawCount > 1 && _gl.features.multiDrawIndirect) {
+        glMultiDrawElementsIndirect(primitive_type, _gl.state.indexType, (const void*)(uintptr_t)offset, (GLsizei)drawCount, (GLsizei)stride);
+    }
+    else {
+        for (uint32_t i = 0; i < drawCount; i++) {
+            glDrawElementsIndirect(primitive_type, _gl.state.indexType, (const void*)(uintptr_t)(offset + (uint64_t)i * stride));
+        }
+    }
+    _VGPU_CHECK_ERROR();
+#endif
+}
+
 void vgpuDispatch(VGpuShader computeShader, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
 #if defined(VGPU_WEBGL)
     _VGPU_THROW("Compute shaders are not supported on WebGL");
@@ -1298,8 +3177,15 @@ void vgpuDispatch(VGpuShader computeShader, uint32_t groupCountX, uint32_t group
         //_VGPU_THROW("Compute shaders are not supported on this system");
     }
 
-    glUseProgram(computeShader->gl_handle);
+    const _VGpuGLShader* shader = _VGPU_GL_SHADER(computeShader);
+    if (!shader) {
+        return;
+    }
+
+    _vgpuGLUseProgram(shader->gl_handle);
+    _vgpuGLApplyBindings(&shader->gl_bindings);
     glDispatchCompute(groupCountX, groupCountY, groupCountZ);
+    _gl.frameStats.dispatches++;
     glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 
     _VGPU_CHECK_ERROR();
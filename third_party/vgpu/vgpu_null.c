@@ -0,0 +1,1039 @@
+//
+// Copyright (c) 2017-2019 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#if defined(VGPU_NULL)
+#include "vgpu.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Host allocations go through the callbacks set with vgpuSetAllocationCallbacks. */
+extern void* _vgpu_alloc(size_t size);
+extern void* _vgpu_calloc(size_t size);
+extern void _vgpu_free(void* ptr);
+extern uint64_t _vgpu_texture_memory_size(const VGpuTextureDescriptor* descriptor);
+extern void _vgpu_track_texture(uint64_t size, VGpuTextureUsageFlags usage, bool created);
+extern void _vgpu_track_buffer(uint64_t size, bool created);
+
+/* Object pools, see vgpu.c */
+typedef struct _VGpuPool _VGpuPool;
+extern _VGpuPool* _vgpu_pool_create(uint32_t capacity, uint32_t itemSize);
+extern void _vgpu_pool_destroy(_VGpuPool* pool);
+extern uint32_t _vgpu_pool_alloc(_VGpuPool* pool, void** item);
+extern void* _vgpu_pool_get(const _VGpuPool* pool, uint32_t id);
+extern void _vgpu_pool_retire(_VGpuPool* pool, uint32_t id, uint32_t frame);
+extern void* _vgpu_pool_collect(_VGpuPool* pool, uint32_t completedFrame);
+extern uint32_t _vgpu_pool_live_count(const _VGpuPool* pool);
+
+#define _VGPU_ALLOC(type)           ((type*) _vgpu_alloc(sizeof(type)))
+#define _VGPU_ALLOCN(type, n)       ((type*) _vgpu_alloc(sizeof(type) * n))
+#define _VGPU_FREE(ptr)             (_vgpu_free((void*)(ptr)))
+#define _VGPU_HANDLE(type, id)      ((type)(uintptr_t)(id))
+#define _VGPU_HANDLE_ID(handle)     ((uint32_t)(uintptr_t)(handle))
+
+#ifndef _VGPU_ASSERT
+#   include <assert.h>
+#   define _VGPU_ASSERT(c) assert(c)
+#endif
+
+#ifndef _VGPU_UNREACHABLE
+#   define _VGPU_UNREACHABLE _VGPU_ASSERT(false)
+#endif
+
+/* Pooled objects, handles are pool ids so stale or mistyped handles fail the lookup. */
+typedef struct _VGpuNullTexture {
+    VGpuTextureType         textureType;
+    VGpuPixelFormat         pixelFormat;
+    VGpuExtent3D            size;
+    uint32_t                mipLevels;
+    uint32_t                arrayLayers;
+    VgpuSampleCount         samples;
+    VGpuTextureUsageFlags   usage;
+    uint64_t                memorySize;     /* estimated device bytes */
+    bool                    external_handle;
+} _VGpuNullTexture;
+
+typedef struct _VGpuNullFramebuffer {
+    uint32_t                width;
+    uint32_t                height;
+    uint32_t                layers;
+    uint32_t                colorAttachmentCount;
+    bool                    hasDepthStencil;
+} _VGpuNullFramebuffer;
+
+typedef struct _VGpuNullBuffer {
+    uint64_t            size;
+    VGpuBufferUsage     usage;
+    VGpuResourceUsage   resourceUsage;
+    void*               data;       /* host memory standing in for the mapping of DYNAMIC and STREAM buffers */
+} _VGpuNullBuffer;
+
+typedef struct _VGpuNullShader {
+    bool                compute;
+} _VGpuNullShader;
+
+typedef struct _VGpuNullPipeline {
+    uint32_t                shader;     /* id of the shader, only compared to count program changes */
+    VGpuPrimitiveTopology   topology;
+} _VGpuNullPipeline;
+
+#define _VGPU_NULL_MAX_FRAMES_IN_FLIGHT (4u)
+#define _VGPU_NULL_DEFAULT_TRANSIENT_SIZE (2u * 1024u * 1024u)
+
+typedef enum _VGpuNullTransientRing {
+    _VGPU_NULL_TRANSIENT_VERTEX,
+    _VGPU_NULL_TRANSIENT_INDEX,
+    _VGPU_NULL_TRANSIENT_UNIFORM,
+    _VGPU_NULL_TRANSIENT_STORAGE,
+    _VGPU_NULL_TRANSIENT_COUNT
+} _VGpuNullTransientRing;
+
+typedef struct _vgpu_null_transient_ring {
+    VGpuBuffer          buffer;
+    uint64_t            offset;
+    uint32_t            frameIndex;
+} _vgpu_null_transient_ring;
+
+typedef struct _vgpu_null_frame_counters {
+    uint32_t    renderPasses;
+    uint32_t    draws;
+    uint32_t    pipelineBinds;
+    uint32_t    dispatches;
+    uint32_t    programBinds;
+    uint32_t    textureBinds;
+    uint32_t    bufferBinds;
+    uint32_t    resourcesCreated;
+    uint32_t    resourcesDestroyed;
+    uint64_t    vertices;
+    uint64_t    instances;
+    uint64_t    primitives;
+    uint64_t    bytesUploaded;
+} _vgpu_null_frame_counters;
+
+static struct {
+    bool                        initialized;
+    uint32_t                    frameIndex;
+    VGpuLimits                  limits;
+    uint32_t                    width;
+    uint32_t                    height;
+
+    /* state */
+    bool                        insideRenderPass;
+    VGpuPipeline                currentPipeline;
+    VGpuBuffer                  indexBuffer;
+    uint64_t                    indexOffset;
+    uint32_t                    indexSize;
+
+    /* transient rings, one segment per frame in flight */
+    uint64_t                    transientFrameSize;
+    uint32_t                    transientFrameCount;
+    _vgpu_null_transient_ring   transient[_VGPU_NULL_TRANSIENT_COUNT];
+
+    /* object pools */
+    _VGpuPool*                  textures;
+    _VGpuPool*                  framebuffers;
+    _VGpuPool*                  buffers;
+    _VGpuPool*                  shaders;
+    _VGpuPool*                  pipelines;
+
+    /* counters */
+    VGpuNullCounters            counters;
+    _vgpu_null_frame_counters   frame;
+    VGpuFrameStats              stats;
+} _null = { 0 };
+
+extern void _vgpu_log(vgpu_log_type type, const char *message);
+
+static void _vgpuNullLogError(const char* function, const char* message) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s: %s\n", function, message);
+    _vgpu_log(vgpu_log_type_error, buffer);
+}
+
+#define _VGPU_NULL_VALIDATE(cond, message, ...) \
+    if (!(cond)) { _vgpuNullLogError(__func__, message); return __VA_ARGS__; }
+
+/* Resolve a handle, NULL when it is NULL, stale or vgpu is not initialized. */
+static void* _vgpuNullGet(const _VGpuPool* pool, uint32_t id) {
+    return pool ? _vgpu_pool_get(pool, id) : NULL;
+}
+
+#define _VGPU_NULL_TEXTURE(handle)      ((_VGpuNullTexture*)_vgpuNullGet(_null.textures, _VGPU_HANDLE_ID(handle)))
+#define _VGPU_NULL_FRAMEBUFFER(handle)  ((_VGpuNullFramebuffer*)_vgpuNullGet(_null.framebuffers, _VGPU_HANDLE_ID(handle)))
+#define _VGPU_NULL_BUFFER(handle)       ((_VGpuNullBuffer*)_vgpuNullGet(_null.buffers, _VGPU_HANDLE_ID(handle)))
+#define _VGPU_NULL_SHADER(handle)       ((_VGpuNullShader*)_vgpuNullGet(_null.shaders, _VGPU_HANDLE_ID(handle)))
+#define _VGPU_NULL_PIPELINE(handle)     ((_VGpuNullPipeline*)_vgpuNullGet(_null.pipelines, _VGPU_HANDLE_ID(handle)))
+
+/* Allocate a zeroed object from pool, 0 when vgpu is not initialized or the pool is full. */
+static uint32_t _vgpuNullAlloc(_VGpuPool* pool, const char* function, void** item) {
+    *item = NULL;
+    _VGPU_NULL_VALIDATE(pool, "vgpu is not initialized", 0);
+    const uint32_t id = _vgpu_pool_alloc(pool, item);
+    if (!id) {
+        _vgpuNullLogError(function, "object pool is full");
+    }
+    return id;
+}
+
+static void _vgpuNullCollectRetired(uint32_t completedFrame);
+
+static void _vgpuNullOnCreate(uint32_t* live) {
+    (*live)++;
+    _null.counters.objectsCreated++;
+    _null.frame.resourcesCreated++;
+}
+
+static void _vgpuNullOnDestroy(uint32_t* live) {
+    _VGPU_ASSERT(*live > 0);
+    (*live)--;
+    _null.counters.objectsDestroyed++;
+    _null.frame.resourcesDestroyed++;
+}
+
+VGpuBackend vgpuGetBackend() {
+    return VGPU_BACKEND_NULL;
+}
+
+bool vgpuInitialize(const char* appName, const VGpuRendererSettings* settings)
+{
+    if (_null.initialized) {
+        _vgpu_log(vgpu_log_type_error, "vgpu already initialized");
+        return true;
+    }
+
+    _VGPU_NULL_VALIDATE(settings, "settings cannot be NULL", false);
+
+    memset(&_null, 0, sizeof(_null));
+    _null.width = settings->width;
+    _null.height = settings->height;
+    _null.transientFrameCount = settings->swapchain.imageCount ? settings->swapchain.imageCount : 2;
+    if (_null.transientFrameCount > _VGPU_NULL_MAX_FRAMES_IN_FLIGHT) {
+        _null.transientFrameCount = _VGPU_NULL_MAX_FRAMES_IN_FLIGHT;
+    }
+    _null.transientFrameSize = settings->transientBufferSize ? settings->transientBufferSize : _VGPU_NULL_DEFAULT_TRANSIENT_SIZE;
+    _null.transientFrameSize = (_null.transientFrameSize + 4095u) & ~(uint64_t)4095u;
+
+    _null.limits.maxTextureDimension2D = 16384;
+    _null.limits.maxTextureDimension3D = 2048;
+    _null.limits.maxTextureDimensionCube = 16384;
+    _null.limits.maxTextureArrayLayers = 2048;
+    _null.limits.maxColorAttachments = VGPU_MAX_COLOR_ATTACHMENTS;
+    _null.limits.maxUniformBufferSize = 65536;
+    _null.limits.minUniformBufferOffsetAlignment = 256;
+    _null.limits.maxStorageBufferSize = 128u * 1024u * 1024u;
+    _null.limits.minStorageBufferOffsetAlignment = 16;
+    _null.limits.maxSamplerAnisotropy = 16;
+    _null.limits.maxViewports = 16;
+    _null.limits.maxViewportDimensions[0] = 16384;
+    _null.limits.maxViewportDimensions[1] = 16384;
+    _null.limits.maxPatchVertices = 32;
+    _null.limits.pointSizeRange[0] = 1.0f;
+    _null.limits.pointSizeRange[1] = 64.0f;
+    _null.limits.lineWidthRange[0] = 1.0f;
+    _null.limits.lineWidthRange[1] = 1.0f;
+    _null.limits.maxComputeSharedMemorySize = 32768;
+    _null.limits.maxComputeWorkGroupCount[0] = 65535;
+    _null.limits.maxComputeWorkGroupCount[1] = 65535;
+    _null.limits.maxComputeWorkGroupCount[2] = 65535;
+    _null.limits.maxComputeWorkGroupInvocations = 1024;
+    _null.limits.maxComputeWorkGroupSize[0] = 1024;
+    _null.limits.maxComputeWorkGroupSize[1] = 1024;
+    _null.limits.maxComputeWorkGroupSize[2] = 64;
+
+    _null.textures = _vgpu_pool_create(settings->maxTextures, sizeof(_VGpuNullTexture));
+    _null.framebuffers = _vgpu_pool_create(settings->maxFramebuffers, sizeof(_VGpuNullFramebuffer));
+    _null.buffers = _vgpu_pool_create(settings->maxBuffers, sizeof(_VGpuNullBuffer));
+    _null.shaders = _vgpu_pool_create(settings->maxShaders, sizeof(_VGpuNullShader));
+    _null.pipelines = _vgpu_pool_create(settings->maxPipelines, sizeof(_VGpuNullPipeline));
+    if (!_null.textures || !_null.framebuffers || !_null.buffers || !_null.shaders || !_null.pipelines) {
+        _vgpu_pool_destroy(_null.textures);
+        _vgpu_pool_destroy(_null.framebuffers);
+        _vgpu_pool_destroy(_null.buffers);
+        _vgpu_pool_destroy(_null.shaders);
+        _vgpu_pool_destroy(_null.pipelines);
+        memset(&_null, 0, sizeof(_null));
+        _vgpu_log(vgpu_log_type_error, "vgpu failed to allocate object pools");
+        return false;
+    }
+
+    _vgpu_log(vgpu_log_type_debug, "vgpu initialized with success (null backend)");
+    _null.initialized = true;
+    return true;
+}
+
+void vgpuShutdown()
+{
+    if (!_null.initialized) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < _VGPU_NULL_TRANSIENT_COUNT; i++) {
+        vgpuDestroyBuffer(_null.transient[i].buffer);
+        _null.transient[i].buffer = NULL;
+    }
+
+    /* There is no GPU to wait for, every retired object can go. */
+    _vgpuNullCollectRetired(_null.frameIndex);
+
+    const uint32_t leaked = _vgpu_pool_live_count(_null.textures) + _vgpu_pool_live_count(_null.framebuffers)
+        + _vgpu_pool_live_count(_null.buffers) + _vgpu_pool_live_count(_null.shaders) + _vgpu_pool_live_count(_null.pipelines);
+    if (leaked > 0) {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "vgpu shutdown with %u live objects\n", leaked);
+        _vgpu_log(vgpu_log_type_warn, buffer);
+    }
+
+    _vgpu_pool_destroy(_null.textures);
+    _vgpu_pool_destroy(_null.framebuffers);
+    _vgpu_pool_destroy(_null.buffers);
+    _vgpu_pool_destroy(_null.shaders);
+    _vgpu_pool_destroy(_null.pipelines);
+    _null.textures = NULL;
+    _null.framebuffers = NULL;
+    _null.buffers = NULL;
+    _null.shaders = NULL;
+    _null.pipelines = NULL;
+
+    _null.initialized = false;
+    _vgpu_log(vgpu_log_type_debug, "vgpu shutdown with success");
+}
+
+bool vgpuQueryFeature(VGpuFeature feature) {
+    _VGPU_ASSERT(_null.initialized);
+
+    switch (feature)
+    {
+    case VGPU_FEATURE_TEXTURE_COMPRESSION_PVRTC:
+    case VGPU_FEATURE_TEXTURE_COMPRESSION_ETC2:
+    case VGPU_FEATURE_TEXTURE_COMPRESSION_ATC:
+    case VGPU_FEATURE_TEXTURE_COMPRESSION_ASTC:
+    case VGPU_FEATURE_RAYTRACING:
+        return false;
+
+    default:
+        return true;
+    }
+}
+
+void vgpuQueryLimits(VGpuLimits* pLimits) {
+    _VGPU_ASSERT(_null.initialized);
+    _VGPU_NULL_VALIDATE(pLimits, "pLimits cannot be NULL");
+
+    memcpy(pLimits, &_null.limits, sizeof(VGpuLimits));
+}
+
+uint32_t vgpuFrame() {
+    _VGPU_NULL_VALIDATE(!_null.insideRenderPass, "frame submitted inside render pass", _null.frameIndex);
+
+    _null.counters.renderPasses = _null.frame.renderPasses;
+    _null.counters.draws = _null.frame.draws;
+    _null.counters.pipelineBinds = _null.frame.pipelineBinds;
+    _null.counters.dispatches = _null.frame.dispatches;
+    _null.counters.vertices = _null.frame.vertices;
+    _null.counters.instances = _null.frame.instances;
+    _null.counters.bytesUploaded = _null.frame.bytesUploaded;
+
+    memset(&_null.stats, 0, sizeof(_null.stats));
+    _null.stats.frameIndex = _null.frameIndex;
+    _null.stats.renderPasses = _null.frame.renderPasses;
+    _null.stats.draws = _null.frame.draws;
+    _null.stats.dispatches = _null.frame.dispatches;
+    _null.stats.instances = _null.frame.instances;
+    _null.stats.primitives = _null.frame.primitives;
+    _null.stats.pipelineBinds = _null.frame.pipelineBinds;
+    _null.stats.programBinds = _null.frame.programBinds;
+    _null.stats.textureBinds = _null.frame.textureBinds;
+    _null.stats.bufferBinds = _null.frame.bufferBinds;
+    _null.stats.resourcesCreated = _null.frame.resourcesCreated;
+    _null.stats.resourcesDestroyed = _null.frame.resourcesDestroyed;
+    _null.stats.bytesUploaded = _null.frame.bytesUploaded;
+    memset(&_null.frame, 0, sizeof(_null.frame));
+
+    /* Bindings persist across frames like the GL state cache, so pipelineBinds matches between backends. */
+    _null.counters.frameIndex = _null.frameIndex;
+
+    /* Pretend the GPU runs transientFrameCount frames behind, objects retired in older frames are released. */
+    const uint32_t frameIndex = _null.frameIndex++;
+    if (_null.frameIndex >= _null.transientFrameCount) {
+        _vgpuNullCollectRetired(_null.frameIndex - _null.transientFrameCount);
+    }
+    return frameIndex;
+}
+
+void vgpuGetFrameStats(VGpuFrameStats* stats) {
+    _VGPU_NULL_VALIDATE(stats, "stats cannot be NULL");
+    /* There is no GPU to time, gpuPassCount stays 0. */
+    memcpy(stats, &_null.stats, sizeof(VGpuFrameStats));
+}
+
+void vgpuGetStateCacheCounters(VGpuStateCacheCounters* counters) {
+    _VGPU_NULL_VALIDATE(counters, "counters cannot be NULL");
+    /* Nothing reaches a driver, there is no state to filter. */
+    memset(counters, 0, sizeof(VGpuStateCacheCounters));
+    counters->pipelineSwitches = _null.counters.pipelineBinds;
+}
+
+void vgpuNullGetCounters(VGpuNullCounters* counters) {
+    _VGPU_NULL_VALIDATE(counters, "counters cannot be NULL");
+    memcpy(counters, &_null.counters, sizeof(VGpuNullCounters));
+}
+
+/* Texture */
+static bool _vgpuNullValidateTextureDescriptor(const VGpuTextureDescriptor* descriptor) {
+    _VGPU_NULL_VALIDATE(descriptor, "descriptor cannot be NULL", false);
+    _VGPU_NULL_VALIDATE(descriptor->textureType < VGPU_TEXTURE_TYPE_COUNT, "invalid texture type", false);
+    _VGPU_NULL_VALIDATE(descriptor->pixelFormat > VGPU_PIXEL_FORMAT_UNDEFINED
+        && descriptor->pixelFormat < VGPU_PIXEL_FORMAT_COUNT, "invalid pixel format", false);
+    _VGPU_NULL_VALIDATE(descriptor->size.width > 0 && descriptor->size.height > 0, "texture size cannot be zero", false);
+    _VGPU_NULL_VALIDATE(descriptor->size.width <= _null.limits.maxTextureDimension2D
+        && descriptor->size.height <= _null.limits.maxTextureDimension2D, "texture size exceeds limits", false);
+    _VGPU_NULL_VALIDATE(descriptor->arrayLayers <= _null.limits.maxTextureArrayLayers, "too many array layers", false);
+    uint32_t maxExtent = descriptor->size.width > descriptor->size.height ? descriptor->size.width : descriptor->size.height;
+    if (descriptor->textureType == VGPU_TEXTURE_TYPE_3D && descriptor->size.depth > maxExtent) {
+        maxExtent = descriptor->size.depth;
+    }
+    uint32_t maxMipLevels = 1;
+    while (maxExtent >>= 1) {
+        maxMipLevels++;
+    }
+    _VGPU_NULL_VALIDATE(descriptor->mipLevels <= maxMipLevels, "too many mip levels for texture size", false);
+    return true;
+}
+
+static void _vgpuNullSetupTexture(_VGpuNullTexture* texture, const VGpuTextureDescriptor* descriptor)
+{
+    texture->textureType = descriptor->textureType;
+    texture->pixelFormat = descriptor->pixelFormat;
+    texture->size = descriptor->size;
+    texture->mipLevels = descriptor->mipLevels > 0 ? descriptor->mipLevels : 1;
+    texture->arrayLayers = descriptor->arrayLayers > 0 ? descriptor->arrayLayers : 1;
+    texture->samples = descriptor->samples;
+    texture->usage = descriptor->usage;
+}
+
+/* Validate initial data pitches and return the number of bytes it covers, ~0 on error. */
+static uint64_t _vgpuNullValidateTextureData(const _VGpuNullTexture* texture, const VGpuTextureData* initialData, uint32_t layerCount) {
+    uint64_t bytes = 0;
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        for (uint32_t mip = 0; mip < texture->mipLevels; mip++) {
+            const VGpuTextureData* subresource = &initialData[layer * texture->mipLevels + mip];
+            if (!subresource->data) {
+                continue;
+            }
+
+            const uint32_t width = (texture->size.width >> mip) > 0 ? texture->size.width >> mip : 1;
+            const uint32_t height = (texture->size.height >> mip) > 0 ? texture->size.height >> mip : 1;
+            const uint32_t depth = texture->textureType == VGPU_TEXTURE_TYPE_3D && (texture->size.depth >> mip) > 0 ? texture->size.depth >> mip : 1;
+            uint32_t rowPitch, rowCount;
+            uint64_t slicePitch;
+            vgpuGetSurfaceLayout(texture->pixelFormat, width, height, &rowPitch, &rowCount, &slicePitch);
+
+            _VGPU_NULL_VALIDATE(subresource->rowPitch == 0 || subresource->rowPitch >= rowPitch, "texture data row pitch is too small", ~0ull);
+            const uint64_t dataRowPitch = subresource->rowPitch ? subresource->rowPitch : rowPitch;
+            _VGPU_NULL_VALIDATE(subresource->slicePitch == 0 || subresource->slicePitch >= dataRowPitch * rowCount, "texture data slice pitch is too small", ~0ull);
+            bytes += slicePitch * depth;
+        }
+    }
+    return bytes;
+}
+
+VGpuTexture vgpuCreateTexture(const VGpuTextureDescriptor* descriptor, const VGpuTextureData* initialData) {
+    if (!_vgpuNullValidateTextureDescriptor(descriptor)) {
+        return NULL;
+    }
+
+    /* Validate against a scratch copy so that a rejected texture never touches the pool. */
+    _VGpuNullTexture desc;
+    memset(&desc, 0, sizeof(desc));
+    _vgpuNullSetupTexture(&desc, descriptor);
+    uint64_t bytes = 0;
+    if (initialData) {
+        bytes = _vgpuNullValidateTextureData(&desc, initialData, vgpuGetTextureLayerCount(descriptor));
+        if (bytes == ~0ull) {
+            return NULL;
+        }
+    }
+
+    _VGpuNullTexture* texture;
+    const uint32_t id = _vgpuNullAlloc(_null.textures, __func__, (void**)&texture);
+    if (!id) {
+        return NULL;
+    }
+
+    *texture = desc;
+    texture->external_handle = false;
+    texture->memorySize = _vgpu_texture_memory_size(descriptor);
+    _null.frame.bytesUploaded += bytes;
+    _vgpu_track_texture(texture->memorySize, texture->usage, true);
+    _vgpuNullOnCreate(&_null.counters.textures);
+    return _VGPU_HANDLE(VGpuTexture, id);
+}
+
+VGpuTexture vgpuCreateExternalTexture(const VGpuTextureDescriptor* descriptor, void* handle) {
+    if (!_vgpuNullValidateTextureDescriptor(descriptor)) {
+        return NULL;
+    }
+
+    _VGpuNullTexture* texture;
+    const uint32_t id = _vgpuNullAlloc(_null.textures, __func__, (void**)&texture);
+    if (!id) {
+        return NULL;
+    }
+
+    _vgpuNullSetupTexture(texture, descriptor);
+    texture->external_handle = true;
+    _vgpuNullOnCreate(&_null.counters.textures);
+    return _VGPU_HANDLE(VGpuTexture, id);
+}
+
+static void _vgpuNullReleaseTexture(_VGpuNullTexture* texture) {
+    if (!texture->external_handle) {
+        _vgpu_track_texture(texture->memorySize, texture->usage, false);
+    }
+}
+
+void vgpuDestroyTexture(VGpuTexture handle) {
+    if (!handle) {
+        return;
+    }
+
+    _VGPU_NULL_VALIDATE(_VGPU_NULL_TEXTURE(handle), "invalid or destroyed handle");
+    _vgpuNullOnDestroy(&_null.counters.textures);
+    _vgpu_pool_retire(_null.textures, _VGPU_HANDLE_ID(handle), _null.frameIndex);
+}
+
+/* Framebuffer */
+VGpuFramebuffer vgpuCreateFramebuffer(const VGpuFramebufferDescriptor* descriptor) {
+    _VGPU_NULL_VALIDATE(descriptor, "descriptor cannot be NULL", NULL);
+
+    uint32_t colorAttachmentCount = 0;
+    for (uint32_t i = 0; i < VGPU_MAX_COLOR_ATTACHMENTS; i++) {
+        if (!descriptor->colorAttachments[i].texture) {
+            break;
+        }
+
+        const _VGpuNullTexture* texture = _VGPU_NULL_TEXTURE(descriptor->colorAttachments[i].texture);
+        _VGPU_NULL_VALIDATE(texture, "invalid or destroyed handle", NULL);
+        _VGPU_NULL_VALIDATE(!vgpuIsDepthStencilFormat(texture->pixelFormat), "color attachment has depth format", NULL);
+        _VGPU_NULL_VALIDATE(descriptor->colorAttachments[i].level < texture->mipLevels, "invalid attachment mip level", NULL);
+        colorAttachmentCount++;
+    }
+
+    const _VGpuNullTexture* depthStencil = NULL;
+    if (descriptor->depthStencilAttachment.texture) {
+        depthStencil = _VGPU_NULL_TEXTURE(descriptor->depthStencilAttachment.texture);
+        _VGPU_NULL_VALIDATE(depthStencil, "invalid or destroyed handle", NULL);
+        _VGPU_NULL_VALIDATE(vgpuIsDepthStencilFormat(depthStencil->pixelFormat), "depth attachment has color format", NULL);
+    }
+
+    _VGPU_NULL_VALIDATE(colorAttachmentCount > 0 || depthStencil, "framebuffer has no attachments", NULL);
+
+    _VGpuNullFramebuffer* framebuffer;
+    const uint32_t id = _vgpuNullAlloc(_null.framebuffers, __func__, (void**)&framebuffer);
+    if (!id) {
+        return NULL;
+    }
+
+    framebuffer->width = descriptor->width;
+    framebuffer->height = descriptor->height;
+    framebuffer->layers = descriptor->layers;
+    framebuffer->colorAttachmentCount = colorAttachmentCount;
+    framebuffer->hasDepthStencil = depthStencil != NULL;
+    _vgpuNullOnCreate(&_null.counters.framebuffers);
+    return _VGPU_HANDLE(VGpuFramebuffer, id);
+}
+
+void vgpuDestroyFramebuffer(VGpuFramebuffer handle) {
+    if (!handle) {
+        return;
+    }
+
+    _VGPU_NULL_VALIDATE(_VGPU_NULL_FRAMEBUFFER(handle), "invalid or destroyed handle");
+    _vgpuNullOnDestroy(&_null.counters.framebuffers);
+    _vgpu_pool_retire(_null.framebuffers, _VGPU_HANDLE_ID(handle), _null.frameIndex);
+}
+
+/* Buffer */
+VGpuBuffer vgpuCreateBuffer(uint64_t size, VGpuBufferUsage usage, VGpuResourceUsage resourceUsage, const void* data) {
+    _VGPU_NULL_VALIDATE(size > 0, "buffer size cannot be zero", NULL);
+    _VGPU_NULL_VALIDATE(usage != VGPU_BUFFER_USAGE_NONE, "buffer usage cannot be none", NULL);
+    _VGPU_NULL_VALIDATE(resourceUsage != VGPU_RESOURCE_USAGE_IMMUTABLE || data, "immutable buffer requires initial data", NULL);
+
+    _VGpuNullBuffer* buffer;
+    const uint32_t id = _vgpuNullAlloc(_null.buffers, __func__, (void**)&buffer);
+    if (!id) {
+        return NULL;
+    }
+
+    buffer->size = size;
+    buffer->usage = usage;
+    buffer->resourceUsage = resourceUsage;
+    if (resourceUsage == VGPU_RESOURCE_USAGE_DYNAMIC || resourceUsage == VGPU_RESOURCE_USAGE_STREAM) {
+        buffer->data = data ? _vgpu_alloc(size) : _vgpu_calloc(size);
+        _VGPU_ASSERT(buffer->data);
+        if (data) {
+            memcpy(buffer->data, data, size);
+        }
+    }
+    if (data) {
+        _null.frame.bytesUploaded += size;
+    }
+    _vgpu_track_buffer(size, true);
+    _vgpuNullOnCreate(&_null.counters.buffers);
+    return _VGPU_HANDLE(VGpuBuffer, id);
+}
+
+static void _vgpuNullReleaseBuffer(_VGpuNullBuffer* buffer) {
+    _vgpu_track_buffer(buffer->size, false);
+    _VGPU_FREE(buffer->data);
+}
+
+void vgpuDestroyBuffer(VGpuBuffer handle) {
+    if (!handle) {
+        return;
+    }
+
+    _VGPU_NULL_VALIDATE(_VGPU_NULL_BUFFER(handle), "invalid or destroyed handle");
+    if (_null.indexBuffer == handle) {
+        _null.indexBuffer = NULL;
+    }
+    _vgpuNullOnDestroy(&_null.counters.buffers);
+    _vgpu_pool_retire(_null.buffers, _VGPU_HANDLE_ID(handle), _null.frameIndex);
+}
+
+void* vgpuMapBuffer(VGpuBuffer handle) {
+    const _VGpuNullBuffer* buffer = _VGPU_NULL_BUFFER(handle);
+    _VGPU_NULL_VALIDATE(buffer, "invalid or destroyed handle", NULL);
+    return buffer->data;
+}
+
+void vgpuFlushBuffer(VGpuBuffer handle, uint64_t offset, uint64_t size) {
+    const _VGpuNullBuffer* buffer = _VGPU_NULL_BUFFER(handle);
+    _VGPU_NULL_VALIDATE(buffer, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(buffer->data, "buffer is not mappable");
+    _VGPU_NULL_VALIDATE(offset + size <= buffer->size, "flush range exceeds buffer size");
+    _null.frame.bytesUploaded += size;
+}
+
+void vgpuUpdateBuffer(VGpuBuffer handle, uint64_t offset, uint64_t size, const void* data) {
+    _VGpuNullBuffer* buffer = _VGPU_NULL_BUFFER(handle);
+    _VGPU_NULL_VALIDATE(buffer, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(data, "data cannot be NULL");
+    _VGPU_NULL_VALIDATE(buffer->resourceUsage != VGPU_RESOURCE_USAGE_IMMUTABLE, "immutable buffer cannot be updated");
+    _VGPU_NULL_VALIDATE(offset + size <= buffer->size, "update range exceeds buffer size");
+
+    if (buffer->data) {
+        memcpy((uint8_t*)buffer->data + offset, data, size);
+    }
+    _null.frame.bytesUploaded += size;
+}
+
+VGpuResult vgpuAllocateTransient(VGpuBufferUsage usage, uint64_t size, uint64_t alignment, VGpuTransientAllocation* allocation) {
+    _VGPU_NULL_VALIDATE(_null.initialized, "vgpu is not initialized", VGPU_ERROR_INITIALIZATION_FAILED);
+    _VGPU_NULL_VALIDATE(allocation, "allocation cannot be NULL", VGPU_ERROR_GENERIC);
+
+    _VGpuNullTransientRing type;
+    if (usage & VGPU_BUFFER_USAGE_UNIFORM) {
+        type = _VGPU_NULL_TRANSIENT_UNIFORM;
+        _VGPU_NULL_VALIDATE(size <= _null.limits.maxUniformBufferSize, "uniform range exceeds limits", VGPU_ERROR_GENERIC);
+        if (alignment < _null.limits.minUniformBufferOffsetAlignment) {
+            alignment = _null.limits.minUniformBufferOffsetAlignment;
+        }
+    }
+    else if (usage & (VGPU_BUFFER_USAGE_STORAGE_READ | VGPU_BUFFER_USAGE_STORAGE_WRITE)) {
+        type = _VGPU_NULL_TRANSIENT_STORAGE;
+    }
+    else if (usage & VGPU_BUFFER_USAGE_INDEX) {
+        type = _VGPU_NULL_TRANSIENT_INDEX;
+    }
+    else {
+        _VGPU_NULL_VALIDATE(usage & VGPU_BUFFER_USAGE_VERTEX, "unsupported transient usage", VGPU_ERROR_GENERIC);
+        type = _VGPU_NULL_TRANSIENT_VERTEX;
+    }
+
+    if (alignment == 0) {
+        alignment = 16;
+    }
+    _VGPU_NULL_VALIDATE((alignment & (alignment - 1)) == 0, "alignment must be a power of two", VGPU_ERROR_GENERIC);
+
+    _vgpu_null_transient_ring* ring = &_null.transient[type];
+    if (!ring->buffer) {
+        ring->buffer = vgpuCreateBuffer(_null.transientFrameSize * _null.transientFrameCount, usage, VGPU_RESOURCE_USAGE_STREAM, NULL);
+        _VGPU_NULL_VALIDATE(ring->buffer, "failed to create transient ring buffer", VGPU_ERROR_TOO_MANY_OBJECTS);
+    }
+
+    if (ring->frameIndex != _null.frameIndex) {
+        ring->frameIndex = _null.frameIndex;
+        ring->offset = 0;
+    }
+
+    const uint64_t offset = (ring->offset + alignment - 1) & ~(alignment - 1);
+    _VGPU_NULL_VALIDATE(offset + size <= _null.transientFrameSize, "transient ring exhausted for this frame", VGPU_ERROR_OUT_OF_DEVICE_MEMORY);
+    ring->offset = offset + size;
+
+    allocation->buffer = ring->buffer;
+    allocation->offset = (_null.frameIndex % _null.transientFrameCount) * _null.transientFrameSize + offset;
+    allocation->data = (uint8_t*)_VGPU_NULL_BUFFER(ring->buffer)->data + allocation->offset;
+    return VGPU_SUCCESS;
+}
+
+/* Shader */
+static VGpuShader _vgpuNullCreateShader(bool compute, const char* function) {
+    _VGpuNullShader* shader;
+    const uint32_t id = _vgpuNullAlloc(_null.shaders, function, (void**)&shader);
+    if (!id) {
+        return NULL;
+    }
+
+    shader->compute = compute;
+    _vgpuNullOnCreate(&_null.counters.shaders);
+    return _VGPU_HANDLE(VGpuShader, id);
+}
+
+VGpuShader vgpuCreateShader(const char* vertexSource, const char* fragmentSource) {
+    _VGPU_NULL_VALIDATE(vertexSource && vertexSource[0], "vertex source cannot be empty", NULL);
+    _VGPU_NULL_VALIDATE(fragmentSource && fragmentSource[0], "fragment source cannot be empty", NULL);
+
+    return _vgpuNullCreateShader(false, __func__);
+}
+
+VGpuShader vgpuCreateComputeShader(const char* source) {
+    _VGPU_NULL_VALIDATE(source && source[0], "compute source cannot be empty", NULL);
+
+    return _vgpuNullCreateShader(true, __func__);
+}
+
+VGpuShader vgpuCreateShaderWithDescriptor(const VGpuShaderDescriptor* descriptor) {
+    _VGPU_NULL_VALIDATE(descriptor, "shader descriptor cannot be null", NULL);
+    const bool compute = descriptor->compute.code != NULL;
+    if (compute) {
+        _VGPU_NULL_VALIDATE(descriptor->compute.codeSize > 0, "compute code cannot be empty", NULL);
+        _VGPU_NULL_VALIDATE(!descriptor->vertex.code && !descriptor->fragment.code, "compute shader cannot have graphics stages", NULL);
+    }
+    else {
+        _VGPU_NULL_VALIDATE(descriptor->vertex.code && descriptor->vertex.codeSize > 0, "vertex code cannot be empty", NULL);
+        _VGPU_NULL_VALIDATE(descriptor->fragment.code && descriptor->fragment.codeSize > 0, "fragment code cannot be empty", NULL);
+    }
+
+    _VGPU_NULL_VALIDATE(descriptor->vertexInputCount == 0 || descriptor->vertexInputs, "vertex inputs cannot be NULL", NULL);
+    for (uint32_t i = 0; i < descriptor->vertexInputCount; i++) {
+        _VGPU_NULL_VALIDATE(descriptor->vertexInputs[i].name, "vertex input name cannot be NULL", NULL);
+        _VGPU_NULL_VALIDATE(descriptor->vertexInputs[i].location < VGPU_MAX_VERTEX_ATTRIBUTES, "vertex input location out of range", NULL);
+    }
+
+    _VGPU_NULL_VALIDATE(descriptor->resourceCount == 0 || descriptor->resources, "resources cannot be NULL", NULL);
+    for (uint32_t i = 0; i < descriptor->resourceCount; i++) {
+        const VGpuShaderResourceBinding* resource = &descriptor->resources[i];
+        _VGPU_NULL_VALIDATE(resource->name, "resource name cannot be NULL", NULL);
+        if (resource->type == VGPU_SHADER_RESOURCE_TYPE_UNIFORM_BUFFER) {
+            _VGPU_NULL_VALIDATE(resource->binding < VGPU_MAX_UNIFORM_BUFFER_BINDINGS, "uniform buffer binding out of range", NULL);
+        }
+        else {
+            _VGPU_NULL_VALIDATE(resource->type == VGPU_SHADER_RESOURCE_TYPE_TEXTURE, "invalid resource type", NULL);
+            _VGPU_NULL_VALIDATE(resource->binding < VGPU_MAX_TEXTURE_BINDINGS, "texture binding out of range", NULL);
+        }
+    }
+
+    return _vgpuNullCreateShader(compute, __func__);
+}
+
+void vgpuDestroyShader(VGpuShader handle) {
+    if (!handle) {
+        return;
+    }
+
+    _VGPU_NULL_VALIDATE(_VGPU_NULL_SHADER(handle), "invalid or destroyed handle");
+    _vgpuNullOnDestroy(&_null.counters.shaders);
+    _vgpu_pool_retire(_null.shaders, _VGPU_HANDLE_ID(handle), _null.frameIndex);
+}
+
+/* Pipeline */
+VGpuPipeline vgpuCreateRenderPipeline(const VGpuRenderPipelineDescriptor* descriptor) {
+    _VGPU_NULL_VALIDATE(descriptor, "descriptor cannot be NULL", NULL);
+    const _VGpuNullShader* shader = _VGPU_NULL_SHADER(descriptor->shader);
+    _VGPU_NULL_VALIDATE(shader, "invalid or destroyed handle", NULL);
+    _VGPU_NULL_VALIDATE(!shader->compute, "render pipeline requires a graphics shader", NULL);
+    _VGPU_NULL_VALIDATE(descriptor->primitiveTopology < VGPU_PRIMITIVE_TOPOLOGY_COUNT, "invalid primitive topology", NULL);
+    _VGPU_NULL_VALIDATE(descriptor->depthStencil.depthCompareFunction < VGPU_COMPARE_FUNCTION_COUNT, "invalid depth compare function", NULL);
+
+    for (uint32_t i = 0; i < VGPU_MAX_VERTEX_ATTRIBUTES; i++) {
+        const VGpuVertexAttributeDescriptor* attr_desc = &descriptor->vertexDescriptor.attributes[i];
+        if (attr_desc->format == VGPU_VERTEX_FORMAT_UNKNOWN) {
+            break;
+        }
+
+        _VGPU_NULL_VALIDATE(attr_desc->format < VGPU_VERTEX_FORMAT_COUNT, "invalid vertex format", NULL);
+        _VGPU_NULL_VALIDATE(attr_desc->bufferIndex < VGPU_MAX_VERTEX_BUFFER_BINDINGS, "invalid vertex buffer index", NULL);
+        const VGpuVertexBufferLayoutDescriptor* layout = &descriptor->vertexDescriptor.layouts[attr_desc->bufferIndex];
+        _VGPU_NULL_VALIDATE(layout->stride > 0, "vertex buffer layout stride cannot be zero", NULL);
+        _VGPU_NULL_VALIDATE(attr_desc->offset < layout->stride, "vertex attribute offset outside of stride", NULL);
+    }
+
+    _VGpuNullPipeline* pipeline;
+    const uint32_t id = _vgpuNullAlloc(_null.pipelines, __func__, (void**)&pipeline);
+    if (!id) {
+        return NULL;
+    }
+
+    pipeline->shader = _VGPU_HANDLE_ID(descriptor->shader);
+    pipeline->topology = descriptor->primitiveTopology;
+    _vgpuNullOnCreate(&_null.counters.pipelines);
+    return _VGPU_HANDLE(VGpuPipeline, id);
+}
+
+void vgpuDestroyPipeline(VGpuPipeline handle) {
+    if (!handle) {
+        return;
+    }
+
+    _VGPU_NULL_VALIDATE(_VGPU_NULL_PIPELINE(handle), "invalid or destroyed handle");
+    if (_null.currentPipeline == handle) {
+        _null.currentPipeline = NULL;
+    }
+
+    _vgpuNullOnDestroy(&_null.counters.pipelines);
+    _vgpu_pool_retire(_null.pipelines, _VGPU_HANDLE_ID(handle), _null.frameIndex);
+}
+
+/* Release objects retired in completedFrame or earlier, framebuffers, shaders and pipelines own nothing. */
+static void _vgpuNullCollectRetired(uint32_t completedFrame) {
+    _VGpuNullTexture* texture;
+    while ((texture = (_VGpuNullTexture*)_vgpu_pool_collect(_null.textures, completedFrame)) != NULL) {
+        _vgpuNullReleaseTexture(texture);
+    }
+
+    _VGpuNullBuffer* buffer;
+    while ((buffer = (_VGpuNullBuffer*)_vgpu_pool_collect(_null.buffers, completedFrame)) != NULL) {
+        _vgpuNullReleaseBuffer(buffer);
+    }
+
+    while (_vgpu_pool_collect(_null.framebuffers, completedFrame) != NULL) {
+    }
+    while (_vgpu_pool_collect(_null.shaders, completedFrame) != NULL) {
+    }
+    while (_vgpu_pool_collect(_null.pipelines, completedFrame) != NULL) {
+    }
+}
+
+/* Commands */
+void vgpuBeginDefaultRenderPass(VGpuColor clearColor, float clearDepth, uint8_t clearStencil) {
+    _VGPU_NULL_VALIDATE(!_null.insideRenderPass, "render pass already active");
+    _null.insideRenderPass = true;
+    _null.frame.renderPasses++;
+}
+
+void vgpuBeginRenderPass(const VGpuRenderPassBeginDescriptor* descriptor) {
+    _VGPU_NULL_VALIDATE(descriptor, "descriptor cannot be NULL");
+    _VGPU_NULL_VALIDATE(_VGPU_NULL_FRAMEBUFFER(descriptor->framebuffer), "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(!_null.insideRenderPass, "render pass already active");
+    _null.insideRenderPass = true;
+    _null.frame.renderPasses++;
+}
+
+void vgpuEndRenderPass() {
+    _VGPU_NULL_VALIDATE(_null.insideRenderPass, "no active render pass");
+    _null.insideRenderPass = false;
+}
+
+void vgpuSetViewport(float x, float y, float width, float height) {
+    _VGPU_NULL_VALIDATE(width >= 0.0f && height >= 0.0f, "viewport size cannot be negative");
+    _VGPU_NULL_VALIDATE(width <= (float)_null.limits.maxViewportDimensions[0]
+        && height <= (float)_null.limits.maxViewportDimensions[1], "viewport size exceeds limits");
+}
+
+void vgpuSetScissor(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    _VGPU_NULL_VALIDATE(x >= 0 && y >= 0, "scissor offset cannot be negative");
+}
+
+void vgpuBindPipeline(VGpuPipeline handle) {
+    const _VGpuNullPipeline* pipeline = _VGPU_NULL_PIPELINE(handle);
+    _VGPU_NULL_VALIDATE(pipeline, "invalid or destroyed handle");
+    if (_null.currentPipeline != handle) {
+        const _VGpuNullPipeline* current = _VGPU_NULL_PIPELINE(_null.currentPipeline);
+        if (!current || current->shader != pipeline->shader) {
+            _null.frame.programBinds++;
+        }
+        _null.currentPipeline = handle;
+        _null.frame.pipelineBinds++;
+    }
+}
+
+void vgpuSetUniformBuffer(uint32_t binding, VGpuBuffer handle, uint64_t offset, uint64_t size) {
+    _VGPU_NULL_VALIDATE(binding < VGPU_MAX_UNIFORM_BUFFER_BINDINGS, "uniform buffer binding out of range");
+    if (!handle) {
+        return;
+    }
+
+    const _VGpuNullBuffer* buffer = _VGPU_NULL_BUFFER(handle);
+    _VGPU_NULL_VALIDATE(buffer, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(buffer->usage & VGPU_BUFFER_USAGE_UNIFORM, "buffer was not created with uniform usage");
+    _VGPU_NULL_VALIDATE(offset % _null.limits.minUniformBufferOffsetAlignment == 0, "uniform buffer offset is not aligned");
+    _VGPU_NULL_VALIDATE(offset + size <= buffer->size, "uniform buffer range exceeds buffer size");
+    _VGPU_NULL_VALIDATE(size <= _null.limits.maxUniformBufferSize, "uniform buffer range exceeds limits");
+    _null.frame.bufferBinds++;
+}
+
+void vgpuSetTexture(uint32_t binding, VGpuTexture texture) {
+    _VGPU_NULL_VALIDATE(binding < VGPU_MAX_TEXTURE_BINDINGS, "texture binding out of range");
+    if (texture) {
+        _VGPU_NULL_VALIDATE(_VGPU_NULL_TEXTURE(texture), "invalid or destroyed handle");
+        _null.frame.textureBinds++;
+    }
+}
+
+void vgpuSetVertexBuffers(uint32_t firstBinding, uint32_t count, const VGpuBuffer* buffers, const uint64_t* offsets) {
+    _VGPU_NULL_VALIDATE(firstBinding + count <= VGPU_MAX_VERTEX_BUFFER_BINDINGS, "vertex buffer binding out of range");
+    _VGPU_NULL_VALIDATE(count == 0 || buffers, "buffers cannot be NULL");
+    for (uint32_t i = 0; i < count; i++) {
+        if (!buffers[i]) {
+            continue;
+        }
+
+        const _VGpuNullBuffer* buffer = _VGPU_NULL_BUFFER(buffers[i]);
+        _VGPU_NULL_VALIDATE(buffer, "invalid or destroyed handle");
+        _VGPU_NULL_VALIDATE(buffer->usage & VGPU_BUFFER_USAGE_VERTEX, "buffer was not created with vertex usage");
+        _VGPU_NULL_VALIDATE(!offsets || offsets[i] < buffer->size, "vertex buffer offset exceeds buffer size");
+        _null.frame.bufferBinds++;
+    }
+}
+
+void vgpuSetIndexBuffer(VGpuBuffer handle, uint64_t offset, VGpuIndexType indexType) {
+    if (!handle) {
+        _null.indexBuffer = NULL;
+        return;
+    }
+
+    const uint32_t indexSize = indexType == VGPU_INDEX_TYPE_UINT32 ? 4 : 2;
+    const _VGpuNullBuffer* buffer = _VGPU_NULL_BUFFER(handle);
+    _VGPU_NULL_VALIDATE(buffer, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(buffer->usage & VGPU_BUFFER_USAGE_INDEX, "buffer was not created with index usage");
+    _VGPU_NULL_VALIDATE(offset % indexSize == 0, "index buffer offset must be a multiple of the index size");
+    _VGPU_NULL_VALIDATE(offset < buffer->size, "index buffer offset exceeds buffer size");
+    _null.indexBuffer = handle;
+    _null.indexOffset = offset;
+    _null.indexSize = indexSize;
+    _null.frame.bufferBinds++;
+}
+
+void vgpuDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex) {
+    _VGPU_NULL_VALIDATE(_null.insideRenderPass, "draw outside of render pass");
+    const _VGpuNullPipeline* pipeline = _VGPU_NULL_PIPELINE(_null.currentPipeline);
+    _VGPU_NULL_VALIDATE(pipeline, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(vertexCount > 0, "vertex count cannot be zero");
+
+    _null.frame.draws++;
+    _null.frame.vertices += (uint64_t)vertexCount * (instanceCount > 0 ? instanceCount : 1);
+    _null.frame.instances += instanceCount > 0 ? instanceCount : 1;
+    _null.frame.primitives += vgpuGetPrimitiveCount(pipeline->topology, vertexCount) * (instanceCount > 0 ? instanceCount : 1);
+}
+
+void vgpuDrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex) {
+    _VGPU_NULL_VALIDATE(_null.insideRenderPass, "draw outside of render pass");
+    const _VGpuNullPipeline* pipeline = _VGPU_NULL_PIPELINE(_null.currentPipeline);
+    _VGPU_NULL_VALIDATE(pipeline, "invalid or destroyed handle");
+    const _VGpuNullBuffer* indexBuffer = _VGPU_NULL_BUFFER(_null.indexBuffer);
+    _VGPU_NULL_VALIDATE(indexBuffer, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(indexCount > 0, "index count cannot be zero");
+    _VGPU_NULL_VALIDATE(_null.indexOffset + ((uint64_t)firstIndex + indexCount) * _null.indexSize <= indexBuffer->size,
+        "index range exceeds index buffer size");
+    (void)baseVertex;
+
+    _null.frame.draws++;
+    _null.frame.vertices += (uint64_t)indexCount * (instanceCount > 0 ? instanceCount : 1);
+    _null.frame.instances += instanceCount > 0 ? instanceCount : 1;
+    _null.frame.primitives += vgpuGetPrimitiveCount(pipeline->topology, indexCount) * (instanceCount > 0 ? instanceCount : 1);
+}
+
+/* Validate an indirect argument range and count the draws, returns the argument buffer or NULL on error. */
+static const _VGpuNullBuffer* _vgpuNullValidateIndirect(VGpuBuffer handle, uint64_t offset, uint32_t drawCount, uint32_t stride, uint32_t commandSize) {
+    _VGPU_NULL_VALIDATE(_null.insideRenderPass, "draw outside of render pass", NULL);
+    _VGPU_NULL_VALIDATE(_VGPU_NULL_PIPELINE(_null.currentPipeline), "invalid or destroyed handle", NULL);
+    const _VGpuNullBuffer* buffer = _VGPU_NULL_BUFFER(handle);
+    _VGPU_NULL_VALIDATE(buffer, "invalid or destroyed handle", NULL);
+    _VGPU_NULL_VALIDATE(buffer->usage & VGPU_BUFFER_USAGE_INDIRECT, "buffer was not created with indirect usage", NULL);
+    _VGPU_NULL_VALIDATE(offset % 4 == 0, "indirect offset must be a multiple of 4", NULL);
+    _VGPU_NULL_VALIDATE(stride % 4 == 0 && stride >= commandSize, "indirect stride must be a multiple of 4 and hold a command", NULL);
+    _VGPU_NULL_VALIDATE(drawCount == 0 || offset + (uint64_t)(drawCount - 1) * stride + commandSize <= buffer->size,
+        "indirect range exceeds buffer size", NULL);
+    _null.frame.draws += drawCount;
+    return buffer;
+}
+
+void vgpuDrawIndirect(VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride) {
+    if (stride == 0) {
+        stride = sizeof(VGpuDrawIndirectCommand);
+    }
+
+    /* When the arguments live in host memory their work is counted too. */
+    const _VGpuNullBuffer* buffer = _vgpuNullValidateIndirect(indirectBuffer, offset, drawCount, stride, sizeof(VGpuDrawIndirectCommand));
+    if (!buffer || !buffer->data) {
+        return;
+    }
+
+    const VGpuPrimitiveTopology topology = _VGPU_NULL_PIPELINE(_null.currentPipeline)->topology;
+    for (uint32_t i = 0; i < drawCount; i++) {
+        VGpuDrawIndirectCommand command;
+        memcpy(&command, (const uint8_t*)buffer->data + offset + (uint64_t)i * stride, sizeof(command));
+        _null.frame.vertices += (uint64_t)command.vertexCount * command.instanceCount;
+        _null.frame.instances += command.instanceCount;
+        _null.frame.primitives += vgpuGetPrimitiveCount(topology, command.vertexCount) * command.instanceCount;
+    }
+}
+
+void vgpuDrawIndexedIndirect(VGpuBuffer indirectBuffer, uint64_t offset, uint32_t drawCount, uint32_t stride) {
+    const _VGpuNullBuffer* indexBuffer = _VGPU_NULL_BUFFER(_null.indexBuffer);
+    _VGPU_NULL_VALIDATE(indexBuffer, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(_null.indexOffset == 0, "indexed indirect draws read indices from the start of the index buffer");
+    if (stride == 0) {
+        stride = sizeof(VGpuDrawIndexedIndirectCommand);
+    }
+
+    const _VGpuNullBuffer* buffer = _vgpuNullValidateIndirect(indirectBuffer, offset, drawCount, stride, sizeof(VGpuDrawIndexedIndirectCommand));
+    if (!buffer || !buffer->data) {
+        return;
+    }
+
+    const VGpuPrimitiveTopology topology = _VGPU_NULL_PIPELINE(_null.currentPipeline)->topology;
+    for (uint32_t i = 0; i < drawCount; i++) {
+        VGpuDrawIndexedIndirectCommand command;
+        memcpy(&command, (const uint8_t*)buffer->data + offset + (uint64_t)i * stride, sizeof(command));
+        _VGPU_NULL_VALIDATE(((uint64_t)command.firstIndex + command.indexCount) * _null.indexSize <= indexBuffer->size,
+            "indirect index range exceeds index buffer size");
+        _null.frame.vertices += (uint64_t)command.indexCount * command.instanceCount;
+        _null.frame.instances += command.instanceCount;
+        _null.frame.primitives += vgpuGetPrimitiveCount(topology, command.indexCount) * command.instanceCount;
+    }
+}
+
+void vgpuDispatch(VGpuShader computeShader, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+    const _VGpuNullShader* shader = _VGPU_NULL_SHADER(computeShader);
+    _VGPU_NULL_VALIDATE(shader, "invalid or destroyed handle");
+    _VGPU_NULL_VALIDATE(shader->compute, "dispatch requires a compute shader");
+    _VGPU_NULL_VALIDATE(!_null.insideRenderPass, "dispatch inside render pass");
+    _VGPU_NULL_VALIDATE(groupCountX <= _null.limits.maxComputeWorkGroupCount[0]
+        && groupCountY <= _null.limits.maxComputeWorkGroupCount[1]
+        && groupCountZ <= _null.limits.maxComputeWorkGroupCount[2], "dispatch group count exceeds limits");
+
+    _null.frame.dispatches++;
+}
+
+#endif /* defined(VGPU_NULL) */